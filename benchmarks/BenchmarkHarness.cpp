@@ -0,0 +1,136 @@
+#include "BenchmarkHarness.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace umppi::bench {
+
+namespace {
+
+std::string formatRate(double value) {
+    if (value <= 0)
+        return "-";
+    const char* prefixes[] = {"", "k", "M", "G", "T"};
+    int prefix = 0;
+    while (value >= 1000.0 && prefix < 4) {
+        value /= 1000.0;
+        prefix++;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f%s/s", value, prefixes[prefix]);
+    return buffer;
+}
+
+double measure(const std::function<void()>& operation, uint64_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; i++)
+        operation();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+BenchmarkHarness::BenchmarkHarness(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) {
+            filter_ = argv[++i];
+        } else if (arg == "--min-time" && hasValue) {
+            minTimeSeconds_ = std::stod(argv[++i]);
+        } else if (arg == "--csv" && hasValue) {
+            csvPath_ = argv[++i];
+        } else if (arg == "--corpus" && hasValue) {
+            corpusDirectory_ = argv[++i];
+        } else if (arg == "--baseline" && hasValue) {
+            std::ifstream baseline(argv[++i]);
+            if (!baseline) {
+                std::cerr << "Cannot open baseline " << argv[i] << "\n";
+                valid_ = false;
+                return;
+            }
+            std::string line;
+            std::getline(baseline, line); // header
+            while (std::getline(baseline, line)) {
+                std::istringstream fields(line);
+                std::string name, iterations, nanoseconds;
+                if (std::getline(fields, name, ',') && std::getline(fields, iterations, ',') &&
+                    std::getline(fields, nanoseconds, ','))
+                    baseline_[name] = std::stod(nanoseconds);
+            }
+        } else {
+            valid_ = false;
+            return;
+        }
+    }
+
+    std::printf("%-48s %12s %14s %14s %11s%s\n", "benchmark", "ns/op", "packets", "bytes", "allocs/op",
+                baseline_.empty() ? "" : "   speedup");
+}
+
+void BenchmarkHarness::printUsage() {
+    std::cerr << "Usage: umppi-bench [--filter substring] [--min-time seconds] [--corpus smf-directory]\n"
+              << "                   [--csv output.csv] [--baseline previous.csv]\n";
+}
+
+void BenchmarkHarness::run(const std::string& name, double packetsPerOperation, double bytesPerOperation,
+                           const std::function<void()>& operation) {
+    if (!filter_.empty() && name.find(filter_) == std::string::npos)
+        return;
+
+    // warm up caches and any lazily grown buffers, then find an iteration count that fills the minimum time
+    operation();
+    uint64_t iterations = 1;
+    double elapsed = measure(operation, iterations);
+    while (elapsed < minTimeSeconds_ / 10 && iterations < (1ULL << 40)) {
+        iterations *= 10;
+        elapsed = measure(operation, iterations);
+    }
+    if (elapsed < minTimeSeconds_)
+        iterations = static_cast<uint64_t>(iterations * (minTimeSeconds_ / std::max(elapsed, 1e-9))) + 1;
+
+    uint64_t allocationsBefore = getAllocationCount();
+    elapsed = measure(operation, iterations);
+    uint64_t allocations = getAllocationCount() - allocationsBefore;
+
+    BenchmarkResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.nanosecondsPerOperation = elapsed * 1e9 / iterations;
+    result.packetsPerSecond = packetsPerOperation * iterations / elapsed;
+    result.bytesPerSecond = bytesPerOperation * iterations / elapsed;
+    result.allocationsPerOperation = static_cast<double>(allocations) / iterations;
+    print(result);
+    results_.push_back(result);
+}
+
+void BenchmarkHarness::print(const BenchmarkResult& result) const {
+    std::printf("%-48s %12.1f %14s %14s %11.2f", result.name.c_str(), result.nanosecondsPerOperation,
+                formatRate(result.packetsPerSecond).c_str(), formatRate(result.bytesPerSecond).c_str(),
+                result.allocationsPerOperation);
+    auto baseline = baseline_.find(result.name);
+    if (baseline != baseline_.end())
+        std::printf("   %6.2fx", baseline->second / result.nanosecondsPerOperation);
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+int BenchmarkHarness::finish() {
+    if (csvPath_.empty())
+        return 0;
+    std::ofstream csv(csvPath_);
+    if (!csv) {
+        std::cerr << "Cannot write " << csvPath_ << "\n";
+        return 1;
+    }
+    csv << "name,iterations,ns_per_op,packets_per_second,bytes_per_second,allocations_per_op\n";
+    for (const auto& result : results_)
+        csv << result.name << "," << result.iterations << "," << result.nanosecondsPerOperation << ","
+            << result.packetsPerSecond << "," << result.bytesPerSecond << "," << result.allocationsPerOperation << "\n";
+    return 0;
+}
+
+} // namespace umppi::bench
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace umppi::bench {
+
+// Number of global operator new calls so far (counted by AllocationCounter.cpp).
+uint64_t getAllocationCount();
+
+// Keeps the compiler from discarding a result that is otherwise unused.
+inline void doNotOptimize(const void* value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = value;
+#endif
+}
+
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterations = 0;
+    double nanosecondsPerOperation = 0;
+    double packetsPerSecond = 0;
+    double bytesPerSecond = 0;
+    double allocationsPerOperation = 0;
+};
+
+// Minimal benchmark runner: each benchmark is run repeatedly until it has taken at least the
+// minimum time, then reported as time per operation, packets/s and bytes/s (from the amounts
+// processed per operation) and global allocations per operation.
+//
+// Options: --filter <substring>  --min-time <seconds>  --csv <output file>  --baseline <csv file>
+// A CSV written by --csv can be passed to a later run as --baseline to print the speedup against it.
+class BenchmarkHarness {
+public:
+    BenchmarkHarness(int argc, char** argv);
+
+    bool isValid() const { return valid_; }
+    const std::string& getCorpusDirectory() const { return corpusDirectory_; }
+
+    // packetsPerOperation and bytesPerOperation may be 0 when they do not apply.
+    void run(const std::string& name, double packetsPerOperation, double bytesPerOperation,
+             const std::function<void()>& operation);
+
+    // Prints the summary; returns the process exit code.
+    int finish();
+
+    static void printUsage();
+
+private:
+    void print(const BenchmarkResult& result) const;
+
+    bool valid_ = true;
+    std::string filter_;
+    double minTimeSeconds_ = 0.5;
+    std::string csvPath_;
+    std::string corpusDirectory_;
+    std::map<std::string, double> baseline_;
+    std::vector<BenchmarkResult> results_;
+};
+
+} // namespace umppi::bench
@@ -0,0 +1,283 @@
+// Micro-benchmarks for the umppi hot paths. See BenchmarkHarness.hpp for the options.
+// Synthetic inputs are always run; pass --corpus <directory> to also run the SMF benchmarks over real files.
+
+#include "BenchmarkHarness.hpp"
+#include <umppi/umppi.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <istream>
+#include <sstream>
+#include <streambuf>
+
+using namespace umppi;
+using namespace umppi::bench;
+
+namespace {
+
+// Reads from an existing buffer without copying it into a stringstream.
+class MemoryStreamBuffer : public std::streambuf {
+public:
+    MemoryStreamBuffer(const char* data, size_t size) {
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+};
+
+Midi1Music readMidi1Bytes(const std::string& bytes) {
+    MemoryStreamBuffer buffer(bytes.data(), bytes.size());
+    std::istream stream(&buffer);
+    return Midi1Reader(stream).read();
+}
+
+// A mix of the packet types a typical MIDI 2.0 stream carries.
+std::vector<Ump> createMixedPackets(size_t count) {
+    std::vector<Ump> packets;
+    packets.reserve(count);
+    auto sysex = UmpFactory::sysex7(0, {0x7E, 0x7F, 0x06, 0x01, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60});
+    for (size_t i = 0; packets.size() < count; i++) {
+        auto note = static_cast<uint8_t>(36 + i % 48);
+        auto channel = static_cast<uint8_t>(i % 16);
+        switch (i % 8) {
+            case 0: packets.emplace_back(UmpFactory::midi2NoteOn(0, channel, note, 0, 0xC000, 0)); break;
+            case 1: packets.emplace_back(UmpFactory::midi2NoteOff(0, channel, note, 0, 0, 0)); break;
+            case 2: packets.emplace_back(UmpFactory::midi2CC(0, channel, 7, static_cast<uint32_t>(i * 0x10000))); break;
+            case 3: packets.emplace_back(UmpFactory::midi1NoteOn(0, channel, note, 100)); break;
+            case 4: packets.emplace_back(UmpFactory::midi1CC(0, channel, 11, static_cast<uint8_t>(i % 128))); break;
+            case 5: packets.emplace_back(UmpFactory::midi2PitchBendDirect(0, channel, static_cast<uint32_t>(i * 0x1000))); break;
+            case 6: packets.emplace_back(UmpFactory::deltaClockstamp(static_cast<uint32_t>(i % 480))); break;
+            case 7: packets.insert(packets.end(), sysex.begin(), sysex.end()); break;
+        }
+    }
+    packets.resize(count);
+    return packets;
+}
+
+// MIDI 2.0 channel voice messages that all have a MIDI 1.0 translation, with delta clockstamps.
+std::vector<Ump> createMidi2Sequence(size_t count) {
+    std::vector<Ump> packets;
+    packets.reserve(count);
+    for (size_t i = 0; packets.size() < count; i++) {
+        auto note = static_cast<uint8_t>(36 + i % 48);
+        auto channel = static_cast<uint8_t>(i % 16);
+        switch (i % 4) {
+            case 0: packets.emplace_back(UmpFactory::midi2NoteOn(0, channel, note, 0, 0xC000, 0)); break;
+            case 1: packets.emplace_back(UmpFactory::midi2CC(0, channel, 7, static_cast<uint32_t>(i * 0x10000))); break;
+            case 2: packets.emplace_back(UmpFactory::midi2NoteOff(0, channel, note, 0, 0, 0)); break;
+            case 3: packets.emplace_back(UmpFactory::deltaClockstamp(static_cast<uint32_t>(i % 480))); break;
+        }
+    }
+    return packets;
+}
+
+std::vector<uint8_t> createMidi1Bytes(size_t messageCount) {
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < messageCount; i++) {
+        auto note = static_cast<uint8_t>(36 + i % 48);
+        auto channel = static_cast<uint8_t>(i % 16);
+        switch (i % 5) {
+            case 0: bytes.insert(bytes.end(), {static_cast<uint8_t>(0x90 | channel), note, 100}); break;
+            case 1: bytes.insert(bytes.end(), {static_cast<uint8_t>(0x80 | channel), note, 0}); break;
+            case 2: bytes.insert(bytes.end(), {static_cast<uint8_t>(0xB0 | channel), 7, static_cast<uint8_t>(i % 128)}); break;
+            case 3: bytes.insert(bytes.end(), {static_cast<uint8_t>(0xE0 | channel), 0, static_cast<uint8_t>(i % 128)}); break;
+            case 4: bytes.insert(bytes.end(), {static_cast<uint8_t>(0xC0 | channel), static_cast<uint8_t>(i % 128)}); break;
+        }
+    }
+    return bytes;
+}
+
+Midi1Music createMidi1Music(int trackCount, int eventsPerTrack) {
+    Midi1Music music;
+    music.format = 1;
+    music.deltaTimeSpec = 480;
+    Midi1Track conductor;
+    for (int i = 0; i < 32; i++) {
+        std::vector<uint8_t> tempo{0x07, static_cast<uint8_t>(0xA1 + i % 8), 0x20};
+        conductor.events.emplace_back(i == 0 ? 0 : 1920,
+            std::make_shared<Midi1CompoundMessage>(Midi1Status::META, MidiMetaType::TEMPO, 0, tempo, 0, tempo.size()));
+    }
+    music.addTrack(conductor);
+    for (int t = 0; t < trackCount; t++) {
+        Midi1Track track;
+        for (int i = 0; i < eventsPerTrack; i++) {
+            int note = 36 + (i * 7 + t) % 48;
+            bool on = i % 2 == 0;
+            track.events.emplace_back(on ? (i * 13 + t) % 120 : 60,
+                std::make_shared<Midi1SimpleMessage>((on ? 0x90 : 0x80) | (t % 16), note, on ? 100 : 0));
+        }
+        music.addTrack(track);
+    }
+    return music;
+}
+
+std::string toSmfBytes(const Midi1Music& music) {
+    std::ostringstream stream;
+    Midi1Writer(stream).write(music);
+    return stream.str();
+}
+
+size_t countEvents(const Midi1Music& music) {
+    size_t count = 0;
+    for (const auto& track : music.tracks)
+        count += track.events.size();
+    return count;
+}
+
+void runUmpBenchmarks(BenchmarkHarness& harness) {
+    auto packets = createMixedPackets(4096);
+    std::vector<uint32_t> words;
+    std::vector<uint8_t> bytes;
+    for (const auto& ump : packets) {
+        ump.toWords(words, words.size());
+        ump.toBytes(bytes, bytes.size());
+    }
+
+    harness.run("Ump::fromWords/4096", packets.size(), words.size() * 4.0, [&] {
+        auto result = Ump::fromWords(words);
+        doNotOptimize(result.data());
+    });
+    harness.run("Ump::fromBytes/4096", packets.size(), bytes.size(), [&] {
+        auto result = Ump::fromBytes(bytes);
+        doNotOptimize(result.data());
+    });
+    harness.run("UmpClassifier::scan/4096", packets.size(), words.size() * 4.0, [&, classifier = UmpClassifier()]() mutable {
+        classifier.scan(words);
+        doNotOptimize(&classifier);
+    });
+
+    for (size_t size : {16, 256, 4096}) {
+        std::vector<uint8_t> sysex(size);
+        for (size_t i = 0; i < size; i++)
+            sysex[i] = static_cast<uint8_t>(i & 0x7F);
+        auto sysexPackets = UmpFactory::sysex7(0, sysex);
+        harness.run("UmpFactory::sysex7/" + std::to_string(size), sysexPackets.size(), size, [&] {
+            auto result = UmpFactory::sysex7(0, sysex);
+            doNotOptimize(result.data());
+        });
+        harness.run("UmpRetriever::getSysex7Data/" + std::to_string(size), sysexPackets.size(), size, [&] {
+            auto result = UmpRetriever::getSysex7Data(sysexPackets);
+            doNotOptimize(result.data());
+        });
+    }
+}
+
+void runTranslatorBenchmarks(BenchmarkHarness& harness) {
+    auto midi1 = createMidi1Bytes(4096);
+    size_t midi1Packets = 0;
+    {
+        Midi1ToUmpTranslatorContext context(midi1, 0, false, static_cast<int>(MidiTransportProtocol::UMP));
+        UmpTranslator::translateMidi1BytesToUmp(context);
+        midi1Packets = context.output.size();
+    }
+    harness.run("UmpTranslator::translateMidi1BytesToUmp/midi2", midi1Packets, midi1.size(), [&] {
+        Midi1ToUmpTranslatorContext context(midi1, 0, false, static_cast<int>(MidiTransportProtocol::UMP));
+        UmpTranslator::translateMidi1BytesToUmp(context);
+        doNotOptimize(context.output.data());
+    });
+    harness.run("UmpTranslator::translateMidi1BytesToUmp/midi1", midi1Packets, midi1.size(), [&] {
+        Midi1ToUmpTranslatorContext context(midi1, 0, false, static_cast<int>(MidiTransportProtocol::MIDI1));
+        UmpTranslator::translateMidi1BytesToUmp(context);
+        doNotOptimize(context.output.data());
+    });
+
+    auto midi2 = createMidi2Sequence(4096);
+    std::vector<uint8_t> smfBytes;
+    UmpTranslator::translateUmpToMidi1Bytes(smfBytes, midi2);
+    harness.run("UmpTranslator::translateUmpToMidi1Bytes/4096", midi2.size(), smfBytes.size(), [&] {
+        std::vector<uint8_t> dst;
+        UmpTranslator::translateUmpToMidi1Bytes(dst, midi2);
+        doNotOptimize(dst.data());
+    });
+    harness.run("UmpToMidi1BytesTranslator::translate/4096", midi2.size(), smfBytes.size(),
+                [&, translator = UmpToMidi1BytesTranslator(), dst = std::vector<uint8_t>()]() mutable {
+        translator.translate(dst, midi2);
+        doNotOptimize(dst.data());
+    });
+    harness.run("UmpTranslator::translateMidi2UmpToMidi1Ump/4096", midi2.size(), midi2.size() * 8.0, [&] {
+        std::vector<Ump> dst;
+        UmpTranslator::translateMidi2UmpToMidi1Ump(dst, midi2);
+        doNotOptimize(dst.data());
+    });
+}
+
+void runSmfBenchmarks(BenchmarkHarness& harness, const std::string& label, const std::vector<std::string>& files) {
+    size_t totalBytes = 0;
+    size_t totalEvents = 0;
+    std::vector<Midi1Music> songs;
+    for (const auto& file : files) {
+        totalBytes += file.size();
+        songs.push_back(readMidi1Bytes(file));
+        totalEvents += countEvents(songs.back());
+    }
+
+    harness.run("Midi1Reader::read/" + label, totalEvents, totalBytes, [&] {
+        for (const auto& file : files) {
+            auto music = readMidi1Bytes(file);
+            doNotOptimize(&music);
+        }
+    });
+    harness.run("Midi1Music::mergeTracks/" + label, totalEvents, 0, [&] {
+        for (const auto& song : songs) {
+            auto merged = song.mergeTracks();
+            doNotOptimize(&merged);
+        }
+    });
+
+    std::vector<Midi1Music> mergedSongs;
+    std::vector<int> totalTicks;
+    for (const auto& song : songs) {
+        mergedSongs.push_back(song.mergeTracks());
+        totalTicks.push_back(mergedSongs.back().getTotalTicks());
+    }
+    harness.run("Midi1Music::getPlayTimeMillisecondsAtTick/" + label, totalEvents, 0, [&] {
+        for (size_t i = 0; i < mergedSongs.size(); i++) {
+            const auto& song = mergedSongs[i];
+            if (song.tracks.empty())
+                continue;
+            int ms = Midi1Music::getPlayTimeMillisecondsAtTick(song.tracks[0].events, totalTicks[i], song.deltaTimeSpec);
+            doNotOptimize(&ms);
+        }
+    });
+}
+
+std::vector<std::string> loadCorpus(const std::string& directory) {
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
+        auto ext = entry.path().extension().string();
+        if (!entry.is_regular_file() || (ext != ".mid" && ext != ".midi" && ext != ".MID"))
+            continue;
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::string bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        try {
+            readMidi1Bytes(bytes);
+            files.push_back(std::move(bytes));
+        } catch (const std::exception& e) {
+            std::cerr << "Skipping " << entry.path().string() << ": " << e.what() << "\n";
+        }
+    }
+    return files;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkHarness harness(argc, argv);
+    if (!harness.isValid()) {
+        BenchmarkHarness::printUsage();
+        return 2;
+    }
+
+    runUmpBenchmarks(harness);
+    runTranslatorBenchmarks(harness);
+    runSmfBenchmarks(harness, "synthetic", {toSmfBytes(createMidi1Music(16, 4000))});
+
+    if (!harness.getCorpusDirectory().empty()) {
+        auto corpus = loadCorpus(harness.getCorpusDirectory());
+        if (corpus.empty())
+            std::cerr << "No readable SMF in " << harness.getCorpusDirectory() << "\n";
+        else
+            runSmfBenchmarks(harness, "corpus", corpus);
+    }
+
+    return harness.finish();
+}
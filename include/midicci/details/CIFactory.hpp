@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <vector>
 #include <cstring>
+#include <functional>
+#include <span>
 #include "midicci/midicci.hpp"
 
 namespace midicci {
@@ -59,6 +61,17 @@ public:
         uint32_t source_muid, uint32_t destination_muid, uint8_t request_id,
         const std::vector<uint8_t>& header, const std::vector<uint8_t>& data);
 
+    // Receives one complete SysEx packet at a time. Returning false stops the serialization.
+    using PacketSink = std::function<bool(const std::vector<uint8_t>& packet)>;
+
+    // Same chunking as above, but each chunk is built into buffer (resized to the packet, so its
+    // capacity is reused) and passed to sink before the next one is built; only one chunk is held
+    // in memory at a time. Returns the number of chunks passed to sink.
+    static size_t midiCIPropertyChunks(
+        std::vector<uint8_t>& buffer, uint32_t max_chunk_size, uint8_t sub_id_2,
+        uint32_t source_muid, uint32_t destination_muid, uint8_t request_id,
+        std::span<const uint8_t> header, std::span<const uint8_t> data, const PacketSink& sink);
+
     static void midiCIProfile(std::vector<uint8_t>& dst, size_t offset, MidiCIProfileId info);
 
     static std::vector<uint8_t> midiCIProfileInquiry(
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <span>
 #include <cstdint>
 #include <utility>
 #include "midicci/midicci.hpp"
@@ -9,39 +10,41 @@ namespace midicci {
 
 class CIRetrieval {
 public:
-    static uint8_t getAddressing(const std::vector<uint8_t>& sysex);
+    static uint8_t getAddressing(std::span<const uint8_t> sysex);
     
-    static DeviceDetails getDeviceDetails(const std::vector<uint8_t>& sysex);
+    static DeviceDetails getDeviceDetails(std::span<const uint8_t> sysex);
     
-    static uint32_t getSourceMuid(const std::vector<uint8_t>& sysex);
+    static uint32_t getSourceMuid(std::span<const uint8_t> sysex);
     
-    static uint32_t getDestinationMuid(const std::vector<uint8_t>& sysex);
+    static uint32_t getDestinationMuid(std::span<const uint8_t> sysex);
     
-    static uint32_t getMuidToInvalidate(const std::vector<uint8_t>& sysex);
+    static uint32_t getMuidToInvalidate(std::span<const uint8_t> sysex);
     
-    static uint32_t getMaxSysexSize(const std::vector<uint8_t>& sysex);
+    static uint32_t getMaxSysexSize(std::span<const uint8_t> sysex);
     
     static std::pair<std::vector<MidiCIProfileId>, std::vector<MidiCIProfileId>>
-    getProfileSet(const std::vector<uint8_t>& sysex);
+    getProfileSet(std::span<const uint8_t> sysex);
     
-    static MidiCIProfileId getProfileId(const std::vector<uint8_t>& sysex);
+    static MidiCIProfileId getProfileId(std::span<const uint8_t> sysex);
     
-    static uint16_t getProfileEnabledChannels(const std::vector<uint8_t>& sysex);
+    static uint16_t getProfileEnabledChannels(std::span<const uint8_t> sysex);
     
-    static uint16_t getProfileSpecificDataSize(const std::vector<uint8_t>& sysex);
+    static uint16_t getProfileSpecificDataSize(std::span<const uint8_t> sysex);
     
-    static uint8_t getMaxPropertyRequests(const std::vector<uint8_t>& sysex);
+    static uint8_t getMaxPropertyRequests(std::span<const uint8_t> sysex);
     
-    static std::vector<uint8_t> getPropertyHeader(const std::vector<uint8_t>& sysex);
+    // The property header and body accessors return views into sysex; they stay valid only as long
+    // as the input buffer does, and callers copy them only where the bytes need to be kept.
+    static std::span<const uint8_t> getPropertyHeader(std::span<const uint8_t> sysex);
     
-    static std::vector<uint8_t> getPropertyBodyInThisChunk(const std::vector<uint8_t>& sysex);
+    static std::span<const uint8_t> getPropertyBodyInThisChunk(std::span<const uint8_t> sysex);
     
-    static uint16_t getPropertyTotalChunks(const std::vector<uint8_t>& sysex);
+    static uint16_t getPropertyTotalChunks(std::span<const uint8_t> sysex);
     
-    static uint16_t getPropertyChunkIndex(const std::vector<uint8_t>& sysex);
+    static uint16_t getPropertyChunkIndex(std::span<const uint8_t> sysex);
 
 private:
-    static MidiCIProfileId getProfileIdEntry(const std::vector<uint8_t>& sysex, size_t offset);
+    static MidiCIProfileId getProfileIdEntry(std::span<const uint8_t> sysex, size_t offset);
 };
 
 } // namespace midi_ci
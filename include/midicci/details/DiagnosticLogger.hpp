@@ -0,0 +1,199 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace midicci {
+
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+enum class LogCategory : uint8_t {
+    Transport,        // raw SysEx / UMP traffic
+    Discovery,
+    Profile,
+    Property,
+    ProcessInquiry,
+    Application,
+    Count
+};
+
+// What a LogRecord describes. Each event has a fixed rendering in formatLogRecord(), so records only
+// carry numbers and raw bytes.
+enum class LogEvent : uint16_t {
+    Text,                    // payload: UTF-8 text
+    SysExReceived,           // args: group, total size; payload: leading bytes
+    SysExSent,               // args: group, total size; payload: leading bytes
+    UmpReceived,             // args: word count; payload: leading words (little endian)
+    MidiMessageReportChunk,  // args: total size; payload: leading bytes
+    MessageSent,             // args: sub-ID#2, destination MUID
+    MessageReceived,         // args: sub-ID#2, source MUID
+    PropertyChunkReceived,   // args: sub-ID#2, request ID, chunk index, total chunks
+    Continuation             // payload: the next part of the payload of the record it follows
+};
+
+// Fixed-size, trivially copyable diagnostic record. Anything that needs formatting is stored as
+// numbers or raw bytes and only rendered by the consumer. A payload longer than MAX_PAYLOAD_SIZE
+// goes on in continuation_count Continuation records right behind it (see
+// DiagnosticLogger::setMaxPayloadSize()).
+struct LogRecord {
+    static constexpr size_t MAX_PAYLOAD_SIZE = 48;
+
+    uint64_t timestamp_ns = 0;   // steady clock
+    uint32_t muid = 0;
+    std::array<uint32_t, 4> args{};
+    LogEvent event = LogEvent::Text;
+    LogLevel level = LogLevel::Info;
+    LogCategory category = LogCategory::Application;
+    bool is_outgoing = false;
+    uint8_t payload_size = 0;
+    uint16_t continuation_count = 0;
+    std::array<uint8_t, MAX_PAYLOAD_SIZE> payload{};
+};
+
+const char* getLogLevelName(LogLevel level);
+const char* getLogCategoryName(LogCategory category);
+
+// Renders a record as one line of text. Only meant to be called on the consumer side.
+std::string formatLogRecord(const LogRecord& record);
+// Same, with the whole payload as assembled by DiagnosticLogger::drain() instead of record.payload.
+std::string formatLogRecord(const LogRecord& record, std::span<const uint8_t> payload);
+
+// Bounded lock-free multi-producer multi-consumer queue of LogRecords. When it is full, new records
+// are dropped (and counted) instead of blocking the producer.
+class LogRecordRing {
+public:
+    // capacity is rounded up to a power of two.
+    explicit LogRecordRing(size_t capacity = 1024);
+    ~LogRecordRing();
+
+    LogRecordRing(const LogRecordRing&) = delete;
+    LogRecordRing& operator=(const LogRecordRing&) = delete;
+
+    bool tryPush(const LogRecord& record) noexcept;
+    // Pushes count records at consecutive positions, or none of them if they do not all fit.
+    // fill(index, record) fills in each record; the first one becomes visible to consumers last.
+    template <typename Fill>
+    bool tryPushAll(size_t count, Fill&& fill) noexcept;
+    bool tryPop(LogRecord& record) noexcept;
+
+    size_t getCapacity() const noexcept { return mask_ + 1; }
+    uint64_t getDroppedCount() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueue_position_{0};
+    alignas(64) std::atomic<size_t> dequeue_position_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+template <typename Fill>
+bool LogRecordRing::tryPushAll(size_t count, Fill&& fill) noexcept {
+    if (count == 0 || count > mask_ + 1) {
+        dropped_.fetch_add(count, std::memory_order_relaxed);
+        return false;
+    }
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    while (true) {
+        bool full = false;
+        bool stale = false;
+        for (size_t i = 0; i < count && !full && !stale; i++) {
+            size_t sequence = cells_[(position + i) & mask_].sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + i);
+            full = diff < 0;
+            stale = diff > 0;
+        }
+        if (full) {
+            dropped_.fetch_add(count, std::memory_order_relaxed);
+            return false;
+        }
+        if (stale) {
+            position = enqueue_position_.load(std::memory_order_relaxed);
+        } else if (enqueue_position_.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        fill(i, cells_[(position + i) & mask_].record);
+    }
+    for (size_t i = count; i-- > 0;) {
+        cells_[(position + i) & mask_].sequence.store(position + i + 1, std::memory_order_release);
+    }
+    return true;
+}
+
+// Level- and category-gated diagnostics. Check isEnabled() before building a record so that
+// disabled diagnostics cost a single relaxed load; all categories are Off by default.
+//
+//     auto& log = device.getDiagnosticLogger();
+//     if (log.isEnabled(LogLevel::Debug, LogCategory::Property))
+//         log.write(LogLevel::Debug, LogCategory::Property, LogEvent::PropertyChunkReceived, muid, {...});
+//
+// Producers only copy the record into the ring; drain() (typically from a UI or logging thread)
+// hands records to a consumer that formats them with formatLogRecord(). Payloads (e.g. SysEx dumps)
+// are cut to LogRecord::MAX_PAYLOAD_SIZE bytes unless setMaxPayloadSize() allows more, in which case
+// they take several records in the ring and drain() puts them back together.
+class DiagnosticLogger {
+public:
+    explicit DiagnosticLogger(size_t capacity = 1024);
+
+    bool isEnabled(LogLevel level, LogCategory category) const noexcept {
+        return level != LogLevel::Off &&
+               level >= levels_[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    LogLevel getLevel(LogCategory category) const noexcept;
+    void setLevel(LogCategory category, LogLevel level) noexcept;
+    // Sets the level of all categories.
+    void setLevel(LogLevel level) noexcept;
+
+    // The longest payload kept whole; longer ones are truncated. Defaults to LogRecord::MAX_PAYLOAD_SIZE,
+    // and is also limited by the ring capacity (MAX_PAYLOAD_SIZE bytes per record).
+    size_t getMaxPayloadSize() const noexcept { return max_payload_size_.load(std::memory_order_relaxed); }
+    void setMaxPayloadSize(size_t size) noexcept { max_payload_size_.store(size, std::memory_order_relaxed); }
+
+    // Returns false if the record was dropped because the ring is full. payload is truncated to
+    // getMaxPayloadSize().
+    bool write(LogLevel level, LogCategory category, LogEvent event, uint32_t muid,
+               std::initializer_list<uint32_t> args = {}, std::span<const uint8_t> payload = {},
+               bool is_outgoing = false) noexcept;
+    bool writeText(LogLevel level, LogCategory category, std::string_view text) noexcept;
+
+    // Pops all currently queued records; returns the number of records handed to consumer.
+    // The first overload only sees the first LogRecord::MAX_PAYLOAD_SIZE bytes of each payload, the
+    // second one gets the whole payload. Concurrent drain() calls are serialized.
+    size_t drain(const std::function<void(const LogRecord&)>& consumer);
+    size_t drain(const std::function<void(const LogRecord&, std::span<const uint8_t> payload)>& consumer);
+
+    LogRecordRing& getRing() noexcept { return ring_; }
+
+private:
+    std::array<std::atomic<LogLevel>, static_cast<size_t>(LogCategory::Count)> levels_;
+    std::atomic<size_t> max_payload_size_{LogRecord::MAX_PAYLOAD_SIZE};
+    LogRecordRing ring_;
+    std::mutex drain_mutex_;
+    std::vector<uint8_t> drain_payload_;
+};
+
+} // namespace midicci
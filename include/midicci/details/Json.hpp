@@ -6,6 +6,8 @@
 #include <memory>
 #include <variant>
 #include <cstdint>
+#include <optional>
+#include <span>
 
 namespace midicci {
 
@@ -102,6 +104,23 @@ private:
     size_t pos_;
 };
 
+// Byte ranges of the elements of a serialized JSON array, found by scanning only for brackets,
+// commas and strings; the elements themselves are not parsed. A page of a large list can then be
+// serialized by copying the ranges of its elements, without parsing the rest of the array.
+class JsonArrayIndex {
+public:
+    // std::nullopt if json is not a single array.
+    static std::optional<JsonArrayIndex> build(std::span<const uint8_t> json);
+
+    size_t size() const noexcept { return elements_.size(); }
+    // The array of up to limit elements starting at offset, taken from the json the index was built from.
+    std::vector<uint8_t> slice(std::span<const uint8_t> json, size_t offset, size_t limit) const;
+
+private:
+    // [begin, end) of each element
+    std::vector<std::pair<size_t, size_t>> elements_;
+};
+
 std::string escapeString(const std::string& str);
 std::string unescapeString(const std::string& str);
 
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <vector>
 #include <memory>
+#include <span>
 #include <string>
 #include "midicci/midicci.hpp"
 
@@ -49,6 +50,45 @@ struct Common {
         : source_muid(src), destination_muid(dest), address(addr), group(grp) {}
 };
 
+// Owned, cheaply copyable snapshot of a Message for logs and inspectors. Property messages only
+// keep their header and body bytes (the body is shared with the message); their text and JSON
+// renderings are produced on demand. Other messages are small and are rendered when captured.
+class MessageLogRecord {
+public:
+    // for single packet messages
+    MessageLogRecord(MessageType type, const Common& common, std::string label, std::string body_string);
+    // for property messages
+    MessageLogRecord(MessageType type, const Common& common, uint8_t request_id,
+                     SharedBytes header, SharedBytes body);
+
+    MessageType getType() const noexcept { return type_; }
+    const Common& getCommon() const noexcept { return common_; }
+    uint32_t getSourceMuid() const noexcept { return common_.source_muid; }
+    uint32_t getDestinationMuid() const noexcept { return common_.destination_muid; }
+
+    bool isPropertyMessage() const noexcept { return is_property_; }
+    uint8_t getRequestId() const noexcept { return request_id_; }
+    std::span<const uint8_t> getHeader() const noexcept;
+    std::span<const uint8_t> getBody() const noexcept;
+
+    std::string getLabel() const;
+    // Same text as Message::getLogMessage().
+    std::string getText() const;
+    // Indented JSON of the property header and body, e.g. for export. Non-JSON bodies are
+    // included as text. Empty for non-property messages.
+    std::string getPrettyJson() const;
+
+private:
+    MessageType type_;
+    Common common_;
+    uint8_t request_id_{0};
+    std::string label_;
+    std::string body_string_;
+    bool is_property_{false};
+    SharedBytes header_;
+    SharedBytes body_;
+};
+
 class Message {
 public:
     Message(MessageType type, const Common& common);
@@ -66,9 +106,15 @@ public:
     const Common& getCommon() const noexcept { return common_; }
     
     virtual std::vector<std::vector<uint8_t>> serializeMulti(const MidiCIDeviceConfiguration& config) const;
+    // Serializes one SysEx packet at a time into buffer and hands each to sink, so that only one
+    // packet is held in memory. Stops early when sink returns false.
+    virtual void serializeInto(const MidiCIDeviceConfiguration& config, std::vector<uint8_t>& buffer,
+                               const CIFactory::PacketSink& sink) const;
     virtual std::string getLabel() const = 0;
     virtual std::string getBodyString() const = 0;
     virtual std::string getLogMessage() const;
+    // Captures the message for deferred rendering; see MessageLogRecord.
+    virtual MessageLogRecord createLogRecord() const;
     
 protected:
     MessageType type_;
@@ -81,24 +127,32 @@ public:
     
     virtual std::vector<uint8_t> serialize(const MidiCIDeviceConfiguration& config) const = 0;
     std::vector<std::vector<uint8_t>> serializeMulti(const MidiCIDeviceConfiguration& config) const override;
+    void serializeInto(const MidiCIDeviceConfiguration& config, std::vector<uint8_t>& buffer,
+                       const CIFactory::PacketSink& sink) const override;
 };
 
 class PropertyMessage : public Message {
 public:
     PropertyMessage(MessageType type, const Common& common, uint8_t request_id, 
-                   const std::vector<uint8_t>& header, const std::vector<uint8_t>& body);
+                   std::vector<uint8_t> header, SharedBytes body);
     
     virtual std::vector<std::vector<uint8_t>> serialize(const MidiCIDeviceConfiguration& config) const = 0;
     std::vector<std::vector<uint8_t>> serializeMulti(const MidiCIDeviceConfiguration& config) const override;
+    // Chunks header and body straight from the message, regardless of how many chunks there are.
+    void serializeInto(const MidiCIDeviceConfiguration& config, std::vector<uint8_t>& buffer,
+                       const CIFactory::PacketSink& sink) const override;
+    MessageLogRecord createLogRecord() const override;
     
     uint8_t getRequestId() const { return request_id_; }
     const std::vector<uint8_t>& getHeader() const { return header_; }
-    const std::vector<uint8_t>& getBody() const { return body_; }
+    const std::vector<uint8_t>& getBody() const { return body_.get(); }
+    // The body without copying it, e.g. to keep it in a PropertyValue beyond the message lifetime.
+    const SharedBytes& getSharedBody() const { return body_; }
     
 protected:
     uint8_t request_id_;
     std::vector<uint8_t> header_;
-    std::vector<uint8_t> body_;
+    SharedBytes body_;
 };
 
 class DiscoveryInquiry : public SinglePacketMessage {
@@ -166,7 +220,7 @@ private:
 
 class GetPropertyData : public PropertyMessage {
 public:
-    GetPropertyData(const Common& common, uint8_t request_id, const std::vector<uint8_t>& header);
+    GetPropertyData(const Common& common, uint8_t request_id, std::vector<uint8_t> header);
     GetPropertyData(const Common& common, uint8_t request_id, const std::string& resource_identifier, const std::string& res_id = "");
     
     std::vector<std::vector<uint8_t>> serialize(const MidiCIDeviceConfiguration& config) const override;
@@ -182,9 +236,9 @@ private:
 class SetPropertyData : public PropertyMessage {
 public:
     SetPropertyData(const Common& common, uint8_t request_id, 
-                   const std::vector<uint8_t>& header, const std::vector<uint8_t>& body);
+                   std::vector<uint8_t> header, SharedBytes body);
     SetPropertyData(const Common& common, uint8_t request_id, const std::string& resource_identifier, 
-                   const std::vector<uint8_t>& body, const std::string& res_id = "", bool set_partial = false);
+                   SharedBytes body, const std::string& res_id = "", bool set_partial = false);
     
     std::vector<std::vector<uint8_t>> serialize(const MidiCIDeviceConfiguration& config) const override;
     std::string getLabel() const override;
@@ -199,7 +253,7 @@ private:
 class SubscribeProperty : public PropertyMessage {
 public:
     SubscribeProperty(const Common& common, uint8_t request_id, 
-                     const std::vector<uint8_t>& header, const std::vector<uint8_t>& body);
+                     std::vector<uint8_t> header, SharedBytes body);
     SubscribeProperty(const Common& common, uint8_t request_id, const std::string& resource_identifier, 
                      const std::string& command, const std::string& mutual_encoding = "");
     
@@ -385,7 +439,7 @@ private:
 class GetPropertyDataReply : public PropertyMessage {
 public:
     GetPropertyDataReply(const Common& common, uint8_t request_id, 
-                        const std::vector<uint8_t>& header, const std::vector<uint8_t>& body);
+                        std::vector<uint8_t> header, SharedBytes body);
     
     std::vector<std::vector<uint8_t>> serialize(const MidiCIDeviceConfiguration& config) const override;
     std::string getLabel() const override;
@@ -394,7 +448,7 @@ public:
 
 class SetPropertyDataReply : public PropertyMessage {
 public:
-    SetPropertyDataReply(const Common& common, uint8_t request_id, const std::vector<uint8_t>& header);
+    SetPropertyDataReply(const Common& common, uint8_t request_id, std::vector<uint8_t> header);
     
     std::vector<std::vector<uint8_t>> serialize(const MidiCIDeviceConfiguration& config) const override;
     std::string getLabel() const override;
@@ -404,7 +458,7 @@ public:
 class SubscribePropertyReply : public PropertyMessage {
 public:
     SubscribePropertyReply(const Common& common, uint8_t request_id, 
-                          const std::vector<uint8_t>& header, const std::vector<uint8_t>& body);
+                          std::vector<uint8_t> header, SharedBytes body);
     
     std::vector<std::vector<uint8_t>> serialize(const MidiCIDeviceConfiguration& config) const override;
     std::string getLabel() const override;
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <memory>
 #include <vector>
+#include <span>
 #include <functional>
 #include "midicci/midicci.hpp"
 
@@ -64,6 +65,9 @@ public:
     void addMessageCallback(MessageCallback callback);
     void removeMessageCallback(MessageCallback callback);
     
+    // For the requests the property host sends by itself (subscription updates and ends). Requests to
+    // a responder go through its PropertyClientFacade, which takes IDs from the connection's
+    // PropertyRequestScheduler and replaces one that is already in use.
     uint8_t getNextRequestId() noexcept;
     
 private:
@@ -114,8 +118,8 @@ private:
     PropertyGetCapabilitiesReply getPropertyCapabilitiesReplyFor(const PropertyGetCapabilities& msg);
     
     void handleChunk(const Common& common, uint8_t request_id, uint16_t chunk_index, uint16_t num_chunks,
-                     const std::vector<uint8_t>& header, const std::vector<uint8_t>& body,
-                     std::function<void(const std::vector<uint8_t>&, const std::vector<uint8_t>&)> on_complete);
+                     std::span<const uint8_t> header, std::span<const uint8_t> body,
+                     std::function<void(std::vector<uint8_t>, std::vector<uint8_t>)> on_complete);
     
     class Impl;
     std::unique_ptr<Impl> pimpl_;
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <memory>
 #include <vector>
+#include <span>
 #include <functional>
 #include <unordered_map>
 #include <variant>
@@ -75,10 +76,18 @@ public:
     
     void setLogger(LoggerFunction logger);
     LoggerFunction getLogger() const;
+    // Whether a logger other than the default NOP logger is set.
+    bool hasLogger() const;
+
+    // Level-gated binary diagnostics (raw traffic, chunk progress etc.); all categories are Off
+    // unless enabled. Unlike the logger, records are queued and formatted by whoever drains them.
+    DiagnosticLogger& getDiagnosticLogger();
     
     Messenger& getMessenger();
     
-    void notifyPropertyChunk(uint32_t source_muid, uint8_t request_id, const std::vector<uint8_t>& header);
+    bool hasPropertyChunkCallback() const;
+    // header is only copied when a property chunk callback is registered.
+    void notifyPropertyChunk(uint32_t source_muid, uint8_t request_id, std::span<const uint8_t> header);
     
 private:
     class Impl;
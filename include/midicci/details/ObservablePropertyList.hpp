@@ -31,7 +31,7 @@ public:
     
     // Pure virtual method for setting property values - to be implemented by derived classes
     virtual void setPropertyValue(const std::string& propertyId, const std::string& resId, 
-                                  const std::vector<uint8_t>& data, bool isPartial = false) = 0;
+                                  const SharedBytes& data, bool isPartial = false) = 0;
     
     void addPropertyUpdatedCallback(PropertyUpdatedCallback callback);
     void addPropertyCatalogUpdatedCallback(PropertyCatalogUpdatedCallback callback);
@@ -58,9 +58,9 @@ public:
     std::vector<PropertyValue> getValues() const override;
     
     void setPropertyValue(const std::string& propertyId, const std::string& resId, 
-                          const std::vector<uint8_t>& data, bool isPartial = false) override;
+                          const SharedBytes& data, bool isPartial = false) override;
 
-    void updateValue(const std::string& propertyId, const std::vector<uint8_t>& body, const std::string& mediaType = "application/json");
+    void updateValue(const std::string& propertyId, const SharedBytes& body, const std::string& mediaType = "application/json");
     std::string updateValue(const SubscribeProperty& msg);
     
 private:
@@ -78,7 +78,7 @@ public:
     std::vector<PropertyValue> getValues() const override;
     
     void setPropertyValue(const std::string& propertyId, const std::string& resId, 
-                          const std::vector<uint8_t>& data, bool isPartial = false) override;
+                          const SharedBytes& data, bool isPartial = false) override;
 
     // Safer method to get metadata by property ID without ownership transfer
     const PropertyMetadata* getMetadata(const std::string& property_id) const;
@@ -88,8 +88,8 @@ public:
     
     void addMetadata(std::unique_ptr<PropertyMetadata> metadata);
     void updateMetadata(const std::string& propertyId, PropertyMetadata* metadata);
-    void updateValue(const std::vector<uint8_t>& header, const std::vector<uint8_t>& body);
-    void updateValue(const std::string& propertyId, const std::string& resId, const std::string& mediaType, const std::vector<uint8_t>& body);
+    void updateValue(const std::vector<uint8_t>& header, const SharedBytes& body);
+    void updateValue(const std::string& propertyId, const std::string& resId, const std::string& mediaType, const SharedBytes& body);
     void removeMetadata(const std::string& propertyId);
     
 private:
@@ -3,12 +3,23 @@
 #include <cstdint>
 #include <memory>
 #include <vector>
+#include <span>
 #include <utility>
 
 namespace midicci {
 
+// Reassembles chunked property exchange bodies, keyed by (source MUID, request ID).
+//
+// Timestamps are in seconds. Every addPendingChunk() and expireChunks() advances an internal timing
+// wheel, so transfers that did not receive a chunk for longer than the timeout are dropped without
+// anyone calling cleanupExpiredChunks(). Once chunk traffic stops, only expireChunks() advances it,
+// so call it from a periodic tick (PropertyClientFacade::processTimeouts() does).
 class PropertyChunkManager {
 public:
+    static constexpr uint64_t DEFAULT_TIMEOUT_SECONDS = 30;
+    // Upper bound of what is reserved up front for one transfer, whatever numChunks claims.
+    static constexpr size_t MAX_PREALLOCATION_SIZE = 1024 * 1024;
+
     PropertyChunkManager();
     ~PropertyChunkManager();
     
@@ -18,17 +29,35 @@ public:
     PropertyChunkManager(PropertyChunkManager&&) = default;
     PropertyChunkManager& operator=(PropertyChunkManager&&) = default;
     
+    // header and data are views into the received chunk; this is where they get copied, appended
+    // to the reassembly buffer of (source_muid, request_id). When num_chunks is given, the first
+    // chunk reserves num_chunks times its own size so that the body is never reallocated.
     void addPendingChunk(uint64_t timestamp, uint32_t source_muid, uint8_t request_id,
-                          const std::vector<uint8_t>& header, const std::vector<uint8_t>& data);
+                          std::span<const uint8_t> header, std::span<const uint8_t> data,
+                          uint16_t num_chunks = 0);
     
+    // Appends final_data and hands over the reassembled header and body (moved out, not copied).
     std::pair<std::vector<uint8_t>, std::vector<uint8_t>> 
-    finishPendingChunk(uint32_t source_muid, uint8_t request_id, const std::vector<uint8_t>& final_data);
+    finishPendingChunk(uint32_t source_muid, uint8_t request_id, std::span<const uint8_t> final_data);
     
+    // Drops the partial transfer of (source_muid, request_id), if any, e.g. when the request is sent
+    // again or its first chunk arrives anew.
+    void discard(uint32_t source_muid, uint8_t request_id);
+
     bool hasPendingChunk(uint32_t source_muid, uint8_t request_id) const;
 
     std::vector<uint8_t> getPendingHeader(uint32_t source_muid, uint8_t request_id) const;
+
+    size_t getPendingChunkCount() const;
+
+    // Advances the timing wheel to timestamp, dropping the transfers that expired by then.
+    void expireChunks(uint64_t timestamp);
+
+    uint64_t getTimeout() const;
+    void setTimeout(uint64_t timeout_seconds);
     
-    void cleanupExpiredChunks(uint64_t current_timestamp, uint64_t timeout_seconds = 30);
+    // Drops transfers whose last chunk is older than timeout_seconds, regardless of the wheel.
+    void cleanupExpiredChunks(uint64_t current_timestamp, uint64_t timeout_seconds = DEFAULT_TIMEOUT_SECONDS);
     
     void clearAllChunks();
     
@@ -24,6 +24,14 @@ public:
     using SubscriptionUpdateCallback = std::function<void(const ClientSubscription&)>;
     using GetPropertyDataCallback = std::function<void(const GetPropertyDataReply&)>;
     using SetPropertyDataCallback = std::function<void(const SetPropertyDataReply&)>;
+    using GetPropertyDataTask = PropertyRequestTask<std::shared_ptr<const GetPropertyDataReply>>;
+    using SetPropertyDataTask = PropertyRequestTask<std::shared_ptr<const SetPropertyDataReply>>;
+    // One page of a list property: the index of its first entry and the entries.
+    using PropertyListPageCallback = std::function<void(size_t offset, const JsonArray& entries)>;
+    // The whole list arrived (status OK) or a page failed.
+    using PropertyListCompletionCallback = std::function<void(int status, size_t total_count)>;
+
+    static constexpr size_t DEFAULT_LIST_PAGE_SIZE = 32;
 
     PropertyClientFacade(MidiCIDevice& device, ClientConnection& conn);
     ~PropertyClientFacade();
@@ -37,15 +45,37 @@ public:
     void setPropertyRules(std::unique_ptr<MidiCIClientPropertyRules> rules);
     MidiCIClientPropertyRules* getPropertyRules();
 
+    // Requests are queued in the request scheduler and sent when the responder accepts more
+    // simultaneous requests. A GET that is identical to a queued or in-flight one is not sent
+    // again; the ID of the pending request is returned instead.
     uint8_t sendGetPropertyData(const std::string& resource, const std::string& res_id, const std::string& encoding = "", int paginate_offset = -1, int paginate_limit = -1);
-    void sendGetPropertyData(const GetPropertyData& msg);
+    // Sends msg as is, except that its request ID is replaced with a free one if a pending request
+    // uses it already. Returns the request ID it is sent with.
+    uint8_t sendGetPropertyData(const GetPropertyData& msg);
 
     uint8_t sendSetPropertyData(const std::string& resource, const std::string& res_id, const std::vector<uint8_t>& data, const std::string& encoding = "", bool is_partial = false);
-    void sendSetPropertyData(const SetPropertyData& msg);
+    uint8_t sendSetPropertyData(const SetPropertyData& msg);
 
     void getPropertyData(const std::string& resource, const std::string& res_id, GetPropertyDataCallback callback, const std::string& encoding = "", int paginate_offset = -1, int paginate_limit = -1);
     void setPropertyData(const std::string& resource, const std::string& res_id, const std::vector<uint8_t>& data, SetPropertyDataCallback callback, const std::string& encoding = "", bool is_partial = false);
+
+    // Awaitable / future-returning variants of getPropertyData() and setPropertyData(). Issue as many
+    // as needed and await them (e.g. with whenAll()); the request scheduler sends them as the
+    // responder's window allows.
+    GetPropertyDataTask getPropertyDataAsync(const std::string& resource, const std::string& res_id = "", const std::string& encoding = "", int paginate_offset = -1, int paginate_limit = -1);
+    SetPropertyDataTask setPropertyDataAsync(const std::string& resource, const std::string& res_id, const std::vector<uint8_t>& data, const std::string& encoding = "", bool is_partial = false);
     
+    // Fetches a list property (e.g. ProgramList) page by page. The first page tells totalCount, then
+    // the remaining pages are requested as many at a time as the request window allows, the next one
+    // whenever a page arrives. Pages are passed to on_page as they arrive, which is not necessarily in
+    // order. A page with fewer entries than asked for is continued with another request, and an empty
+    // page ends the list even if totalCount said otherwise. Once all are in, the assembled list becomes
+    // the property value, as if it had been fetched in one GET. A page that fails or cannot be
+    // requested ends the fetch with an error status.
+    void getPaginatedPropertyData(const std::string& resource, const std::string& res_id, size_t page_size,
+                                  PropertyListPageCallback on_page, PropertyListCompletionCallback on_complete = nullptr,
+                                  const std::string& encoding = "");
+
     void sendSubscribeProperty(const std::string& resource, const std::string& res_id, const std::string& mutual_encoding = "", const std::string& subscription_id = "");
     void sendUnsubscribeProperty(const std::string& property_id, const std::string& res_id);
     
@@ -60,6 +90,12 @@ public:
     
     PropertyChunkManager& getPendingChunkManager();
     const PropertyChunkManager& getPendingChunkManager() const;
+
+    PropertyRequestScheduler& getRequestScheduler();
+    const PropertyRequestScheduler& getRequestScheduler() const;
+    // Retries or fails requests that did not get a reply in time, and drops chunked replies that
+    // stopped arriving. Call it periodically.
+    void processTimeouts();
     
     void addSubscriptionUpdateCallback(SubscriptionUpdateCallback callback);
     void removeSubscriptionUpdateCallback(const SubscriptionUpdateCallback& callback);
@@ -72,7 +108,7 @@ private:
     void notifySubscriptionUpdated(const ClientSubscription& subscription);
     
     class Impl;
-    std::unique_ptr<Impl> pimpl_;
+    std::shared_ptr<Impl> pimpl_;
 };
 
 class MidiCIClientPropertyRules {
@@ -37,7 +37,7 @@ public:
     const PropertyMetadata* getPropertyMetadata(const std::string& property_id) const;
     
     // Property value updates with subscriber notifications (like Kotlin setPropertyValue)
-    void setPropertyValue(const std::string& property_id, const std::string& res_id, const std::vector<uint8_t>& data, bool is_partial);
+    void setPropertyValue(const std::string& property_id, const std::string& res_id, const SharedBytes& data, bool is_partial);
     
     // Common Rules updates (following Kotlin implementation)
     void updateCommonRulesDeviceInfo(const DeviceInfo& device_info);
@@ -66,13 +66,14 @@ public:
     void terminateSubscriptionsToAllSubscribers(uint8_t group);
     SubscribeProperty createShutdownSubscriptionMessage(uint32_t destination_muid, const std::string& property_id, const std::string& res_id, uint8_t group, uint8_t request_id);
 
-    // Property binary getter accessor (following Kotlin propertyBinaryGetter)
-    using PropertyBinaryGetter = std::function<std::vector<uint8_t>(const std::string& property_id, const std::string& res_id)>;
+    // Property binary getter accessor (following Kotlin propertyBinaryGetter).
+    // Returning a stored SharedBytes lets GET replies send it without copying.
+    using PropertyBinaryGetter = std::function<SharedBytes(const std::string& property_id, const std::string& res_id)>;
     void setPropertyBinaryGetter(PropertyBinaryGetter getter);
     PropertyBinaryGetter getPropertyBinaryGetter() const;
 
     // Property binary setter accessor (following Kotlin propertyBinarySetter)
-    using PropertyBinarySetter = std::function<bool(const std::string& property_id, const std::string& res_id, const std::string& media_type, const std::vector<uint8_t>& body)>;
+    using PropertyBinarySetter = std::function<bool(const std::string& property_id, const std::string& res_id, const std::string& media_type, const SharedBytes& body)>;
     void setPropertyBinarySetter(PropertyBinarySetter setter);
     PropertyBinarySetter getPropertyBinarySetter() const;
 
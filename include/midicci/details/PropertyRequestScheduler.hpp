@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace midicci {
+
+class PropertyMessage;
+
+// Property exchange inquiries from one initiator to one responder (one ClientConnection).
+//
+// Requests are queued and sent so that no more than getMaxInFlight() of them await a reply; the
+// limit starts at our own max_simultaneous_property_requests and is narrowed to what the responder
+// answers in its Property Exchange Capabilities reply. Request IDs are allocated per connection and
+// are never shared by two queued or in-flight requests.
+//
+// The scheduler does not see replies by itself: the owner calls complete() for each reply and then
+// dispatch(). Keeping the two apart lets the owner finish processing a reply (including callbacks
+// that issue new requests) before the next queued request goes out.
+//
+// Requests that get no reply within the timeout are sent again (with the same request ID) up to
+// getMaxRetries() times, then handed to the failure handler. Timeouts are checked on dispatch(),
+// so call processTimeouts() periodically if no other property traffic is expected. The same goes for
+// requeued requests, which wait getRetryDelay() times the number of attempts so far before a
+// dispatch() sends them again.
+//
+// The sender and the failure handler are called without the scheduler's lock held, so they may
+// call back into the scheduler, and a reply may be delivered from another thread meanwhile.
+class PropertyRequestScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Sender = std::function<void(const PropertyMessage& msg)>;
+    using FailureHandler = std::function<void(const PropertyMessage& msg)>;
+
+    static constexpr uint8_t MAX_REQUEST_ID = 0x7F;
+    static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{3000};
+    static constexpr int DEFAULT_MAX_RETRIES = 2;
+    static constexpr std::chrono::milliseconds DEFAULT_RETRY_DELAY{250};
+
+    PropertyRequestScheduler(Sender sender, uint8_t max_in_flight);
+    ~PropertyRequestScheduler();
+
+    PropertyRequestScheduler(const PropertyRequestScheduler&) = delete;
+    PropertyRequestScheduler& operator=(const PropertyRequestScheduler&) = delete;
+
+    PropertyRequestScheduler(PropertyRequestScheduler&&) = default;
+    PropertyRequestScheduler& operator=(PropertyRequestScheduler&&) = default;
+
+    // Returns an ID that no queued or in-flight request uses. Throws std::runtime_error when all
+    // of them are in use.
+    uint8_t allocateRequestId();
+
+    // Queues msg behind the other waiting requests and sends whatever the window allows. Its
+    // request ID must not be in use (std::invalid_argument otherwise).
+    void enqueue(std::shared_ptr<const PropertyMessage> msg, Clock::time_point now = Clock::now());
+    // Like enqueue(), but sends nothing until the next dispatch().
+    void queue(std::shared_ptr<const PropertyMessage> msg);
+
+    // The ID of a queued or in-flight request of the same type and destination whose header is
+    // identical, if any. Used to fold identical GETs into one.
+    std::optional<uint8_t> findPending(const PropertyMessage& msg) const;
+
+    // Removes the request from the in-flight set and returns it; null if request_id is not in
+    // flight. Nothing is sent; call dispatch() afterwards.
+    std::shared_ptr<const PropertyMessage> complete(uint8_t request_id);
+
+    // Puts an in-flight request back at the front of the queue (e.g. on "too many requests"), to be
+    // sent again after the retry delay; the requests behind it wait as well. Returns false, leaving
+    // the request in flight, once its retries are used up.
+    bool requeue(uint8_t request_id, Clock::time_point now = Clock::now());
+
+    // Withdraws a request that is still queued. Returns false if it is in flight or unknown.
+    bool cancel(uint8_t request_id);
+
+    // Restarts the timeout of an in-flight request, e.g. while its reply chunks are arriving.
+    void extend(uint8_t request_id, Clock::time_point now = Clock::now());
+
+    // Handles timed out requests, then sends queued requests while the window allows.
+    void dispatch(Clock::time_point now = Clock::now());
+    void processTimeouts(Clock::time_point now = Clock::now());
+
+    bool isPending(uint8_t request_id) const;
+    // The queued or in-flight request, or null.
+    std::shared_ptr<const PropertyMessage> getRequest(uint8_t request_id) const;
+    size_t getQueuedCount() const;
+    size_t getInFlightCount() const;
+
+    uint8_t getMaxInFlight() const;
+    void setMaxInFlight(uint8_t max_in_flight);
+    std::chrono::milliseconds getTimeout() const;
+    void setTimeout(std::chrono::milliseconds timeout);
+    int getMaxRetries() const;
+    void setMaxRetries(int max_retries);
+    std::chrono::milliseconds getRetryDelay() const;
+    void setRetryDelay(std::chrono::milliseconds delay);
+    void setFailureHandler(FailureHandler handler);
+
+    // Forgets all queued and in-flight requests without sending or failing them.
+    void clear();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl_;
+};
+
+} // namespace midicci
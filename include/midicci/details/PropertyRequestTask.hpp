@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace midicci {
+
+class PropertyRequestCancelledException : public std::runtime_error {
+public:
+    PropertyRequestCancelledException() : std::runtime_error("Property exchange request was cancelled") {}
+};
+
+// The pending result of an asynchronous property exchange request, as returned by
+// PropertyClientFacade::getPropertyDataAsync() and setPropertyDataAsync().
+//
+// It can be co_awaited from a C++20 coroutine, or waited on through getFuture(). Replies are
+// delivered on the thread that processes the incoming MIDI-CI messages, which is also where an
+// awaiting coroutine resumes; don't block on getFuture() on that thread.
+//
+// A request that gets no reply even after retries completes with a reply that has status
+// INTERNAL_ERROR, as the callback API does. If the facade goes away first, the task fails with
+// std::future_error (broken_promise).
+template <typename T>
+class PropertyRequestTask {
+    struct State {
+        std::mutex mutex;
+        std::promise<T> promise;
+        std::shared_future<T> future{promise.get_future().share()};
+        bool done{false};
+        std::vector<std::function<void()>> continuations;
+        std::function<void()> canceller;
+
+        // Returns false if the task was already complete.
+        template <typename Settle>
+        bool settle(Settle&& settle) {
+            std::vector<std::function<void()>> continuations_to_run;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (done)
+                    return false;
+                done = true;
+                settle(promise);
+                continuations_to_run = std::move(continuations);
+                canceller = nullptr;
+            }
+            for (auto& continuation : continuations_to_run)
+                continuation();
+            return true;
+        }
+
+        // Runs continuation right away if the task is already complete.
+        void then(std::function<void()> continuation) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!done) {
+                    continuations.push_back(std::move(continuation));
+                    return;
+                }
+            }
+            continuation();
+        }
+    };
+
+public:
+    PropertyRequestTask() = default;
+
+    // The request ID on the wire; empty for a task made by whenAll().
+    std::optional<uint8_t> getRequestId() const noexcept { return request_id_; }
+    bool isValid() const noexcept { return state_ != nullptr; }
+    bool isReady() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->done;
+    }
+    std::shared_future<T> getFuture() const { return state_->future; }
+
+    // Stops waiting for the reply: the task fails with PropertyRequestCancelledException. A request
+    // that nobody else waits for and that was not sent yet is withdrawn from the queue. Does nothing
+    // if the task is already complete.
+    void cancel() {
+        std::function<void()> canceller;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            canceller = state_->canceller;
+        }
+        if (state_->settle([](std::promise<T>& p) { p.set_exception(std::make_exception_ptr(PropertyRequestCancelledException())); }) &&
+            canceller)
+            canceller();
+    }
+
+    bool await_ready() const { return isReady(); }
+    bool await_suspend(std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->done)
+            return false;
+        state_->continuations.push_back([handle] { handle.resume(); });
+        return true;
+    }
+    T await_resume() const { return state_->future.get(); }
+
+    // A task that completes when all tasks did, with their results in the same order. It fails with
+    // the first failure (cancelling the remaining tasks); cancelling it cancels all of them.
+    friend PropertyRequestTask<std::vector<T>> whenAll(std::vector<PropertyRequestTask<T>> tasks) {
+        using Combined = PropertyRequestTask<std::vector<T>>;
+        auto combined = Combined::create(std::nullopt, [tasks]() mutable {
+            for (auto& task : tasks)
+                task.cancel();
+        });
+        if (tasks.empty()) {
+            combined.setValue({});
+            return combined;
+        }
+        auto remaining = std::make_shared<std::atomic<size_t>>(tasks.size());
+        for (auto& task : tasks) {
+            task.state_->then([tasks, task, combined, remaining]() mutable {
+                try {
+                    task.state_->future.get();
+                } catch (...) {
+                    if (combined.setException(std::current_exception())) {
+                        for (auto& other : tasks)
+                            other.cancel();
+                    }
+                    return;
+                }
+                if (--*remaining == 0) {
+                    std::vector<T> results;
+                    results.reserve(tasks.size());
+                    for (auto& done : tasks)
+                        results.push_back(done.state_->future.get());
+                    combined.setValue(std::move(results));
+                }
+            });
+        }
+        return combined;
+    }
+
+    // For the request's owner: a task for request_id that calls canceller on cancel().
+    static PropertyRequestTask create(std::optional<uint8_t> request_id, std::function<void()> canceller) {
+        PropertyRequestTask task;
+        task.state_ = std::make_shared<State>();
+        task.state_->canceller = std::move(canceller);
+        task.request_id_ = request_id;
+        return task;
+    }
+
+    // Completes the task; returns false if it was already complete (e.g. cancelled).
+    bool setValue(T value) {
+        return state_->settle([&value](std::promise<T>& p) { p.set_value(std::move(value)); });
+    }
+    bool setException(std::exception_ptr exception) {
+        return state_->settle([&exception](std::promise<T>& p) { p.set_exception(exception); });
+    }
+
+private:
+    template <typename U>
+    friend class PropertyRequestTask;
+
+    std::shared_ptr<State> state_;
+    std::optional<uint8_t> request_id_;
+};
+
+} // namespace midicci
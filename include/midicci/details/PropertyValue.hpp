@@ -7,13 +7,14 @@ namespace midicci {
         std::string id;
         std::string resId;
         std::string mediaType;
-        std::vector<uint8_t> body;
+        // shared with the message it was received in, and with copies of this value
+        SharedBytes body;
 
-        PropertyValue(const std::string& property_id, const std::string& media_type, const std::vector<uint8_t>& data)
-                : id(property_id), resId(""), mediaType(media_type), body(data) {}
+        PropertyValue(const std::string& property_id, const std::string& media_type, SharedBytes data)
+                : id(property_id), resId(""), mediaType(media_type), body(std::move(data)) {}
 
-        PropertyValue(const std::string& property_id, const std::string& resource_id, const std::string& media_type, const std::vector<uint8_t>& data)
-                : id(property_id), resId(resource_id), mediaType(media_type), body(data) {}
+        PropertyValue(const std::string& property_id, const std::string& resource_id, const std::string& media_type, SharedBytes data)
+                : id(property_id), resId(resource_id), mediaType(media_type), body(std::move(data)) {}
 
         bool operator==(const PropertyValue& other) const {
             return id == other.id && resId == other.resId && mediaType == other.mediaType && body == other.body;
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace midicci {
+
+// Immutable, reference-counted byte buffer. Copies share the same storage, so a property body that
+// was reassembled once can be handed from the message to PropertyValues, caches, log records and
+// callbacks without being copied again. It converts to `const std::vector<uint8_t>&` so that code
+// taking vectors keeps working.
+class SharedBytes {
+public:
+    using value_type = uint8_t;
+    using const_iterator = std::vector<uint8_t>::const_iterator;
+    using iterator = const_iterator;
+
+    SharedBytes() = default;
+    SharedBytes(std::vector<uint8_t> bytes)
+        : bytes_(bytes.empty() ? nullptr : std::make_shared<const std::vector<uint8_t>>(std::move(bytes))) {}
+    SharedBytes(std::shared_ptr<const std::vector<uint8_t>> bytes) : bytes_(std::move(bytes)) {}
+
+    const std::vector<uint8_t>& get() const noexcept { return bytes_ ? *bytes_ : emptyVector(); }
+    operator const std::vector<uint8_t>&() const noexcept { return get(); }
+    std::span<const uint8_t> span() const noexcept { return get(); }
+    // The underlying storage; null for an empty buffer.
+    const std::shared_ptr<const std::vector<uint8_t>>& getShared() const noexcept { return bytes_; }
+
+    const uint8_t* data() const noexcept { return get().data(); }
+    size_t size() const noexcept { return bytes_ ? bytes_->size() : 0; }
+    bool empty() const noexcept { return size() == 0; }
+    const_iterator begin() const noexcept { return get().begin(); }
+    const_iterator end() const noexcept { return get().end(); }
+    uint8_t operator[](size_t index) const noexcept { return (*bytes_)[index]; }
+
+    friend bool operator==(const SharedBytes& a, const SharedBytes& b) {
+        return a.bytes_ == b.bytes_ || a.get() == b.get();
+    }
+    friend bool operator==(const SharedBytes& a, const std::vector<uint8_t>& b) { return a.get() == b; }
+
+private:
+    static const std::vector<uint8_t>& emptyVector() noexcept {
+        static const std::vector<uint8_t> instance;
+        return instance;
+    }
+
+    std::shared_ptr<const std::vector<uint8_t>> bytes_;
+};
+
+} // namespace midicci
@@ -53,6 +53,8 @@ private:
     std::vector<SubscriptionEntry> subscriptions_;
     
     std::vector<std::unique_ptr<PropertyMetadata>> getMetadataListForBody(const std::vector<uint8_t>& body);
+    // GETs a list property, page by page if the responder can paginate it
+    void fetchList(const PropertyMetadata& metadata);
 };
 
 } // namespace
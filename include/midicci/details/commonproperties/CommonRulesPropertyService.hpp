@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 namespace midicci {
 namespace commonproperties {
@@ -52,7 +53,7 @@ public:
     
     // Additional helper methods
     void setPropertyValue(const std::string& property_id, const std::string& res_id,
-                            const std::vector<uint8_t>& data,
+                            const SharedBytes& data,
                             const std::string& media_type = CommonRulesKnownMimeTypes::APPLICATION_JSON);
 
     // Property catalog update callback management (following Kotlin propertyCatalogUpdated)
@@ -61,6 +62,14 @@ public:
     
     // Direct metadata access (for ServiceObservablePropertyList)
     const PropertyMetadata* getMetadataById(const std::string& property_id) const;
+
+    // GET replies are cached as encoded bytes per resource, resId, encoding and page, so repeated
+    // GETs cost a lookup. Values set through this service, PropertyHostFacade and SET requests,
+    // metadata changes and the PropertyHostFacade::updateCommonRules* methods invalidate them.
+    // Call this after modifying the device configuration directly; an empty property_id drops all.
+    // Values from a custom propertyBinaryGetter are never cached. The element indexes used to
+    // serve pages of list properties are dropped along with the replies.
+    void invalidateReplyCache(const std::string& property_id = "");
     
 private:
     MidiCIDevice& device_;
@@ -74,10 +83,27 @@ private:
     // Subscription update callbacks (following Kotlin subscruotionsUpdated)
     std::vector<std::function<void(const SubscriptionEntry&, bool)>> subscription_updated_callbacks_;
 
+    struct CachedReply {
+        std::vector<uint8_t> header;
+        SharedBytes body;
+    };
+    // resource -> (resId, encoding, media type, offset, limit) -> reply
+    std::unordered_map<std::string, std::unordered_map<std::string, CachedReply>> reply_cache_;
+    size_t cached_reply_count_{0};
+
+    // Element index of a list property value, for serving offset/limit pages by copying the
+    // elements' bytes. It is valid as long as the getter returns the same shared body.
+    struct ListIndex {
+        std::shared_ptr<const std::vector<uint8_t>> body;
+        std::optional<JsonArrayIndex> index;
+    };
+    // resource + '\0' + resId -> index
+    mutable std::unordered_map<std::string, ListIndex> list_indexes_;
+
 public:
-    std::function<std::vector<uint8_t>(const std::string& property_id, const std::string& res_id)> propertyBinaryGetter{};
+    std::function<SharedBytes(const std::string& property_id, const std::string& res_id)> propertyBinaryGetter{};
 
-    std::function<bool(const std::string& property_id, const std::string& res_id, const std::string& media_type, const std::vector<uint8_t>& body)> propertyBinarySetter{};
+    std::function<bool(const std::string& property_id, const std::string& res_id, const std::string& media_type, const SharedBytes& body)> propertyBinarySetter{};
 
 private:
 
@@ -88,9 +114,11 @@ private:
     std::pair<JsonValue, JsonValue> subscribe(uint32_t subscriber_muid, const JsonValue& header_json);
     std::pair<JsonValue, JsonValue> unsubscribe(const std::string& resource, const std::string& subscribe_id);
 
-    JsonValue setPropertyData(const JsonValue& header_json, const std::vector<uint8_t>& body);
+    JsonValue setPropertyData(const JsonValue& header_json, const SharedBytes& body);
     std::pair<JsonValue, JsonValue> getPropertyDataJson(const PropertyCommonRequestHeader& header) const;
-    std::pair<JsonValue, std::vector<uint8_t>> getPropertyDataEncoded(const JsonValue& header_json) const;
+    std::pair<JsonValue, SharedBytes> getPropertyDataEncoded(const JsonValue& header_json) const;
+    bool isReplyCacheable(const std::string& resource) const;
+    std::optional<std::pair<JsonValue, SharedBytes>> getListPage(const PropertyCommonRequestHeader& header) const;
 };
 
 } // namespace properties
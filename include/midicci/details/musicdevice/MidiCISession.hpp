@@ -4,7 +4,9 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <umppi/details/Ump.hpp>
+#include <umppi/details/UmpClassifier.hpp>
 #include "midicci/midicci.hpp"
 
 namespace midicci::musicdevice {
@@ -45,8 +47,9 @@ public:
     MidiCISession(const MidiCISession&) = delete;
     MidiCISession& operator=(const MidiCISession&) = delete;
     
-    MidiCISession(MidiCISession&&) = default;
-    MidiCISession& operator=(MidiCISession&&) = default;
+    // the input listener refers to this session
+    MidiCISession(MidiCISession&&) = delete;
+    MidiCISession& operator=(MidiCISession&&) = delete;
 
     MidiCIDevice& getDevice() { return *device_; }
     const MidiCIDevice& getDevice() const { return *device_; }
@@ -62,7 +65,11 @@ private:
     std::vector<uint8_t> chunked_messages_;
     std::vector<std::function<void()>> midi_message_report_mode_changed_;
     
-    // UMP message buffering
+    // UMP message buffering. Input may arrive from more than one thread, and a handler may feed
+    // input back in while the classifier is being iterated, which then scans into a local one.
+    std::recursive_mutex input_mutex_;
+    bool scanning_{false};
+    umppi::UmpClassifier ump_classifier_;
     std::vector<uint8_t> buffered_sysex7_;
     std::vector<uint8_t> buffered_sysex8_;
 };
@@ -6,6 +6,7 @@
 #include <memory>
 #include <chrono>
 #include <umppi/details/Ump.hpp>
+#include <umppi/details/UmpScheduler.hpp>
 #include "midicci/midicci.hpp"
 
 namespace midicci::musicdevice {
@@ -50,6 +51,25 @@ private:
     std::function<void(umppi::UmpWordSpan, uint64_t)> output_sender_;
 };
 
+// Holds outgoing packets until their timestamp (a steady_clock time, see umppi::UmpScheduler::now())
+// and then forwards them to another sender from a dedicated dispatch thread.
+// Timestamp 0 is sent as soon as possible, still in order with the scheduled packets.
+class ScheduledMusicDeviceOutputSender : public MusicDeviceOutputSender {
+public:
+    explicit ScheduledMusicDeviceOutputSender(std::shared_ptr<MusicDeviceOutputSender> output,
+                                              umppi::UmpScheduler::Options options = {});
+
+    void send(umppi::UmpWordSpan words, uint64_t timestamp_ns) override;
+    // Blocks until every packet sent so far has been forwarded.
+    void flush();
+
+    umppi::UmpScheduler& getScheduler() { return scheduler_; }
+
+private:
+    std::shared_ptr<MusicDeviceOutputSender> output_;
+    umppi::UmpScheduler scheduler_;
+};
+
 // Helps determine which MIDI-CI to connect among discovered endpoints
 class MusicDeviceConnector {
 public:
@@ -117,12 +137,12 @@ public:
     void send(umppi::UmpWordSpan data, uint64_t timestamp_ns);
 
     // Property binary getter accessor (following Kotlin propertyBinaryGetter)
-    using PropertyBinaryGetter = std::function<std::vector<uint8_t>(const std::string& property_id, const std::string& res_id)>;
+    using PropertyBinaryGetter = std::function<SharedBytes(const std::string& property_id, const std::string& res_id)>;
     void setPropertyBinaryGetter(PropertyBinaryGetter getter);
     PropertyBinaryGetter getPropertyBinaryGetter() const;
 
     // Property binary setter accessor (following Kotlin propertyBinarySetter)
-    using PropertyBinarySetter = std::function<bool(const std::string& property_id, const std::string& res_id, const std::string& media_type, const std::vector<uint8_t>& body)>;
+    using PropertyBinarySetter = std::function<bool(const std::string& property_id, const std::string& res_id, const std::string& media_type, const SharedBytes& body)>;
     void setPropertyBinarySetter(PropertyBinarySetter setter);
     PropertyBinarySetter getPropertyBinarySetter() const;
 
@@ -13,6 +13,7 @@
 #include <midicci/details/CIFactory.hpp>
 #include <midicci/details/CIRetrieval.hpp>
 #include <midicci/details/MidiCIConverter.hpp>
+#include <midicci/details/SharedBytes.hpp>
 
 #include <midicci/details/Message.hpp>
 #include <midicci/details/Messenger.hpp>
@@ -23,6 +24,7 @@
 #include <midicci/details/ObservableProfileList.hpp>
 
 #include <midicci/details/MidiCIDeviceConfiguration.hpp>
+#include <midicci/details/DiagnosticLogger.hpp>
 
 #include <midicci/details/MidiCIDevice.hpp>
 #include <midicci/details/ClientConnection.hpp>
@@ -32,6 +34,8 @@
 
 // Property management
 #include <midicci/details/PropertyChunkManager.hpp>
+#include <midicci/details/PropertyRequestScheduler.hpp>
+#include <midicci/details/PropertyRequestTask.hpp>
 #include <midicci/details/PropertyCommonRules.hpp>
 #include <midicci/details/PropertyCommonConverter.hpp>
 
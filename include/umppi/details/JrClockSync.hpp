@@ -0,0 +1,93 @@
+#pragma once
+
+#include <umppi/details/Ump.hpp>
+#include <array>
+#include <functional>
+#include <optional>
+#include <vector>
+#include <cstdint>
+
+namespace umppi {
+
+// Jitter Reduction (JR) Clock / JR Timestamp synchronization.
+//
+// Receiving: JR Clock messages tell the sender's clock (16 bits of 1/31250 seconds, wrapping every
+// ~2.1 seconds). Each one is paired with its local arrival time, and a line through the recent pairs
+// gives the drift (slope) of the sender clock against the local clock. Transport jitter can only delay
+// a message, so the line is placed on the least delayed arrivals of the window rather than their average.
+// JR Timestamps are then mapped onto that line, which gives local times without the transport jitter.
+//
+// Sending: createJrClock()/createJrTimestamp() express local times in the same units, and
+// isJrClockDue() tells when the next JR Clock should be sent (the sender clock is the local clock).
+//
+// All local times are nanoseconds of std::chrono::steady_clock (see UmpScheduler::now()).
+// The receiving and the sending functions have separate state, and each side must be used from one thread.
+class JrClockSync {
+public:
+    static constexpr uint64_t TICKS_PER_SECOND = 31250;
+    static constexpr uint64_t NANOSECONDS_PER_TICK = 1000000000ULL / TICKS_PER_SECOND;
+    static constexpr size_t WINDOW_SIZE = 32;
+
+    using PacketCallback = std::function<void(UmpWordSpan packet, uint64_t localTimeNs)>;
+
+    // latencyNs is added to every converted time, so that replayed messages are scheduled in the future
+    // even if they arrived late. It should exceed the expected transport jitter.
+    explicit JrClockSync(uint64_t latencyNs = 0) : latencyNs_(latencyNs) {}
+
+    void reset();
+
+    // Updates the clock estimate from a JR Clock, or remembers a JR Timestamp for the next packet.
+    // Returns the local time for the packet: for a message following a JR Timestamp it is the
+    // converted timestamp, otherwise (or until the clock is synchronized) the arrival time plus latency.
+    uint64_t receive(UmpWordSpan packet, uint64_t arrivalNs);
+    // Splits words into packets and calls back with each non-JR packet and its local time.
+    void process(UmpWordSpan words, uint64_t arrivalNs, const PacketCallback& callback);
+
+    void onJrClock(uint16_t senderClockTime16, uint64_t arrivalNs);
+    // Converts a sender time in 16-bit JR units, interpreted as the time nearest to the latest JR Clock.
+    std::optional<uint64_t> convertJrTimestamp(uint16_t senderClockTimestamp16) const;
+    std::optional<uint64_t> senderTicksToLocal(int64_t senderTicks) const;
+
+    bool isSynchronized() const { return sampleCount_ >= 2; }
+    // Sender clock speed relative to the local clock, in parts per million (positive: sender runs fast).
+    double getDriftPpm() const;
+
+    uint64_t getLatencyNs() const { return latencyNs_; }
+    void setLatencyNs(uint64_t latencyNs) { latencyNs_ = latencyNs; }
+
+    static uint16_t toJrTicks(uint64_t localNs) { return static_cast<uint16_t>((localNs / NANOSECONDS_PER_TICK) & 0xFFFF); }
+    static uint32_t createJrClock(uint64_t localNs);
+    static uint32_t createJrTimestamp(uint64_t localNs);
+
+    // The UMP specification recommends a JR Clock at least every 250 milliseconds while JR is in use.
+    bool isJrClockDue(uint64_t nowNs) const { return !clockSent_ || nowNs - lastClockSentNs_ >= clockIntervalNs; }
+    // Returns the JR Clock to send and remembers when it was sent.
+    uint32_t nextJrClock(uint64_t nowNs);
+    uint64_t clockIntervalNs = 250000000;
+
+private:
+    struct Sample {
+        int64_t senderTicks;
+        uint64_t arrivalNs;
+    };
+
+    int64_t unwrap(uint16_t value16, int64_t reference) const;
+    void estimate();
+
+    uint64_t latencyNs_;
+    std::array<Sample, WINDOW_SIZE> samples_{};
+    size_t sampleCount_ = 0;
+    size_t nextSample_ = 0;
+    Sample last_{};
+    // local ns = reference_.arrivalNs + offset_ + slope_ * (sender ticks - reference_.senderTicks).
+    // Keeping the reference separate keeps the doubles small enough for nanosecond precision.
+    Sample reference_{};
+    double slope_ = static_cast<double>(NANOSECONDS_PER_TICK);
+    double offset_ = 0;
+    std::optional<uint16_t> pendingTimestamp_;
+
+    bool clockSent_ = false;
+    uint64_t lastClockSentNs_ = 0;
+};
+
+} // namespace umppi
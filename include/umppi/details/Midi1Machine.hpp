@@ -1,6 +1,7 @@
 #pragma once
 
 #include <umppi/details/Midi1Message.hpp>
+#include <umppi/details/Ump.hpp>
 #include <array>
 #include <vector>
 #include <functional>
@@ -68,7 +69,11 @@ public:
     Midi1SystemCommon systemCommon;
     std::array<Midi1MachineChannel, 16> channels;
 
+    // Realtime-safe as long as the listeners are (no allocation or locking in the machine itself).
     void processMessage(const Midi1Message& message);
+    // Processes a MIDI 1.0 channel voice UMP (message type 2) without allocating. Other packets are
+    // ignored. The group is not part of the Midi1Machine state.
+    void processMessage(const Ump& ump);
 };
 
 }
@@ -18,13 +18,18 @@ private:
     void readBytes(uint8_t* buffer, size_t length);
     uint8_t peekByte();
 
-    Midi1Track readTrack();
     Midi1Event readEvent(int deltaTime);
 
 public:
     explicit Midi1Reader(std::istream& stream);
 
     Midi1Music read();
+
+    // Incremental reading, for callers that process one track at a time instead of keeping the
+    // whole song: readHeader() reads MThd into music (format and deltaTimeSpec; tracks are left
+    // untouched) and returns the number of tracks, then readTrack() reads the next MTrk.
+    int readHeader(Midi1Music& music);
+    Midi1Track readTrack();
 };
 
 Midi1Music readMidi1File(const std::string& filename);
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <umppi/details/Midi2Track.hpp>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace umppi {
+
+// MIDI Clip File ("SMF2CLIP") I/O.
+//
+// A clip file is the "SMF2CLIP" magic followed by big endian UMP words:
+//   clip configuration header:  Delta Clockstamp, DCTPQ
+//   clip sequence:              Delta Clockstamp, Start of Clip, { Delta Clockstamp, events }, End of Clip
+// Both classes work packet by packet on the stream, so a clip never has to be held in memory as a whole.
+class Midi2ClipWriter {
+public:
+    explicit Midi2ClipWriter(std::ostream& stream);
+
+    // Writes the magic, the clip configuration header and Start of Clip.
+    void writeHeader(uint16_t ticksPerQuarterNote);
+    // Writes sequence messages as they are; delta clockstamps are expected to be part of src.
+    void write(const Ump& ump);
+    void write(std::span<const Ump> src);
+    // Writes End of Clip. Nothing must be written afterwards.
+    void finish();
+
+    uint64_t getPacketCount() const { return packetCount_; }
+
+private:
+    std::ostream& stream_;
+    uint64_t packetCount_ = 0;
+    bool headerWritten_ = false;
+    bool finished_ = false;
+};
+
+class Midi2ClipReader {
+public:
+    explicit Midi2ClipReader(std::istream& stream);
+
+    // Reads up to Start of Clip and returns the DCTPQ from the clip configuration header.
+    uint16_t readHeader();
+    // Reads the next sequence message. Returns false at End of Clip (or at the end of a truncated stream).
+    bool read(Ump& ump);
+
+    bool isTruncated() const { return truncated_; }
+
+private:
+    bool readPacket(Ump& ump);
+
+    std::istream& stream_;
+    bool truncated_ = false;
+    bool ended_ = false;
+};
+
+// Converts Standard MIDI Files to clip files and back, stream to stream (used by umppi-convert).
+// SMF tracks are read and translated one at a time, but the translated tracks are all kept (as UMP)
+// until they are merged by time into the clip sequence, so SMF to clip holds the whole song in memory
+// (it does not stream). Clips are translated in chunks as they are read, into a format 0 SMF; tempo,
+// time signature and text Flex Data become meta events again. The buffers are reused across
+// conversions, so keep one converter per thread. Both directions throw std::runtime_error on input
+// they cannot convert.
+class Midi2ClipConverter {
+public:
+    // Returns the number of UMP packets written. group is the UMP group of the clip messages.
+    uint64_t smfToClip(std::istream& input, std::ostream& output, int group = 0);
+    // Returns the number of UMP packets read. output must be seekable (the track length comes last).
+    uint64_t clipToSmf(std::istream& input, std::ostream& output);
+
+private:
+    std::vector<uint8_t> midi1_;
+    std::vector<std::vector<Ump>> tracks_;
+    std::vector<Ump> chunk_;
+};
+
+void writeMidi2ClipFile(const Midi2Track& track, uint16_t ticksPerQuarterNote, const std::string& filename);
+// Returns the sequence messages between Start of Clip and End of Clip; the DCTPQ goes to ticksPerQuarterNote.
+Midi2Track readMidi2ClipFile(const std::string& filename, uint16_t* ticksPerQuarterNote = nullptr);
+
+} // namespace umppi
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <umppi/details/Ump.hpp>
+#include <array>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+namespace umppi {
+
+// Channel state as tracked from MIDI 2.0 channel voice messages, at MIDI 2.0 resolution.
+class Midi2MachineChannel {
+public:
+    std::array<bool, 128> noteOnStatus{};
+    std::array<uint16_t, 128> noteVelocity{};
+    std::array<uint8_t, 128> noteAttributeType{};
+    std::array<uint16_t, 128> noteAttributeData{};
+    std::array<uint32_t, 128> pafVelocity{};
+    std::array<uint32_t, 128> perNotePitchbend;
+    std::array<uint32_t, 128> controls{};
+
+    // indexed by (msb << 7) + lsb
+    std::array<uint32_t, 128 * 128> rpns{};
+    std::array<uint32_t, 128 * 128> nrpns{};
+
+    uint8_t program = 0;
+    uint8_t bankMsb = 0;
+    uint8_t bankLsb = 0;
+    uint32_t caf = 0;
+    uint32_t pitchbend = 0x80000000;
+
+    Midi2MachineChannel();
+};
+
+// The MIDI 2.0 counterpart of Midi1Machine. It only tracks the channels of one group (messages for
+// other groups are ignored), and processMessage() neither allocates nor locks, so it can be driven
+// from an audio callback as long as the listeners are realtime-safe too. The state is large (~2MB);
+// create the machine on the heap, outside of the realtime thread.
+class Midi2Machine {
+public:
+    using OnMidi2MessageListener = std::function<void(const Ump&)>;
+
+    explicit Midi2Machine(uint8_t group = 0) : group(group) {}
+
+    std::vector<OnMidi2MessageListener> messageListeners;
+    std::array<Midi2MachineChannel, 16> channels;
+    uint8_t group;
+
+    void processMessage(const Ump& ump);
+};
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <umppi/details/Midi1Track.hpp>
+#include <umppi/details/Midi2Track.hpp>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace umppi {
+
+struct NoteInterval {
+    static constexpr uint32_t NO_INDEX = std::numeric_limits<uint32_t>::max();
+
+    int64_t startTick = 0;
+    // For a note that is not terminated yet, the end of the track (as of the last update).
+    int64_t endTick = 0;
+    // Indices of the Note On and Note Off in Midi2Track::messages or Midi1Track::events.
+    uint32_t startIndex = NO_INDEX;
+    uint32_t endIndex = NO_INDEX;
+    uint8_t group = 0;
+    uint8_t channel = 0;
+    uint8_t note = 0;
+    // 16-bit for MIDI 2.0 messages, 7-bit for MIDI 1.0 messages.
+    uint16_t velocity = 0;
+    uint16_t releaseVelocity = 0;
+    uint8_t attributeType = 0;
+    uint16_t attributeData = 0;
+    // Indices of the per-note messages (poly pressure, per-note controllers, per-note pitch bend and
+    // per-note management) sent while the note was on.
+    std::vector<uint32_t> perNoteMessages;
+
+    bool isTerminated() const { return endIndex != NO_INDEX; }
+};
+
+// Pairs Note On/Note Off messages of a track into intervals, for piano rolls and range queries.
+// The intervals are kept sorted by start tick in an implicit augmented interval tree (each node
+// knows the maximum end tick of its subtree), so a range query costs O(log n + k) where k is the
+// number of intervals overlapping the time range. Only time is indexed: the note range of a query
+// is a filter over those k intervals, so narrowing the notes does not make a query cheaper.
+//
+// The index is built lazily on the first query, and messages appended to the track afterwards
+// (e.g. while recording) are paired incrementally. Intervals appended after the tree was built are
+// scanned linearly by queries until they outnumber an eighth of the tree, when the tree is rebuilt;
+// this keeps appending amortized O(1) per interval. If the track is modified in any other way,
+// call invalidate() to rebuild it. The track must outlive the index.
+// Overlapping notes of the same pitch on the same channel are paired first-in, first-out.
+class NoteIntervalIndex {
+public:
+    explicit NoteIntervalIndex(const Midi2Track& track) : midi2Track_(&track) {}
+    explicit NoteIntervalIndex(const Midi1Track& track) : midi1Track_(&track) {}
+
+    // Pairs the messages appended since the last update. Queries call it automatically.
+    void update();
+    void invalidate();
+
+    // Appends the indices (see getInterval()) of the intervals overlapping [startTick, endTick) whose
+    // note is within [lowestNote, highestNote], in start tick order. Returns the number of matches.
+    size_t query(int64_t startTick, int64_t endTick, std::vector<uint32_t>& results,
+                 uint8_t lowestNote = 0, uint8_t highestNote = 127);
+
+    size_t size();
+    const NoteInterval& getInterval(uint32_t index) const { return intervals_[index]; }
+    const std::vector<NoteInterval>& getIntervals() { update(); return intervals_; }
+
+private:
+    void scanMidi2();
+    void scanMidi1();
+    void noteOn(int64_t tick, uint32_t index, uint8_t group, uint8_t channel, uint8_t note,
+                uint16_t velocity, uint8_t attributeType, uint16_t attributeData);
+    void noteOff(int64_t tick, uint32_t index, uint8_t group, uint8_t channel, uint8_t note, uint16_t velocity);
+    void perNoteMessage(uint32_t index, uint8_t group, uint8_t channel, uint8_t note);
+    void buildTree();
+
+    static uint32_t getKey(uint8_t group, uint8_t channel, uint8_t note) {
+        return (static_cast<uint32_t>(group & 0xF) << 11) | (static_cast<uint32_t>(channel & 0xF) << 7) | (note & 0x7F);
+    }
+
+    const Midi2Track* midi2Track_ = nullptr;
+    const Midi1Track* midi1Track_ = nullptr;
+
+    std::vector<NoteInterval> intervals_;
+    // the tree covers intervals_[0, treeSize_); unterminated notes count as never ending in it
+    std::vector<int64_t> maxEnd_;
+    size_t treeSize_ = 0;
+    int treeLevels_ = -1;
+
+    // incremental pairing state
+    size_t scannedCount_ = 0;
+    int64_t currentTick_ = 0;
+    // (group, channel, note) -> intervals that are still on, oldest first
+    std::unordered_map<uint32_t, std::vector<uint32_t>> activeNotes_;
+};
+
+} // namespace umppi
@@ -121,6 +121,13 @@ public:
         return fromWords(words.data(), words.size());
     }
 
+    // Realtime-safe variants that parse into caller-provided storage instead of allocating. They return
+    // the number of packets written to dst, stopping early when dst is full or the input ends in the
+    // middle of a packet; consumed (if given) receives the number of words (bytes) parsed, so that the
+    // rest can be passed to the next call.
+    static size_t fromWords(UmpWordSpan words, std::span<Ump> dst, size_t* consumed = nullptr);
+    static size_t fromBytes(std::span<const uint8_t> bytes, std::span<Ump> dst, size_t* consumed = nullptr);
+
     std::string toString() const;
 
     bool operator==(const Ump& other) const {
@@ -135,6 +142,23 @@ inline int umpSizeInInts(uint8_t messageType) {
     return 1;
 }
 
+// Calls f(const Ump&) for every complete packet in words and returns the number of words consumed.
+// Does not allocate, so it is realtime-safe as long as f is.
+template <typename F>
+size_t forEachUmp(UmpWordSpan words, F&& f) {
+    size_t offset = 0;
+    while (offset < words.size()) {
+        uint32_t i1 = words[offset];
+        size_t size = static_cast<size_t>(umpSizeInInts(static_cast<uint8_t>(i1 >> 28)));
+        if (offset + size > words.size())
+            break;
+        Ump ump(i1, size > 1 ? words[offset + 1] : 0, size > 2 ? words[offset + 2] : 0, size > 3 ? words[offset + 3] : 0);
+        f(static_cast<const Ump&>(ump));
+        offset += size;
+    }
+    return offset;
+}
+
 std::vector<Ump> parseUmpsFromBytes(const uint8_t* data, size_t start, size_t length);
 std::vector<Ump> parseUmpsFromWords(const uint32_t* words, size_t count);
 std::vector<Ump> parseUmpsFromWords(UmpWordSpan words);
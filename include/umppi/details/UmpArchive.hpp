@@ -0,0 +1,104 @@
+#pragma once
+
+#include <umppi/details/Ump.hpp>
+#include <umppi/details/UmpDemux.hpp>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace umppi {
+
+// Compact on-disk storage of timestamped UMP traffic.
+//
+// The archive is a sequence of independently zlib-compressed blocks followed by a block index:
+//   file header:  "UMPA", version (u16), reserved (u16)
+//   block:        "UMPB", raw size (u32), compressed size (u32), packet count (u32), first timestamp (u64),
+//                 last timestamp (u64), CRC-32 of the compressed bytes (u32), compressed bytes
+//                 raw bytes = packet count delta timestamps (LEB128 varints, nanoseconds since the
+//                 previous packet, the first one since the block's first timestamp), then the packed words
+//   index:        per block: file offset (u64), first and last timestamp (u64), packet count (u32)
+//   trailer:      index offset (u64), block count (u32), "UMPI"
+// All integers are little endian. Keeping deltas and words in separate runs compresses better than
+// interleaving them. Since blocks carry their own headers, an archive whose index was never written
+// (e.g. the recorder crashed) can still be read; the blocks are then found by scanning.
+struct UmpArchiveBlockInfo {
+    uint64_t offset = 0;
+    uint64_t firstTimestamp = 0;
+    uint64_t lastTimestamp = 0;
+    uint32_t packetCount = 0;
+};
+
+class UmpArchiveWriter {
+public:
+    struct Options {
+        uint32_t packetsPerBlock = 4096;
+        int compressionLevel = 6;
+    };
+
+    // Creates the archive, or opens an existing one to append to it.
+    explicit UmpArchiveWriter(const std::string& path) : UmpArchiveWriter(path, Options{}) {}
+    UmpArchiveWriter(const std::string& path, Options options);
+    ~UmpArchiveWriter();
+
+    UmpArchiveWriter(const UmpArchiveWriter&) = delete;
+    UmpArchiveWriter& operator=(const UmpArchiveWriter&) = delete;
+
+    // Appends every packet in words with the same timestamp. Timestamps must not decrease.
+    void write(UmpWordSpan words, uint64_t timestampNs);
+    // Writes the pending packets as a (possibly short) block and updates the index, so that
+    // everything written so far can be read even if the process ends abruptly.
+    void flush();
+    void close();
+
+    uint64_t getPacketCount() const { return packetCount_; }
+    size_t getBlockCount() const { return blocks_.size(); }
+
+private:
+    void writeBlock();
+    void writeIndex();
+
+    std::fstream file_;
+    Options options_;
+    std::vector<UmpArchiveBlockInfo> blocks_;
+    // where the next block goes (i.e. where the index currently starts)
+    uint64_t endOfBlocks_ = 0;
+    uint64_t packetCount_ = 0;
+    uint64_t lastTimestamp_ = 0;
+
+    // pending block
+    std::vector<uint64_t> timestamps_;
+    std::vector<uint32_t> words_;
+    std::vector<uint8_t> raw_;
+    std::vector<uint8_t> compressed_;
+    bool closed_ = false;
+};
+
+class UmpArchiveReader {
+public:
+    explicit UmpArchiveReader(const std::string& path);
+    // Reads an archive that is already in memory, e.g. a memory-mapped file. The data must outlive the reader.
+    explicit UmpArchiveReader(std::span<const uint8_t> data);
+
+    const std::vector<UmpArchiveBlockInfo>& getBlocks() const { return blocks_; }
+    uint64_t getPacketCount() const;
+    // Index of the first block that may contain packets at or after timestampNs (getBlocks().size() if none).
+    size_t findBlock(uint64_t timestampNs) const;
+
+    std::vector<UmpQueueEntry> readBlock(size_t index) const;
+    // Returns the packets with timestamps in [startNs, endNs), in order. The overlapping blocks are
+    // decompressed on up to `threads` threads.
+    std::vector<UmpQueueEntry> read(uint64_t startNs, uint64_t endNs, unsigned threads = 1) const;
+
+private:
+    void load(uint64_t fileSize);
+    void readBytes(uint64_t offset, uint8_t* dst, size_t size) const;
+    void scanBlocks(uint64_t fileSize);
+
+    std::string path_;
+    std::span<const uint8_t> data_;
+    std::vector<UmpArchiveBlockInfo> blocks_;
+};
+
+} // namespace umppi
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <umppi/details/Ump.hpp>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <span>
+#include <initializer_list>
+
+namespace umppi {
+
+// Packet size in words for each message type, as defined in the UMP specification (including reserved types).
+inline constexpr std::array<uint8_t, 16> umpPacketSizeInInts{1, 1, 1, 2, 2, 4, 1, 1, 2, 2, 2, 3, 3, 4, 4, 4};
+
+// Selects packets by message type, group, status (upper nibble of the status byte) and channel.
+// Each field is a bitmask indexed by the field value. Channel is only examined for channel voice
+// messages (MIDI1 and MIDI2), as the same nibble has other meanings in the other message types.
+struct UmpFilter {
+    uint16_t messageTypes = 0xFFFF;
+    uint16_t groups = 0xFFFF;
+    uint16_t statuses = 0xFFFF;
+    uint16_t channels = 0xFFFF;
+
+    static UmpFilter all() { return {}; }
+    static UmpFilter ofMessageType(MessageType type) {
+        UmpFilter f;
+        f.messageTypes = static_cast<uint16_t>(1u << static_cast<uint8_t>(type));
+        return f;
+    }
+
+    UmpFilter& withMessageType(MessageType type) {
+        messageTypes = static_cast<uint16_t>(1u << static_cast<uint8_t>(type));
+        return *this;
+    }
+    UmpFilter& withGroup(uint8_t group) {
+        groups = static_cast<uint16_t>(1u << (group & 0xF));
+        return *this;
+    }
+    // status is either a status code such as MidiChannelStatus::NOTE_ON, or a binary chunk status.
+    UmpFilter& withStatus(uint8_t status) {
+        statuses = static_cast<uint16_t>(1u << (status >> 4));
+        return *this;
+    }
+    UmpFilter& withStatuses(std::initializer_list<uint8_t> list) {
+        statuses = 0;
+        for (auto status : list)
+            statuses = static_cast<uint16_t>(statuses | (1u << (status >> 4)));
+        return *this;
+    }
+    UmpFilter& withChannel(uint8_t channel) {
+        channels = static_cast<uint16_t>(1u << (channel & 0xF));
+        return *this;
+    }
+};
+
+// Classifies a UMP word stream in bulk. scan() splits the words into packets once, keeping the packet
+// offsets and the upper 16 bits of each first word (message type, group, status and channel); the
+// select functions then evaluate filters over those compact keys without any per-packet branching.
+// Buffers are kept across scans, so a long-lived classifier does not allocate in steady state.
+class UmpClassifier {
+public:
+    // Returns false if the words end in the middle of a packet; that packet is excluded.
+    // The words are referenced (not copied) until the next scan().
+    bool scan(UmpWordSpan words);
+
+    size_t getPacketCount() const { return offsets_.size(); }
+    size_t getTruncatedWordCount() const { return truncatedWords_; }
+    std::span<const uint32_t> getPacketOffsets() const { return offsets_; }
+    std::span<const uint16_t> getPacketKeys() const { return keys_; }
+    UmpWordSpan getPacket(size_t index) const;
+    Ump getUmp(size_t index) const;
+
+    std::array<uint32_t, 16> countByMessageType() const;
+
+    // Appends the indices of the matching packets to indices, and returns the number of matches.
+    size_t select(const UmpFilter& filter, std::vector<uint32_t>& indices) const;
+    // Fills mask with one bit per packet (bit i % 64 of mask[i / 64]), and returns the number of matches.
+    size_t selectMask(const UmpFilter& filter, std::vector<uint64_t>& mask) const;
+
+    static bool matches(const UmpFilter& filter, uint16_t key) {
+        return evaluate(filter, key) != 0;
+    }
+
+private:
+    static uint32_t evaluate(const UmpFilter& filter, uint16_t key) {
+        uint32_t type = key >> 12;
+        uint32_t group = (key >> 8) & 0xF;
+        uint32_t status = (key >> 4) & 0xF;
+        uint32_t channel = key & 0xF;
+        // MIDI1 (2) and MIDI2 (4) are the channel voice message types.
+        uint32_t ignoresChannel = (~0x14u >> type) & 1;
+        return (filter.messageTypes >> type) & (filter.groups >> group) & (filter.statuses >> status) &
+               ((filter.channels >> channel) | ignoresChannel) & 1;
+    }
+
+    UmpWordSpan words_;
+    std::vector<uint32_t> offsets_;
+    std::vector<uint16_t> keys_;
+    size_t truncatedWords_ = 0;
+};
+
+} // namespace umppi
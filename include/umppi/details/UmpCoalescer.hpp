@@ -0,0 +1,64 @@
+#pragma once
+
+#include <umppi/details/Ump.hpp>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <cstdint>
+
+namespace umppi {
+
+// Thins out high-rate controller output (e.g. a slider dragged in a UI) before it reaches a slow output.
+// Controller-like messages (CC, RPN, NRPN, pitch bend, pressure and per-note controllers, both MIDI1 and
+// MIDI2) are held and only their latest value per (group, channel, note, index) is sent, at most once per
+// flush interval. Any other message (notes, program changes, relative controllers, SysEx...) first flushes
+// everything pending, so that notes are never reordered relative to controllers.
+// The first controller after an idle interval is sent immediately, so a single change is not delayed.
+// Not thread-safe; callers that send from multiple threads must serialize the calls.
+class UmpCoalescer {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Sender = std::function<void(UmpWordSpan packet)>;
+
+    explicit UmpCoalescer(Sender sender, std::chrono::microseconds flushInterval = std::chrono::milliseconds(10));
+
+    // Zero disables coalescing; every packet is sent immediately.
+    void setFlushInterval(std::chrono::microseconds interval) { flushInterval_ = interval; }
+    std::chrono::microseconds getFlushInterval() const { return flushInterval_; }
+
+    void send(UmpWordSpan packet) { send(packet, Clock::now()); }
+    void send(UmpWordSpan packet, Clock::time_point now);
+
+    // Sends the pending values if the flush interval has elapsed. Call it periodically (e.g. once per UI frame).
+    // Returns true if anything was sent.
+    bool flushIfDue() { return flushIfDue(Clock::now()); }
+    bool flushIfDue(Clock::time_point now);
+    void flush() { flushPending(Clock::now()); }
+
+    size_t getPendingCount() const { return pending_.size(); }
+    // Number of packets that were superseded by a later value and never sent.
+    uint64_t getCoalescedCount() const { return coalesced_; }
+
+    // Returns true if the packet can be superseded by a later one, and stores the identity it is compared by.
+    static bool getCoalescingKey(UmpWordSpan packet, uint32_t& key);
+
+private:
+    struct Pending {
+        uint32_t key;
+        std::array<uint32_t, 4> words;
+        uint8_t sizeInInts;
+    };
+
+    void flushPending(Clock::time_point now);
+
+    Sender sender_;
+    std::chrono::microseconds flushInterval_;
+    Clock::time_point lastFlush_{};
+    // Kept in arrival order; the number of distinct controllers within one interval is small,
+    // so lookups are a linear scan and the buffer does not allocate in steady state.
+    std::vector<Pending> pending_;
+    uint64_t coalesced_ = 0;
+};
+
+} // namespace umppi
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <umppi/details/Ump.hpp>
+#include <umppi/details/UmpClassifier.hpp>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace umppi {
+
+struct UmpQueueEntry {
+    uint64_t timestamp;
+    std::array<uint32_t, 4> words;
+    uint8_t sizeInInts;
+
+    UmpWordSpan getWords() const { return {words.data(), sizeInInts}; }
+};
+
+// Lock-free single-producer single-consumer packet queue. The capacity is rounded up to a power of two.
+class UmpPacketQueue {
+public:
+    explicit UmpPacketQueue(size_t capacity);
+
+    // Returns false (and counts the packet as dropped) when the queue is full.
+    bool push(UmpWordSpan packet, uint64_t timestamp);
+    bool pop(UmpQueueEntry& entry);
+
+    size_t size() const;
+    size_t capacity() const { return entries_.size(); }
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<UmpQueueEntry> entries_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+// Fans one UMP stream out to multiple consumers by group, channel and message type.
+// Routes are compiled into a table indexed by (message type, group, channel) whose entries are
+// bitmasks of the matching routes, so dispatching a packet costs one lookup regardless of how many
+// routes exist. Callback routes receive a view of the input words (no copy); queue routes copy the
+// packet into their lock-free queue to be consumed on another thread.
+// Statuses are matched through a second, 16-entry table of route bitmasks that is ANDed in.
+// Adding or removing routes is not thread-safe against process(); configure routes before streaming,
+// or build a new demux and swap it in. process() itself may run on several threads at once as long
+// as every queue route has a single producer.
+class UmpDemux {
+public:
+    using RouteId = int;
+    using RouteCallback = std::function<void(UmpWordSpan packet, uint64_t timestamp)>;
+    static constexpr size_t MAX_ROUTES = 64;
+
+    RouteId addRoute(const UmpFilter& filter, RouteCallback callback);
+    // The route queue (see getQueue()) is owned by the demux and stays valid until the route is removed.
+    RouteId addQueueRoute(const UmpFilter& filter, size_t capacity);
+    void removeRoute(RouteId id);
+    void clearRoutes();
+
+    UmpPacketQueue* getQueue(RouteId id) const;
+
+    // Dispatches every complete packet in words. Returns the number of packets that matched no route.
+    size_t process(UmpWordSpan words, uint64_t timestamp = 0);
+
+    uint64_t getTruncatedPacketCount() const { return truncatedPackets_.load(std::memory_order_relaxed); }
+
+    static size_t getTableIndex(uint32_t firstWord) {
+        // message type (4 bits) | group (4 bits) | channel (4 bits)
+        return ((firstWord >> 20) & 0xFF0) | ((firstWord >> 16) & 0xF);
+    }
+
+private:
+    struct Route {
+        bool active = false;
+        UmpFilter filter;
+        RouteCallback callback;
+        std::unique_ptr<UmpPacketQueue> queue;
+    };
+
+    RouteId allocateRoute(const UmpFilter& filter);
+    void compile();
+
+    std::array<Route, MAX_ROUTES> routes_;
+    std::array<uint64_t, 16 * 16 * 16> table_{};
+    // status nibble -> routes whose filter accepts it
+    std::array<uint64_t, 16> statusTable_{};
+    std::atomic<uint64_t> truncatedPackets_{0};
+};
+
+} // namespace umppi
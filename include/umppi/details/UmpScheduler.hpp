@@ -0,0 +1,106 @@
+#pragma once
+
+#include <umppi/details/Ump.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace umppi {
+
+// Releases UMP packets at their timestamps from a dedicated dispatch thread, so that callers
+// (e.g. sequencers) can enqueue events ahead of time instead of sleeping on their own.
+// Timestamps are nanoseconds of std::chrono::steady_clock (see now()); 0 means "as soon as possible".
+// Packets with the same timestamp are released in the order they were enqueued.
+//
+// schedule() is lock-free and may be called from any number of threads: packets go into a bounded
+// multi-producer ring, and the dispatch thread moves them into a min-heap keyed by timestamp. The
+// dispatch thread sleeps until shortly before the next due packet and then spins for the rest, which
+// gives sub-millisecond release accuracy without keeping a core busy while idle.
+class UmpScheduler {
+public:
+    // Called on the dispatch thread with one packet at a time. It must not throw.
+    using Sender = std::function<void(UmpWordSpan words, uint64_t timestamp_ns)>;
+
+    struct Options {
+        size_t inputCapacity = 4096;
+        // How long before the due time the dispatch thread stops sleeping and starts spinning.
+        std::chrono::nanoseconds spinThreshold = std::chrono::microseconds(200);
+        // Prepends a JR Timestamp to every packet sent, carrying its scheduled time.
+        bool insertJrTimestamps = false;
+    };
+
+    explicit UmpScheduler(Sender sender) : UmpScheduler(std::move(sender), Options{}) {}
+    UmpScheduler(Sender sender, Options options);
+    ~UmpScheduler();
+
+    UmpScheduler(const UmpScheduler&) = delete;
+    UmpScheduler& operator=(const UmpScheduler&) = delete;
+
+    static uint64_t now();
+
+    // Splits words into packets and enqueues them. Returns false if the input ring was full;
+    // the packets that did not fit are dropped and counted.
+    bool schedule(UmpWordSpan words, uint64_t timestamp_ns);
+
+    // Stops the dispatch thread. Packets that are not sent yet are discarded; call flush() first to send them.
+    void stop();
+    // Blocks until every packet enqueued so far has been sent (i.e. waits for the latest timestamp).
+    void flush();
+
+    size_t getPendingCount() const { return pending_.load(std::memory_order_acquire); }
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t getSentCount() const { return sent_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        uint64_t timestamp;
+        uint64_t sequence;
+        std::array<uint32_t, 4> words;
+        uint8_t sizeInInts;
+    };
+    struct Slot {
+        std::atomic<size_t> turn;
+        Entry entry;
+    };
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.timestamp != b.timestamp ? a.timestamp > b.timestamp : a.sequence > b.sequence;
+        }
+    };
+
+    bool push(UmpWordSpan packet, uint64_t timestamp);
+    bool pop(Entry& entry);
+    void run();
+    void dispatch(const Entry& entry);
+
+    Sender sender_;
+    Options options_;
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueuePos_{0};
+    alignas(64) std::atomic<size_t> dequeuePos_{0};
+    std::atomic<uint64_t> sequence_{0};
+    std::atomic<size_t> pending_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> sent_{0};
+
+    // Only touched by the dispatch thread.
+    std::vector<Entry> heap_;
+
+    // Only used to park the dispatch thread; producers take the lock just to wake it up.
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    std::atomic<bool> sleeping_{false};
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
+
+} // namespace umppi
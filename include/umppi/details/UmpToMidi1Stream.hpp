@@ -0,0 +1,64 @@
+#pragma once
+
+#include <umppi/details/Ump.hpp>
+#include <umppi/details/Common.hpp>
+#include <umppi/details/Midi1Machine.hpp>
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace umppi {
+
+// Stateful UMP to MIDI 1.0 byte stream encoder for bandwidth-limited (e.g. 31.25kbaud DIN) links.
+// Unlike UmpTranslator::translateSingleUmpToMidi1Bytes(), it remembers what the receiver has already
+// been told: the RPN/NRPN selection and bank per channel, and the last status byte (running status).
+// Group is not part of a MIDI 1.0 byte stream, so state is kept per channel only, just like the
+// stateless translator does.
+class UmpToMidi1Stream {
+public:
+    struct ChannelState {
+        // (msb << 8) | lsb, 0x80 bits indicate "unknown to the receiver" (same as Midi1ToUmpTranslatorContext).
+        uint16_t rpnState = 0x8080;
+        uint16_t nrpnState = 0x8080;
+        uint16_t bankState = 0x8080;
+        bool dteTargetKnown = false;
+        DteTarget dteTarget = DteTarget::RPN;
+    };
+
+    explicit UmpToMidi1Stream(bool useRunningStatus = true, bool elideParameterSelection = true);
+
+    // Appends the MIDI 1.0 bytes for the UMP to dst, and returns the number of bytes appended.
+    // Utility messages and messages that have no MIDI 1.0 counterpart are ignored.
+    size_t process(std::vector<uint8_t>& dst, const Ump& ump);
+    size_t process(std::vector<uint8_t>& dst, const std::vector<Ump>& src);
+
+    // Forgets everything the receiver is assumed to know. Call it when the link is (re)connected,
+    // or periodically if the receiver may have missed bytes.
+    void reset();
+    // Only forgets the running status, e.g. after other bytes were sent to the same output.
+    void resetRunningStatus() { runningStatus_ = 0; }
+
+    bool hasPendingSysex7() const { return sysexPending_; }
+    const ChannelState& getChannelState(uint8_t channel) const { return channels_[channel & 0xF]; }
+
+    bool useRunningStatus = true;
+    bool elideParameterSelection = true;
+    // Sends Note Off as Note On with zero velocity so that it can share the running status.
+    // The Note Off velocity is lost, so it is disabled by default.
+    bool noteOffAsNoteOnZeroVelocity = false;
+
+private:
+    void emitChannelMessage(std::vector<uint8_t>& dst, uint8_t status, uint8_t data1);
+    void emitChannelMessage(std::vector<uint8_t>& dst, uint8_t status, uint8_t data1, uint8_t data2);
+    void emitSystemMessage(std::vector<uint8_t>& dst, uint8_t status, const Ump& ump);
+    void emitParameterSelection(std::vector<uint8_t>& dst, uint8_t channel, DteTarget target, uint8_t msb, uint8_t lsb);
+    void emitBankSelection(std::vector<uint8_t>& dst, uint8_t channel, uint8_t msb, uint8_t lsb);
+    void trackMidi1ControlChange(uint8_t channel, uint8_t index, uint8_t value);
+
+    std::array<ChannelState, 16> channels_{};
+    uint8_t runningStatus_ = 0;
+    std::vector<uint8_t> sysex7_;
+    bool sysexPending_ = false;
+};
+
+} // namespace umppi
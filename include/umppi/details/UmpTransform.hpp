@@ -0,0 +1,98 @@
+#pragma once
+
+#include <umppi/details/Ump.hpp>
+#include <umppi/details/UmpClassifier.hpp>
+#include <array>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+#include <cstdint>
+
+namespace umppi {
+
+// Note On velocity mapping, stored as a lookup table so that applying it costs one interpolation.
+// Curves are defined on normalized velocities (0.0 - 1.0). A non-zero MIDI 1.0 velocity never maps
+// to 0, since that would turn the Note On into a Note Off.
+class VelocityCurve {
+public:
+    static VelocityCurve linear();
+    // exponent < 1 makes soft playing louder, > 1 makes it softer.
+    static VelocityCurve gamma(double exponent);
+    static VelocityCurve fixed(double velocity);
+    static VelocityCurve fromFunction(const std::function<double(double)>& curve);
+
+    uint16_t apply16(uint16_t velocity) const {
+        uint32_t index = velocity >> 8;
+        uint32_t fraction = velocity & 0xFF;
+        int32_t from = table_[index];
+        int32_t to = table_[index + 1];
+        return static_cast<uint16_t>(from + (((to - from) * static_cast<int32_t>(fraction)) >> 8));
+    }
+    uint8_t apply7(uint8_t velocity) const { return table7_[velocity & 0x7F]; }
+
+private:
+    std::array<uint16_t, 257> table_{};
+    std::array<uint8_t, 128> table7_{};
+};
+
+// Composable rewrites of channel voice messages (transpose, velocity curve, group/channel remap and
+// CC scaling) that work on the packed UMP words without decoding them into Ump fields and re-encoding
+// them with UmpFactory. Stages run in the order they were added; most take a UmpFilter to limit them
+// to some groups, channels or message types.
+// process() never allocates, so a configured pipeline can be used in a realtime stream as well as on
+// captured data (e.g. Midi2Track::messages). Delta Clockstamps and other messages are kept as they are.
+class UmpTransformPipeline {
+public:
+    // Notes moved outside 0-127 are removed, along with their per-note messages.
+    UmpTransformPipeline& transpose(int semitones, const UmpFilter& filter = UmpFilter::all());
+    UmpTransformPipeline& applyVelocityCurve(const VelocityCurve& curve, const UmpFilter& filter = UmpFilter::all());
+    // map[from] = to. Groupless messages (Utility, UMP Stream) are not affected.
+    UmpTransformPipeline& remapGroups(const std::array<uint8_t, 16>& map);
+    UmpTransformPipeline& remapGroup(uint8_t from, uint8_t to);
+    // map[from] = to, for MIDI1 and MIDI2 channel voice messages.
+    UmpTransformPipeline& remapChannels(const std::array<uint8_t, 16>& map, const UmpFilter& filter = UmpFilter::all());
+    UmpTransformPipeline& remapChannel(uint8_t from, uint8_t to, const UmpFilter& filter = UmpFilter::all());
+    // Maps the full range of the controller onto outMin - outMax (normalized; outMin > outMax inverts it).
+    UmpTransformPipeline& scaleControlChange(uint8_t index, double outMin, double outMax,
+                                             const UmpFilter& filter = UmpFilter::all());
+
+    bool empty() const { return stages_.empty(); }
+    void clear() { stages_.clear(); }
+
+    // Rewrites one packet in place. Returns false if the packet should be dropped.
+    bool apply(std::span<uint32_t> packet) const;
+    bool apply(Ump& ump) const;
+
+    // Transforms every packet in place and compacts away the dropped ones. Returns the new word count;
+    // a trailing incomplete packet is kept unchanged.
+    size_t process(std::span<uint32_t> words) const;
+    void process(std::vector<uint32_t>& words) const;
+    void process(std::vector<Ump>& messages) const;
+
+private:
+    enum class StageKind : uint8_t {
+        Transpose,
+        VelocityCurve,
+        GroupRemap,
+        ChannelRemap,
+        ScaleControlChange
+    };
+
+    struct Stage {
+        StageKind kind;
+        UmpFilter filter;
+        int semitones = 0;
+        std::array<uint8_t, 16> map{};
+        uint8_t ccIndex = 0;
+        uint32_t outMin = 0;
+        uint32_t outMax = 0;
+        std::shared_ptr<const VelocityCurve> curve{};
+    };
+
+    static bool applyStage(const Stage& stage, uint32_t* words);
+
+    std::vector<Stage> stages_;
+};
+
+} // namespace umppi
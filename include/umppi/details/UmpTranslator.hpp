@@ -5,6 +5,7 @@
 #include <vector>
 #include <cstdint>
 #include <functional>
+#include <span>
 
 namespace umppi {
 
@@ -14,6 +15,7 @@ namespace UmpTranslationResult {
     constexpr int INVALID_DTE_SEQUENCE = 0x11;
     constexpr int INVALID_STATUS = 0x13;
     constexpr int INCOMPLETE_SYSEX7 = 0x20;
+    constexpr int INSUFFICIENT_BUFFER = 0x30;
 }
 
 struct Midi1ToUmpTranslatorContext {
@@ -59,6 +61,36 @@ struct UmpToMidi1BytesTranslatorContext {
           skipDeltaTime(skipDeltaTime) {}
 };
 
+// Reusable UMP to MIDI 1.0 bytes translator. It translates in two phases: computeMidi1BytesSize() runs
+// the translation without writing anything to get the exact output size, then translate() writes into
+// a buffer of exactly that size. Unless delta times are skipped, tempo, time signature and text Flex
+// Data are written as SMF meta events. The SysEx7 and text reassembly buffers are owned by the
+// translator, so converting many clips with one instance does not allocate once the buffers have grown.
+class UmpToMidi1BytesTranslator {
+public:
+    explicit UmpToMidi1BytesTranslator(const UmpToMidi1BytesTranslatorContext& context = UmpToMidi1BytesTranslatorContext());
+
+    size_t computeMidi1BytesSize(std::span<const Ump> src);
+
+    // Replaces the content of dst, resizing it only once.
+    int translate(std::vector<uint8_t>& dst, std::span<const Ump> src);
+    // Writes into the caller-supplied buffer; returns INSUFFICIENT_BUFFER if it is smaller than computeMidi1BytesSize().
+    int translate(uint8_t* dst, size_t dstSize, std::span<const Ump> src, size_t& written);
+
+    // Delta time at the end of the last translation that no written event carries (e.g. the ticks
+    // before the end of a clip). It is not carried over into the next translation.
+    uint32_t getPendingDeltaTime() const { return pendingDeltaTime_; }
+
+    UmpToMidi1BytesTranslatorContext context;
+
+private:
+    size_t process(uint8_t* dst, std::span<const Ump> src, int& result);
+
+    std::vector<uint8_t> sysex7_;
+    std::vector<uint8_t> flexDataText_;
+    uint32_t pendingDeltaTime_ = 0;
+};
+
 class UmpTranslator {
 public:
     static int translateUmpToMidi1Bytes(std::vector<uint8_t>& dst,
@@ -77,6 +109,13 @@ public:
 
     static void translateMidi2UmpToMidi1Ump(std::vector<Ump>& dst, const std::vector<Ump>& src);
 
+    // Realtime-safe single packet variants (no allocation, no locking). Packets that are not MIDI 1.0
+    // (resp. MIDI 2.0) channel voice messages are passed through as they are.
+    static Ump translateMidi1UmpToMidi2Ump(const Ump& ump);
+    // A MIDI 2.0 message becomes up to 4 MIDI 1.0 messages (e.g. RPN). Returns the number written to dst;
+    // messages without a MIDI 1.0 translation (per-note and relative controllers) result in 0.
+    static size_t translateMidi2UmpToMidi1Ump(const Ump& ump, std::span<Ump, 4> dst);
+
 private:
     static uint64_t convertMidi1DteToUmp(Midi1ToUmpTranslatorContext& context, int channel);
     static int getMidi1MessageSize(uint8_t statusByte);
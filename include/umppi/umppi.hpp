@@ -12,6 +12,14 @@
 #include <umppi/details/UmpFactory.hpp>
 #include <umppi/details/UmpRetriever.hpp>
 #include <umppi/details/UmpTranslator.hpp>
+#include <umppi/details/UmpToMidi1Stream.hpp>
+#include <umppi/details/UmpClassifier.hpp>
+#include <umppi/details/UmpDemux.hpp>
+#include <umppi/details/UmpCoalescer.hpp>
+#include <umppi/details/UmpScheduler.hpp>
+#include <umppi/details/JrClockSync.hpp>
+#include <umppi/details/UmpTransform.hpp>
+#include <umppi/details/UmpArchive.hpp>
 
 #include <umppi/details/Midi1Message.hpp>
 #include <umppi/details/Midi1Event.hpp>
@@ -20,5 +28,8 @@
 #include <umppi/details/Midi1Reader.hpp>
 #include <umppi/details/Midi1Writer.hpp>
 #include <umppi/details/Midi1Machine.hpp>
+#include <umppi/details/Midi2Machine.hpp>
 
 #include <umppi/details/Midi2Track.hpp>
+#include <umppi/details/Midi2Clip.hpp>
+#include <umppi/details/NoteIntervalIndex.hpp>
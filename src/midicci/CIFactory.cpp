@@ -50,18 +50,44 @@ void CIFactory::memcpy(std::vector<uint8_t>& dst, size_t dst_offset, const std::
     }
 }
 
-std::vector<uint8_t> CIFactory::midiCIMessageCommon(
-    std::vector<uint8_t>& dst, uint8_t address, uint8_t sub_id_2,
-    uint8_t version_and_format, uint32_t source_muid, uint32_t destination_muid) {
+namespace {
 
-    dst.resize(std::max(dst.size(), size_t(13)));
+// dst must already hold at least 13 bytes.
+void put_message_common(std::vector<uint8_t>& dst, uint8_t address, uint8_t sub_id_2,
+                        uint8_t version_and_format, uint32_t source_muid, uint32_t destination_muid) {
     dst[0] = MIDI_CI_UNIVERSAL_SYSEX_ID;
     dst[1] = address;
     dst[2] = MIDI_CI_SUB_ID_1;
     dst[3] = sub_id_2;
     dst[4] = version_and_format;
-    midiCiDirectUint32At(dst, 5, source_muid);
-    midiCiDirectUint32At(dst, 9, destination_muid);
+    CIFactory::midiCiDirectUint32At(dst, 5, source_muid);
+    CIFactory::midiCiDirectUint32At(dst, 9, destination_muid);
+}
+
+// Writes one property exchange packet into dst, resized to exactly the packet size.
+void put_property_packet(std::vector<uint8_t>& dst, uint8_t sub_id_2, uint32_t source_muid,
+                         uint32_t destination_muid, uint8_t request_id, std::span<const uint8_t> header,
+                         uint16_t num_chunks, uint16_t chunk_index, std::span<const uint8_t> chunk_data) {
+    dst.resize(22 + header.size() + chunk_data.size());
+    put_message_common(dst, WHOLE_FUNCTION_BLOCK, sub_id_2, MIDI_CI_VERSION_1_2, source_muid, destination_muid);
+    dst[13] = request_id;
+    CIFactory::midiCI7bitInt14At(dst, 14, static_cast<uint16_t>(header.size()));
+    std::copy(header.begin(), header.end(), dst.begin() + 16);
+    size_t offset = 16 + header.size();
+    CIFactory::midiCI7bitInt14At(dst, offset, num_chunks);
+    CIFactory::midiCI7bitInt14At(dst, offset + 2, chunk_index);
+    CIFactory::midiCI7bitInt14At(dst, offset + 4, static_cast<uint16_t>(chunk_data.size()));
+    std::copy(chunk_data.begin(), chunk_data.end(), dst.begin() + offset + 6);
+}
+
+} // namespace
+
+std::vector<uint8_t> CIFactory::midiCIMessageCommon(
+    std::vector<uint8_t>& dst, uint8_t address, uint8_t sub_id_2,
+    uint8_t version_and_format, uint32_t source_muid, uint32_t destination_muid) {
+
+    dst.resize(std::max(dst.size(), size_t(13)));
+    put_message_common(dst, address, sub_id_2, version_and_format, source_muid, destination_muid);
 
     return std::vector<uint8_t>(dst.begin(), dst.begin() + 13);
 }
@@ -164,13 +190,18 @@ std::vector<std::vector<uint8_t>> CIFactory::midiCIPropertyChunks(
     const std::vector<uint8_t>& header, const std::vector<uint8_t>& data) {
 
     std::vector<std::vector<uint8_t>> result;
-
-    if (data.empty()) {
-        auto packet = midiCIPropertyPacketCommon(dst, sub_id_2,
-                                               source_muid, destination_muid, request_id, header, 1, 1, data);
+    midiCIPropertyChunks(dst, max_chunk_size, sub_id_2, source_muid, destination_muid, request_id,
+                         header, data, [&](const std::vector<uint8_t>& packet) {
         result.push_back(packet);
-        return result;
-    }
+        return true;
+    });
+    return result;
+}
+
+size_t CIFactory::midiCIPropertyChunks(
+    std::vector<uint8_t>& buffer, uint32_t max_chunk_size, uint8_t sub_id_2,
+    uint32_t source_muid, uint32_t destination_muid, uint8_t request_id,
+    std::span<const uint8_t> header, std::span<const uint8_t> data, const PacketSink& sink) {
 
     auto available_payload = [&](bool include_header) -> size_t {
         size_t overhead = 22 + (include_header ? header.size() : 0);
@@ -180,42 +211,31 @@ std::vector<std::vector<uint8_t>> CIFactory::midiCIPropertyChunks(
         return max_chunk_size - overhead;
     };
 
-    std::vector<std::vector<uint8_t>> chunk_payloads;
-    size_t offset = 0;
-
-    if (!header.empty()) {
-        size_t first_capacity = available_payload(true);
-        size_t first_len = std::min(first_capacity, data.size());
-        chunk_payloads.emplace_back(data.begin(), data.begin() + first_len);
-        offset = first_len;
-    }
-
+    // The first chunk carries the header (if any) and therefore less data than the others.
+    size_t first_len = header.empty() ? 0 : std::min(available_payload(true), data.size());
     size_t regular_capacity = available_payload(false);
-    while (offset < data.size()) {
-        if (regular_capacity == 0) {
-            throw std::runtime_error("max_property_chunk_size too small for property payload");
-        }
-        size_t len = std::min(regular_capacity, data.size() - offset);
-        chunk_payloads.emplace_back(data.begin() + offset, data.begin() + offset + len);
-        offset += len;
+    size_t rest = data.size() - first_len;
+    if (rest > 0 && regular_capacity == 0) {
+        throw std::runtime_error("max_property_chunk_size too small for property payload");
     }
-
-    if (chunk_payloads.empty()) {
-        chunk_payloads.emplace_back(); // Ensure we still emit a packet even with no data/header
+    size_t num_chunks = (header.empty() ? 0 : 1) + (rest == 0 ? 0 : (rest + regular_capacity - 1) / regular_capacity);
+    if (num_chunks == 0) {
+        num_chunks = 1; // Ensure we still emit a packet even with no data/header
     }
 
-    const size_t num_chunks = chunk_payloads.size();
+    size_t offset = 0;
     for (size_t i = 0; i < num_chunks; ++i) {
-        auto packet = midiCIPropertyPacketCommon(
-            dst, sub_id_2,
-            source_muid, destination_muid, request_id,
-            (i == 0) ? header : std::vector<uint8_t>(),
-            static_cast<uint16_t>(num_chunks),
-            static_cast<uint16_t>(i + 1),
-            chunk_payloads[i]);
-        result.push_back(packet);
+        size_t len = i == 0 && !header.empty() ? first_len : std::min(regular_capacity, data.size() - offset);
+        put_property_packet(buffer, sub_id_2, source_muid, destination_muid, request_id,
+                            i == 0 ? header : std::span<const uint8_t>{},
+                            static_cast<uint16_t>(num_chunks), static_cast<uint16_t>(i + 1),
+                            data.subspan(offset, len));
+        offset += len;
+        if (!sink(buffer)) {
+            return i + 1;
+        }
     }
-    return result;
+    return num_chunks;
 }
 
 void CIFactory::midiCIProfile(std::vector<uint8_t>& dst, size_t offset, MidiCIProfileId info) {
@@ -3,11 +3,11 @@
 
 namespace midicci {
 
-uint8_t CIRetrieval::getAddressing(const std::vector<uint8_t>& sysex) {
+uint8_t CIRetrieval::getAddressing(std::span<const uint8_t> sysex) {
     return sysex.size() > 1 ? sysex[1] : 0;
 }
 
-DeviceDetails CIRetrieval::getDeviceDetails(const std::vector<uint8_t>& sysex) {
+DeviceDetails CIRetrieval::getDeviceDetails(std::span<const uint8_t> sysex) {
     DeviceDetails details;
     details.manufacturer = sysex[13] | (sysex[14] << 8) | (sysex[15] << 16);
     details.family = static_cast<uint16_t>(sysex[16] | (sysex[17] << 8));
@@ -16,26 +16,26 @@ DeviceDetails CIRetrieval::getDeviceDetails(const std::vector<uint8_t>& sysex) {
     return details;
 }
 
-uint32_t CIRetrieval::getSourceMuid(const std::vector<uint8_t>& sysex) {
+uint32_t CIRetrieval::getSourceMuid(std::span<const uint8_t> sysex) {
     return sysex.size() > 8 ? 
         sysex[5] | (sysex[6] << 8) | (sysex[7] << 16) | (sysex[8] << 24) : 0;
 }
 
-uint32_t CIRetrieval::getDestinationMuid(const std::vector<uint8_t>& sysex) {
+uint32_t CIRetrieval::getDestinationMuid(std::span<const uint8_t> sysex) {
     return sysex.size() > 12 ? 
         sysex[9] | (sysex[10] << 8) | (sysex[11] << 16) | (sysex[12] << 24) : 0;
 }
 
-uint32_t CIRetrieval::getMuidToInvalidate(const std::vector<uint8_t>& sysex) {
+uint32_t CIRetrieval::getMuidToInvalidate(std::span<const uint8_t> sysex) {
     return sysex[13] | (sysex[14] << 8) | (sysex[15] << 16) | (sysex[16] << 24);
 }
 
-uint32_t CIRetrieval::getMaxSysexSize(const std::vector<uint8_t>& sysex) {
+uint32_t CIRetrieval::getMaxSysexSize(std::span<const uint8_t> sysex) {
     return sysex[25] | (sysex[26] << 8) | (sysex[27] << 16) | (sysex[28] << 24);
 }
 
 std::pair<std::vector<MidiCIProfileId>, std::vector<MidiCIProfileId>>
-CIRetrieval::getProfileSet(const std::vector<uint8_t>& sysex) {
+CIRetrieval::getProfileSet(std::span<const uint8_t> sysex) {
     std::vector<MidiCIProfileId> enabled_profiles;
     std::vector<MidiCIProfileId> disabled_profiles;
 
@@ -64,59 +64,54 @@ CIRetrieval::getProfileSet(const std::vector<uint8_t>& sysex) {
     return {enabled_profiles, disabled_profiles};
 }
 
-MidiCIProfileId CIRetrieval::getProfileId(const std::vector<uint8_t>& sysex) {
+MidiCIProfileId CIRetrieval::getProfileId(std::span<const uint8_t> sysex) {
     return getProfileIdEntry(sysex, 13);
 }
 
-uint16_t CIRetrieval::getProfileEnabledChannels(const std::vector<uint8_t>& sysex) {
+uint16_t CIRetrieval::getProfileEnabledChannels(std::span<const uint8_t> sysex) {
     return static_cast<uint16_t>(sysex[18] | (sysex[19] << 7));
 }
 
-MidiCIProfileId CIRetrieval::getProfileIdEntry(const std::vector<uint8_t>& sysex, size_t offset) {
+MidiCIProfileId CIRetrieval::getProfileIdEntry(std::span<const uint8_t> sysex, size_t offset) {
     std::vector<uint8_t> d{sysex.begin() + offset, sysex.begin() + offset + 5};
     return MidiCIProfileId{d};
 }
 
-uint16_t CIRetrieval::getProfileSpecificDataSize(const std::vector<uint8_t>& sysex) {
+uint16_t CIRetrieval::getProfileSpecificDataSize(std::span<const uint8_t> sysex) {
     return static_cast<uint16_t>(sysex[19] | (sysex[20] << 7));
 }
 
-uint8_t CIRetrieval::getMaxPropertyRequests(const std::vector<uint8_t>& sysex) {
+uint8_t CIRetrieval::getMaxPropertyRequests(std::span<const uint8_t> sysex) {
     return sysex[13];
 }
 
-std::vector<uint8_t> CIRetrieval::getPropertyHeader(const std::vector<uint8_t>& sysex) {
+std::span<const uint8_t> CIRetrieval::getPropertyHeader(std::span<const uint8_t> sysex) {
     uint16_t size = sysex[14] | (sysex[15] << 7);
-    std::vector<uint8_t> header;
     if (16 + size <= sysex.size()) {
-        header.assign(sysex.begin() + 16, sysex.begin() + 16 + size);
+        return sysex.subspan(16, size);
     }
-    return header;
+    return {};
 }
 
-std::vector<uint8_t> CIRetrieval::getPropertyBodyInThisChunk(const std::vector<uint8_t>& sysex) {
+std::span<const uint8_t> CIRetrieval::getPropertyBodyInThisChunk(std::span<const uint8_t> sysex) {
     uint16_t header_size = sysex[14] | (sysex[15] << 7);
     size_t index = 20 + header_size;
     if (index + 2 <= sysex.size()) {
         uint16_t body_size = sysex[index] | (sysex[index + 1] << 7);
         size_t start_pos = 22 + header_size;
         size_t actual_size = std::min(static_cast<size_t>(body_size), sysex.size() - start_pos);
-        std::vector<uint8_t> body;
-        if (start_pos < sysex.size()) {
-            body.assign(sysex.begin() + start_pos, sysex.begin() + start_pos + actual_size);
-        }
-        return body;
+        return sysex.subspan(start_pos, actual_size);
     }
     return {};
 }
 
-uint16_t CIRetrieval::getPropertyTotalChunks(const std::vector<uint8_t>& sysex) {
+uint16_t CIRetrieval::getPropertyTotalChunks(std::span<const uint8_t> sysex) {
     uint16_t header_size = sysex[14] | (sysex[15] << 7);
     size_t index = 16 + header_size;
     return static_cast<uint16_t>(sysex[index] | (sysex[index + 1] << 7));
 }
 
-uint16_t CIRetrieval::getPropertyChunkIndex(const std::vector<uint8_t>& sysex) {
+uint16_t CIRetrieval::getPropertyChunkIndex(std::span<const uint8_t> sysex) {
     uint16_t header_size = sysex[14] | (sysex[15] << 7);
     size_t index = 18 + header_size;
     return static_cast<uint16_t>(sysex[index] | (sysex[index + 1] << 7));
@@ -0,0 +1,255 @@
+#include "midicci/midicci.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+
+namespace midicci {
+
+const char* getLogLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warning: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Off: return "OFF";
+    }
+    return "?";
+}
+
+const char* getLogCategoryName(LogCategory category) {
+    switch (category) {
+        case LogCategory::Transport: return "transport";
+        case LogCategory::Discovery: return "discovery";
+        case LogCategory::Profile: return "profile";
+        case LogCategory::Property: return "property";
+        case LogCategory::ProcessInquiry: return "process-inquiry";
+        case LogCategory::Application: return "app";
+        case LogCategory::Count: break;
+    }
+    return "?";
+}
+
+namespace {
+
+void appendFormat(std::string& s, const char* format, ...) {
+    char buffer[128];
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length > 0)
+        s.append(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+}
+
+void appendHexBytes(std::string& s, std::span<const uint8_t> payload, uint32_t total_size) {
+    s.reserve(s.size() + payload.size() * 3 + 24);
+    for (uint8_t byte : payload) {
+        appendFormat(s, "%02x ", byte);
+    }
+    if (total_size > payload.size()) {
+        appendFormat(s, "... (%u bytes)", total_size);
+    }
+}
+
+} // namespace
+
+std::string formatLogRecord(const LogRecord& record) {
+    return formatLogRecord(record, std::span<const uint8_t>(record.payload.data(), record.payload_size));
+}
+
+std::string formatLogRecord(const LogRecord& record, std::span<const uint8_t> payload) {
+    std::string s;
+    appendFormat(s, "%s [%s] ", getLogLevelName(record.level), getLogCategoryName(record.category));
+    const auto& args = record.args;
+    switch (record.event) {
+        case LogEvent::Text:
+            s.append(reinterpret_cast<const char*>(payload.data()), payload.size());
+            break;
+        case LogEvent::Continuation:
+            s += "... ";
+            appendHexBytes(s, payload, 0);
+            break;
+        case LogEvent::SysExReceived:
+        case LogEvent::SysExSent:
+            appendFormat(s, "[%s CI SysEx (grp:%u)] ",
+                         record.event == LogEvent::SysExSent ? "sent" : "received", args[0]);
+            appendHexBytes(s, payload, args[1]);
+            break;
+        case LogEvent::UmpReceived:
+            s += "[received UMP] ";
+            for (size_t i = 0; i + 4 <= payload.size(); i += 4) {
+                uint32_t word = payload[i] | (payload[i + 1] << 8) |
+                                (payload[i + 2] << 16) | (static_cast<uint32_t>(payload[i + 3]) << 24);
+                appendFormat(s, "%08x ", word);
+            }
+            if (args[0] * 4 > payload.size()) {
+                appendFormat(s, "... (%u words)", args[0]);
+            }
+            break;
+        case LogEvent::MidiMessageReportChunk:
+            s += "[received MIDI (buffered)] ";
+            appendHexBytes(s, payload, args[0]);
+            break;
+        case LogEvent::MessageSent:
+            appendFormat(s, "sent CI message 0x%02X to MUID 0x%08X", args[0], args[1]);
+            break;
+        case LogEvent::MessageReceived:
+            appendFormat(s, "received CI message 0x%02X from MUID 0x%08X", args[0], args[1]);
+            break;
+        case LogEvent::PropertyChunkReceived:
+            appendFormat(s, "property message 0x%02X (request %u) from MUID 0x%08X part: %u / %u",
+                         args[0], args[1], record.muid, args[2], args[3]);
+            break;
+    }
+    return s;
+}
+
+LogRecordRing::LogRecordRing(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    cells_ = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; i++) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask_ = size - 1;
+}
+
+LogRecordRing::~LogRecordRing() = default;
+
+bool LogRecordRing::tryPush(const LogRecord& record) noexcept {
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = cells_[position & mask_];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (diff == 0) {
+            if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.record = record;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool LogRecordRing::tryPop(LogRecord& record) noexcept {
+    size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = cells_[position & mask_];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+        if (diff == 0) {
+            if (dequeue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                record = cell.record;
+                cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            position = dequeue_position_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+DiagnosticLogger::DiagnosticLogger(size_t capacity) : ring_(capacity) {
+    for (auto& level : levels_) {
+        level.store(LogLevel::Off, std::memory_order_relaxed);
+    }
+}
+
+LogLevel DiagnosticLogger::getLevel(LogCategory category) const noexcept {
+    return levels_[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+void DiagnosticLogger::setLevel(LogCategory category, LogLevel level) noexcept {
+    levels_[static_cast<size_t>(category)].store(level, std::memory_order_relaxed);
+}
+
+void DiagnosticLogger::setLevel(LogLevel level) noexcept {
+    for (auto& l : levels_) {
+        l.store(level, std::memory_order_relaxed);
+    }
+}
+
+bool DiagnosticLogger::write(LogLevel level, LogCategory category, LogEvent event, uint32_t muid,
+                             std::initializer_list<uint32_t> args, std::span<const uint8_t> payload,
+                             bool is_outgoing) noexcept {
+    LogRecord record;
+    record.timestamp_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    record.muid = muid;
+    std::copy_n(args.begin(), std::min(args.size(), record.args.size()), record.args.begin());
+    record.event = event;
+    record.level = level;
+    record.category = category;
+    record.is_outgoing = is_outgoing;
+    payload = payload.first(std::min(payload.size(), std::max(getMaxPayloadSize(), LogRecord::MAX_PAYLOAD_SIZE)));
+    record.payload_size = static_cast<uint8_t>(std::min(payload.size(), LogRecord::MAX_PAYLOAD_SIZE));
+    std::copy_n(payload.begin(), record.payload_size, record.payload.begin());
+    if (payload.size() <= LogRecord::MAX_PAYLOAD_SIZE) {
+        return ring_.tryPush(record);
+    }
+
+    // the rest of the payload follows in Continuation records
+    size_t count = std::min((payload.size() + LogRecord::MAX_PAYLOAD_SIZE - 1) / LogRecord::MAX_PAYLOAD_SIZE,
+                            std::min<size_t>(ring_.getCapacity(), UINT16_MAX + size_t{1}));
+    record.continuation_count = static_cast<uint16_t>(count - 1);
+    return ring_.tryPushAll(count, [&](size_t index, LogRecord& cell) {
+        if (index == 0) {
+            cell = record;
+            return;
+        }
+        auto part = payload.subspan(index * LogRecord::MAX_PAYLOAD_SIZE);
+        cell.timestamp_ns = record.timestamp_ns;
+        cell.muid = muid;
+        cell.event = LogEvent::Continuation;
+        cell.level = level;
+        cell.category = category;
+        cell.is_outgoing = is_outgoing;
+        cell.continuation_count = 0;
+        cell.payload_size = static_cast<uint8_t>(std::min(part.size(), LogRecord::MAX_PAYLOAD_SIZE));
+        std::copy_n(part.begin(), cell.payload_size, cell.payload.begin());
+    });
+}
+
+bool DiagnosticLogger::writeText(LogLevel level, LogCategory category, std::string_view text) noexcept {
+    return write(level, category, LogEvent::Text, 0, {},
+                 std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(text.data()), text.size()));
+}
+
+size_t DiagnosticLogger::drain(const std::function<void(const LogRecord&)>& consumer) {
+    return drain([&consumer](const LogRecord& record, std::span<const uint8_t>) { consumer(record); });
+}
+
+// The continuation records of a record were published before it, so they can be popped right after it.
+size_t DiagnosticLogger::drain(const std::function<void(const LogRecord&, std::span<const uint8_t> payload)>& consumer) {
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    size_t count = 0;
+    LogRecord record;
+    LogRecord continuation;
+    while (ring_.tryPop(record)) {
+        if (record.event == LogEvent::Continuation) {
+            continue; // its record was popped by someone else through getRing()
+        }
+        drain_payload_.assign(record.payload.begin(), record.payload.begin() + record.payload_size);
+        for (uint16_t i = 0; i < record.continuation_count && ring_.tryPop(continuation); i++) {
+            drain_payload_.insert(drain_payload_.end(), continuation.payload.begin(),
+                                  continuation.payload.begin() + continuation.payload_size);
+        }
+        consumer(record, drain_payload_);
+        count++;
+    }
+    return count;
+}
+
+} // namespace midicci
@@ -3,6 +3,7 @@
 #include <stdexcept>
 #include <cctype>
 #include <iomanip>
+#include <algorithm>
 
 namespace midicci {
 
@@ -355,6 +356,103 @@ bool JsonParser::hasMore() const {
     return pos_ < json_.size();
 }
 
+std::optional<JsonArrayIndex> JsonArrayIndex::build(std::span<const uint8_t> json) {
+    auto is_space = [](uint8_t c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+    size_t pos = 0;
+    while (pos < json.size() && is_space(json[pos]))
+        pos++;
+    if (pos == json.size() || json[pos] != '[')
+        return std::nullopt;
+    pos++;
+
+    JsonArrayIndex index;
+    // the closing bracket expected for each open array or object, the outer array included
+    std::vector<uint8_t> closers{']'};
+    // the current element's range; begin is npos between elements
+    size_t begin = std::string::npos;
+    size_t end = 0;
+    // whether the previous byte of the current element continues a number or literal
+    bool in_scalar = false;
+    auto finish_element = [&]() {
+        if (begin == std::string::npos)
+            return false;
+        index.elements_.emplace_back(begin, end);
+        begin = std::string::npos;
+        return true;
+    };
+    auto is_scalar = [&](uint8_t c) {
+        return !is_space(c) && c != '"' && c != ',' && c != ':' && c != '[' && c != ']' && c != '{' && c != '}';
+    };
+
+    for (; pos < json.size() && !closers.empty(); pos++) {
+        uint8_t c = json[pos];
+        if (is_space(c)) {
+            in_scalar = false;
+            continue;
+        }
+        if (closers.size() == 1) {
+            if (c == ',' || c == ']') {
+                // an empty slot is only valid for "[]"
+                if (!finish_element() && (c == ',' || !index.elements_.empty()))
+                    return std::nullopt;
+                in_scalar = false;
+                if (c == ']')
+                    closers.pop_back();
+                continue;
+            }
+            // a second value in one element, e.g. "[1 2]"
+            if (begin != std::string::npos && !(in_scalar && is_scalar(c)))
+                return std::nullopt;
+            if (c == ':' || c == '}')
+                return std::nullopt;
+            if (begin == std::string::npos)
+                begin = pos;
+            in_scalar = is_scalar(c);
+        }
+        if (c == '"') {
+            for (pos++; pos < json.size() && json[pos] != '"'; pos++) {
+                if (json[pos] == '\\')
+                    pos++;
+            }
+            if (pos >= json.size())
+                return std::nullopt;
+        } else if (c == '[') {
+            closers.push_back(']');
+        } else if (c == '{') {
+            closers.push_back('}');
+        } else if (c == ']' || c == '}') {
+            if (closers.back() != c)
+                return std::nullopt;
+            closers.pop_back();
+        }
+        end = pos + 1;
+    }
+    if (!closers.empty())
+        return std::nullopt;
+    for (; pos < json.size(); pos++) {
+        if (!is_space(json[pos]))
+            return std::nullopt;
+    }
+    return index;
+}
+
+std::vector<uint8_t> JsonArrayIndex::slice(std::span<const uint8_t> json, size_t offset, size_t limit) const {
+    std::vector<uint8_t> result;
+    result.push_back('[');
+    if (offset < elements_.size()) {
+        size_t last = offset + std::min(limit, elements_.size() - offset);
+        if (last > offset)
+            result.reserve(elements_[last - 1].second - elements_[offset].first + 2);
+        for (size_t i = offset; i < last; i++) {
+            if (i > offset)
+                result.push_back(',');
+            result.insert(result.end(), json.begin() + elements_[i].first, json.begin() + elements_[i].second);
+        }
+    }
+    result.push_back(']');
+    return result;
+}
+
 std::string escapeString(const std::string& str) {
     std::ostringstream oss;
     for (char c : str) {
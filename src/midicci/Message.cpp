@@ -1,31 +1,156 @@
 #include "midicci/midicci.hpp"
+#include <algorithm>
+#include <cctype>
 #include <sstream>
 #include <iomanip>
 
 namespace midicci {
 
-    std::string format_json_bytes(const std::vector<uint8_t>& bytes, size_t max_length = 4096) {
-        if (bytes.empty()) {
-            return "";
+    // Property headers and bodies are logged as they are; parsing and re-serializing them just to
+    // build a log line costs far more than the logging itself for large bodies.
+    std::string format_json_bytes(std::span<const uint8_t> bytes, size_t max_length = 4096) {
+        return std::string(bytes.begin(), bytes.begin() + std::min(bytes.size(), max_length));
+    }
+
+namespace {
+
+    const char* get_property_message_label(MessageType type) {
+        switch (type) {
+            case MessageType::GetPropertyData: return "GetPropertyData";
+            case MessageType::GetPropertyDataReply: return "GetPropertyDataReply";
+            case MessageType::SetPropertyData: return "SetPropertyData";
+            case MessageType::SetPropertyDataReply: return "SetPropertyDataReply";
+            case MessageType::SubscribeProperty: return "SubscribeProperty";
+            case MessageType::SubscribePropertyReply: return "SubscribePropertyReply";
+            case MessageType::PropertyNotify: return "PropertyNotify";
+            default: return "PropertyMessage";
         }
-        
-        try {
-            std::string json_str(bytes.begin(), bytes.end());
-            if (json_str.length() > max_length) {
-                json_str = json_str.substr(0, max_length);
+    }
+
+    bool looks_like_json(std::span<const uint8_t> bytes) {
+        auto it = std::find_if(bytes.begin(), bytes.end(), [](uint8_t c) { return !std::isspace(c); });
+        return it != bytes.end() && (*it == '{' || *it == '[');
+    }
+
+    // Re-indents JSON text token by token, without building a JsonValue.
+    void append_pretty_json(std::string& dst, std::span<const uint8_t> bytes, int depth) {
+        auto new_line = [&](int d) {
+            dst += '\n';
+            dst.append(static_cast<size_t>(d) * 2, ' ');
+        };
+        bool in_string = false;
+        bool escaped = false;
+        bool just_opened = false;
+        for (uint8_t b : bytes) {
+            char c = static_cast<char>(b);
+            if (in_string) {
+                dst += c;
+                if (escaped)
+                    escaped = false;
+                else if (c == '\\')
+                    escaped = true;
+                else if (c == '"')
+                    in_string = false;
+                continue;
+            }
+            if (std::isspace(b))
+                continue;
+            bool closing = c == '}' || c == ']';
+            if (just_opened) {
+                just_opened = false;
+                if (closing) {
+                    depth--;
+                    dst += c;
+                    continue;
+                }
+                new_line(depth);
             }
-            
-            auto json_value = midicci::JsonValue::parse(json_str);
-            return json_value.serialize();
-        } catch (...) {
-            std::string fallback(bytes.begin(), bytes.end());
-            if (fallback.length() > max_length) {
-                fallback = fallback.substr(0, max_length);
+            switch (c) {
+                case '{':
+                case '[':
+                    dst += c;
+                    depth++;
+                    just_opened = true;
+                    break;
+                case '}':
+                case ']':
+                    depth--;
+                    new_line(depth);
+                    dst += c;
+                    break;
+                case ',':
+                    dst += c;
+                    new_line(depth);
+                    break;
+                case ':':
+                    dst += ": ";
+                    break;
+                case '"':
+                    in_string = true;
+                    dst += c;
+                    break;
+                default:
+                    dst += c;
+                    break;
             }
-            return fallback;
         }
     }
 
+    void append_pretty_field(std::string& dst, const char* name, std::span<const uint8_t> bytes) {
+        dst += "  \"";
+        dst += name;
+        dst += "\": ";
+        if (bytes.empty())
+            dst += "null";
+        else if (looks_like_json(bytes))
+            append_pretty_json(dst, bytes, 1);
+        else
+            dst += JsonValue(std::string(bytes.begin(), bytes.end())).serialize();
+    }
+
+} // namespace
+
+MessageLogRecord::MessageLogRecord(MessageType type, const Common& common, std::string label, std::string body_string)
+    : type_(type), common_(common), label_(std::move(label)), body_string_(std::move(body_string)) {}
+
+MessageLogRecord::MessageLogRecord(MessageType type, const Common& common, uint8_t request_id,
+                                   SharedBytes header, SharedBytes body)
+    : type_(type), common_(common), request_id_(request_id), is_property_(true),
+      header_(std::move(header)), body_(std::move(body)) {}
+
+std::span<const uint8_t> MessageLogRecord::getHeader() const noexcept {
+    return header_.span();
+}
+
+std::span<const uint8_t> MessageLogRecord::getBody() const noexcept {
+    return body_.span();
+}
+
+std::string MessageLogRecord::getLabel() const {
+    return isPropertyMessage() ? get_property_message_label(type_) : label_;
+}
+
+std::string MessageLogRecord::getText() const {
+    if (!isPropertyMessage())
+        return label_ + ": " + body_string_;
+    std::ostringstream oss;
+    oss << get_property_message_label(type_) << ": requestId=" << static_cast<int>(request_id_)
+        << ", header=" << format_json_bytes(getHeader())
+        << ", body=" << format_json_bytes(getBody());
+    return oss.str();
+}
+
+std::string MessageLogRecord::getPrettyJson() const {
+    if (!isPropertyMessage())
+        return "";
+    std::string s = "{\n";
+    append_pretty_field(s, "header", getHeader());
+    s += ",\n";
+    append_pretty_field(s, "body", getBody());
+    s += "\n}";
+    return s;
+}
+
 Message::Message(MessageType type, const Common& common)
     : type_(type), common_(common) {}
 
@@ -33,6 +158,14 @@ std::vector<std::vector<uint8_t>> Message::serializeMulti(const MidiCIDeviceConf
     return {};
 }
 
+void Message::serializeInto(const MidiCIDeviceConfiguration& config, std::vector<uint8_t>& /*buffer*/,
+                            const CIFactory::PacketSink& sink) const {
+    for (const auto& packet : serializeMulti(config)) {
+        if (!sink(packet))
+            return;
+    }
+}
+
 MessageType Message::getType() const noexcept {
     return type_;
 }
@@ -53,14 +186,33 @@ std::vector<std::vector<uint8_t>> SinglePacketMessage::serializeMulti(const Midi
     return {single};
 }
 
+void SinglePacketMessage::serializeInto(const MidiCIDeviceConfiguration& config, std::vector<uint8_t>& buffer,
+                                        const CIFactory::PacketSink& sink) const {
+    buffer = serialize(config);
+    sink(buffer);
+}
+
 PropertyMessage::PropertyMessage(MessageType type, const Common& common, uint8_t request_id,
-                               const std::vector<uint8_t>& header, const std::vector<uint8_t>& body)
-    : Message(type, common), request_id_(request_id), header_(header), body_(body) {}
+                               std::vector<uint8_t> header, SharedBytes body)
+    : Message(type, common), request_id_(request_id), header_(std::move(header)), body_(std::move(body)) {}
 
 std::vector<std::vector<uint8_t>> PropertyMessage::serializeMulti(const MidiCIDeviceConfiguration& config) const {
     return serialize(config);
 }
 
+void PropertyMessage::serializeInto(const MidiCIDeviceConfiguration& config, std::vector<uint8_t>& buffer,
+                                    const CIFactory::PacketSink& sink) const {
+    // property message types are their sub ID#2
+    CIFactory::midiCIPropertyChunks(buffer, config.max_property_chunk_size, static_cast<uint8_t>(type_),
+                                    common_.source_muid, common_.destination_muid, request_id_,
+                                    header_, body_.span(), sink);
+}
+
+MessageLogRecord PropertyMessage::createLogRecord() const {
+    // headers are small; the body is shared
+    return MessageLogRecord(type_, common_, request_id_, header_, body_);
+}
+
 DiscoveryInquiry::DiscoveryInquiry(const Common& common, const DeviceDetails& device_details,
                                  uint8_t supported_features, uint32_t max_sysex_size, uint8_t output_path_id)
     : SinglePacketMessage(MessageType::DiscoveryInquiry, common), device_details_(device_details),
@@ -180,8 +332,8 @@ std::string PropertyGetCapabilities::getBodyString() const {
     return oss.str();
 }
 
-GetPropertyData::GetPropertyData(const Common& common, uint8_t request_id, const std::vector<uint8_t>& header)
-    : PropertyMessage(MessageType::GetPropertyData, common, request_id, header, {}) {}
+GetPropertyData::GetPropertyData(const Common& common, uint8_t request_id, std::vector<uint8_t> header)
+    : PropertyMessage(MessageType::GetPropertyData, common, request_id, std::move(header), {}) {}
 
 GetPropertyData::GetPropertyData(const Common& common, uint8_t request_id, const std::string& resource_identifier, 
                                 const std::string& res_id)
@@ -281,12 +433,12 @@ std::string GetPropertyData::getBodyString() const {
 }
 
 SetPropertyData::SetPropertyData(const Common& common, uint8_t request_id, 
-                                 const std::vector<uint8_t>& header, const std::vector<uint8_t>& body)
-    : PropertyMessage(MessageType::SetPropertyData, common, request_id, header, body) {}
+                                 std::vector<uint8_t> header, SharedBytes body)
+    : PropertyMessage(MessageType::SetPropertyData, common, request_id, std::move(header), std::move(body)) {}
 
 SetPropertyData::SetPropertyData(const Common& common, uint8_t request_id, const std::string& resource_identifier, 
-                                 const std::vector<uint8_t>& body, const std::string& res_id, bool set_partial)
-    : PropertyMessage(MessageType::SetPropertyData, common, request_id, {}, body) {
+                                 SharedBytes body, const std::string& res_id, bool set_partial)
+    : PropertyMessage(MessageType::SetPropertyData, common, request_id, {}, std::move(body)) {
     header_ = createJsonHeader(resource_identifier, res_id, "", set_partial, 0, 0);
 }
 
@@ -307,8 +459,8 @@ std::string SetPropertyData::getBodyString() const {
 }
 
 SubscribeProperty::SubscribeProperty(const Common& common, uint8_t request_id, 
-                                   const std::vector<uint8_t>& header, const std::vector<uint8_t>& body)
-    : PropertyMessage(MessageType::SubscribeProperty, common, request_id, header, body) {}
+                                   std::vector<uint8_t> header, SharedBytes body)
+    : PropertyMessage(MessageType::SubscribeProperty, common, request_id, std::move(header), std::move(body)) {}
 
 SubscribeProperty::SubscribeProperty(const Common& common, uint8_t request_id, const std::string& resource_identifier, 
                                    const std::string& command, const std::string& mutual_encoding)
@@ -629,6 +781,10 @@ std::string Message::getLogMessage() const {
     return oss.str();
 }
 
+MessageLogRecord Message::createLogRecord() const {
+    return MessageLogRecord(type_, common_, getLabel(), getBodyString());
+}
+
 ProfileReply::ProfileReply(const Common& common, const std::vector<MidiCIProfileId>& enabled_profiles,
                           const std::vector<MidiCIProfileId>& disabled_profiles)
     : SinglePacketMessage(MessageType::ProfileInquiryReply, common), enabled_profiles_(enabled_profiles), disabled_profiles_(disabled_profiles) {}
@@ -671,8 +827,8 @@ std::string PropertyGetCapabilitiesReply::getBodyString() const {
 }
 
 GetPropertyDataReply::GetPropertyDataReply(const Common& common, uint8_t request_id, 
-                                          const std::vector<uint8_t>& header, const std::vector<uint8_t>& body)
-    : PropertyMessage(MessageType::GetPropertyDataReply, common, request_id, header, body) {}
+                                          std::vector<uint8_t> header, SharedBytes body)
+    : PropertyMessage(MessageType::GetPropertyDataReply, common, request_id, std::move(header), std::move(body)) {}
 
 std::vector<std::vector<uint8_t>> GetPropertyDataReply::serialize(const MidiCIDeviceConfiguration& config) const {
     std::vector<uint8_t> dst(config.receivable_max_sysex_size);
@@ -699,8 +855,8 @@ std::string GetPropertyDataReply::getBodyString() const {
     return oss.str();
 }
 
-SetPropertyDataReply::SetPropertyDataReply(const Common& common, uint8_t request_id, const std::vector<uint8_t>& header)
-    : PropertyMessage(MessageType::SetPropertyDataReply, common, request_id, header, {}) {}
+SetPropertyDataReply::SetPropertyDataReply(const Common& common, uint8_t request_id, std::vector<uint8_t> header)
+    : PropertyMessage(MessageType::SetPropertyDataReply, common, request_id, std::move(header), {}) {}
 
 std::vector<std::vector<uint8_t>> SetPropertyDataReply::serialize(const MidiCIDeviceConfiguration& config) const {
     std::vector<uint8_t> dst(4096);
@@ -728,8 +884,8 @@ std::string SetPropertyDataReply::getBodyString() const {
 }
 
 SubscribePropertyReply::SubscribePropertyReply(const Common& common, uint8_t request_id, 
-                                              const std::vector<uint8_t>& header, const std::vector<uint8_t>& body)
-    : PropertyMessage(MessageType::SubscribePropertyReply, common, request_id, header, body) {}
+                                              std::vector<uint8_t> header, SharedBytes body)
+    : PropertyMessage(MessageType::SubscribePropertyReply, common, request_id, std::move(header), std::move(body)) {}
 
 std::vector<std::vector<uint8_t>> SubscribePropertyReply::serialize(const MidiCIDeviceConfiguration& config) const {
     std::vector<uint8_t> dst(4096);
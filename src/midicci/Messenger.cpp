@@ -1,6 +1,8 @@
 #include "midicci/midicci.hpp"
 #include <mutex>
 #include <vector>
+#include <array>
+#include <span>
 #include <functional>
 #include <atomic>
 #include <algorithm>
@@ -22,6 +24,48 @@ public:
     std::atomic<uint8_t> request_id_counter_;
     PropertyChunkManager local_chunk_manager_;
 
+    // Decoded view of an incoming CI message. data refers to the caller's sysex buffer; observed tells
+    // whether a logger or message callback wants the materialized Message.
+    struct MessageView {
+        std::span<const uint8_t> data;
+        Common common;
+        bool observed;
+
+        uint8_t at(size_t index) const { return data[index]; }
+        uint16_t getUint14(size_t index) const { return static_cast<uint16_t>(data[index] | (data[index + 1] << 7)); }
+        std::vector<uint8_t> copy(size_t offset, size_t size) const {
+            size_t start = std::min(offset, data.size());
+            size_t end = std::min(start + size, data.size());
+            return {data.begin() + start, data.begin() + end};
+        }
+    };
+
+    using Handler = void (*)(Messenger& messenger, const MessageView& view);
+
+    struct DispatchEntry {
+        size_t min_size = 0;
+        Handler handler = nullptr;
+    };
+
+    // Indexed by sub-ID#2. Entries without a handler are passed to processUnknownCIMessage().
+    static const std::array<DispatchEntry, 128>& dispatchTable();
+
+    bool hasMessageObservers() const {
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex_);
+            if (!callbacks_.empty()) {
+                return true;
+            }
+        }
+        return device_.hasLogger();
+    }
+
+    // Messages that only reach a client connection can be dropped unmaterialized when nobody
+    // observes them and there is no connection for the sender.
+    bool isClientMessageWanted(const MessageView& view) const {
+        return view.observed || device_.getConnection(view.common.source_muid) != nullptr;
+    }
+
     void notify_callbacks(const Message& message) {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
         for (const auto& callback : callbacks_) {
@@ -44,6 +88,11 @@ Messenger::~Messenger() = default;
 
 void Messenger::send(const Message& message) {
     pimpl_->log_message(message, true);
+    auto& diagnostics = pimpl_->device_.getDiagnosticLogger();
+    if (diagnostics.isEnabled(LogLevel::Trace, LogCategory::Transport)) {
+        diagnostics.write(LogLevel::Trace, LogCategory::Transport, LogEvent::MessageSent, message.getSourceMuid(),
+                          {static_cast<uint8_t>(message.getType()), message.getDestinationMuid()}, {}, true);
+    }
 
     auto& device_config = pimpl_->device_.getConfig();
     int original_chunk_size = device_config.max_property_chunk_size;
@@ -68,19 +117,33 @@ void Messenger::send(const Message& message) {
         }
     }
 
-    auto parts = message.serializeMulti(device_config);
-    if (overridden) {
-        device_config.max_property_chunk_size = original_chunk_size;
-        device_config.receivable_max_sysex_size = original_sysex_size;
+    auto restore_config = [&] {
+        if (overridden) {
+            device_config.max_property_chunk_size = original_chunk_size;
+            device_config.receivable_max_sysex_size = original_sysex_size;
+        }
+    };
+    auto ci_output_sender = pimpl_->device_.getCiOutputSender();
+    if (!ci_output_sender) {
+        restore_config();
+        return;
     }
-    for (auto & part : parts) {
-        auto ci_output_sender = pimpl_->device_.getCiOutputSender();
-        if (ci_output_sender) {
-            uint8_t group = message.getCommon().group;
-            if (!ci_output_sender(group, part))
+
+    // Each packet goes out as soon as it is built, so even a large property body only needs one
+    // chunk worth of buffer.
+    uint8_t group = message.getCommon().group;
+    std::vector<uint8_t> buffer;
+    try {
+        message.serializeInto(device_config, buffer, [&](const std::vector<uint8_t>& packet) {
+            if (!ci_output_sender(group, packet))
                 throw std::runtime_error("Failed to send MIDI-CI message");
-        }
+            return true;
+        });
+    } catch (...) {
+        restore_config();
+        throw;
     }
+    restore_config();
 }
 
 void Messenger::sendDiscoveryInquiry(uint8_t ciCategorySupported) {
@@ -215,19 +278,19 @@ void Messenger::sendPropertySubscribe(uint8_t group, uint32_t destination_muid,
 
 void Messenger::sendNakForError(const Common& common, uint8_t original_sub_id2, uint8_t status_code, 
                                   uint8_t status_data, const std::vector<uint8_t>& details, const std::string& message) {
-    std::vector<uint8_t> dst(pimpl_->device_.getConfig().receivable_max_sysex_size);
+    auto ci_output_sender = pimpl_->device_.getCiOutputSender();
+    if (!ci_output_sender)
+        return;
+
     std::vector<uint8_t> message_bytes(message.begin(), message.end());
-    
-    auto nak_message = CIFactory::midiCIAckNak(
+    // midiCIAckNak() grows dst to exactly the NAK size, so dst itself is the packet.
+    std::vector<uint8_t> dst;
+    CIFactory::midiCIAckNak(
         dst, true, common.address, CI_VERSION_AND_FORMAT,
         pimpl_->device_.getMuid(), common.source_muid, original_sub_id2,
         status_code, status_data, details, message_bytes
     );
-    
-    auto ci_output_sender = pimpl_->device_.getCiOutputSender();
-    if (ci_output_sender) {
-        ci_output_sender(common.group, nak_message);
-    }
+    ci_output_sender(common.group, dst);
 }
 
 void Messenger::sendProcessInquiryCapabilities(uint8_t group, uint32_t destination_muid) {
@@ -248,376 +311,329 @@ void Messenger::sendMidiMessageReportInquiry(uint8_t group, uint8_t address, uin
     send(inquiry);
 }
 
-void Messenger::processInput(uint8_t group, const std::vector<uint8_t>& data) {
-
-    if (data.size() < 4 ||
-        data[0] != MIDI_CI_UNIVERSAL_SYSEX_ID ||
-        data[2] != MIDI_CI_SUB_ID_1) {
-        return;
-    }
-
-    if (data.size() < MIDI_CI_COMMON_HEADER_SIZE) {
-        return;
-    }
-
-    uint32_t source_muid = CIRetrieval::getSourceMuid(data);
-    uint32_t dest_muid = CIRetrieval::getDestinationMuid(data);
-    uint8_t address = CIRetrieval::getAddressing(data);
-
-    Common common(source_muid, dest_muid, address, group);
-
-    if (dest_muid != pimpl_->device_.getMuid() && dest_muid != MIDI_CI_BROADCAST_MUID_32) {
-        return;
-    }
-
-    CISubId2 message_type = static_cast<CISubId2>(data[3]);
-
-    switch (message_type) {
-        case CISubId2::DISCOVERY_REPLY: {
-            if (data.size() >= 30) {
-                auto device_details = CIRetrieval::getDeviceDetails(data);
+const std::array<Messenger::Impl::DispatchEntry, 128>& Messenger::Impl::dispatchTable() {
+    static const std::array<DispatchEntry, 128> table = [] {
+        std::array<DispatchEntry, 128> t{};
+        auto on = [&t](CISubId2 sub_id2, size_t min_size, Handler handler) {
+            t[static_cast<uint8_t>(sub_id2)] = {min_size, handler};
+        };
 
-                uint8_t ci_supported = data[24];
-                uint32_t max_sysex = CIRetrieval::getMaxSysexSize(data);
-                uint8_t output_path = data.size() > 29 ? data[29] : 0;
-                uint8_t function_block = data.size() > 30 ? data[30] : 0;
+        // Discovery and management
 
-                DiscoveryReply reply(common, device_details, ci_supported, max_sysex, output_path, function_block);
-                pimpl_->log_message(reply, false);
-                processDiscoveryReply(reply);
-            }
-            break;
-        }
-        case CISubId2::INVALIDATE_MUID: {
-            if (data.size() >= 18) {
-                uint32_t target_muid = CIRetrieval::getMuidToInvalidate(data);
-                InvalidateMUID invalidate(common, target_muid);
-                pimpl_->log_message(invalidate, false);
-                processInvalidateMUID(invalidate);
+        on(CISubId2::DISCOVERY_INQUIRY, 30, [](Messenger& m, const MessageView& v) {
+            if (!v.observed) {
+                // the reply only needs the sender, so discovery storms are answered without a Message
+                m.sendDiscoveryReply(v.common.group, v.common.source_muid);
+                return;
             }
-            break;
-        }
-        case CISubId2::PROFILE_INQUIRY_REPLY: {
-            if (data.size() >= 15) {
-                const auto [enabled_profiles, disabled_profiles] = CIRetrieval::getProfileSet(data);
-                ProfileReply reply(common, enabled_profiles, disabled_profiles);
-                pimpl_->log_message(reply, false);
-                processProfileReply(reply);
+            DiscoveryInquiry inquiry(v.common, CIRetrieval::getDeviceDetails(v.data), v.at(24),
+                                     CIRetrieval::getMaxSysexSize(v.data), v.data.size() > 29 ? v.at(29) : 0);
+            m.pimpl_->log_message(inquiry, false);
+            m.processDiscovery(inquiry);
+        });
+        on(CISubId2::DISCOVERY_REPLY, 30, [](Messenger& m, const MessageView& v) {
+            DiscoveryReply reply(v.common, CIRetrieval::getDeviceDetails(v.data), v.at(24),
+                                 CIRetrieval::getMaxSysexSize(v.data), v.data.size() > 29 ? v.at(29) : 0,
+                                 v.data.size() > 30 ? v.at(30) : 0);
+            m.pimpl_->log_message(reply, false);
+            m.processDiscoveryReply(reply);
+        });
+        on(CISubId2::INVALIDATE_MUID, 18, [](Messenger& m, const MessageView& v) {
+            InvalidateMUID invalidate(v.common, CIRetrieval::getMuidToInvalidate(v.data));
+            m.pimpl_->log_message(invalidate, false);
+            m.processInvalidateMUID(invalidate);
+        });
+        on(CISubId2::ENDPOINT_MESSAGE_INQUIRY, 14, [](Messenger& m, const MessageView& v) {
+            EndpointInquiry inquiry(v.common, v.at(13));
+            m.pimpl_->log_message(inquiry, false);
+            m.processEndpointMessage(inquiry);
+        });
+        on(CISubId2::ENDPOINT_MESSAGE_REPLY, 16, [](Messenger& m, const MessageView& v) {
+            if (!v.observed) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROFILE_ADDED_REPORT: {
-            if (data.size() >= 18) {
-                auto profile_id = CIRetrieval::getProfileId(data);
-                ProfileAdded added(common, profile_id);
-                pimpl_->log_message(added, false);
-                processProfileAddedReport(added);
+            EndpointReply reply(v.common, v.at(13), v.copy(16, v.getUint14(14)));
+            m.pimpl_->log_message(reply, false);
+            m.processEndpointReply(reply);
+        });
+        on(CISubId2::ACK, 23, [](Messenger& m, const MessageView& v) {
+            m.processAck(v.common.source_muid, v.common.destination_muid, v.at(13), v.at(14), v.at(15),
+                         v.copy(16, 5), v.getUint14(21), v.copy(23, v.data.size()));
+        });
+        on(CISubId2::NAK, 23, [](Messenger& m, const MessageView& v) {
+            m.processNak(v.common.source_muid, v.common.destination_muid, v.at(13), v.at(14), v.at(15),
+                         v.copy(16, 5), v.getUint14(21), v.copy(23, v.data.size()));
+        });
+
+        // Profile Configuration
+
+        on(CISubId2::PROFILE_INQUIRY, 0, [](Messenger& m, const MessageView& v) {
+            ProfileInquiry inquiry(v.common);
+            m.pimpl_->log_message(inquiry, false);
+            m.processProfileInquiry(inquiry);
+        });
+        on(CISubId2::PROFILE_INQUIRY_REPLY, 15, [](Messenger& m, const MessageView& v) {
+            if (!m.pimpl_->isClientMessageWanted(v)) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROFILE_REMOVED_REPORT: {
-            if (data.size() >= 18) {
-                auto profile_id = CIRetrieval::getProfileId(data);
-                ProfileRemoved removed(common, profile_id);
-                pimpl_->log_message(removed, false);
-                processProfileRemovedReport(removed);
+            const auto [enabled_profiles, disabled_profiles] = CIRetrieval::getProfileSet(v.data);
+            ProfileReply reply(v.common, enabled_profiles, disabled_profiles);
+            m.pimpl_->log_message(reply, false);
+            m.processProfileReply(reply);
+        });
+        on(CISubId2::PROFILE_SET_ON, 20, [](Messenger& m, const MessageView& v) {
+            if (!v.observed) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROFILE_ENABLED_REPORT: {
-            if (data.size() >= 20) {
-                MidiCIProfileId profile_id = CIRetrieval::getProfileId(data);
-                uint16_t channels = CIRetrieval::getProfileEnabledChannels(data);
-                ProfileEnabled enabled(common, profile_id, channels);
-                pimpl_->log_message(enabled, false);
-                processProfileEnabledReport(enabled);
+            SetProfileOn set_on(v.common, CIRetrieval::getProfileId(v.data), CIRetrieval::getProfileEnabledChannels(v.data));
+            m.pimpl_->log_message(set_on, false);
+            m.processSetProfileOn(set_on);
+        });
+        on(CISubId2::PROFILE_SET_OFF, 18, [](Messenger& m, const MessageView& v) {
+            if (!v.observed) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROFILE_DISABLED_REPORT: {
-            if (data.size() >= 20) {
-                MidiCIProfileId profile_id = CIRetrieval::getProfileId(data);
-                uint16_t channels = CIRetrieval::getProfileEnabledChannels(data);
-                ProfileDisabled disabled(common, profile_id, channels);
-                pimpl_->log_message(disabled, false);
-                processProfileDisabledReport(disabled);
+            SetProfileOff set_off(v.common, CIRetrieval::getProfileId(v.data));
+            m.pimpl_->log_message(set_off, false);
+            m.processSetProfileOff(set_off);
+        });
+        on(CISubId2::PROFILE_ENABLED_REPORT, 20, [](Messenger& m, const MessageView& v) {
+            if (!m.pimpl_->isClientMessageWanted(v)) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROPERTY_EXCHANGE_CAPABILITIES_REPLY: {
-            if (data.size() >= 14) {
-                uint8_t max_requests = CIRetrieval::getMaxPropertyRequests(data);
-                PropertyGetCapabilitiesReply reply(common, max_requests);
-                pimpl_->log_message(reply, false);
-                processPropertyCapabilitiesReply(reply);
+            ProfileEnabled enabled(v.common, CIRetrieval::getProfileId(v.data), CIRetrieval::getProfileEnabledChannels(v.data));
+            m.pimpl_->log_message(enabled, false);
+            m.processProfileEnabledReport(enabled);
+        });
+        on(CISubId2::PROFILE_DISABLED_REPORT, 20, [](Messenger& m, const MessageView& v) {
+            if (!m.pimpl_->isClientMessageWanted(v)) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROPERTY_GET_DATA_REPLY: {
-            if (data.size() >= 21) {
-                uint8_t request_id = data[13];
-                std::vector<uint8_t> header = CIRetrieval::getPropertyHeader(data);
-                std::vector<uint8_t> body = CIRetrieval::getPropertyBodyInThisChunk(data);
-                uint16_t num_chunks = CIRetrieval::getPropertyTotalChunks(data);
-                uint16_t chunk_index = CIRetrieval::getPropertyChunkIndex(data);
-                std::string msg = std::format("GetPropertyDataReply Part: {} / {}", chunk_index, num_chunks);
-                pimpl_->device_.getLogger()(LogData{msg, false});
-
-                handleChunk(common, request_id, chunk_index, num_chunks, header, body,
-                    [this, common, request_id](const std::vector<uint8_t>& complete_header, const std::vector<uint8_t>& complete_body) {
-                        GetPropertyDataReply reply(common, request_id, complete_header, complete_body);
-                        pimpl_->log_message(reply, false);
-                        processGetDataReply(reply);
-                    });
+            ProfileDisabled disabled(v.common, CIRetrieval::getProfileId(v.data), CIRetrieval::getProfileEnabledChannels(v.data));
+            m.pimpl_->log_message(disabled, false);
+            m.processProfileDisabledReport(disabled);
+        });
+        on(CISubId2::PROFILE_ADDED_REPORT, 18, [](Messenger& m, const MessageView& v) {
+            if (!m.pimpl_->isClientMessageWanted(v)) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROPERTY_SET_DATA_REPLY: {
-            if (data.size() >= 21) {
-                uint8_t request_id = data[13];
-                std::vector<uint8_t> header = CIRetrieval::getPropertyHeader(data);
-                SetPropertyDataReply reply(common, request_id, header);
-                pimpl_->log_message(reply, false);
-                processSetDataReply(reply);
+            ProfileAdded added(v.common, CIRetrieval::getProfileId(v.data));
+            m.pimpl_->log_message(added, false);
+            m.processProfileAddedReport(added);
+        });
+        on(CISubId2::PROFILE_REMOVED_REPORT, 18, [](Messenger& m, const MessageView& v) {
+            if (!m.pimpl_->isClientMessageWanted(v)) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROPERTY_SUBSCRIPTION_REPLY: {
-            if (data.size() >= 21) {
-                uint8_t request_id = data[13];
-                std::vector<uint8_t> header = CIRetrieval::getPropertyHeader(data);
-                std::vector<uint8_t> body = CIRetrieval::getPropertyBodyInThisChunk(data);
-                SubscribePropertyReply reply(common, request_id, header, body);
-                pimpl_->log_message(reply, false);
-                processSubscribePropertyReply(reply);
+            ProfileRemoved removed(v.common, CIRetrieval::getProfileId(v.data));
+            m.pimpl_->log_message(removed, false);
+            m.processProfileRemovedReport(removed);
+        });
+        on(CISubId2::PROFILE_DETAILS_REPLY, 22, [](Messenger& m, const MessageView& v) {
+            if (!m.pimpl_->isClientMessageWanted(v)) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROPERTY_NOTIFY: {
-            if (data.size() >= 16) {
-                uint8_t request_id = data[13];
-                std::vector<uint8_t> header = CIRetrieval::getPropertyHeader(data);
-                std::vector<uint8_t> body = CIRetrieval::getPropertyBodyInThisChunk(data);
-                uint16_t num_chunks = CIRetrieval::getPropertyTotalChunks(data);
-                uint16_t chunk_index = CIRetrieval::getPropertyChunkIndex(data);
-                
-                handleChunk(common, request_id, chunk_index, num_chunks, header, body,
-                    [this, common, request_id](const std::vector<uint8_t>& complete_header, const std::vector<uint8_t>& complete_body) {
-                        SubscribeProperty notify(common, request_id, complete_header, complete_body);
-                        pimpl_->log_message(notify, false);
-                        processPropertyNotify(notify);
-                    });
+            ProfileDetailsReply reply(v.common, CIRetrieval::getProfileId(v.data), v.at(18), v.copy(21, v.getUint14(19)));
+            m.pimpl_->log_message(reply, false);
+            m.processProfileDetailsReply(reply);
+        });
+        on(CISubId2::PROFILE_SPECIFIC_DATA, 22, [](Messenger& m, const MessageView& v) {
+            if (!v.observed) {
+                return;
             }
-            break;
-        }
-        case CISubId2::DISCOVERY_INQUIRY: {
-            if (data.size() >= 30) {
-                auto device_details = CIRetrieval::getDeviceDetails(data);
+            ProfileSpecificData specific_data(v.common, CIRetrieval::getProfileId(v.data),
+                                              v.copy(22, CIRetrieval::getProfileSpecificDataSize(v.data)));
+            m.pimpl_->log_message(specific_data, false);
+            m.processProfileSpecificData(specific_data);
+        });
 
-                uint8_t ci_supported = data[24];
-                uint32_t max_sysex = CIRetrieval::getMaxSysexSize(data);
-                uint8_t output_path = data.size() > 29 ? data[29] : 0;
+        // Property Exchange
 
-                DiscoveryInquiry inquiry(common, device_details, ci_supported, max_sysex, output_path);
-                pimpl_->log_message(inquiry, false);
-                processDiscovery(inquiry);
-            }
-            break;
-        }
-        case CISubId2::PROFILE_INQUIRY: {
-            ProfileInquiry inquiry(common);
-            pimpl_->log_message(inquiry, false);
-            processProfileInquiry(inquiry);
-            break;
-        }
-        case CISubId2::PROFILE_SET_ON: {
-            if (data.size() >= 20) {
-                MidiCIProfileId profile_id = CIRetrieval::getProfileId(data);
-                uint16_t channels = CIRetrieval::getProfileEnabledChannels(data);
-                SetProfileOn set_on(common, profile_id, channels);
-                pimpl_->log_message(set_on, false);
-                processSetProfileOn(set_on);
-            }
-            break;
-        }
-        case CISubId2::PROFILE_SET_OFF: {
-            if (data.size() >= 18) {
-                MidiCIProfileId profile_id = CIRetrieval::getProfileId(data);
-                SetProfileOff set_off(common, profile_id);
-                pimpl_->log_message(set_off, false);
-                processSetProfileOff(set_off);
-            }
-            break;
-        }
-        case CISubId2::PROPERTY_EXCHANGE_CAPABILITIES_INQUIRY: {
-            if (data.size() >= 14) {
-                uint8_t max_requests = CIRetrieval::getMaxPropertyRequests(data);
-                PropertyGetCapabilities inquiry(common, max_requests);
-                pimpl_->log_message(inquiry, false);
-                processPropertyCapabilitiesInquiry(inquiry);
-            }
-            break;
-        }
-        case CISubId2::PROPERTY_GET_DATA_INQUIRY: {
-            if (data.size() >= 16) {
-                uint8_t request_id = data[13];
-                std::vector<uint8_t> header = CIRetrieval::getPropertyHeader(data);
-                GetPropertyData inquiry(common, request_id, header);
-                pimpl_->log_message(inquiry, false);
-                processGetPropertyData(inquiry);
-            }
-            break;
-        }
-        case CISubId2::PROPERTY_SET_DATA_INQUIRY: {
-            if (data.size() >= 16) {
-                uint8_t request_id = data[13];
-                std::vector<uint8_t> header = CIRetrieval::getPropertyHeader(data);
-                std::vector<uint8_t> body = CIRetrieval::getPropertyBodyInThisChunk(data);
-                uint16_t num_chunks = CIRetrieval::getPropertyTotalChunks(data);
-                uint16_t chunk_index = CIRetrieval::getPropertyChunkIndex(data);
-
-                handleChunk(common, request_id, chunk_index, num_chunks, header, body,
-                    [this, common, request_id](const std::vector<uint8_t>& complete_header, const std::vector<uint8_t>& complete_body) {
-                        SetPropertyData inquiry(common, request_id, complete_header, complete_body);
-                        pimpl_->log_message(inquiry, false);
-                        processSetPropertyData(inquiry);
-                    });
-            }
-            break;
-        }
-        case CISubId2::PROPERTY_SUBSCRIPTION_INQUIRY: {
-            if (data.size() >= 16) {
-                uint8_t request_id = data[13];
-                std::vector<uint8_t> header = CIRetrieval::getPropertyHeader(data);
-                std::vector<uint8_t> body = CIRetrieval::getPropertyBodyInThisChunk(data);
-                uint16_t num_chunks = CIRetrieval::getPropertyTotalChunks(data);
-                uint16_t chunk_index = CIRetrieval::getPropertyChunkIndex(data);
-                
-                handleChunk(common, request_id, chunk_index, num_chunks, header, body,
-                    [this, common, request_id](const std::vector<uint8_t>& complete_header, const std::vector<uint8_t>& complete_body) {
-                        SubscribeProperty inquiry(common, request_id, complete_header, complete_body);
-                        pimpl_->log_message(inquiry, false);
-                        processSubscribeProperty(inquiry);
-                    });
-            }
-            break;
-        }
-        case CISubId2::ENDPOINT_MESSAGE_REPLY: {
-            if (data.size() >= 16) {
-                uint8_t status = data[13];
-                uint16_t data_length = data[14] | (data[15] << 7);
-                std::vector<uint8_t> endpoint_data(data.begin() + 16, data.begin() + 16 + data_length);
-                EndpointReply reply(common, status, endpoint_data);
-                pimpl_->log_message(reply, false);
-                processEndpointReply(reply);
+        on(CISubId2::PROPERTY_EXCHANGE_CAPABILITIES_INQUIRY, 14, [](Messenger& m, const MessageView& v) {
+            PropertyGetCapabilities inquiry(v.common, CIRetrieval::getMaxPropertyRequests(v.data));
+            m.pimpl_->log_message(inquiry, false);
+            m.processPropertyCapabilitiesInquiry(inquiry);
+        });
+        on(CISubId2::PROPERTY_EXCHANGE_CAPABILITIES_REPLY, 14, [](Messenger& m, const MessageView& v) {
+            if (!m.pimpl_->isClientMessageWanted(v)) {
+                return;
             }
-            break;
-        }
-        case CISubId2::ACK: {
-            if (data.size() >= 23) {
-                uint8_t original_sub_id = data[13];
-                uint8_t status_code = data[14];
-                uint8_t status_data = data[15];
-                std::vector<uint8_t> details(data.begin() + 16, data.begin() + 21);
-                uint16_t message_length = data[21] | (data[22] << 7);
-                std::vector<uint8_t> message_text(data.begin() + 23, data.end());
-                processAck(common.source_muid, common.destination_muid, original_sub_id, status_code, status_data, details, message_length, message_text);
+            PropertyGetCapabilitiesReply reply(v.common, CIRetrieval::getMaxPropertyRequests(v.data));
+            m.pimpl_->log_message(reply, false);
+            m.processPropertyCapabilitiesReply(reply);
+        });
+        on(CISubId2::PROPERTY_GET_DATA_INQUIRY, 16, [](Messenger& m, const MessageView& v) {
+            auto header = CIRetrieval::getPropertyHeader(v.data);
+            GetPropertyData inquiry(v.common, v.at(13), std::vector<uint8_t>(header.begin(), header.end()));
+            m.pimpl_->log_message(inquiry, false);
+            m.processGetPropertyData(inquiry);
+        });
+        on(CISubId2::PROPERTY_GET_DATA_REPLY, 21, [](Messenger& m, const MessageView& v) {
+            uint8_t request_id = v.at(13);
+            uint16_t num_chunks = CIRetrieval::getPropertyTotalChunks(v.data);
+            uint16_t chunk_index = CIRetrieval::getPropertyChunkIndex(v.data);
+            auto& diagnostics = m.pimpl_->device_.getDiagnosticLogger();
+            if (diagnostics.isEnabled(LogLevel::Debug, LogCategory::Property)) {
+                diagnostics.write(LogLevel::Debug, LogCategory::Property, LogEvent::PropertyChunkReceived, v.common.source_muid,
+                                  {v.at(3), request_id, chunk_index, num_chunks});
             }
-            break;
-        }
-        case CISubId2::NAK: {
-            if (data.size() >= 23) {
-                uint8_t original_sub_id = data[13];
-                uint8_t status_code = data[14];
-                uint8_t status_data = data[15];
-                std::vector<uint8_t> details(data.begin() + 16, data.begin() + 21);
-                uint16_t message_length = data[21] | (data[22] << 7);
-                std::vector<uint8_t> message_text(data.begin() + 23, data.end());
-                processNak(common.source_muid, common.destination_muid, original_sub_id, status_code, status_data, details, message_length, message_text);
+            // a long reply is still arriving; don't let the request time out under it
+            if (chunk_index < num_chunks) {
+                if (auto conn = m.pimpl_->device_.getConnection(v.common.source_muid))
+                    conn->getPropertyClientFacade().getRequestScheduler().extend(request_id);
             }
-            break;
-        }
-        case CISubId2::PROFILE_DETAILS_REPLY: {
-            if (data.size() >= 22) {
-                MidiCIProfileId profile_id = CIRetrieval::getProfileId(data);
-                uint8_t target = data[18];
-                uint16_t data_size = data[19] | (data[20] << 7);
-                std::vector<uint8_t> profile_data(data.begin() + 21, data.begin() + 21 + data_size);
-                ProfileDetailsReply reply(common, profile_id, target, profile_data);
-                pimpl_->log_message(reply, false);
-                processProfileDetailsReply(reply);
+
+            m.handleChunk(v.common, request_id, chunk_index, num_chunks,
+                CIRetrieval::getPropertyHeader(v.data), CIRetrieval::getPropertyBodyInThisChunk(v.data),
+                [&m, &v, request_id](std::vector<uint8_t> complete_header, std::vector<uint8_t> complete_body) {
+                    if (!m.pimpl_->isClientMessageWanted(v)) {
+                        return;
+                    }
+                    GetPropertyDataReply reply(v.common, request_id, std::move(complete_header), std::move(complete_body));
+                    m.pimpl_->log_message(reply, false);
+                    m.processGetDataReply(reply);
+                });
+        });
+        on(CISubId2::PROPERTY_SET_DATA_INQUIRY, 16, [](Messenger& m, const MessageView& v) {
+            uint8_t request_id = v.at(13);
+            m.handleChunk(v.common, request_id,
+                CIRetrieval::getPropertyChunkIndex(v.data), CIRetrieval::getPropertyTotalChunks(v.data),
+                CIRetrieval::getPropertyHeader(v.data), CIRetrieval::getPropertyBodyInThisChunk(v.data),
+                [&m, &v, request_id](std::vector<uint8_t> complete_header, std::vector<uint8_t> complete_body) {
+                    SetPropertyData inquiry(v.common, request_id, std::move(complete_header), std::move(complete_body));
+                    m.pimpl_->log_message(inquiry, false);
+                    m.processSetPropertyData(inquiry);
+                });
+        });
+        on(CISubId2::PROPERTY_SET_DATA_REPLY, 21, [](Messenger& m, const MessageView& v) {
+            if (!m.pimpl_->isClientMessageWanted(v)) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROFILE_SPECIFIC_DATA: {
-            if (data.size() >= 22) {
-                MidiCIProfileId profile_id = CIRetrieval::getProfileId(data);
-                uint16_t data_length = CIRetrieval::getProfileSpecificDataSize(data);
-                std::vector<uint8_t> profile_data(data.begin() + 22, data.begin() + 22 + data_length);
-                ProfileSpecificData specific_data(common, profile_id, profile_data);
-                pimpl_->log_message(specific_data, false);
-                processProfileSpecificData(specific_data);
+            auto header = CIRetrieval::getPropertyHeader(v.data);
+            SetPropertyDataReply reply(v.common, v.at(13), std::vector<uint8_t>(header.begin(), header.end()));
+            m.pimpl_->log_message(reply, false);
+            m.processSetDataReply(reply);
+        });
+        on(CISubId2::PROPERTY_SUBSCRIPTION_INQUIRY, 16, [](Messenger& m, const MessageView& v) {
+            uint8_t request_id = v.at(13);
+            m.handleChunk(v.common, request_id,
+                CIRetrieval::getPropertyChunkIndex(v.data), CIRetrieval::getPropertyTotalChunks(v.data),
+                CIRetrieval::getPropertyHeader(v.data), CIRetrieval::getPropertyBodyInThisChunk(v.data),
+                [&m, &v, request_id](std::vector<uint8_t> complete_header, std::vector<uint8_t> complete_body) {
+                    SubscribeProperty inquiry(v.common, request_id, std::move(complete_header), std::move(complete_body));
+                    m.pimpl_->log_message(inquiry, false);
+                    m.processSubscribeProperty(inquiry);
+                });
+        });
+        on(CISubId2::PROPERTY_SUBSCRIPTION_REPLY, 21, [](Messenger& m, const MessageView& v) {
+            if (!m.pimpl_->isClientMessageWanted(v)) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROCESS_INQUIRY_CAPABILITIES_REPLY: {
-            if (data.size() >= 14) {
-                uint8_t supported_features = data[13];
-                ProcessInquiryCapabilitiesReply reply(common, supported_features);
-                pimpl_->log_message(reply, false);
-                processProcessInquiryReply(reply);
+            auto header = CIRetrieval::getPropertyHeader(v.data);
+            auto body = CIRetrieval::getPropertyBodyInThisChunk(v.data);
+            SubscribePropertyReply reply(v.common, v.at(13), std::vector<uint8_t>(header.begin(), header.end()),
+                                         std::vector<uint8_t>(body.begin(), body.end()));
+            m.pimpl_->log_message(reply, false);
+            m.processSubscribePropertyReply(reply);
+        });
+        on(CISubId2::PROPERTY_NOTIFY, 16, [](Messenger& m, const MessageView& v) {
+            uint8_t request_id = v.at(13);
+            m.handleChunk(v.common, request_id,
+                CIRetrieval::getPropertyChunkIndex(v.data), CIRetrieval::getPropertyTotalChunks(v.data),
+                CIRetrieval::getPropertyHeader(v.data), CIRetrieval::getPropertyBodyInThisChunk(v.data),
+                [&m, &v, request_id](std::vector<uint8_t> complete_header, std::vector<uint8_t> complete_body) {
+                    if (!m.pimpl_->isClientMessageWanted(v)) {
+                        return;
+                    }
+                    SubscribeProperty notify(v.common, request_id, std::move(complete_header), std::move(complete_body));
+                    m.pimpl_->log_message(notify, false);
+                    m.processPropertyNotify(notify);
+                });
+        });
+
+        // Process Inquiry
+
+        on(CISubId2::PROCESS_INQUIRY_CAPABILITIES, 0, [](Messenger& m, const MessageView& v) {
+            ProcessInquiryCapabilities inquiry(v.common);
+            m.pimpl_->log_message(inquiry, false);
+            m.processProcessInquiry(inquiry);
+        });
+        on(CISubId2::PROCESS_INQUIRY_CAPABILITIES_REPLY, 14, [](Messenger& m, const MessageView& v) {
+            if (!m.pimpl_->isClientMessageWanted(v)) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROCESS_INQUIRY_MIDI_MESSAGE_REPORT_REPLY: {
-            if (data.size() >= 17) {
-                uint8_t system_messages = data[13];
-                uint8_t channel_controller_messages = data[15];
-                uint8_t note_data_messages = data[16];
-                MidiMessageReportReply reply(common, system_messages, channel_controller_messages, note_data_messages);
-                pimpl_->log_message(reply, false);
-                processMidiMessageReportReply(reply);
+            ProcessInquiryCapabilitiesReply reply(v.common, v.at(13));
+            m.pimpl_->log_message(reply, false);
+            m.processProcessInquiryReply(reply);
+        });
+        on(CISubId2::PROCESS_INQUIRY_MIDI_MESSAGE_REPORT, 18, [](Messenger& m, const MessageView& v) {
+            if (!v.observed) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROCESS_INQUIRY_END_OF_MIDI_MESSAGE: {
-            MidiMessageReportNotifyEnd end_notify(common);
-            pimpl_->log_message(end_notify, false);
-            processEndOfMidiMessageReport(end_notify);
-            break;
-        }
-        case CISubId2::PROCESS_INQUIRY_MIDI_MESSAGE_REPORT: {
-            if (data.size() >= 18) {
-                uint8_t message_data_control = data[13];
-                uint8_t system_messages = data[14];
-                uint8_t channel_controller_messages = data[16];
-                uint8_t note_data_messages = data[17];
-                MidiMessageReportInquiry inquiry(common, message_data_control, system_messages, channel_controller_messages, note_data_messages);
-                pimpl_->log_message(inquiry, false);
-                processMidiMessageReport(inquiry);
+            MidiMessageReportInquiry inquiry(v.common, v.at(13), v.at(14), v.at(16), v.at(17));
+            m.pimpl_->log_message(inquiry, false);
+            m.processMidiMessageReport(inquiry);
+        });
+        on(CISubId2::PROCESS_INQUIRY_MIDI_MESSAGE_REPORT_REPLY, 17, [](Messenger& m, const MessageView& v) {
+            if (!v.observed) {
+                return;
             }
-            break;
-        }
-        case CISubId2::ENDPOINT_MESSAGE_INQUIRY: {
-            if (data.size() >= 14) {
-                uint8_t status = data[13];
-                EndpointInquiry inquiry(common, status);
-                pimpl_->log_message(inquiry, false);
-                processEndpointMessage(inquiry);
+            MidiMessageReportReply reply(v.common, v.at(13), v.at(15), v.at(16));
+            m.pimpl_->log_message(reply, false);
+            m.processMidiMessageReportReply(reply);
+        });
+        on(CISubId2::PROCESS_INQUIRY_END_OF_MIDI_MESSAGE, 0, [](Messenger& m, const MessageView& v) {
+            if (!v.observed) {
+                return;
             }
-            break;
-        }
-        case CISubId2::PROCESS_INQUIRY_CAPABILITIES: {
-            ProcessInquiryCapabilities inquiry(common);
-            pimpl_->log_message(inquiry, false);
-            processProcessInquiry(inquiry);
-            break;
-        }
-        default: {
-            processUnknownCIMessage(common, data);
-            break;
-        }
+            MidiMessageReportNotifyEnd end_notify(v.common);
+            m.pimpl_->log_message(end_notify, false);
+            m.processEndOfMidiMessageReport(end_notify);
+        });
+        return t;
+    }();
+    return table;
+}
+
+void Messenger::processInput(uint8_t group, const std::vector<uint8_t>& data) {
+
+    if (data.size() < 4 ||
+        data[0] != MIDI_CI_UNIVERSAL_SYSEX_ID ||
+        data[2] != MIDI_CI_SUB_ID_1) {
+        return;
+    }
+
+    if (data.size() < MIDI_CI_COMMON_HEADER_SIZE) {
+        return;
     }
+
+    uint32_t source_muid = CIRetrieval::getSourceMuid(data);
+    uint32_t dest_muid = CIRetrieval::getDestinationMuid(data);
+    uint8_t address = CIRetrieval::getAddressing(data);
+
+    Common common(source_muid, dest_muid, address, group);
+
+    if (dest_muid != pimpl_->device_.getMuid() && dest_muid != MIDI_CI_BROADCAST_MUID_32) {
+        return;
+    }
+
+    uint8_t sub_id2 = data[3];
+    auto& diagnostics = pimpl_->device_.getDiagnosticLogger();
+    if (diagnostics.isEnabled(LogLevel::Trace, LogCategory::Transport)) {
+        diagnostics.write(LogLevel::Trace, LogCategory::Transport, LogEvent::MessageReceived, source_muid,
+                          {sub_id2, source_muid});
+    }
+
+    const auto& table = Impl::dispatchTable();
+    if (sub_id2 >= table.size() || !table[sub_id2].handler) {
+        processUnknownCIMessage(common, data);
+        return;
+    }
+    const auto& entry = table[sub_id2];
+    if (data.size() < entry.min_size) {
+        return;
+    }
+    entry.handler(*this, Impl::MessageView{data, common, pimpl_->hasMessageObservers()});
 }
 
 void Messenger::addMessageCallback(MessageCallback callback) {
@@ -637,7 +653,7 @@ void Messenger::removeMessageCallback(MessageCallback callback) {
 }
 
 uint8_t Messenger::getNextRequestId() noexcept {
-    return ++pimpl_->request_id_counter_;
+    return ++pimpl_->request_id_counter_ & PropertyRequestScheduler::MAX_REQUEST_ID;
 }
 
 void Messenger::handleNewEndpoint(const DiscoveryReply& msg) {
@@ -961,8 +977,8 @@ void Messenger::processProfileSpecificData(const ProfileSpecificData& msg) {
 }
 
 void Messenger::handleChunk(const Common& common, uint8_t request_id, uint16_t chunk_index, uint16_t num_chunks,
-                           const std::vector<uint8_t>& header, const std::vector<uint8_t>& body,
-                           std::function<void(const std::vector<uint8_t>&, const std::vector<uint8_t>&)> on_complete) {
+                           std::span<const uint8_t> header, std::span<const uint8_t> body,
+                           std::function<void(std::vector<uint8_t>, std::vector<uint8_t>)> on_complete) {
     PropertyChunkManager* chunk_manager = &pimpl_->local_chunk_manager_;
     auto connection = pimpl_->device_.getConnection(common.source_muid);
     if (connection) {
@@ -970,33 +986,42 @@ void Messenger::handleChunk(const Common& common, uint8_t request_id, uint16_t c
         chunk_manager = &property_client.getPendingChunkManager();
     }
 
-    std::vector<uint8_t> effective_header = header;
-    if (effective_header.empty() && chunk_manager->hasPendingChunk(common.source_muid, request_id)) {
-        effective_header = chunk_manager->getPendingHeader(common.source_muid, request_id);
+    // header and body are views into the received sysex. They are copied exactly once: appended to the
+    // reassembly buffer, or (for a single-chunk message) into the vectors handed to on_complete.
+    if (pimpl_->device_.hasPropertyChunkCallback()) {
+        std::vector<uint8_t> pending_header;
+        std::span<const uint8_t> effective_header = header;
+        if (header.empty() && chunk_manager->hasPendingChunk(common.source_muid, request_id)) {
+            pending_header = chunk_manager->getPendingHeader(common.source_muid, request_id);
+            effective_header = pending_header;
+        }
+        pimpl_->device_.notifyPropertyChunk(common.source_muid, request_id, effective_header);
     }
 
-    pimpl_->device_.notifyPropertyChunk(common.source_muid, request_id, effective_header);
+    // a first chunk starts the transfer over, whatever is left of an earlier reply with this request ID
+    if (chunk_index == 1)
+        chunk_manager->discard(common.source_muid, request_id);
+    uint64_t timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
     if (chunk_index < num_chunks) {
         chunk_manager->addPendingChunk(
-            std::chrono::duration_cast<std::chrono::seconds>(
-                std::chrono::system_clock::now().time_since_epoch()
-            ).count(),
+            timestamp,
             common.source_muid,
             request_id,
             header,
-            body
+            body,
+            num_chunks
         );
+        return;
+    }
+    // the last chunk also expires abandoned transfers, as addPendingChunk() does
+    chunk_manager->expireChunks(timestamp);
+    if (chunk_manager->hasPendingChunk(common.source_muid, request_id)) {
+        auto result = chunk_manager->finishPendingChunk(common.source_muid, request_id, body);
+        on_complete(std::move(result.first), std::move(result.second));
     } else {
-        std::vector<uint8_t> complete_header = header;
-        std::vector<uint8_t> complete_body = body;
-
-        if (chunk_manager->hasPendingChunk(common.source_muid, request_id)) {
-            auto result = chunk_manager->finishPendingChunk(common.source_muid, request_id, body);
-            complete_header = result.first;
-            complete_body = result.second;
-        }
-
-        on_complete(complete_header, complete_body);
+        on_complete(std::vector<uint8_t>(header.begin(), header.end()), std::vector<uint8_t>(body.begin(), body.end()));
     }
 }
 
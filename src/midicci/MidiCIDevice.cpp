@@ -29,6 +29,9 @@ public:
     std::unique_ptr<PropertyHostFacade> property_host_facade_;
     mutable std::recursive_mutex mutex_;
     LoggerFunction logger_;
+    // false while logger_ is the NOP logger
+    bool has_logger_ = false;
+    DiagnosticLogger diagnostic_logger_;
     Messenger messenger_;
     PropertyChunkCallback property_chunk_callback_;
 };
@@ -153,9 +156,19 @@ const PropertyHostFacade& MidiCIDevice::getPropertyHostFacade() const {
 
 void MidiCIDevice::setLogger(LoggerFunction logger) {
     std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    pimpl_->has_logger_ = static_cast<bool>(logger);
     pimpl_->logger_ = logger ? std::move(logger) : pimpl_->create_nop_logger();
 }
 
+DiagnosticLogger& MidiCIDevice::getDiagnosticLogger() {
+    return pimpl_->diagnostic_logger_;
+}
+
+bool MidiCIDevice::hasLogger() const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    return pimpl_->has_logger_;
+}
+
 MidiCIDevice::LoggerFunction MidiCIDevice::getLogger() const {
     std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
     return pimpl_->logger_;
@@ -166,14 +179,19 @@ Messenger& MidiCIDevice::getMessenger() {
     return pimpl_->messenger_;
 }
 
-void MidiCIDevice::notifyPropertyChunk(uint32_t source_muid, uint8_t request_id, const std::vector<uint8_t>& header) {
+bool MidiCIDevice::hasPropertyChunkCallback() const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    return static_cast<bool>(pimpl_->property_chunk_callback_);
+}
+
+void MidiCIDevice::notifyPropertyChunk(uint32_t source_muid, uint8_t request_id, std::span<const uint8_t> header) {
     PropertyChunkCallback callback;
     {
         std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
         callback = pimpl_->property_chunk_callback_;
     }
     if (callback) {
-        callback(source_muid, request_id, header);
+        callback(source_muid, request_id, std::vector<uint8_t>(header.begin(), header.end()));
     }
 }
 
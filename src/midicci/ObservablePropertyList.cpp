@@ -90,7 +90,7 @@ namespace midicci {
     }
 
     void ClientObservablePropertyList::setPropertyValue(const std::string& propertyId, const std::string& resId, 
-                                                        const std::vector<uint8_t>& data, bool isPartial) {
+                                                        const SharedBytes& data, bool isPartial) {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
         
         // For client property list, we use a default media type of application/json
@@ -107,7 +107,7 @@ namespace midicci {
         notifyPropertyUpdated(propertyId, resId);
     }
 
-    void ClientObservablePropertyList::updateValue(const std::string& propertyId, const std::vector<uint8_t>& body, const std::string& mediaType) {
+    void ClientObservablePropertyList::updateValue(const std::string& propertyId, const SharedBytes& body, const std::string& mediaType) {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
 
         auto it = values_.find(propertyId);
@@ -150,7 +150,7 @@ namespace midicci {
         // For now, we don't handle encoding, so just use body as-is
         // In full implementation, you'd call property_client_->decodeBody(msg.getHeader(), msg.getBody())
 
-        updateValue(property_id, msg.getBody(), media_type);
+        updateValue(property_id, msg.getSharedBody(), media_type);
 
         return command;
     }
@@ -198,7 +198,7 @@ namespace midicci {
     }
 
     void ServiceObservablePropertyList::setPropertyValue(const std::string& propertyId, const std::string& resId, 
-                                                         const std::vector<uint8_t>& data, bool isPartial) {
+                                                         const SharedBytes& data, bool isPartial) {
         // For service property list, delegate to the existing updateValue method
         // Use default media type of application/json, and ignore the isPartial parameter for now
         updateValue(propertyId, resId, "application/json", data);
@@ -224,7 +224,7 @@ namespace midicci {
         }
     }
 
-    void ServiceObservablePropertyList::updateValue(const std::vector<uint8_t>& header, const std::vector<uint8_t>& body) {
+    void ServiceObservablePropertyList::updateValue(const std::vector<uint8_t>& header, const SharedBytes& body) {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
 
         std::string propertyId = property_service_.getPropertyIdForHeader(header);
@@ -232,12 +232,15 @@ namespace midicci {
         std::string mediaType = property_service_.getHeaderFieldString(header, PropertyCommonHeaderKeys::MEDIA_TYPE);
         if (mediaType.empty())
             mediaType = CommonRulesKnownMimeTypes::APPLICATION_JSON;
-        std::vector<uint8_t> decodedBody = property_service_.decodeBody(header, body);
-        updateValue(propertyId, resId, mediaType, decodedBody);
+        std::string encoding = property_service_.getHeaderFieldString(header, PropertyCommonHeaderKeys::MUTUAL_ENCODING);
+        if (encoding.empty() || encoding == PropertyDataEncoding::ASCII)
+            updateValue(propertyId, resId, mediaType, body);
+        else
+            updateValue(propertyId, resId, mediaType, SharedBytes(property_service_.decodeBody(header, body)));
     }
 
     void ServiceObservablePropertyList::updateValue(const std::string& propertyId, const std::string& resId,
-                                                    const std::string& mediaType, const std::vector<uint8_t>& body) {
+                                                    const std::string& mediaType, const SharedBytes& body) {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
 
         auto matches = [&propertyId, &resId](const PropertyValue& pv) {
@@ -1,25 +1,78 @@
 #include "midicci/midicci.hpp"
 #include <mutex>
 #include <vector>
+#include <unordered_map>
 #include <algorithm>
 
 namespace midicci {
 
-struct Chunk {
-    uint64_t timestamp;
-    uint32_t source_muid;
-    uint8_t request_id;
+namespace {
+
+uint64_t transfer_key(uint32_t source_muid, uint8_t request_id) {
+    return (static_cast<uint64_t>(source_muid) << 8) | request_id;
+}
+
+} // namespace
+
+struct PendingTransfer {
+    uint64_t last_timestamp;
+    // the tick at which the transfer expires unless another chunk arrives; also its wheel slot
+    uint64_t deadline;
     std::vector<uint8_t> header;
     std::vector<uint8_t> data;
-    
-    Chunk(uint64_t ts, uint32_t muid, uint8_t req_id, const std::vector<uint8_t>& hdr, const std::vector<uint8_t>& chunk_data)
-        : timestamp(ts), source_muid(muid), request_id(req_id), header(hdr), data(chunk_data) {}
 };
 
 class PropertyChunkManager::Impl {
 public:
-    std::vector<Chunk> chunks_;
+    std::unordered_map<uint64_t, PendingTransfer> transfers_;
+    // transfer keys by deadline % size. Entries are not removed when a transfer is rescheduled or
+    // finished; they are just skipped when their slot comes up.
+    std::vector<std::vector<uint64_t>> wheel_;
+    uint64_t timeout_{DEFAULT_TIMEOUT_SECONDS};
+    uint64_t current_tick_{0};
+    bool started_{false};
     mutable std::recursive_mutex mutex_;
+
+    Impl() { resetWheel(); }
+
+    void resetWheel() {
+        wheel_.assign(timeout_ + 2, {});
+        for (auto& [key, transfer] : transfers_) {
+            transfer.deadline = transfer.last_timestamp + timeout_ + 1;
+            wheel_[transfer.deadline % wheel_.size()].push_back(key);
+        }
+    }
+
+    void schedule(uint64_t key, PendingTransfer& transfer) {
+        uint64_t deadline = transfer.last_timestamp + timeout_ + 1;
+        if (deadline == transfer.deadline)
+            return;
+        transfer.deadline = deadline;
+        wheel_[deadline % wheel_.size()].push_back(key);
+    }
+
+    void expireSlot(std::vector<uint64_t>& slot, uint64_t now) {
+        for (uint64_t key : slot) {
+            auto it = transfers_.find(key);
+            if (it != transfers_.end() && it->second.deadline <= now)
+                transfers_.erase(it);
+        }
+        slot.clear();
+    }
+
+    void advance(uint64_t now) {
+        if (!started_) {
+            started_ = true;
+            current_tick_ = now;
+            return;
+        }
+        if (now <= current_tick_)
+            return;
+        uint64_t steps = std::min<uint64_t>(now - current_tick_, wheel_.size());
+        for (uint64_t i = 1; i <= steps; i++)
+            expireSlot(wheel_[(current_tick_ + i) % wheel_.size()], now);
+        current_tick_ = now;
+    }
 };
 
 PropertyChunkManager::PropertyChunkManager() : pimpl_(std::make_unique<Impl>()) {}
@@ -27,80 +80,96 @@ PropertyChunkManager::PropertyChunkManager() : pimpl_(std::make_unique<Impl>())
 PropertyChunkManager::~PropertyChunkManager() = default;
 
 void PropertyChunkManager::addPendingChunk(uint64_t timestamp, uint32_t source_muid, uint8_t request_id,
-                                            const std::vector<uint8_t>& header, const std::vector<uint8_t>& data) {
+                                            std::span<const uint8_t> header, std::span<const uint8_t> data,
+                                            uint16_t num_chunks) {
     std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
-    
-    auto it = std::find_if(pimpl_->chunks_.begin(), pimpl_->chunks_.end(),
-        [&](const Chunk& chunk) {
-            return chunk.source_muid == source_muid && chunk.request_id == request_id;
-        });
-    
-    if (it != pimpl_->chunks_.end()) {
-        it->data.insert(it->data.end(), data.begin(), data.end());
-    } else {
-        pimpl_->chunks_.emplace_back(timestamp, source_muid, request_id, header, data);
+    pimpl_->advance(timestamp);
+
+    uint64_t key = transfer_key(source_muid, request_id);
+    auto [it, inserted] = pimpl_->transfers_.try_emplace(key);
+    auto& transfer = it->second;
+    if (inserted) {
+        transfer.header.assign(header.begin(), header.end());
+        // The sender fills every chunk but the last one, so the first chunk tells the chunk size.
+        if (num_chunks > 1)
+            transfer.data.reserve(std::min(static_cast<size_t>(num_chunks) * data.size(), MAX_PREALLOCATION_SIZE));
     }
+    transfer.data.insert(transfer.data.end(), data.begin(), data.end());
+    transfer.last_timestamp = timestamp;
+    pimpl_->schedule(key, transfer);
 }
 
-std::pair<std::vector<uint8_t>, std::vector<uint8_t>> 
-PropertyChunkManager::finishPendingChunk(uint32_t source_muid, uint8_t request_id, const std::vector<uint8_t>& final_data) {
+std::pair<std::vector<uint8_t>, std::vector<uint8_t>>
+PropertyChunkManager::finishPendingChunk(uint32_t source_muid, uint8_t request_id, std::span<const uint8_t> final_data) {
     std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
-    
-    auto it = std::find_if(pimpl_->chunks_.begin(), pimpl_->chunks_.end(),
-        [&](const Chunk& chunk) {
-            return chunk.source_muid == source_muid && chunk.request_id == request_id;
-        });
-    
-    if (it != pimpl_->chunks_.end()) {
-        it->data.insert(it->data.end(), final_data.begin(), final_data.end());
-        
-        std::pair<std::vector<uint8_t>, std::vector<uint8_t>> result = {it->header, it->data};
-        pimpl_->chunks_.erase(it);
+
+    auto it = pimpl_->transfers_.find(transfer_key(source_muid, request_id));
+    if (it != pimpl_->transfers_.end()) {
+        it->second.data.insert(it->second.data.end(), final_data.begin(), final_data.end());
+
+        std::pair<std::vector<uint8_t>, std::vector<uint8_t>> result = {std::move(it->second.header), std::move(it->second.data)};
+        pimpl_->transfers_.erase(it);
         return result;
     }
-    
-    return {{}, final_data};
+
+    return {{}, std::vector<uint8_t>(final_data.begin(), final_data.end())};
+}
+
+void PropertyChunkManager::discard(uint32_t source_muid, uint8_t request_id) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    // its wheel entry is skipped when the slot comes up
+    pimpl_->transfers_.erase(transfer_key(source_muid, request_id));
 }
 
 bool PropertyChunkManager::hasPendingChunk(uint32_t source_muid, uint8_t request_id) const {
     std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
-    
-    auto it = std::find_if(pimpl_->chunks_.begin(), pimpl_->chunks_.end(),
-        [&](const Chunk& chunk) {
-            return chunk.source_muid == source_muid && chunk.request_id == request_id;
-        });
-    
-    return it != pimpl_->chunks_.end();
+    return pimpl_->transfers_.contains(transfer_key(source_muid, request_id));
 }
 
 std::vector<uint8_t> PropertyChunkManager::getPendingHeader(uint32_t source_muid, uint8_t request_id) const {
     std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
-    
-    auto it = std::find_if(pimpl_->chunks_.begin(), pimpl_->chunks_.end(),
-        [&](const Chunk& chunk) {
-            return chunk.source_muid == source_muid && chunk.request_id == request_id;
-        });
-    
-    if (it != pimpl_->chunks_.end()) {
-        return it->header;
+
+    auto it = pimpl_->transfers_.find(transfer_key(source_muid, request_id));
+    if (it != pimpl_->transfers_.end()) {
+        return it->second.header;
     }
     return {};
 }
 
+size_t PropertyChunkManager::getPendingChunkCount() const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    return pimpl_->transfers_.size();
+}
+
+void PropertyChunkManager::expireChunks(uint64_t timestamp) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    pimpl_->advance(timestamp);
+}
+
+uint64_t PropertyChunkManager::getTimeout() const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    return pimpl_->timeout_;
+}
+
+void PropertyChunkManager::setTimeout(uint64_t timeout_seconds) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    pimpl_->timeout_ = timeout_seconds;
+    pimpl_->resetWheel();
+}
+
 void PropertyChunkManager::cleanupExpiredChunks(uint64_t current_timestamp, uint64_t timeout_seconds) {
     std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
-    
-    auto it = std::remove_if(pimpl_->chunks_.begin(), pimpl_->chunks_.end(),
-        [&](const Chunk& chunk) {
-            return (current_timestamp - chunk.timestamp) > timeout_seconds;
-        });
-    
-    pimpl_->chunks_.erase(it, pimpl_->chunks_.end());
+
+    std::erase_if(pimpl_->transfers_, [&](const auto& entry) {
+        return (current_timestamp - entry.second.last_timestamp) > timeout_seconds;
+    });
 }
 
 void PropertyChunkManager::clearAllChunks() {
     std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
-    pimpl_->chunks_.clear();
+    pimpl_->transfers_.clear();
+    for (auto& slot : pimpl_->wheel_)
+        slot.clear();
 }
 
 } // namespace
@@ -3,34 +3,416 @@
 #include <mutex>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
+#include <future>
+#include <chrono>
 
 namespace midicci {
 
-class PropertyClientFacade::Impl {
+namespace {
+
+// Messages are not copyable; the copy shares the body with the original.
+std::shared_ptr<const GetPropertyDataReply> copyReply(const GetPropertyDataReply& reply) {
+    return std::make_shared<GetPropertyDataReply>(reply.getCommon(), reply.getRequestId(), reply.getHeader(), reply.getSharedBody());
+}
+
+std::shared_ptr<const SetPropertyDataReply> copyReply(const SetPropertyDataReply& reply) {
+    return std::make_shared<SetPropertyDataReply>(reply.getCommon(), reply.getRequestId(), reply.getHeader());
+}
+
+// Fails the task if the facade drops its callback without calling it.
+template <typename Reply>
+struct TaskCompleter {
+    PropertyRequestTask<std::shared_ptr<const Reply>> task;
+    ~TaskCompleter() {
+        if (task.isValid())
+            task.setException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+    }
+};
+
+template <typename Reply>
+std::function<void(const Reply&)> completeTaskCallback(PropertyRequestTask<std::shared_ptr<const Reply>> task) {
+    auto completer = std::make_shared<TaskCompleter<Reply>>();
+    completer->task = std::move(task);
+    return [completer](const Reply& reply) { completer->task.setValue(copyReply(reply)); };
+}
+
+// A list property being fetched page by page by getPaginatedPropertyData().
+struct PaginatedFetch {
+    std::string resource;
+    std::string res_id;
+    std::string encoding;
+    size_t page_size;
+    PropertyClientFacade::PropertyListPageCallback on_page;
+    PropertyClientFacade::PropertyListCompletionCallback on_complete;
+    // the list as assembled so far; it grows as pages arrive, never beyond total_count
+    JsonArray entries;
+    // as told by the first page, lowered when a page comes back empty
+    size_t total_count{0};
+    // pages requested and not received yet
+    size_t pending_pages{1};
+    // the first entry of the next page to request
+    size_t next_offset{0};
+    bool finished{false};
+};
+
+} // namespace
+
+// Shared so that a task's canceller can keep it alive while it runs, even if the facade is being
+// destroyed on another thread.
+class PropertyClientFacade::Impl : public std::enable_shared_from_this<PropertyClientFacade::Impl> {
 public:
     Impl(MidiCIDevice& device, ClientConnection& conn) : device_(device), conn_(conn),
-          property_rules_(std::make_unique<CommonRulesPropertyClient>(device, conn)) {
+          property_rules_(std::make_unique<CommonRulesPropertyClient>(device, conn)),
+          scheduler_([this](const PropertyMessage& msg) { send(msg); },
+                     device.getConfig().max_simultaneous_property_requests) {
         properties_ = std::make_unique<ClientObservablePropertyList>(property_rules_.get());
+        scheduler_.setFailureHandler([this](const PropertyMessage& msg) { failRequest(msg); });
     }
 
     MidiCIDevice& device_;
     ClientConnection& conn_;
     std::unique_ptr<MidiCIClientPropertyRules> property_rules_;
     std::unique_ptr<ClientObservablePropertyList> properties_;
-    std::unordered_map<uint8_t, std::vector<uint8_t>> open_requests_;
-    std::unordered_map<std::string, std::vector<uint8_t>> cached_properties_;
+    std::unordered_map<std::string, SharedBytes> cached_properties_;
     std::vector<std::unique_ptr<PropertyMetadata>> metadata_list_;
     std::vector<ClientSubscription> subscriptions_;
     std::vector<PropertyClientFacade::SubscriptionUpdateCallback> subscription_update_callbacks_;
-    std::unordered_map<uint8_t, PropertyClientFacade::GetPropertyDataCallback> pending_get_property_callbacks_;
+    // more than one callback per request when identical GETs were folded into one
+    std::unordered_map<uint8_t, std::vector<PropertyClientFacade::GetPropertyDataCallback>> pending_get_property_callbacks_;
     std::unordered_map<uint8_t, PropertyClientFacade::SetPropertyDataCallback> pending_set_property_callbacks_;
     PropertyChunkManager pending_chunk_manager_;
+    PropertyRequestScheduler scheduler_;
+    // how many callers wait for each GET/SET request; cancelled tasks give up their share
+    std::unordered_map<uint8_t, int> request_waiters_;
+    // GETs of single pages issued by getPaginatedPropertyData(), whose replies are not property values
+    std::unordered_set<uint8_t> page_requests_;
     mutable std::recursive_mutex mutex_;
+    // how many Locks the thread holding mutex_ has taken
+    int lock_depth_{0};
+
+    // Taken by the public methods that may queue requests. Queued requests are sent once the outermost
+    // of them unlocks, so the transport (which may deliver the reply inline) never runs with the facade locked.
+    class Lock {
+    public:
+        explicit Lock(Impl& impl) : impl_(impl) {
+            impl_.mutex_.lock();
+            impl_.lock_depth_++;
+        }
+        ~Lock() {
+            if (locked_) {
+                impl_.lock_depth_--;
+                impl_.mutex_.unlock();
+            }
+        }
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+        void unlockAndDispatch() {
+            bool outermost = --impl_.lock_depth_ == 0;
+            locked_ = false;
+            impl_.mutex_.unlock();
+            if (outermost)
+                impl_.scheduler_.dispatch();
+        }
+
+    private:
+        Impl& impl_;
+        bool locked_{true};
+    };
+
+    Common createCommon() const {
+        return Common(device_.getMuid(), conn_.getTargetMuid(), 0x7F, 0);
+    }
+
+    // make_callback (if any) is called with the ID of the request that the caller ends up waiting for.
+    template <typename Reply>
+    using CallbackFactory = std::function<std::function<void(const Reply&)>(uint8_t request_id)>;
+
+    uint8_t enqueueGetPropertyData(const std::string& resource, const std::string& res_id, const std::string& encoding,
+                                   int paginate_offset, int paginate_limit, CallbackFactory<GetPropertyDataReply> make_callback) {
+        auto request_id = scheduler_.allocateRequestId();
+
+        if (!property_rules_) return request_id;
+
+        std::map<std::string, std::string> fields;
+        if (!res_id.empty()) fields["resId"] = res_id;
+        if (!encoding.empty()) fields["mutualEncoding"] = encoding;
+        fields["setPartial"] = "false";
+        if (paginate_offset >= 0) fields["offset"] = std::to_string(paginate_offset);
+        if (paginate_limit >= 0) fields["limit"] = std::to_string(paginate_limit);
+
+        auto header = property_rules_->createDataRequestHeader(resource, fields);
+        if (header.empty()) {
+            device_.getLogger()(LogData("Failed to create request header for resource: " + resource, true));
+            return request_id;
+        }
+
+        auto msg = std::make_shared<GetPropertyData>(createCommon(), request_id, std::move(header));
+        if (auto pending = scheduler_.findPending(*msg)) {
+            request_waiters_[*pending]++;
+            if (make_callback)
+                pending_get_property_callbacks_[*pending].push_back(make_callback(*pending));
+            return *pending;
+        }
+        // registered before sending, as the reply may arrive before enqueue() returns
+        request_waiters_[request_id]++;
+        if (make_callback)
+            pending_get_property_callbacks_[request_id].push_back(make_callback(request_id));
+        scheduler_.queue(std::move(msg));
+        return request_id;
+    }
+
+    uint8_t enqueueSetPropertyData(const std::string& resource, const std::string& res_id, const std::vector<uint8_t>& data,
+                                   const std::string& encoding, bool is_partial, CallbackFactory<SetPropertyDataReply> make_callback) {
+        auto request_id = scheduler_.allocateRequestId();
+
+        if (!property_rules_) return request_id;
+
+        std::map<std::string, std::string> fields;
+        if (!res_id.empty()) fields["resId"] = res_id;
+        if (!encoding.empty()) fields["mutualEncoding"] = encoding;
+        fields["setPartial"] = is_partial ? "true" : "false";
+
+        auto header = property_rules_->createDataRequestHeader(resource, fields);
+        auto encoded_body = property_rules_->encodeBody(data, encoding);
+
+        request_waiters_[request_id]++;
+        if (make_callback)
+            pending_set_property_callbacks_[request_id] = make_callback(request_id);
+        scheduler_.queue(std::make_shared<SetPropertyData>(createCommon(), request_id, std::move(header), std::move(encoded_body)));
+        return request_id;
+    }
+
+    void propertyValueReceived(const std::string& property_id, const std::string& res_id, const SharedBytes& body,
+                               const Common& reply_common) {
+        if (properties_) {
+            properties_->setPropertyValue(property_id, res_id, body, false);
+        }
+
+        property_rules_->propertyValueUpdated(property_id, body);
+        cached_properties_[property_id] = body;
+
+        if (property_id == commonproperties::StandardPropertyNames::ALL_CTRL_LIST) {
+            conn_.setAllCtrlListReceived(true);
+
+            auto features = conn_.getProcessInquirySupportedFeatures();
+            if (features & static_cast<uint8_t>(MidiCIProcessInquiryFeatures::MIDI_MESSAGE_REPORT)) {
+                device_.getMessenger().sendMidiMessageReportInquiry(
+                    reply_common.group,
+                    reply_common.address,
+                    reply_common.source_muid,
+                    static_cast<uint8_t>(MidiMessageReportDataControl::Full),
+                    static_cast<uint8_t>(MidiMessageReportChannelControllerFlags::All),
+                    static_cast<uint8_t>(MidiMessageReportChannelControllerFlags::All),
+                    0
+                );
+            }
+        }
+    }
+
+    // Returns false if the page could not be requested (e.g. no request ID is free).
+    bool requestPage(const std::shared_ptr<PaginatedFetch>& fetch, size_t offset, size_t limit) {
+        bool queued = false;
+        try {
+            enqueueGetPropertyData(fetch->resource, fetch->res_id, fetch->encoding, static_cast<int>(offset),
+                                   static_cast<int>(limit), [this, fetch, offset, limit, &queued](uint8_t request_id) {
+                queued = true;
+                page_requests_.insert(request_id);
+                return [this, fetch, offset, limit](const GetPropertyDataReply& reply) {
+                    pageReceived(fetch, offset, limit, reply);
+                };
+            });
+        } catch (const std::exception& e) {
+            device_.getLogger()(LogData("Could not request page of " + fetch->resource + " at offset " +
+                                        std::to_string(offset) + ": " + e.what(), true));
+        }
+        return queued;
+    }
+
+    void pageReceived(const std::shared_ptr<PaginatedFetch>& fetch, size_t offset, size_t limit,
+                      const GetPropertyDataReply& reply) {
+        if (fetch->finished || !property_rules_)
+            return;
+        auto status = property_rules_->getHeaderFieldInteger(reply.getHeader(), PropertyCommonHeaderKeys::STATUS);
+        if (status != PropertyExchangeStatus::OK) {
+            finishFetch(fetch, status, reply.getCommon());
+            return;
+        }
+        auto body = property_rules_->decodeBody(reply.getHeader(), reply.getBody());
+        auto page = JsonValue::parseOrNull(std::string(body.begin(), body.end()));
+        if (!page.isArray()) {
+            device_.getLogger()(LogData("Page of " + fetch->resource + " at offset " + std::to_string(offset) + " is not a list", true));
+            finishFetch(fetch, PropertyExchangeStatus::INTERNAL_ERROR, reply.getCommon());
+            return;
+        }
+        const auto& entries = page.asArray();
+
+        if (offset == 0) {
+            // The first page tells how many entries there are; a responder that does not paginate
+            // sends them all at once. The count is not trusted for allocation: entries only grows by
+            // what actually arrives.
+            auto total_count = property_rules_->getHeaderFieldInteger(reply.getHeader(), PropertyCommonHeaderKeys::TOTAL_COUNT);
+            fetch->total_count = total_count > 0 ? static_cast<size_t>(total_count) : entries.size();
+            fetch->next_offset = entries.size();
+        }
+        // an empty page means that the list ends there, whatever totalCount said
+        if (entries.empty())
+            fetch->total_count = std::min(fetch->total_count, offset);
+        size_t end = std::min(offset + entries.size(), fetch->total_count);
+        if (end > fetch->entries.size())
+            fetch->entries.resize(end);
+        for (size_t i = offset; i < end; i++)
+            fetch->entries[i] = entries[i - offset];
+        if (fetch->on_page)
+            fetch->on_page(offset, entries);
+        fetch->pending_pages--;
+
+        // A responder may send fewer entries than asked for (e.g. it caps the limit); the rest of
+        // this page is requested again rather than left as a hole.
+        if (offset > 0 && !entries.empty() && entries.size() < limit && end < fetch->total_count) {
+            fetch->pending_pages++;
+            if (!requestPage(fetch, end, std::min(limit - entries.size(), fetch->total_count - end)))
+                finishFetch(fetch, PropertyExchangeStatus::INTERNAL_ERROR, reply.getCommon());
+        }
+
+        // Each page takes a request ID, so only as many are requested as the window lets out at once;
+        // every reply makes room for the next one.
+        size_t window = scheduler_.getMaxInFlight();
+        while (!fetch->finished && fetch->pending_pages < window && fetch->next_offset < fetch->total_count) {
+            size_t next = fetch->next_offset;
+            size_t next_limit = std::min(fetch->page_size, fetch->total_count - next);
+            fetch->next_offset += next_limit;
+            // counted first, as the page may be answered before requestPage() returns
+            fetch->pending_pages++;
+            if (!requestPage(fetch, next, next_limit))
+                finishFetch(fetch, PropertyExchangeStatus::INTERNAL_ERROR, reply.getCommon());
+        }
+        if (fetch->pending_pages == 0)
+            finishFetch(fetch, PropertyExchangeStatus::OK, reply.getCommon());
+    }
+
+    void finishFetch(const std::shared_ptr<PaginatedFetch>& fetch, int status, const Common& reply_common) {
+        if (fetch->finished)
+            return;
+        fetch->finished = true;
+        if (status == PropertyExchangeStatus::OK) {
+            fetch->entries.resize(fetch->total_count);
+            auto json = JsonValue(std::move(fetch->entries)).serialize();
+            propertyValueReceived(fetch->resource, fetch->res_id, std::vector<uint8_t>(json.begin(), json.end()), reply_common);
+        }
+        fetch->entries.clear();
+        if (fetch->on_complete)
+            fetch->on_complete(status, fetch->total_count);
+    }
+
+    // Takes the request that msg replies to out of the scheduler, if it is one of ours.
+    std::shared_ptr<const PropertyMessage> completeRequest(const PropertyMessage& msg, MessageType request_type) {
+        auto request = scheduler_.getRequest(msg.getRequestId());
+        if (!request || request->getType() != request_type ||
+            request->getSourceMuid() != msg.getDestinationMuid() ||
+            request->getDestinationMuid() != msg.getSourceMuid())
+            return nullptr;
+        request_waiters_.erase(msg.getRequestId());
+        return scheduler_.complete(msg.getRequestId());
+    }
+
+    // A cancelled task no longer waits for request_id; withdraw the request if nobody else does
+    // and it is not sent yet.
+    void releaseRequest(uint8_t request_id) {
+        auto it = request_waiters_.find(request_id);
+        if (it == request_waiters_.end() || --it->second > 0 || !scheduler_.cancel(request_id))
+            return;
+        request_waiters_.erase(it);
+        pending_get_property_callbacks_.erase(request_id);
+        pending_set_property_callbacks_.erase(request_id);
+    }
+
+    template <typename Task>
+    Task createTask(uint8_t request_id) {
+        return Task::create(request_id, [weak = weak_from_this(), request_id] {
+            auto self = weak.lock();
+            if (!self)
+                return;
+            std::lock_guard<std::recursive_mutex> lock(self->mutex_);
+            self->releaseRequest(request_id);
+        });
+    }
+
+    // The responder asked us to retry later; returns false if the request ran out of retries. The
+    // request goes out again on a dispatch after the scheduler's retry delay (see processTimeouts()).
+    bool retryIfTooManyRequests(const PropertyMessage& msg) {
+        if (!property_rules_ ||
+            property_rules_->getHeaderFieldInteger(msg.getHeader(), "status") != PropertyExchangeStatus::TOO_MANY_REQUESTS)
+            return false;
+        auto request = scheduler_.getRequest(msg.getRequestId());
+        return request && request->getDestinationMuid() == msg.getSourceMuid() && scheduler_.requeue(msg.getRequestId());
+    }
+
+    template <typename Task>
+    Task failedTask(const std::string& resource) {
+        auto task = Task::create(std::nullopt, nullptr);
+        task.setException(std::make_exception_ptr(std::runtime_error("Could not create a request for resource: " + resource)));
+        return task;
+    }
+
+    // Called by the scheduler for every (re)transmission. A retry keeps its request ID and IDs are
+    // reused, so a partial reply to an earlier send must not be prepended to the reply to this one.
+    void send(const PropertyMessage& msg) {
+        pending_chunk_manager_.discard(msg.getDestinationMuid(), msg.getRequestId());
+        device_.getMessenger().send(msg);
+    }
+
+    // Called by the scheduler when a request got no reply after all retries.
+    void failRequest(const PropertyMessage& msg) {
+        Lock lock(*this);
+        uint8_t request_id = msg.getRequestId();
+        request_waiters_.erase(request_id);
+        page_requests_.erase(request_id);
+        device_.getLogger()(LogData("Property exchange request " + std::to_string(request_id) + " to MUID " +
+                                    std::to_string(msg.getDestinationMuid()) + " timed out", true));
+
+        Common reply_common(msg.getDestinationMuid(), msg.getSourceMuid(), msg.getCommon().address, msg.getCommon().group);
+        auto status_header = [this] {
+            return property_rules_ ? property_rules_->createStatusHeader(PropertyExchangeStatus::INTERNAL_ERROR)
+                                   : std::vector<uint8_t>{};
+        };
+        if (msg.getType() == MessageType::GetPropertyData) {
+            auto it = pending_get_property_callbacks_.find(request_id);
+            if (it != pending_get_property_callbacks_.end()) {
+                auto callbacks = std::move(it->second);
+                pending_get_property_callbacks_.erase(it);
+                GetPropertyDataReply reply(reply_common, request_id, status_header(), {});
+                for (auto& callback : callbacks)
+                    callback(reply);
+            }
+        } else if (msg.getType() == MessageType::SetPropertyData) {
+            auto it = pending_set_property_callbacks_.find(request_id);
+            if (it != pending_set_property_callbacks_.end()) {
+                auto callback = std::move(it->second);
+                pending_set_property_callbacks_.erase(it);
+                callback(SetPropertyDataReply(reply_common, request_id, status_header()));
+            }
+        } else if (msg.getType() == MessageType::SubscribeProperty) {
+            auto it = std::find_if(subscriptions_.begin(), subscriptions_.end(), [request_id](const ClientSubscription& sub) {
+                return sub.pendingRequestId == request_id && sub.state == SubscriptionActionState::Subscribing;
+            });
+            if (it != subscriptions_.end()) {
+                auto subscription = *it;
+                subscriptions_.erase(it);
+                subscription.state = SubscriptionActionState::Unsubscribed;
+                for (const auto& callback : subscription_update_callbacks_)
+                    callback(subscription);
+            }
+        }
+        // the callbacks may have issued new requests
+        lock.unlockAndDispatch();
+    }
 };
 
 PropertyClientFacade::PropertyClientFacade(MidiCIDevice& device, ClientConnection& conn) 
-    : pimpl_(std::make_unique<Impl>(device, conn)) {}
+    : pimpl_(std::make_shared<Impl>(device, conn)) {}
 
 PropertyClientFacade::~PropertyClientFacade() = default;
 
@@ -45,88 +427,95 @@ MidiCIClientPropertyRules* PropertyClientFacade::getPropertyRules() {
 }
 
 uint8_t PropertyClientFacade::sendGetPropertyData(const std::string& resource, const std::string& res_id, const std::string& encoding, int paginate_offset, int paginate_limit) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
-
-    auto request_id = pimpl_->device_.getMessenger().getNextRequestId();
-
-    if (!pimpl_->property_rules_) return request_id;
-
-    std::map<std::string, std::string> fields;
-    if (!res_id.empty()) fields["resId"] = res_id;
-    if (!encoding.empty()) fields["mutualEncoding"] = encoding;
-    fields["setPartial"] = "false";
-    if (paginate_offset >= 0) fields["offset"] = std::to_string(paginate_offset);
-    if (paginate_limit >= 0) fields["limit"] = std::to_string(paginate_limit);
-
-    auto header = pimpl_->property_rules_->createDataRequestHeader(resource, fields);
-    if (header.empty()) {
-        pimpl_->device_.getLogger()(LogData("Failed to create request header for resource: " + resource, true));
-        return request_id;
-    }
-
-    GetPropertyData msg(
-        Common(pimpl_->device_.getMuid(), pimpl_->conn_.getTargetMuid(), 0x7F, 0),
-        request_id, header
-    );
-
-    sendGetPropertyData(msg);
+    Impl::Lock lock(*pimpl_);
+    auto request_id = pimpl_->enqueueGetPropertyData(resource, res_id, encoding, paginate_offset, paginate_limit, nullptr);
+    lock.unlockAndDispatch();
     return request_id;
 }
 
-void PropertyClientFacade::sendGetPropertyData(const GetPropertyData& msg) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
-    
-    pimpl_->open_requests_[msg.getRequestId()] = msg.serialize(pimpl_->device_.getConfig())[0];
-    pimpl_->device_.getMessenger().send(msg);
+uint8_t PropertyClientFacade::sendGetPropertyData(const GetPropertyData& msg) {
+    Impl::Lock lock(*pimpl_);
+    auto request_id = pimpl_->scheduler_.isPending(msg.getRequestId()) ? pimpl_->scheduler_.allocateRequestId() : msg.getRequestId();
+    pimpl_->scheduler_.queue(std::make_shared<GetPropertyData>(msg.getCommon(), request_id, msg.getHeader()));
+    lock.unlockAndDispatch();
+    return request_id;
 }
 
 uint8_t PropertyClientFacade::sendSetPropertyData(const std::string& resource, const std::string& res_id, const std::vector<uint8_t>& data, const std::string& encoding, bool is_partial) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
-
-    auto request_id = pimpl_->device_.getMessenger().getNextRequestId();
-
-    if (!pimpl_->property_rules_) return request_id;
-
-    std::map<std::string, std::string> fields;
-    if (!res_id.empty()) fields["resId"] = res_id;
-    if (!encoding.empty()) fields["mutualEncoding"] = encoding;
-    fields["setPartial"] = is_partial ? "true" : "false";
-
-    auto header = pimpl_->property_rules_->createDataRequestHeader(resource, fields);
-    auto encoded_body = pimpl_->property_rules_->encodeBody(data, encoding);
-
-    SetPropertyData msg(
-        Common(pimpl_->device_.getMuid(), pimpl_->conn_.getTargetMuid(), 0x7F, 0),
-        request_id, header, encoded_body
-    );
-
-    sendSetPropertyData(msg);
+    Impl::Lock lock(*pimpl_);
+    auto request_id = pimpl_->enqueueSetPropertyData(resource, res_id, data, encoding, is_partial, nullptr);
+    lock.unlockAndDispatch();
     return request_id;
 }
 
-void PropertyClientFacade::sendSetPropertyData(const SetPropertyData& msg) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
-
-    pimpl_->open_requests_[msg.getRequestId()] = msg.serialize(pimpl_->device_.getConfig())[0];
-    pimpl_->device_.getMessenger().send(msg);
+uint8_t PropertyClientFacade::sendSetPropertyData(const SetPropertyData& msg) {
+    Impl::Lock lock(*pimpl_);
+    auto request_id = pimpl_->scheduler_.isPending(msg.getRequestId()) ? pimpl_->scheduler_.allocateRequestId() : msg.getRequestId();
+    pimpl_->scheduler_.queue(std::make_shared<SetPropertyData>(msg.getCommon(), request_id, msg.getHeader(), msg.getSharedBody()));
+    lock.unlockAndDispatch();
+    return request_id;
 }
 
 void PropertyClientFacade::getPropertyData(const std::string& resource, const std::string& res_id, GetPropertyDataCallback callback, const std::string& encoding, int paginate_offset, int paginate_limit) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
-
-    auto request_id = sendGetPropertyData(resource, res_id, encoding, paginate_offset, paginate_limit);
-    pimpl_->pending_get_property_callbacks_[request_id] = std::move(callback);
+    Impl::Lock lock(*pimpl_);
+    pimpl_->enqueueGetPropertyData(resource, res_id, encoding, paginate_offset, paginate_limit,
+                                   [&callback](uint8_t) { return std::move(callback); });
+    lock.unlockAndDispatch();
 }
 
 void PropertyClientFacade::setPropertyData(const std::string& resource, const std::string& res_id, const std::vector<uint8_t>& data, SetPropertyDataCallback callback, const std::string& encoding, bool is_partial) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    Impl::Lock lock(*pimpl_);
+    pimpl_->enqueueSetPropertyData(resource, res_id, data, encoding, is_partial,
+                                   [&callback](uint8_t) { return std::move(callback); });
+    lock.unlockAndDispatch();
+}
+
+PropertyClientFacade::GetPropertyDataTask PropertyClientFacade::getPropertyDataAsync(const std::string& resource, const std::string& res_id, const std::string& encoding, int paginate_offset, int paginate_limit) {
+    Impl::Lock lock(*pimpl_);
+    GetPropertyDataTask task;
+    pimpl_->enqueueGetPropertyData(resource, res_id, encoding, paginate_offset, paginate_limit, [&](uint8_t request_id) {
+        task = pimpl_->createTask<GetPropertyDataTask>(request_id);
+        return completeTaskCallback(task);
+    });
+    if (!task.isValid())
+        task = pimpl_->failedTask<GetPropertyDataTask>(resource);
+    lock.unlockAndDispatch();
+    return task;
+}
+
+PropertyClientFacade::SetPropertyDataTask PropertyClientFacade::setPropertyDataAsync(const std::string& resource, const std::string& res_id, const std::vector<uint8_t>& data, const std::string& encoding, bool is_partial) {
+    Impl::Lock lock(*pimpl_);
+    SetPropertyDataTask task;
+    pimpl_->enqueueSetPropertyData(resource, res_id, data, encoding, is_partial, [&](uint8_t request_id) {
+        task = pimpl_->createTask<SetPropertyDataTask>(request_id);
+        return completeTaskCallback(task);
+    });
+    if (!task.isValid())
+        task = pimpl_->failedTask<SetPropertyDataTask>(resource);
+    lock.unlockAndDispatch();
+    return task;
+}
 
-    auto request_id = sendSetPropertyData(resource, res_id, data, encoding, is_partial);
-    pimpl_->pending_set_property_callbacks_[request_id] = std::move(callback);
+void PropertyClientFacade::getPaginatedPropertyData(const std::string& resource, const std::string& res_id, size_t page_size,
+                                                    PropertyListPageCallback on_page, PropertyListCompletionCallback on_complete,
+                                                    const std::string& encoding) {
+    if (page_size == 0)
+        throw std::invalid_argument("Page size must not be zero");
+    Impl::Lock lock(*pimpl_);
+    auto fetch = std::make_shared<PaginatedFetch>();
+    fetch->resource = resource;
+    fetch->res_id = res_id;
+    fetch->encoding = encoding;
+    fetch->page_size = page_size;
+    fetch->on_page = std::move(on_page);
+    fetch->on_complete = std::move(on_complete);
+    if (!pimpl_->requestPage(fetch, 0, page_size))
+        pimpl_->finishFetch(fetch, PropertyExchangeStatus::INTERNAL_ERROR, pimpl_->createCommon());
+    lock.unlockAndDispatch();
 }
 
 void PropertyClientFacade::sendSubscribeProperty(const std::string& resource, const std::string& res_id, const std::string& mutual_encoding, const std::string& subscription_id) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    Impl::Lock lock(*pimpl_);
     
     if (!pimpl_->property_rules_) return;
     
@@ -137,21 +526,19 @@ void PropertyClientFacade::sendSubscribeProperty(const std::string& resource, co
     
     auto header = pimpl_->property_rules_->createSubscriptionHeader(resource, fields);
     
-    auto request_id = pimpl_->device_.getMessenger().getNextRequestId();
+    auto request_id = pimpl_->scheduler_.allocateRequestId();
     
-    SubscribeProperty msg(
-        Common(pimpl_->device_.getMuid(), pimpl_->conn_.getTargetMuid(), 0x7F, 0),
-        request_id, header, {}
-    );
+    auto msg = std::make_shared<SubscribeProperty>(pimpl_->createCommon(), request_id, std::move(header), std::vector<uint8_t>{});
     
     // Create pending subscription entry before sending (like Kotlin implementation)
     addPendingSubscription(request_id, subscription_id, resource, res_id);
     
-    pimpl_->device_.getMessenger().send(msg);
+    pimpl_->scheduler_.queue(std::move(msg));
+    lock.unlockAndDispatch();
 }
 
 void PropertyClientFacade::sendUnsubscribeProperty(const std::string& property_id, const std::string& res_id) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    Impl::Lock lock(*pimpl_);
     
     if (!pimpl_->property_rules_) return;
     
@@ -169,7 +556,7 @@ void PropertyClientFacade::sendUnsubscribeProperty(const std::string& property_i
         return;
     }
     
-    auto new_request_id = pimpl_->device_.getMessenger().getNextRequestId();
+    auto new_request_id = pimpl_->scheduler_.allocateRequestId();
     
     std::map<std::string, std::string> fields;
     fields["command"] = MidiCISubscriptionCommand::END;
@@ -181,135 +568,90 @@ void PropertyClientFacade::sendUnsubscribeProperty(const std::string& property_i
     
     auto header = pimpl_->property_rules_->createSubscriptionHeader(property_id, fields);
     
-    SubscribeProperty msg(
-        Common(pimpl_->device_.getMuid(), pimpl_->conn_.getTargetMuid(), 0x7F, 0),
-        new_request_id, header, {}
-    );
+    auto msg = std::make_shared<SubscribeProperty>(pimpl_->createCommon(), new_request_id, std::move(header), std::vector<uint8_t>{});
     
     // Update subscription state to Unsubscribing before sending (like Kotlin implementation)
     promoteSubscriptionAsUnsubscribing(property_id, res_id, new_request_id);
     
-    pimpl_->device_.getMessenger().send(msg);
+    pimpl_->scheduler_.queue(std::move(msg));
+    lock.unlockAndDispatch();
 }
 
 void PropertyClientFacade::processPropertyCapabilitiesReply(const PropertyGetCapabilitiesReply& msg) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    Impl::Lock lock(*pimpl_);
     
+    pimpl_->scheduler_.setMaxInFlight(msg.getMaxSimultaneousRequests());
     if (pimpl_->property_rules_) {
         pimpl_->property_rules_->requestPropertyList(msg.getCommon().group);
     }
+    lock.unlockAndDispatch();
 }
 
 void PropertyClientFacade::processGetDataReply(const GetPropertyDataReply& msg) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    Impl::Lock lock(*pimpl_);
 
-    auto it = pimpl_->open_requests_.find(msg.getRequestId());
-    if (it != pimpl_->open_requests_.end()) {
-        const auto& data = it->second;
-        if (data.size() >= 16) {
-            uint32_t source_muid = CIRetrieval::getSourceMuid(data);
-            uint32_t dest_muid = CIRetrieval::getDestinationMuid(data);
-            uint8_t request_id = data[13];
-            std::vector<uint8_t> header = CIRetrieval::getPropertyHeader(data);
-
-            Common common(source_muid, dest_muid, 0x7F, 0);
-            GetPropertyData stored_request(common, request_id, header);
-
-            if (stored_request.getCommon().source_muid == msg.getCommon().destination_muid &&
-                stored_request.getCommon().destination_muid == msg.getCommon().source_muid) {
-
-                auto callback_it = pimpl_->pending_get_property_callbacks_.find(msg.getRequestId());
-                if (callback_it != pimpl_->pending_get_property_callbacks_.end()) {
-                    auto callback = std::move(callback_it->second);
-                    pimpl_->pending_get_property_callbacks_.erase(callback_it);
-                    callback(msg);
-                }
-
-                if (pimpl_->property_rules_) {
-                    auto status = pimpl_->property_rules_->getHeaderFieldInteger(msg.getHeader(), "status");
-                    if (status == 200) {
-                        auto property_id = pimpl_->property_rules_->getPropertyIdForHeader(stored_request.getHeader());
-                        auto res_id = pimpl_->property_rules_->getHeaderFieldString(stored_request.getHeader(), "resId");
-
-                        auto media_type = pimpl_->property_rules_->getHeaderFieldString(msg.getHeader(), "mediaType");
-                        if (media_type.empty()) {
-                            media_type = "application/json";
-                        }
-
-                        if (pimpl_->properties_) {
-                            pimpl_->properties_->setPropertyValue(property_id, res_id, msg.getBody(), false);
-                        }
-
-                        pimpl_->property_rules_->propertyValueUpdated(property_id, msg.getBody());
-                        pimpl_->cached_properties_[property_id] = msg.getBody();
-
-                        if (property_id == commonproperties::StandardPropertyNames::ALL_CTRL_LIST) {
-                            pimpl_->conn_.setAllCtrlListReceived(true);
-
-                            auto features = pimpl_->conn_.getProcessInquirySupportedFeatures();
-                            if (features & static_cast<uint8_t>(MidiCIProcessInquiryFeatures::MIDI_MESSAGE_REPORT)) {
-                                pimpl_->device_.getMessenger().sendMidiMessageReportInquiry(
-                                    msg.getCommon().group,
-                                    msg.getCommon().address,
-                                    msg.getSourceMuid(),
-                                    static_cast<uint8_t>(MidiMessageReportDataControl::Full),
-                                    static_cast<uint8_t>(MidiMessageReportChannelControllerFlags::All),
-                                    static_cast<uint8_t>(MidiMessageReportChannelControllerFlags::All),
-                                    0
-                                );
-                            }
-                        }
-                    }
-                }
-
-                pimpl_->open_requests_.erase(it);
-            }
+    if (pimpl_->retryIfTooManyRequests(msg)) {
+        lock.unlockAndDispatch();
+        return;
+    }
+    auto request = pimpl_->completeRequest(msg, MessageType::GetPropertyData);
+    if (!request)
+        return;
+
+    auto callback_it = pimpl_->pending_get_property_callbacks_.find(msg.getRequestId());
+    if (callback_it != pimpl_->pending_get_property_callbacks_.end()) {
+        auto callbacks = std::move(callback_it->second);
+        pimpl_->pending_get_property_callbacks_.erase(callback_it);
+        for (auto& callback : callbacks)
+            callback(msg);
+    }
+
+    // A page of getPaginatedPropertyData() is not the property value; the fetch takes care of it.
+    // Other GETs with offset and limit (e.g. from a property inspector) are stored as they are.
+    bool is_page = pimpl_->page_requests_.erase(msg.getRequestId()) > 0;
+    if (pimpl_->property_rules_ && !is_page) {
+        auto status = pimpl_->property_rules_->getHeaderFieldInteger(msg.getHeader(), "status");
+        if (status == 200) {
+            auto property_id = pimpl_->property_rules_->getPropertyIdForHeader(request->getHeader());
+            auto res_id = pimpl_->property_rules_->getHeaderFieldString(request->getHeader(), "resId");
+            pimpl_->propertyValueReceived(property_id, res_id, msg.getSharedBody(), msg.getCommon());
         }
     }
+
+    lock.unlockAndDispatch();
 }
 
 void PropertyClientFacade::processSetDataReply(const SetPropertyDataReply& msg) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    Impl::Lock lock(*pimpl_);
 
-    auto it = pimpl_->open_requests_.find(msg.getRequestId());
-    if (it != pimpl_->open_requests_.end()) {
-        const auto& data = it->second;
-        if (data.size() >= 18) {
-            uint32_t source_muid = CIRetrieval::getSourceMuid(data);
-            uint32_t dest_muid = CIRetrieval::getDestinationMuid(data);
-            uint8_t request_id = data[13];
-            std::vector<uint8_t> header = CIRetrieval::getPropertyHeader(data);
-            std::vector<uint8_t> body = CIRetrieval::getPropertyBodyInThisChunk(data);
-
-            Common common(source_muid, dest_muid, 0x7F, 0);
-            SetPropertyData stored_request(common, request_id, header, body);
-
-            if (stored_request.getCommon().source_muid == msg.getCommon().destination_muid &&
-                stored_request.getCommon().destination_muid == msg.getCommon().source_muid) {
-
-                auto callback_it = pimpl_->pending_set_property_callbacks_.find(msg.getRequestId());
-                if (callback_it != pimpl_->pending_set_property_callbacks_.end()) {
-                    auto callback = std::move(callback_it->second);
-                    pimpl_->pending_set_property_callbacks_.erase(callback_it);
-                    callback(msg);
-                }
-
-                if (pimpl_->property_rules_) {
-                    auto status = pimpl_->property_rules_->getHeaderFieldInteger(msg.getHeader(), "status");
-                    if (status == 200) {
-                        auto property_id = pimpl_->property_rules_->getPropertyIdForHeader(stored_request.getHeader());
-                        pimpl_->property_rules_->propertyValueUpdated(property_id, {});
-                    }
-                }
-
-                pimpl_->open_requests_.erase(it);
-            }
+    if (pimpl_->retryIfTooManyRequests(msg)) {
+        lock.unlockAndDispatch();
+        return;
+    }
+    auto request = pimpl_->completeRequest(msg, MessageType::SetPropertyData);
+    if (!request)
+        return;
+
+    auto callback_it = pimpl_->pending_set_property_callbacks_.find(msg.getRequestId());
+    if (callback_it != pimpl_->pending_set_property_callbacks_.end()) {
+        auto callback = std::move(callback_it->second);
+        pimpl_->pending_set_property_callbacks_.erase(callback_it);
+        callback(msg);
+    }
+
+    if (pimpl_->property_rules_) {
+        auto status = pimpl_->property_rules_->getHeaderFieldInteger(msg.getHeader(), "status");
+        if (status == 200) {
+            auto property_id = pimpl_->property_rules_->getPropertyIdForHeader(request->getHeader());
+            pimpl_->property_rules_->propertyValueUpdated(property_id, {});
         }
     }
+
+    lock.unlockAndDispatch();
 }
 
 SubscribePropertyReply PropertyClientFacade::processSubscribeProperty(const SubscribeProperty& msg) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    Impl::Lock lock(*pimpl_);
     
     if (!pimpl_->property_rules_) {
         // Return error reply if no property rules
@@ -334,6 +676,7 @@ SubscribePropertyReply PropertyClientFacade::processSubscribeProperty(const Subs
             auto res_id = pimpl_->property_rules_->getResIdForHeader(msg.getHeader());
             sendGetPropertyData(property_id, res_id);
         }
+        lock.unlockAndDispatch();
         
         return std::move(result.second);
     }
@@ -398,7 +741,7 @@ std::pair<std::string, SubscribePropertyReply> PropertyClientFacade::updatePrope
         auto property_id = pimpl_->property_rules_->getSubscribedProperty(msg);
         if (!property_id.empty()) {
             pimpl_->property_rules_->propertyValueUpdated(property_id, msg.getBody());
-            pimpl_->cached_properties_[property_id] = msg.getBody();
+            pimpl_->cached_properties_[property_id] = msg.getSharedBody();
         }
     }
     
@@ -411,7 +754,12 @@ std::pair<std::string, SubscribePropertyReply> PropertyClientFacade::updatePrope
 }
 
 void PropertyClientFacade::processSubscribePropertyReply(const SubscribePropertyReply& msg) {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    {
+        Impl::Lock lock(*pimpl_);
+        if (pimpl_->completeRequest(msg, MessageType::SubscribeProperty))
+            lock.unlockAndDispatch();
+    }
+    Impl::Lock lock(*pimpl_);
     
     if (!pimpl_->property_rules_) {
         return;
@@ -472,6 +820,7 @@ void PropertyClientFacade::processSubscribePropertyReply(const SubscribeProperty
         // Notify UI of successful subscription
         notifySubscriptionUpdated(*sub_it);
     }
+    lock.unlockAndDispatch();
 }
 
 void PropertyClientFacade::addPendingSubscription(uint8_t request_id, const std::string& subscription_id, const std::string& property_id, const std::string& res_id) {
@@ -537,6 +886,21 @@ void PropertyClientFacade::removeSubscriptionUpdateCallback(const SubscriptionUp
     // TODO: Implement proper callback removal mechanism if needed
 }
 
+PropertyRequestScheduler& PropertyClientFacade::getRequestScheduler() {
+    return pimpl_->scheduler_;
+}
+
+const PropertyRequestScheduler& PropertyClientFacade::getRequestScheduler() const {
+    return pimpl_->scheduler_;
+}
+
+void PropertyClientFacade::processTimeouts() {
+    pimpl_->scheduler_.dispatch();
+    // chunked replies that stopped arriving are expired here once no more chunks come in
+    pimpl_->pending_chunk_manager_.expireChunks(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
 PropertyChunkManager& PropertyClientFacade::getPendingChunkManager() {
     std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
     return pimpl_->pending_chunk_manager_;
@@ -22,9 +22,16 @@ public:
         
         // Set up property value update callback
         properties_->addPropertyUpdatedCallback([this](const std::string& property_id, const std::string& res_id) {
+            invalidate_cached_replies(property_id);
             notify_property_updated_to_subscribers(property_id);
         });
     }
+
+    void invalidate_cached_replies(const std::string& property_id) {
+        if (auto* common_service = dynamic_cast<CommonRulesPropertyService*>(property_service_.get())) {
+            common_service->invalidateReplyCache(property_id);
+        }
+    }
     
     void notify_property_updated_to_subscribers(const std::string& property_id) {
         // Get the property value
@@ -154,7 +161,7 @@ void PropertyHostFacade::updatePropertyMetadata(const std::string& old_property_
 
 // Property value updates with subscriber notifications (matching Kotlin setPropertyValue)
 void PropertyHostFacade::setPropertyValue(const std::string& property_id, const std::string& res_id, 
-                                         const std::vector<uint8_t>& data, bool is_partial) {
+                                         const SharedBytes& data, bool is_partial) {
     std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
     
     // Following Kotlin implementation exactly: properties.values.first { it.id == propertyId && (resId == null || it.resId == resId) }.body = data
@@ -215,6 +222,7 @@ void PropertyHostFacade::updateCommonRulesDeviceInfo(const DeviceInfo& device_in
     // Update device info in the device itself
     auto& current_device_info = pimpl_->device_.getDeviceInfo();
     current_device_info = device_info;
+    pimpl_->invalidate_cached_replies(PropertyResourceNames::DEVICE_INFO);
 
     // Notify that DeviceInfo property may have changed
     notifyPropertyUpdated(PropertyResourceNames::DEVICE_INFO, "");
@@ -225,6 +233,7 @@ void PropertyHostFacade::updateCommonRulesChannelList(const MidiCIChannelList& c
     
     // Update channel list in the device configuration
     pimpl_->device_.getConfig().channel_list = channel_list;
+    pimpl_->invalidate_cached_replies(PropertyResourceNames::CHANNEL_LIST);
 
     // Notify that ChannelList property may have changed
     notifyPropertyUpdated(PropertyResourceNames::CHANNEL_LIST, "");
@@ -235,6 +244,7 @@ void PropertyHostFacade::updateJsonSchema(const std::string& json_schema) {
     
     // Update JSON schema in the device configuration
     pimpl_->device_.getConfig().json_schema_string = json_schema;
+    pimpl_->invalidate_cached_replies(PropertyResourceNames::JSON_SCHEMA);
 
     // Notify that JSONSchema property may have changed
     notifyPropertyUpdated(PropertyResourceNames::JSON_SCHEMA, "");
@@ -285,7 +295,7 @@ SetPropertyDataReply PropertyHostFacade::processSetPropertyData(const SetPropert
         // Following Kotlin implementation: check if reply is successful, then update property
         auto status = pimpl_->property_service_->getHeaderFieldInteger(reply.getHeader(), PropertyCommonHeaderKeys::STATUS);
         if (status == PropertyExchangeStatus::OK) {
-            pimpl_->properties_->updateValue(msg.getHeader(), msg.getBody());
+            pimpl_->properties_->updateValue(msg.getHeader(), msg.getSharedBody());
             
             // Note: Don't call notifyPropertyUpdated here as it's already called by updateValue
         }
@@ -438,6 +448,7 @@ void PropertyHostFacade::setPropertyBinaryGetter(PropertyBinaryGetter getter) {
 
     if (auto* common_service = dynamic_cast<CommonRulesPropertyService*>(pimpl_->property_service_.get())) {
         common_service->propertyBinaryGetter = std::move(getter);
+        common_service->invalidateReplyCache();
     }
 }
 
@@ -449,7 +460,7 @@ PropertyHostFacade::PropertyBinaryGetter PropertyHostFacade::getPropertyBinaryGe
     }
 
     // Return default empty lambda
-    return [](const std::string&, const std::string&) -> std::vector<uint8_t> { return {}; };
+    return [](const std::string&, const std::string&) -> SharedBytes { return {}; };
 }
 
 void PropertyHostFacade::setPropertyBinarySetter(PropertyBinarySetter setter) {
@@ -468,7 +479,7 @@ PropertyHostFacade::PropertyBinarySetter PropertyHostFacade::getPropertyBinarySe
     }
 
     // Return default lambda that always fails
-    return [](const std::string&, const std::string&, const std::string&, const std::vector<uint8_t>&) -> bool { return false; };
+    return [](const std::string&, const std::string&, const std::string&, const SharedBytes&) -> bool { return false; };
 }
 
 } // namespace midicci
@@ -0,0 +1,277 @@
+#include "midicci/midicci.hpp"
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace midicci {
+
+namespace {
+
+struct ScheduledRequest {
+    std::shared_ptr<const PropertyMessage> message;
+    PropertyRequestScheduler::Clock::time_point deadline{};
+    // a requeued request is not sent again before this
+    PropertyRequestScheduler::Clock::time_point not_before{};
+    // number of times the request was sent
+    int attempts{0};
+    bool in_flight{false};
+};
+
+} // namespace
+
+class PropertyRequestScheduler::Impl {
+public:
+    Impl(Sender sender, uint8_t max_in_flight)
+        : sender_(std::move(sender)), max_in_flight_(std::max<uint8_t>(max_in_flight, 1)) {}
+
+    Sender sender_;
+    FailureHandler failure_handler_;
+    // queued and in-flight requests by request ID
+    std::unordered_map<uint8_t, ScheduledRequest> requests_;
+    std::deque<uint8_t> queue_;
+    size_t in_flight_count_{0};
+    uint8_t max_in_flight_;
+    std::chrono::milliseconds timeout_{DEFAULT_TIMEOUT};
+    int max_retries_{DEFAULT_MAX_RETRIES};
+    std::chrono::milliseconds retry_delay_{DEFAULT_RETRY_DELAY};
+    uint8_t next_request_id_{1};
+    mutable std::recursive_mutex mutex_;
+
+    // A request that became due; sent, or handed to the failure handler, after the lock is released.
+    struct Due {
+        std::shared_ptr<const PropertyMessage> message;
+        bool failed;
+    };
+
+    void markSent(ScheduledRequest& request, Clock::time_point now, std::vector<Due>& due) {
+        request.deadline = now + timeout_;
+        request.attempts++;
+        due.push_back({request.message, false});
+    }
+
+    void collectTimeouts(Clock::time_point now, std::vector<Due>& due) {
+        for (auto it = requests_.begin(); it != requests_.end();) {
+            auto& request = it->second;
+            if (!request.in_flight || request.deadline > now) {
+                ++it;
+            } else if (request.attempts <= max_retries_) {
+                markSent(request, now, due);
+                ++it;
+            } else {
+                due.push_back({std::move(request.message), true});
+                it = requests_.erase(it);
+                in_flight_count_--;
+            }
+        }
+    }
+
+    void collectQueued(Clock::time_point now, std::vector<Due>& due) {
+        while (in_flight_count_ < max_in_flight_ && !queue_.empty()) {
+            uint8_t id = queue_.front();
+            auto it = requests_.find(id);
+            // a requeued request holds back the queue until its retry delay has passed
+            if (it != requests_.end() && !it->second.in_flight && it->second.not_before > now)
+                break;
+            queue_.pop_front();
+            if (it == requests_.end() || it->second.in_flight)
+                continue;
+            it->second.in_flight = true;
+            in_flight_count_++;
+            markSent(it->second, now, due);
+        }
+    }
+
+    // The sender may deliver the reply synchronously and the failure handler may issue new
+    // requests, both of which call back into the scheduler (possibly from other threads too),
+    // so neither is called with mutex_ held.
+    void run(std::unique_lock<std::recursive_mutex>& lock, const std::vector<Due>& due) {
+        if (due.empty())
+            return;
+        auto sender = sender_;
+        auto failure_handler = failure_handler_;
+        lock.unlock();
+        for (const auto& [message, failed] : due) {
+            if (!failed)
+                sender(*message);
+            else if (failure_handler)
+                failure_handler(*message);
+        }
+    }
+};
+
+PropertyRequestScheduler::PropertyRequestScheduler(Sender sender, uint8_t max_in_flight)
+    : pimpl_(std::make_unique<Impl>(std::move(sender), max_in_flight)) {}
+
+PropertyRequestScheduler::~PropertyRequestScheduler() = default;
+
+uint8_t PropertyRequestScheduler::allocateRequestId() {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    for (int i = 0; i <= MAX_REQUEST_ID; i++) {
+        uint8_t id = (pimpl_->next_request_id_ + i) & MAX_REQUEST_ID;
+        if (!pimpl_->requests_.contains(id)) {
+            pimpl_->next_request_id_ = (id + 1) & MAX_REQUEST_ID;
+            return id;
+        }
+    }
+    throw std::runtime_error("All property exchange request IDs are in use");
+}
+
+void PropertyRequestScheduler::enqueue(std::shared_ptr<const PropertyMessage> msg, Clock::time_point now) {
+    queue(std::move(msg));
+    dispatch(now);
+}
+
+void PropertyRequestScheduler::queue(std::shared_ptr<const PropertyMessage> msg) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    uint8_t id = msg->getRequestId();
+    if (pimpl_->requests_.contains(id))
+        throw std::invalid_argument("Property exchange request ID " + std::to_string(id) + " is already in use");
+    pimpl_->requests_[id].message = std::move(msg);
+    pimpl_->queue_.push_back(id);
+}
+
+std::optional<uint8_t> PropertyRequestScheduler::findPending(const PropertyMessage& msg) const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    for (const auto& [id, request] : pimpl_->requests_) {
+        const auto& pending = *request.message;
+        if (pending.getType() == msg.getType() &&
+            pending.getDestinationMuid() == msg.getDestinationMuid() &&
+            pending.getHeader() == msg.getHeader())
+            return id;
+    }
+    return std::nullopt;
+}
+
+std::shared_ptr<const PropertyMessage> PropertyRequestScheduler::complete(uint8_t request_id) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    auto it = pimpl_->requests_.find(request_id);
+    if (it == pimpl_->requests_.end() || !it->second.in_flight)
+        return nullptr;
+    auto message = std::move(it->second.message);
+    pimpl_->requests_.erase(it);
+    pimpl_->in_flight_count_--;
+    return message;
+}
+
+bool PropertyRequestScheduler::requeue(uint8_t request_id, Clock::time_point now) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    auto it = pimpl_->requests_.find(request_id);
+    if (it == pimpl_->requests_.end() || !it->second.in_flight || it->second.attempts > pimpl_->max_retries_)
+        return false;
+    it->second.in_flight = false;
+    it->second.not_before = now + pimpl_->retry_delay_ * it->second.attempts;
+    pimpl_->in_flight_count_--;
+    pimpl_->queue_.push_front(request_id);
+    return true;
+}
+
+bool PropertyRequestScheduler::cancel(uint8_t request_id) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    auto it = pimpl_->requests_.find(request_id);
+    if (it == pimpl_->requests_.end() || it->second.in_flight)
+        return false;
+    pimpl_->requests_.erase(it);
+    std::erase(pimpl_->queue_, request_id);
+    return true;
+}
+
+void PropertyRequestScheduler::extend(uint8_t request_id, Clock::time_point now) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    auto it = pimpl_->requests_.find(request_id);
+    if (it != pimpl_->requests_.end() && it->second.in_flight)
+        it->second.deadline = now + pimpl_->timeout_;
+}
+
+void PropertyRequestScheduler::dispatch(Clock::time_point now) {
+    std::unique_lock<std::recursive_mutex> lock(pimpl_->mutex_);
+    std::vector<Impl::Due> due;
+    pimpl_->collectTimeouts(now, due);
+    pimpl_->collectQueued(now, due);
+    pimpl_->run(lock, due);
+}
+
+void PropertyRequestScheduler::processTimeouts(Clock::time_point now) {
+    std::unique_lock<std::recursive_mutex> lock(pimpl_->mutex_);
+    std::vector<Impl::Due> due;
+    pimpl_->collectTimeouts(now, due);
+    pimpl_->run(lock, due);
+}
+
+bool PropertyRequestScheduler::isPending(uint8_t request_id) const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    return pimpl_->requests_.contains(request_id);
+}
+
+std::shared_ptr<const PropertyMessage> PropertyRequestScheduler::getRequest(uint8_t request_id) const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    auto it = pimpl_->requests_.find(request_id);
+    return it != pimpl_->requests_.end() ? it->second.message : nullptr;
+}
+
+size_t PropertyRequestScheduler::getQueuedCount() const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    return pimpl_->requests_.size() - pimpl_->in_flight_count_;
+}
+
+size_t PropertyRequestScheduler::getInFlightCount() const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    return pimpl_->in_flight_count_;
+}
+
+uint8_t PropertyRequestScheduler::getMaxInFlight() const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    return pimpl_->max_in_flight_;
+}
+
+void PropertyRequestScheduler::setMaxInFlight(uint8_t max_in_flight) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    pimpl_->max_in_flight_ = std::max<uint8_t>(max_in_flight, 1);
+}
+
+std::chrono::milliseconds PropertyRequestScheduler::getTimeout() const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    return pimpl_->timeout_;
+}
+
+void PropertyRequestScheduler::setTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    pimpl_->timeout_ = timeout;
+}
+
+int PropertyRequestScheduler::getMaxRetries() const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    return pimpl_->max_retries_;
+}
+
+void PropertyRequestScheduler::setMaxRetries(int max_retries) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    pimpl_->max_retries_ = std::max(max_retries, 0);
+}
+
+std::chrono::milliseconds PropertyRequestScheduler::getRetryDelay() const {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    return pimpl_->retry_delay_;
+}
+
+void PropertyRequestScheduler::setRetryDelay(std::chrono::milliseconds delay) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    pimpl_->retry_delay_ = std::max(delay, std::chrono::milliseconds::zero());
+}
+
+void PropertyRequestScheduler::setFailureHandler(FailureHandler handler) {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    pimpl_->failure_handler_ = std::move(handler);
+}
+
+void PropertyRequestScheduler::clear() {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->mutex_);
+    pimpl_->requests_.clear();
+    pimpl_->queue_.clear();
+    pimpl_->in_flight_count_ = 0;
+}
+
+} // namespace midicci
@@ -1,5 +1,6 @@
 #include "midicci/midicci.hpp"
 #include <midicci/details/commonproperties/StandardProperties.hpp>
+#include <set>
 #include <sstream>
 #include <algorithm>
 
@@ -113,28 +114,48 @@ void CommonRulesPropertyClient::propertyValueUpdated(const std::string& property
             auto allCtrlIt = std::find_if(resource_list_.begin(), resource_list_.end(),
                 [](const std::unique_ptr<PropertyMetadata>& p) { return p->getPropertyId() == StandardPropertyNames::ALL_CTRL_LIST; });
             if (allCtrlIt != resource_list_.end()) {
-                conn_.getPropertyClientFacade().sendGetPropertyData(StandardPropertyNames::ALL_CTRL_LIST, "");
+                fetchList(**allCtrlIt);
             }
 
             auto programIt = std::find_if(resource_list_.begin(), resource_list_.end(),
                 [](const std::unique_ptr<PropertyMetadata>& p) { return p->getPropertyId() == StandardPropertyNames::PROGRAM_LIST; });
             if (programIt != resource_list_.end()) {
-                conn_.getPropertyClientFacade().sendGetPropertyData(StandardPropertyNames::PROGRAM_LIST, "");
+                fetchList(**programIt);
             }
         } catch (const std::exception& ex) {
             device_.getLogger()(LogData("Error parsing resource list: " + std::string(ex.what()), true));
         }
+    } else if (property_id == StandardPropertyNames::ALL_CTRL_LIST) {
+        // Fetch every referenced CtrlMapList; the request scheduler keeps them within the responder's window.
+        auto ctrlMapIt = std::find_if(resource_list_.begin(), resource_list_.end(),
+            [](const std::unique_ptr<PropertyMetadata>& p) { return p->getPropertyId() == StandardPropertyNames::CTRL_MAP_LIST; });
+        if (ctrlMapIt != resource_list_.end()) {
+            std::set<std::string> ctrl_map_ids;
+            for (const auto& control : StandardProperties::parseControlList(body)) {
+                if (control.ctrlMapId && ctrl_map_ids.insert(*control.ctrlMapId).second)
+                    conn_.getPropertyClientFacade().sendGetPropertyData(StandardPropertyNames::CTRL_MAP_LIST, *control.ctrlMapId);
+            }
+        }
     }
     // Note: DeviceInfo, ChannelList, and JsonSchema are now handled via FoundationalResources
     // and should be accessed through ObservablePropertyList extension methods
 }
 
+void CommonRulesPropertyClient::fetchList(const PropertyMetadata& metadata) {
+    auto& facade = conn_.getPropertyClientFacade();
+    auto* common_rules = dynamic_cast<const CommonRulesPropertyMetadata*>(&metadata);
+    if (common_rules && common_rules->canPaginate)
+        facade.getPaginatedPropertyData(metadata.getPropertyId(), "", PropertyClientFacade::DEFAULT_LIST_PAGE_SIZE, nullptr);
+    else
+        facade.sendGetPropertyData(metadata.getPropertyId(), "");
+}
+
 void CommonRulesPropertyClient::requestPropertyList(uint8_t group) {
     auto request_bytes = helper_->getResourceListRequestBytes();
     
     GetPropertyData msg(
         Common(device_.getMuid(), conn_.getTargetMuid(), 0x7F, group),
-        0,
+        conn_.getPropertyClientFacade().getRequestScheduler().allocateRequestId(),
         request_bytes
     );
     
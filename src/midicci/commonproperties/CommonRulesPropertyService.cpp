@@ -6,10 +6,15 @@
 
 namespace midicci::commonproperties {
 
-CommonRulesPropertyService::CommonRulesPropertyService(MidiCIDevice& device)
-    : device_(device), helper_(std::make_unique<CommonRulesPropertyHelper>(device)) {
-    propertyBinaryGetter = [this](const std::string& property_id, const std::string& res_id) -> std::vector<uint8_t> {
-        const auto& values = device_.getConfig().property_values;
+namespace {
+
+// The default propertyBinaryGetter. It is a named type so that the reply cache can tell whether
+// values come from the configuration (where it sees every change) or from a custom getter.
+struct ConfigPropertyValueGetter {
+    MidiCIDevice* device;
+
+    SharedBytes operator()(const std::string& property_id, const std::string& res_id) const {
+        const auto& values = device->getConfig().property_values;
         auto it = std::find_if(values.begin(), values.end(),
             [&property_id, &res_id](const PropertyValue& pv) {
                 return pv.id == property_id && (res_id.empty() || pv.resId == res_id);
@@ -18,9 +23,32 @@ CommonRulesPropertyService::CommonRulesPropertyService(MidiCIDevice& device)
             return it->body;
         }
         return {};
-    };
+    }
+};
+
+// Bounds the memory spent on replies for many distinct pages; the cache is simply emptied.
+constexpr size_t MAX_CACHED_REPLIES = 256;
 
-    propertyBinarySetter = [this](const std::string& property_id, const std::string& res_id, const std::string& media_type, const std::vector<uint8_t>& body) -> bool {
+std::string replyCacheKey(const PropertyCommonRequestHeader& header) {
+    std::string key = header.res_id;
+    for (const auto* part : {&header.mutual_encoding, &header.media_type}) {
+        key += '\0';
+        key += *part;
+    }
+    key += '\0';
+    key += header.offset ? std::to_string(*header.offset) : "-";
+    key += '\0';
+    key += header.limit ? std::to_string(*header.limit) : "-";
+    return key;
+}
+
+} // namespace
+
+CommonRulesPropertyService::CommonRulesPropertyService(MidiCIDevice& device)
+    : device_(device), helper_(std::make_unique<CommonRulesPropertyHelper>(device)) {
+    propertyBinaryGetter = ConfigPropertyValueGetter{&device_};
+
+    propertyBinarySetter = [this](const std::string& property_id, const std::string& res_id, const std::string& media_type, const SharedBytes& body) -> bool {
         auto& values = device_.getConfig().property_values;
         auto it = std::find_if(values.begin(), values.end(),
             [&property_id, &res_id](const PropertyValue& pv) {
@@ -39,7 +67,7 @@ CommonRulesPropertyService::CommonRulesPropertyService(MidiCIDevice& device)
     };
 }
 void CommonRulesPropertyService::setPropertyValue(const std::string& property_id, const std::string& res_id,
-                                                    const std::vector<uint8_t>& data, const std::string& media_type) {
+                                                    const SharedBytes& data, const std::string& media_type) {
     auto& values = device_.getConfig().property_values;
     bool found = false;
 
@@ -69,6 +97,32 @@ void CommonRulesPropertyService::setPropertyValue(const std::string& property_id
         device_.getConfig().property_values.push_back(
             PropertyValue(property_id, res_id, media_type, data));
     }
+    invalidateReplyCache(property_id);
+}
+
+void CommonRulesPropertyService::invalidateReplyCache(const std::string& property_id) {
+    if (property_id.empty()) {
+        reply_cache_.clear();
+        cached_reply_count_ = 0;
+        list_indexes_.clear();
+        return;
+    }
+    std::erase_if(list_indexes_, [&property_id](const auto& entry) {
+        return entry.first.compare(0, property_id.size(), property_id) == 0 &&
+               entry.first.size() > property_id.size() && entry.first[property_id.size()] == '\0';
+    });
+    auto it = reply_cache_.find(property_id);
+    if (it != reply_cache_.end()) {
+        cached_reply_count_ -= it->second.size();
+        reply_cache_.erase(it);
+    }
+}
+
+bool CommonRulesPropertyService::isReplyCacheable(const std::string& resource) const {
+    if (resource == PropertyResourceNames::RESOURCE_LIST || resource == PropertyResourceNames::DEVICE_INFO ||
+        resource == PropertyResourceNames::CHANNEL_LIST || resource == PropertyResourceNames::JSON_SCHEMA)
+        return true;
+    return propertyBinaryGetter.target<ConfigPropertyValueGetter>() != nullptr;
 }
 
 void CommonRulesPropertyService::addPropertyCatalogUpdatedCallback(std::function<void()> callback) {
@@ -116,15 +170,37 @@ GetPropertyDataReply CommonRulesPropertyService::getPropertyData(const GetProper
         std::string header_str(msg.getHeader().begin(), msg.getHeader().end());
         JsonValue json_inquiry = JsonValue::parse(header_str);
 
+        auto& srcCommon = msg.getCommon();
+        Common common{device_.getMuid(), msg.getSourceMuid(), srcCommon.address, srcCommon.group};
+
+        auto request_header = getPropertyHeader(json_inquiry);
+        bool cacheable = isReplyCacheable(request_header.resource);
+        std::string cache_key;
+        if (cacheable) {
+            cache_key = replyCacheKey(request_header);
+            auto resource_it = reply_cache_.find(request_header.resource);
+            if (resource_it != reply_cache_.end()) {
+                auto it = resource_it->second.find(cache_key);
+                if (it != resource_it->second.end())
+                    return GetPropertyDataReply(common, msg.getRequestId(), it->second.header, it->second.body);
+            }
+        }
+
         auto result = getPropertyDataEncoded(json_inquiry);
 
         std::string reply_header_str = result.first.serialize();
         std::vector<uint8_t> reply_header(reply_header_str.begin(), reply_header_str.end());
-        const std::vector<uint8_t>& reply_body = result.second;
 
-        auto& srcCommon = msg.getCommon();
-        Common common{device_.getMuid(), msg.getSourceMuid(), srcCommon.address, srcCommon.group};
-        return GetPropertyDataReply(common, msg.getRequestId(), reply_header, reply_body);
+        const auto& reply_header_json = result.first;
+        if (cacheable && reply_header_json.isObject() &&
+            reply_header_json[PropertyCommonHeaderKeys::STATUS].asInt() == PropertyExchangeStatus::OK) {
+            if (cached_reply_count_ >= MAX_CACHED_REPLIES)
+                invalidateReplyCache();
+            reply_cache_[request_header.resource][cache_key] = CachedReply{reply_header, result.second};
+            cached_reply_count_++;
+        }
+
+        return GetPropertyDataReply(common, msg.getRequestId(), std::move(reply_header), std::move(result.second));
     } catch (const std::exception& e) {
         JsonObject error_header;
         error_header[PropertyCommonHeaderKeys::STATUS] = JsonValue(PropertyExchangeStatus::INTERNAL_ERROR);
@@ -145,7 +221,7 @@ SetPropertyDataReply CommonRulesPropertyService::setPropertyData(const SetProper
         std::string header_str(msg.getHeader().begin(), msg.getHeader().end());
         JsonValue header_json = JsonValue::parse(header_str);
 
-        auto result = setPropertyData(header_json, msg.getBody());
+        auto result = setPropertyData(header_json, msg.getSharedBody());
 
         std::string reply_header_str = result.serialize();
         std::vector<uint8_t> reply_header(reply_header_str.begin(), reply_header_str.end());
@@ -176,6 +252,7 @@ std::vector<uint8_t> CommonRulesPropertyService::decodeBody(const std::vector<ui
 
 void CommonRulesPropertyService::addMetadata(std::unique_ptr<PropertyMetadata> property) {
     metadata_list_.push_back(std::move(property));
+    invalidateReplyCache(PropertyResourceNames::RESOURCE_LIST);
     // Trigger property catalog updated callbacks (following Kotlin)
     for (const auto& callback : property_catalog_updated_callbacks_) {
         callback();
@@ -197,6 +274,8 @@ void CommonRulesPropertyService::removeMetadata(const std::string& property_id)
                 return pv.id == property_id;
             }),
         values.end());
+    invalidateReplyCache(PropertyResourceNames::RESOURCE_LIST);
+    invalidateReplyCache(property_id);
 
     // Trigger property catalog updated callbacks (following Kotlin)
     for (const auto& callback : property_catalog_updated_callbacks_) {
@@ -387,7 +466,7 @@ std::pair<JsonValue, JsonValue> CommonRulesPropertyService::unsubscribe(const st
     return std::make_pair(getReplyHeaderJson(reply_header), reply_body);
 }
 
-JsonValue CommonRulesPropertyService::setPropertyData(const JsonValue& header_json, const std::vector<uint8_t>& body) {
+JsonValue CommonRulesPropertyService::setPropertyData(const JsonValue& header_json, const SharedBytes& body) {
     PropertyCommonRequestHeader header = getPropertyHeader(header_json);
 
     if (header.resource == PropertyResourceNames::DEVICE_INFO ||
@@ -401,10 +480,12 @@ JsonValue CommonRulesPropertyService::setPropertyData(const JsonValue& header_js
         return getReplyHeaderJson(reply_header);
     }
 
-    std::optional<std::string> mutual_encoding = header.mutual_encoding.empty()
-        ? std::nullopt
-        : std::optional<std::string>(header.mutual_encoding);
-    std::vector<uint8_t> decoded_body = helper_->decodeBody(mutual_encoding, body);
+    invalidateReplyCache(header.resource);
+
+    // Plain bodies are stored as they were received, sharing the message buffer.
+    SharedBytes decoded_body = body;
+    if (!header.mutual_encoding.empty() && header.mutual_encoding != PropertyDataEncoding::ASCII)
+        decoded_body = helper_->decodeBody(std::optional<std::string>(header.mutual_encoding), body);
 
     auto& values = device_.getConfig().property_values;
     auto existing_it = std::find_if(values.begin(), values.end(),
@@ -501,28 +582,28 @@ std::pair<JsonValue, JsonValue> CommonRulesPropertyService::getPropertyDataJson(
     }
     
     // Property list pagination (Common Rules for PE 6.6.2)
-    JsonValue paginated_body = body;
     int total_count = -1;
     
     if (body.isArray() && header.offset.has_value()) {
         auto& array = body.asArray();
         total_count = static_cast<int>(array.size());
         
-        size_t offset = static_cast<size_t>(header.offset.value());
+        size_t offset = static_cast<size_t>(std::max(header.offset.value(), 0));
         JsonArray paginated_array;
         
         if (offset < array.size()) {
             size_t end = array.size();
-            if (header.limit.has_value()) {
+            if (header.limit.has_value() && header.limit.value() >= 0) {
                 end = std::min(end, offset + static_cast<size_t>(header.limit.value()));
             }
             
+            paginated_array.reserve(end - offset);
             for (size_t i = offset; i < end; ++i) {
-                paginated_array.push_back(array[i]);
+                paginated_array.push_back(std::move(array[i]));
             }
         }
         
-        paginated_body = JsonValue(paginated_array);
+        body = JsonValue(std::move(paginated_array));
     }
     
     PropertyCommonReplyHeader reply_header;
@@ -532,22 +613,62 @@ std::pair<JsonValue, JsonValue> CommonRulesPropertyService::getPropertyDataJson(
         reply_header.total_count = total_count;
     }
     
-    return std::make_pair(getReplyHeaderJson(reply_header), paginated_body.isNull() ? JsonValue(JsonObject{}) : paginated_body);
+    return std::make_pair(getReplyHeaderJson(reply_header), body.isNull() ? JsonValue(JsonObject{}) : std::move(body));
+}
+
+// A page of a list property, cut from the stored JSON through its element index instead of
+// parsing the whole list. std::nullopt if the value is not a JSON array.
+std::optional<std::pair<JsonValue, SharedBytes>> CommonRulesPropertyService::getListPage(const PropertyCommonRequestHeader& header) const {
+    if (header.resource == PropertyResourceNames::RESOURCE_LIST || header.resource == PropertyResourceNames::DEVICE_INFO ||
+        header.resource == PropertyResourceNames::CHANNEL_LIST || header.resource == PropertyResourceNames::JSON_SCHEMA)
+        return std::nullopt;
+
+    SharedBytes binary = propertyBinaryGetter(header.resource, header.res_id);
+    if (binary.empty())
+        return std::nullopt;
+
+    std::optional<JsonArrayIndex> built;
+    const std::optional<JsonArrayIndex>* index = &built;
+    if (isReplyCacheable(header.resource)) {
+        auto& entry = list_indexes_[header.resource + '\0' + header.res_id];
+        if (entry.body != binary.getShared()) {
+            entry.body = binary.getShared();
+            entry.index = JsonArrayIndex::build(binary.span());
+        }
+        index = &entry.index;
+    } else {
+        built = JsonArrayIndex::build(binary.span());
+    }
+    if (!index->has_value())
+        return std::nullopt;
+
+    size_t offset = static_cast<size_t>(std::max(header.offset.value_or(0), 0));
+    size_t limit = header.limit.has_value() && header.limit.value() >= 0 ? static_cast<size_t>(header.limit.value()) : SIZE_MAX;
+
+    PropertyCommonReplyHeader reply_header;
+    reply_header.status = PropertyExchangeStatus::OK;
+    reply_header.mutual_encoding = header.mutual_encoding;
+    reply_header.total_count = static_cast<int>((*index)->size());
+    return std::make_pair(getReplyHeaderJson(reply_header), SharedBytes((*index)->slice(binary.span(), offset, limit)));
 }
 
-std::pair<JsonValue, std::vector<uint8_t>> CommonRulesPropertyService::getPropertyDataEncoded(const JsonValue& header_json) const {
+std::pair<JsonValue, SharedBytes> CommonRulesPropertyService::getPropertyDataEncoded(const JsonValue& header_json) const {
     PropertyCommonRequestHeader header = getPropertyHeader(header_json);
 
     if ((header.media_type.empty() || header.media_type == CommonRulesKnownMimeTypes::APPLICATION_JSON) &&
         (header.mutual_encoding.empty() || header.mutual_encoding == PropertyDataEncoding::ASCII)) {
+        if (header.offset.has_value()) {
+            if (auto page = getListPage(header))
+                return std::move(*page);
+        }
         auto result = getPropertyDataJson(header);
         std::string body_str = result.second.serialize();
-        std::vector<uint8_t> body(body_str.begin(), body_str.end());
-        std::vector<uint8_t> encoded_body = helper_->encodeBody(body, header.mutual_encoding);
-        return std::make_pair(result.first, encoded_body);
+        // no encoding is applied here, see the condition above
+        return std::make_pair(result.first, SharedBytes(std::vector<uint8_t>(body_str.begin(), body_str.end())));
     } else {
-        auto body = propertyBinaryGetter(header.resource, header.res_id);
-        std::vector<uint8_t> encoded_body = helper_->encodeBody(body, header.mutual_encoding);
+        SharedBytes encoded_body = propertyBinaryGetter(header.resource, header.res_id);
+        if (!header.mutual_encoding.empty() && header.mutual_encoding != PropertyDataEncoding::ASCII)
+            encoded_body = helper_->encodeBody(encoded_body, header.mutual_encoding);
         PropertyCommonReplyHeader reply_header;
         reply_header.status = PropertyExchangeStatus::OK;
         reply_header.mutual_encoding = header.mutual_encoding;
@@ -2,8 +2,7 @@
 #include <umppi/details/UmpFactory.hpp>
 #include <umppi/details/UmpRetriever.hpp>
 #include <random>
-#include <iomanip>
-#include <sstream>
+#include <array>
 
 namespace midicci::musicdevice {
 
@@ -62,37 +61,40 @@ MidiCISession::MidiCISession(
 void MidiCISession::processCiMessage(uint8_t group, const std::vector<uint8_t>& data) {
     if (data.empty()) return;
     
-    // Log the message
-    auto logger = device_->getLogger();
-    if (logger) {
-        std::stringstream ss;
-        ss << "[received CI SysEx (grp:" << static_cast<int>(group) << ")] ";
-        for (uint8_t byte : data) {
-            ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte) << " ";
-        }
-        logger(LogData(ss.str(), true));  // true for incoming message
+    auto& diagnostics = device_->getDiagnosticLogger();
+    if (diagnostics.isEnabled(LogLevel::Debug, LogCategory::Transport)) {
+        diagnostics.write(LogLevel::Debug, LogCategory::Transport, LogEvent::SysExReceived, device_->getMuid(),
+                          {group, static_cast<uint32_t>(data.size())}, data);
     }
     
     device_->processInput(group, data);
 }
 
 void MidiCISession::logMidiMessageReportChunk(const std::vector<uint8_t>& data) {
-    auto logger = device_->getLogger();
-    if (logger) {
-        std::stringstream ss;
-        ss << "[received MIDI (buffered)] ";
-        for (uint8_t byte : data) {
-            ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte) << " ";
-        }
-        logger(LogData(ss.str(), true));
+    auto& diagnostics = device_->getDiagnosticLogger();
+    if (diagnostics.isEnabled(LogLevel::Debug, LogCategory::Transport)) {
+        diagnostics.write(LogLevel::Debug, LogCategory::Transport, LogEvent::MidiMessageReportChunk, device_->getMuid(),
+                          {static_cast<uint32_t>(data.size())}, data);
     }
 }
 
 void MidiCISession::processUmpInput(umppi::UmpWordSpan words) {
-    auto umps = umppi::parseUmpsFromWords(words);
+    std::lock_guard<std::recursive_mutex> lock(input_mutex_);
+    // the member classifier is reused to avoid allocations, unless an outer call is iterating it
+    umppi::UmpClassifier nested_classifier;
+    auto& classifier = scanning_ ? nested_classifier : ump_classifier_;
+    struct ScanningScope {
+        bool& scanning;
+        bool previous;
+        ~ScanningScope() { scanning = previous; }
+    } scanning_scope{scanning_, scanning_};
+    scanning_ = true;
+
+    classifier.scan(words);
     bool loggedUnexpected = false;
     
-    for (const auto& ump : umps) {
+    for (size_t i = 0; i < classifier.getPacketCount(); ++i) {
+        auto ump = classifier.getUmp(i);
         auto msg_type = ump.getMessageType();
 
         if (msg_type == umppi::MessageType::SYSEX7) {
@@ -161,14 +163,17 @@ void MidiCISession::processUmpInput(umppi::UmpWordSpan words) {
             auto bytes = ump.toBytes();
             chunked_messages_.insert(chunked_messages_.end(), bytes.begin(), bytes.end());
         } else if (!loggedUnexpected) {
-            auto logger = device_->getLogger();
-            if (logger) {
-                std::stringstream ss;
-                ss << "[received UMP] ";
-                for (size_t i = 0; i < words.size(); ++i) {
-                    ss << std::hex << std::setw(8) << std::setfill('0') << words[i] << " ";
+            auto& diagnostics = device_->getDiagnosticLogger();
+            if (diagnostics.isEnabled(LogLevel::Debug, LogCategory::Transport)) {
+                std::array<uint8_t, LogRecord::MAX_PAYLOAD_SIZE> payload;
+                size_t size = 0;
+                for (size_t w = 0; w < words.size() && size + 4 <= payload.size(); ++w) {
+                    for (int b = 0; b < 4; ++b) {
+                        payload[size++] = static_cast<uint8_t>(words[w] >> (8 * b));
+                    }
                 }
-                logger(LogData(ss.str(), true));
+                diagnostics.write(LogLevel::Debug, LogCategory::Transport, LogEvent::UmpReceived, device_->getMuid(),
+                                  {static_cast<uint32_t>(words.size())}, std::span<const uint8_t>(payload.data(), size));
             }
             loggedUnexpected = true;
         }
@@ -39,6 +39,23 @@ void CallbackMusicDeviceOutputSender::send(umppi::UmpWordSpan words, uint64_t ti
     output_sender_(words, timestamp_ns);
 }
 
+// ScheduledMusicDeviceOutputSender implementation
+ScheduledMusicDeviceOutputSender::ScheduledMusicDeviceOutputSender(
+    std::shared_ptr<MusicDeviceOutputSender> output, umppi::UmpScheduler::Options options)
+    : output_(output),
+      scheduler_([this](umppi::UmpWordSpan words, uint64_t timestamp_ns) { output_->send(words, timestamp_ns); },
+                 options)
+{
+}
+
+void ScheduledMusicDeviceOutputSender::send(umppi::UmpWordSpan words, uint64_t timestamp_ns) {
+    scheduler_.schedule(words, timestamp_ns);
+}
+
+void ScheduledMusicDeviceOutputSender::flush() {
+    scheduler_.flush();
+}
+
 // MusicDeviceConnector implementation
 MusicDeviceConnector::MusicDeviceConnector(
     std::shared_ptr<MusicDeviceInputReceiver> receiver,
@@ -0,0 +1,156 @@
+#include <umppi/details/JrClockSync.hpp>
+#include <umppi/details/UmpClassifier.hpp>
+#include <umppi/details/UmpFactory.hpp>
+#include <umppi/details/Common.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace umppi {
+
+namespace {
+// Slopes further than this from the nominal rate are measurement garbage, not drift.
+constexpr double MAX_DRIFT = 0.01;
+}
+
+void JrClockSync::reset() {
+    sampleCount_ = 0;
+    nextSample_ = 0;
+    last_ = {};
+    reference_ = {};
+    slope_ = static_cast<double>(NANOSECONDS_PER_TICK);
+    offset_ = 0;
+    pendingTimestamp_.reset();
+}
+
+int64_t JrClockSync::unwrap(uint16_t value16, int64_t reference) const {
+    auto diff = static_cast<int16_t>(static_cast<uint16_t>(value16 - static_cast<uint16_t>(reference)));
+    return reference + diff;
+}
+
+void JrClockSync::onJrClock(uint16_t senderClockTime16, uint64_t arrivalNs) {
+    int64_t ticks = senderClockTime16;
+    if (sampleCount_ > 0) {
+        // Predict from the elapsed local time, so that gaps longer than half the 16-bit range still unwrap.
+        int64_t predicted = last_.senderTicks +
+                            static_cast<int64_t>((arrivalNs - last_.arrivalNs) / NANOSECONDS_PER_TICK);
+        ticks = unwrap(senderClockTime16, predicted);
+    }
+    last_ = {ticks, arrivalNs};
+    samples_[nextSample_] = last_;
+    nextSample_ = (nextSample_ + 1) % WINDOW_SIZE;
+    sampleCount_ = std::min(sampleCount_ + 1, WINDOW_SIZE);
+    estimate();
+}
+
+void JrClockSync::estimate() {
+    reference_ = last_;
+    size_t n = sampleCount_;
+    size_t oldest = n < WINDOW_SIZE ? 0 : nextSample_;
+    auto x = [this](const Sample& s) { return static_cast<double>(s.senderTicks - reference_.senderTicks); };
+    auto y = [this](const Sample& s) {
+        return static_cast<double>(static_cast<int64_t>(s.arrivalNs - reference_.arrivalNs));
+    };
+
+    // Transport jitter only ever adds delay, so the least delayed sample of the older and of the newer
+    // half of the window are the best two points of the sender timeline; the slope goes through them.
+    double nominal = static_cast<double>(NANOSECONDS_PER_TICK);
+    double slope = nominal;
+    if (n >= 2) {
+        auto leastDelayed = [&](size_t from, size_t to) {
+            const Sample* best = nullptr;
+            double bestResidual = std::numeric_limits<double>::max();
+            for (size_t k = from; k < to; k++) {
+                const auto& s = samples_[(oldest + k) % WINDOW_SIZE];
+                double residual = y(s) - nominal * x(s);
+                if (residual < bestResidual) {
+                    bestResidual = residual;
+                    best = &s;
+                }
+            }
+            return best;
+        };
+        const Sample* a = leastDelayed(0, n / 2);
+        const Sample* b = leastDelayed(n / 2, n);
+        double dx = x(*b) - x(*a);
+        if (dx > 0)
+            slope = std::clamp((y(*b) - y(*a)) / dx, nominal * (1 - MAX_DRIFT), nominal * (1 + MAX_DRIFT));
+    }
+    slope_ = slope;
+
+    double offset = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < n; i++)
+        offset = std::min(offset, y(samples_[i]) - slope * x(samples_[i]));
+    offset_ = offset;
+}
+
+double JrClockSync::getDriftPpm() const {
+    // A sender running fast covers more ticks per local nanosecond, i.e. a smaller slope.
+    return (static_cast<double>(NANOSECONDS_PER_TICK) / slope_ - 1.0) * 1e6;
+}
+
+std::optional<uint64_t> JrClockSync::senderTicksToLocal(int64_t senderTicks) const {
+    if (sampleCount_ == 0)
+        return std::nullopt;
+    double delta = offset_ + slope_ * static_cast<double>(senderTicks - reference_.senderTicks);
+    return reference_.arrivalNs + static_cast<int64_t>(delta) + latencyNs_;
+}
+
+std::optional<uint64_t> JrClockSync::convertJrTimestamp(uint16_t senderClockTimestamp16) const {
+    if (!isSynchronized())
+        return std::nullopt;
+    return senderTicksToLocal(unwrap(senderClockTimestamp16, last_.senderTicks));
+}
+
+uint64_t JrClockSync::receive(UmpWordSpan packet, uint64_t arrivalNs) {
+    uint64_t fallback = arrivalNs + latencyNs_;
+    if (packet.empty())
+        return fallback;
+    uint32_t word = packet[0];
+    if ((word >> 28) == MidiMessageType::UTILITY) {
+        uint8_t status = (word >> 16) & 0xF0;
+        if (status == MidiUtilityStatus::JR_CLOCK) {
+            onJrClock(static_cast<uint16_t>(word & 0xFFFF), arrivalNs);
+            return fallback;
+        }
+        if (status == MidiUtilityStatus::JR_TIMESTAMP) {
+            pendingTimestamp_ = static_cast<uint16_t>(word & 0xFFFF);
+            return fallback;
+        }
+    }
+    if (!pendingTimestamp_)
+        return fallback;
+    auto converted = convertJrTimestamp(*pendingTimestamp_);
+    pendingTimestamp_.reset();
+    return converted.value_or(fallback);
+}
+
+void JrClockSync::process(UmpWordSpan words, uint64_t arrivalNs, const PacketCallback& callback) {
+    for (size_t i = 0; i < words.size();) {
+        size_t size = std::min<size_t>(umpPacketSizeInInts[words[i] >> 28], words.size() - i);
+        auto packet = words.subspan(i, size);
+        uint64_t localTime = receive(packet, arrivalNs);
+        uint32_t word = packet[0];
+        uint8_t status = (word >> 16) & 0xF0;
+        bool isJr = (word >> 28) == MidiMessageType::UTILITY &&
+                    (status == MidiUtilityStatus::JR_CLOCK || status == MidiUtilityStatus::JR_TIMESTAMP);
+        if (!isJr)
+            callback(packet, localTime);
+        i += size;
+    }
+}
+
+uint32_t JrClockSync::createJrClock(uint64_t localNs) {
+    return UmpFactory::jrClock(toJrTicks(localNs));
+}
+
+uint32_t JrClockSync::createJrTimestamp(uint64_t localNs) {
+    return UmpFactory::jrTimestamp(toJrTicks(localNs));
+}
+
+uint32_t JrClockSync::nextJrClock(uint64_t nowNs) {
+    clockSent_ = true;
+    lastClockSentNs_ = nowNs;
+    return createJrClock(nowNs);
+}
+
+} // namespace umppi
@@ -166,4 +166,11 @@ void Midi1Machine::processMessage(const Midi1Message& message) {
     }
 }
 
+void Midi1Machine::processMessage(const Ump& ump) {
+    if (ump.getMessageType() != MessageType::MIDI1)
+        return;
+    Midi1SimpleMessage message(ump.getStatusByte(), ump.getMidi1Msb(), ump.getMidi1Lsb());
+    processMessage(message);
+}
+
 }
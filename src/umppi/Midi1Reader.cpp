@@ -18,7 +18,14 @@ Midi1Reader::Midi1Reader(std::istream& stream)
 
 Midi1Music Midi1Reader::read() {
     Midi1Music music;
+    int trackCount = readHeader(music);
+    for (int i = 0; i < trackCount; i++) {
+        music.tracks.push_back(readTrack());
+    }
+    return music;
+}
 
+int Midi1Reader::readHeader(Midi1Music& music) {
     if (readByte() != 'M' || readByte() != 'T' ||
         readByte() != 'h' || readByte() != 'd') {
         throw SmfParserException("MThd is expected");
@@ -31,12 +38,7 @@ Midi1Music Midi1Reader::read() {
     music.format = static_cast<uint8_t>(readInt16());
     int16_t trackCount = readInt16();
     music.deltaTimeSpec = readInt16();
-
-    for (int16_t i = 0; i < trackCount; i++) {
-        music.tracks.push_back(readTrack());
-    }
-
-    return music;
+    return trackCount;
 }
 
 Midi1Track Midi1Reader::readTrack() {
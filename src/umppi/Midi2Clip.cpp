@@ -0,0 +1,389 @@
+#include <umppi/details/Midi2Clip.hpp>
+#include <umppi/details/Midi1Music.hpp>
+#include <umppi/details/Midi1Reader.hpp>
+#include <umppi/details/UmpClassifier.hpp>
+#include <umppi/details/UmpFactory.hpp>
+#include <umppi/details/UmpTranslator.hpp>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+
+namespace umppi {
+
+namespace {
+
+constexpr char CLIP_MAGIC[8] = {'S', 'M', 'F', '2', 'C', 'L', 'I', 'P'};
+// Clips are translated to MIDI 1.0 in chunks of about this many packets.
+constexpr size_t CLIP_CHUNK_PACKETS = 4096;
+
+void writeWord(std::ostream& stream, uint32_t value) {
+    char bytes[4] = {
+        static_cast<char>((value >> 24) & 0xFF),
+        static_cast<char>((value >> 16) & 0xFF),
+        static_cast<char>((value >> 8) & 0xFF),
+        static_cast<char>(value & 0xFF)
+    };
+    stream.write(bytes, 4);
+}
+
+void writeUmp(std::ostream& stream, const Ump& ump) {
+    int size = umpPacketSizeInInts[ump.int1 >> 28];
+    writeWord(stream, ump.int1);
+    if (size >= 2) writeWord(stream, ump.int2);
+    if (size >= 3) writeWord(stream, ump.int3);
+    if (size >= 4) writeWord(stream, ump.int4);
+}
+
+bool readWord(std::istream& stream, uint32_t& value) {
+    unsigned char bytes[4];
+    if (!stream.read(reinterpret_cast<char*>(bytes), 4))
+        return false;
+    value = (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+            (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
+    return true;
+}
+
+void appendVariableLength(std::vector<uint8_t>& dst, uint32_t value) {
+    uint8_t buffer[5];
+    int length = 0;
+    do {
+        buffer[length++] = static_cast<uint8_t>(value & 0x7F);
+        value >>= 7;
+    } while (value != 0);
+    while (length > 0) {
+        --length;
+        dst.push_back(static_cast<uint8_t>(buffer[length] | (length > 0 ? 0x80 : 0)));
+    }
+}
+
+// Writes the track in the form UmpTranslator::translateMidi1BytesToUmp() takes with isMidi1Smf:
+// every event has its status byte (no running status), and SysEx is F0 <data> F7 without the SMF length.
+void flattenTrack(const Midi1Track& track, std::vector<uint8_t>& dst) {
+    dst.clear();
+    uint32_t pendingDeltaTime = 0;
+    for (const auto& event : track.events) {
+        pendingDeltaTime += static_cast<uint32_t>(event.deltaTime);
+        if (!event.message)
+            continue;
+        uint8_t status = event.message->getStatusByte();
+        auto* compound = dynamic_cast<const Midi1CompoundMessage*>(event.message.get());
+
+        if (status == Midi1Status::SYSEX_END) {
+            // SysEx continuation / escape packets have no UMP counterpart; keep their delta time.
+            continue;
+        }
+        appendVariableLength(dst, pendingDeltaTime);
+        pendingDeltaTime = 0;
+
+        if (status == Midi1Status::META || status == Midi1Status::SYSEX) {
+            const uint8_t* data = compound ? compound->getExtraData().data() + compound->getExtraDataOffset() : nullptr;
+            size_t length = compound ? compound->getExtraDataLength() : 0;
+            dst.push_back(status);
+            if (status == Midi1Status::META) {
+                dst.push_back(event.message->getMetaType());
+                appendVariableLength(dst, static_cast<uint32_t>(length));
+                dst.insert(dst.end(), data, data + length);
+            } else {
+                if (length > 0 && data[length - 1] == Midi1Status::SYSEX_END)
+                    length--;
+                dst.insert(dst.end(), data, data + length);
+                dst.push_back(Midi1Status::SYSEX_END);
+            }
+            continue;
+        }
+
+        dst.push_back(status);
+        dst.push_back(event.message->getMsb());
+        if (Midi1Message::fixedDataSize(status) > 1)
+            dst.push_back(event.message->getLsb());
+    }
+}
+
+void writeDeltaClockstamp(Midi2ClipWriter& writer, uint64_t ticks) {
+    while (ticks > 0) {
+        uint32_t step = static_cast<uint32_t>(std::min<uint64_t>(ticks, 0xFFFFF));
+        writer.write(Ump(UmpFactory::deltaClockstamp(step)));
+        ticks -= step;
+    }
+}
+
+// Merges the translated tracks by time into one clip sequence. Events of one track at the same tick
+// stay together, and tracks at the same tick are written in track order (as in Midi1Music::mergeTracks()).
+void writeMergedTracks(const std::vector<std::vector<Ump>>& tracks, Midi2ClipWriter& writer) {
+    struct Cursor {
+        size_t position = 0;
+        uint64_t tick = 0;
+    };
+    std::vector<Cursor> cursors(tracks.size());
+    auto skipDeltaClockstamps = [&](size_t index) {
+        auto& cursor = cursors[index];
+        const auto& messages = tracks[index];
+        while (cursor.position < messages.size() && messages[cursor.position].isDeltaClockstamp())
+            cursor.tick += messages[cursor.position++].getDeltaClockstamp();
+    };
+    for (size_t i = 0; i < tracks.size(); i++)
+        skipDeltaClockstamps(i);
+
+    uint64_t currentTick = 0;
+    while (true) {
+        size_t next = tracks.size();
+        for (size_t i = 0; i < tracks.size(); i++) {
+            if (cursors[i].position < tracks[i].size() && (next == tracks.size() || cursors[i].tick < cursors[next].tick))
+                next = i;
+        }
+        if (next == tracks.size())
+            break;
+
+        auto& cursor = cursors[next];
+        const auto& messages = tracks[next];
+        writeDeltaClockstamp(writer, cursor.tick - currentTick);
+        currentTick = cursor.tick;
+        while (cursor.position < messages.size() && !messages[cursor.position].isDeltaClockstamp())
+            writer.write(messages[cursor.position++]);
+        skipDeltaClockstamps(next);
+    }
+
+    // keep the length of the song (e.g. the delta time of End of Track)
+    uint64_t endTick = currentTick;
+    for (const auto& cursor : cursors)
+        endTick = std::max(endTick, cursor.tick);
+    writeDeltaClockstamp(writer, endTick - currentTick);
+}
+
+// True if ump always produces a MIDI 1.0 event, i.e. the translator does not carry delta time past it.
+bool producesMidi1Event(const Ump& ump) {
+    switch (ump.getMessageType()) {
+        case MessageType::SYSTEM:
+        case MessageType::MIDI1:
+            return true;
+        case MessageType::SYSEX7: {
+            auto status = ump.getBinaryChunkStatus();
+            return status == BinaryChunkStatus::COMPLETE_PACKET || status == BinaryChunkStatus::END;
+        }
+        case MessageType::MIDI2:
+            switch (ump.getStatusCode()) {
+                case MidiChannelStatus::NOTE_OFF:
+                case MidiChannelStatus::NOTE_ON:
+                case MidiChannelStatus::PAF:
+                case MidiChannelStatus::CC:
+                case MidiChannelStatus::PROGRAM:
+                case MidiChannelStatus::CAF:
+                case MidiChannelStatus::PITCH_BEND:
+                case MidiChannelStatus::RPN:
+                case MidiChannelStatus::NRPN:
+                    return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+void writeBigEndian(std::ostream& output, uint32_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--)
+        output.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+} // namespace
+
+Midi2ClipWriter::Midi2ClipWriter(std::ostream& stream)
+    : stream_(stream) {}
+
+void Midi2ClipWriter::writeHeader(uint16_t ticksPerQuarterNote) {
+    if (headerWritten_)
+        throw std::logic_error("Clip header is already written");
+    stream_.write(CLIP_MAGIC, sizeof(CLIP_MAGIC));
+    writeWord(stream_, UmpFactory::deltaClockstamp(0));
+    writeWord(stream_, UmpFactory::dctpq(ticksPerQuarterNote));
+    writeWord(stream_, UmpFactory::deltaClockstamp(0));
+    writeUmp(stream_, UmpFactory::startOfClip());
+    headerWritten_ = true;
+}
+
+void Midi2ClipWriter::write(const Ump& ump) {
+    if (!headerWritten_ || finished_)
+        throw std::logic_error("Clip messages must be written between writeHeader() and finish()");
+    writeUmp(stream_, ump);
+    packetCount_++;
+}
+
+void Midi2ClipWriter::write(std::span<const Ump> src) {
+    for (const auto& ump : src)
+        write(ump);
+}
+
+void Midi2ClipWriter::finish() {
+    if (finished_)
+        return;
+    if (!headerWritten_)
+        throw std::logic_error("Clip header is not written");
+    writeWord(stream_, UmpFactory::deltaClockstamp(0));
+    writeUmp(stream_, UmpFactory::endOfClip());
+    finished_ = true;
+    if (!stream_)
+        throw std::runtime_error("Failed to write the clip");
+}
+
+Midi2ClipReader::Midi2ClipReader(std::istream& stream)
+    : stream_(stream) {}
+
+uint16_t Midi2ClipReader::readHeader() {
+    char magic[sizeof(CLIP_MAGIC)];
+    if (!stream_.read(magic, sizeof(magic)) || std::memcmp(magic, CLIP_MAGIC, sizeof(magic)) != 0)
+        throw std::runtime_error("SMF2CLIP is expected");
+
+    uint16_t ticksPerQuarterNote = 0;
+    Ump ump;
+    while (readPacket(ump)) {
+        if (ump.isDCTPQ())
+            ticksPerQuarterNote = ump.getDCTPQ();
+        else if (ump.isStartOfClip())
+            return ticksPerQuarterNote;
+    }
+    throw std::runtime_error("Start of Clip is expected");
+}
+
+bool Midi2ClipReader::read(Ump& ump) {
+    if (ended_ || !readPacket(ump))
+        return false;
+    if (ump.isEndOfClip()) {
+        ended_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool Midi2ClipReader::readPacket(Ump& ump) {
+    uint32_t words[4] = {0, 0, 0, 0};
+    if (!readWord(stream_, words[0])) {
+        // a clip without End of Clip
+        truncated_ = true;
+        return false;
+    }
+    int size = umpPacketSizeInInts[words[0] >> 28];
+    for (int i = 1; i < size; i++) {
+        if (!readWord(stream_, words[i])) {
+            truncated_ = true;
+            return false;
+        }
+    }
+    ump = Ump(words[0], words[1], words[2], words[3]);
+    return true;
+}
+
+void writeMidi2ClipFile(const Midi2Track& track, uint16_t ticksPerQuarterNote, const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Failed to open file: " + filename);
+    Midi2ClipWriter writer(file);
+    writer.writeHeader(ticksPerQuarterNote);
+    writer.write(track.messages);
+    writer.finish();
+}
+
+Midi2Track readMidi2ClipFile(const std::string& filename, uint16_t* ticksPerQuarterNote) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Failed to open file: " + filename);
+    Midi2ClipReader reader(file);
+    uint16_t dctpq = reader.readHeader();
+    if (ticksPerQuarterNote)
+        *ticksPerQuarterNote = dctpq;
+    Midi2Track track;
+    Ump ump;
+    while (reader.read(ump))
+        track.messages.push_back(ump);
+    return track;
+}
+
+uint64_t Midi2ClipConverter::smfToClip(std::istream& input, std::ostream& output, int group) {
+    Midi1Reader reader(input);
+    Midi1Music header;
+    int trackCount = reader.readHeader(header);
+    if (header.deltaTimeSpec <= 0)
+        throw std::runtime_error("SMPTE time division cannot be represented in a MIDI 2.0 clip");
+
+    tracks_.resize(static_cast<size_t>(std::max(trackCount, 0)));
+    uint64_t packets = 0;
+    for (int i = 0; i < trackCount; i++) {
+        // only one Midi1Track (the heavyweight representation) is alive at a time
+        flattenTrack(reader.readTrack(), midi1_);
+        Midi1ToUmpTranslatorContext context(midi1_, group, false,
+                                            static_cast<int>(MidiTransportProtocol::UMP), false, true);
+        int result = UmpTranslator::translateMidi1BytesToUmp(context);
+        if (result != UmpTranslationResult::OK)
+            throw std::runtime_error("Translation failed at track " + std::to_string(i) +
+                                     " (result " + std::to_string(result) + ")");
+        tracks_[i] = std::move(context.output);
+        packets += tracks_[i].size();
+    }
+
+    Midi2ClipWriter writer(output);
+    writer.writeHeader(static_cast<uint16_t>(header.deltaTimeSpec));
+    writeMergedTracks(tracks_, writer);
+    writer.finish();
+    for (auto& track : tracks_)
+        track.clear();
+    if (!output)
+        throw std::runtime_error("Failed to write the clip");
+    return packets;
+}
+
+uint64_t Midi2ClipConverter::clipToSmf(std::istream& input, std::ostream& output) {
+    Midi2ClipReader reader(input);
+    uint16_t ticksPerQuarterNote = reader.readHeader();
+    if (ticksPerQuarterNote == 0 || ticksPerQuarterNote > 0x7FFF)
+        throw std::runtime_error("The clip has no usable DCTPQ");
+
+    output.write("MThd", 4);
+    writeBigEndian(output, 6, 4);
+    writeBigEndian(output, 0, 2); // format 0
+    writeBigEndian(output, 1, 2);
+    writeBigEndian(output, ticksPerQuarterNote, 2);
+    output.write("MTrk", 4);
+    auto trackLengthPosition = output.tellp();
+    writeBigEndian(output, 0, 4);
+
+    UmpToMidi1BytesTranslator translator{UmpToMidi1BytesTranslatorContext(ticksPerQuarterNote)};
+    uint32_t trackLength = 0;
+    uint64_t packets = 0;
+    auto flush = [&]() {
+        int result = translator.translate(midi1_, chunk_);
+        if (result != UmpTranslationResult::OK)
+            throw std::runtime_error("Translation failed (result " + std::to_string(result) + ")");
+        output.write(reinterpret_cast<const char*>(midi1_.data()), static_cast<std::streamsize>(midi1_.size()));
+        trackLength += static_cast<uint32_t>(midi1_.size());
+        chunk_.clear();
+    };
+
+    chunk_.clear();
+    Ump ump;
+    while (reader.read(ump)) {
+        chunk_.push_back(ump);
+        packets++;
+        // Cut chunks only after an event that is written out, so that no delta time is pending.
+        if (chunk_.size() >= CLIP_CHUNK_PACKETS && producesMidi1Event(ump))
+            flush();
+    }
+    if (reader.isTruncated())
+        throw std::runtime_error("The clip has no End of Clip");
+
+    flush();
+    // every tick after the last written event, including those around packets that write nothing
+    uint32_t trailingTicks = translator.getPendingDeltaTime();
+
+    std::vector<uint8_t> endOfTrack;
+    appendVariableLength(endOfTrack, trailingTicks);
+    endOfTrack.insert(endOfTrack.end(), {Midi1Status::META, MidiMetaType::END_OF_TRACK, 0});
+    output.write(reinterpret_cast<const char*>(endOfTrack.data()), static_cast<std::streamsize>(endOfTrack.size()));
+    trackLength += static_cast<uint32_t>(endOfTrack.size());
+
+    output.seekp(trackLengthPosition);
+    writeBigEndian(output, trackLength, 4);
+    if (!output)
+        throw std::runtime_error("Failed to write the SMF");
+    return packets;
+}
+
+} // namespace umppi
@@ -0,0 +1,82 @@
+#include <umppi/details/Midi2Machine.hpp>
+#include <umppi/details/Common.hpp>
+
+namespace umppi {
+
+Midi2MachineChannel::Midi2MachineChannel() {
+    perNotePitchbend.fill(0x80000000);
+}
+
+void Midi2Machine::processMessage(const Ump& ump) {
+    if (ump.getMessageType() != MessageType::MIDI2 || ump.getGroup() != group)
+        return;
+
+    auto& channel = channels[ump.getChannelInGroup()];
+    uint8_t note = ump.getMidi2Note();
+
+    switch (ump.getStatusCode()) {
+        case MidiChannelStatus::NOTE_ON:
+        case MidiChannelStatus::NOTE_OFF:
+            channel.noteOnStatus[note] = ump.getStatusCode() == MidiChannelStatus::NOTE_ON;
+            channel.noteVelocity[note] = ump.getMidi2Velocity16();
+            channel.noteAttributeType[note] = static_cast<uint8_t>(ump.int1 & 0xFF);
+            channel.noteAttributeData[note] = static_cast<uint16_t>(ump.int2 & 0xFFFF);
+            break;
+
+        case MidiChannelStatus::PAF:
+            channel.pafVelocity[note] = ump.getMidi2PafData();
+            break;
+
+        case MidiChannelStatus::CC:
+            channel.controls[ump.getMidi2CcIndex()] = ump.getMidi2CcData();
+            break;
+
+        case MidiChannelStatus::RPN:
+            channel.rpns[(ump.getMidi2RpnMsb() << 7) + ump.getMidi2RpnLsb()] = ump.getMidi2RpnData();
+            break;
+
+        case MidiChannelStatus::NRPN:
+            channel.nrpns[(ump.getMidi2NrpnMsb() << 7) + ump.getMidi2NrpnLsb()] = ump.getMidi2NrpnData();
+            break;
+
+        case MidiChannelStatus::RELATIVE_RPN:
+            // relative data is a signed 32-bit value
+            channel.rpns[(ump.getMidi2RpnMsb() << 7) + ump.getMidi2RpnLsb()] += ump.getMidi2RpnData();
+            break;
+
+        case MidiChannelStatus::RELATIVE_NRPN:
+            channel.nrpns[(ump.getMidi2NrpnMsb() << 7) + ump.getMidi2NrpnLsb()] += ump.getMidi2NrpnData();
+            break;
+
+        case MidiChannelStatus::PROGRAM:
+            channel.program = ump.getMidi2ProgramProgram();
+            if (ump.getMidi2ProgramOptions() & MidiProgramChangeOptions::BANK_VALID) {
+                channel.bankMsb = ump.getMidi2ProgramBankMsb();
+                channel.bankLsb = ump.getMidi2ProgramBankLsb();
+            }
+            break;
+
+        case MidiChannelStatus::CAF:
+            channel.caf = ump.getMidi2CafData();
+            break;
+
+        case MidiChannelStatus::PITCH_BEND:
+            channel.pitchbend = ump.getMidi2PitchBendData();
+            break;
+
+        case MidiChannelStatus::PER_NOTE_PITCH_BEND:
+            channel.perNotePitchbend[note] = ump.int2;
+            break;
+
+        case MidiChannelStatus::PER_NOTE_MANAGEMENT:
+            // S (reset per-note controllers) flag
+            if (ump.int1 & 1)
+                channel.perNotePitchbend[note] = 0x80000000;
+            break;
+    }
+
+    for (auto& listener : messageListeners)
+        listener(ump);
+}
+
+}
@@ -0,0 +1,235 @@
+#include <umppi/details/NoteIntervalIndex.hpp>
+#include <umppi/details/Common.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace umppi {
+
+void NoteIntervalIndex::invalidate() {
+    intervals_.clear();
+    maxEnd_.clear();
+    activeNotes_.clear();
+    scannedCount_ = 0;
+    currentTick_ = 0;
+    treeSize_ = 0;
+    treeLevels_ = -1;
+}
+
+void NoteIntervalIndex::update() {
+    size_t count = midi2Track_ ? midi2Track_->messages.size() : midi1Track_->events.size();
+    if (count < scannedCount_)
+        invalidate();
+    if (count == scannedCount_)
+        return;
+
+    if (midi2Track_)
+        scanMidi2();
+    else
+        scanMidi1();
+
+    // notes that are still on extend to the current end of the track
+    for (const auto& active : activeNotes_)
+        for (uint32_t i : active.second)
+            intervals_[i].endTick = currentTick_;
+}
+
+void NoteIntervalIndex::scanMidi2() {
+    const auto& messages = midi2Track_->messages;
+    for (; scannedCount_ < messages.size(); scannedCount_++) {
+        const auto& ump = messages[scannedCount_];
+        auto index = static_cast<uint32_t>(scannedCount_);
+        if (ump.isDeltaClockstamp()) {
+            currentTick_ += ump.getDeltaClockstamp();
+            continue;
+        }
+        uint8_t group = ump.getGroup();
+        uint8_t channel = ump.getChannelInGroup();
+        uint8_t note = (ump.int1 >> 8) & 0x7F;
+        uint8_t status = ump.getStatusCode();
+
+        if (ump.getMessageType() == MessageType::MIDI1) {
+            uint8_t velocity = ump.getMidi1Lsb();
+            if (status == MidiChannelStatus::NOTE_ON && velocity != 0)
+                noteOn(currentTick_, index, group, channel, note, velocity, 0, 0);
+            else if (status == MidiChannelStatus::NOTE_ON || status == MidiChannelStatus::NOTE_OFF)
+                noteOff(currentTick_, index, group, channel, note, velocity);
+            else if (status == MidiChannelStatus::PAF)
+                perNoteMessage(index, group, channel, note);
+        } else if (ump.getMessageType() == MessageType::MIDI2) {
+            switch (status) {
+                case MidiChannelStatus::NOTE_ON:
+                    noteOn(currentTick_, index, group, channel, note, ump.getMidi2Velocity16(),
+                           (ump.int1 & 0xFF), static_cast<uint16_t>(ump.int2 & 0xFFFF));
+                    break;
+                case MidiChannelStatus::NOTE_OFF:
+                    noteOff(currentTick_, index, group, channel, note, ump.getMidi2Velocity16());
+                    break;
+                case MidiChannelStatus::PAF:
+                case MidiChannelStatus::PER_NOTE_RCC:
+                case MidiChannelStatus::PER_NOTE_ACC:
+                case MidiChannelStatus::PER_NOTE_PITCH_BEND:
+                case MidiChannelStatus::PER_NOTE_MANAGEMENT:
+                    perNoteMessage(index, group, channel, note);
+                    break;
+            }
+        }
+    }
+}
+
+void NoteIntervalIndex::scanMidi1() {
+    const auto& events = midi1Track_->events;
+    for (; scannedCount_ < events.size(); scannedCount_++) {
+        const auto& event = events[scannedCount_];
+        auto index = static_cast<uint32_t>(scannedCount_);
+        currentTick_ += event.deltaTime;
+        if (!event.message)
+            continue;
+        uint8_t status = event.message->getStatusCode();
+        uint8_t channel = event.message->getChannel();
+        uint8_t note = event.message->getMsb() & 0x7F;
+        uint8_t velocity = event.message->getLsb() & 0x7F;
+        if (status == MidiChannelStatus::NOTE_ON && velocity != 0)
+            noteOn(currentTick_, index, 0, channel, note, velocity, 0, 0);
+        else if (status == MidiChannelStatus::NOTE_ON || status == MidiChannelStatus::NOTE_OFF)
+            noteOff(currentTick_, index, 0, channel, note, velocity);
+        else if (status == MidiChannelStatus::PAF)
+            perNoteMessage(index, 0, channel, note);
+    }
+}
+
+void NoteIntervalIndex::noteOn(int64_t tick, uint32_t index, uint8_t group, uint8_t channel, uint8_t note,
+                               uint16_t velocity, uint8_t attributeType, uint16_t attributeData) {
+    NoteInterval interval;
+    interval.startTick = tick;
+    interval.endTick = tick;
+    interval.startIndex = index;
+    interval.group = group;
+    interval.channel = channel;
+    interval.note = note;
+    interval.velocity = velocity;
+    interval.attributeType = attributeType;
+    interval.attributeData = attributeData;
+    activeNotes_[getKey(group, channel, note)].push_back(static_cast<uint32_t>(intervals_.size()));
+    intervals_.push_back(std::move(interval));
+}
+
+void NoteIntervalIndex::noteOff(int64_t tick, uint32_t index, uint8_t group, uint8_t channel, uint8_t note,
+                                uint16_t velocity) {
+    auto it = activeNotes_.find(getKey(group, channel, note));
+    if (it == activeNotes_.end())
+        return; // Note Off without Note On
+    auto& interval = intervals_[it->second.front()];
+    interval.endTick = tick;
+    interval.endIndex = index;
+    interval.releaseVelocity = velocity;
+    it->second.erase(it->second.begin());
+    if (it->second.empty())
+        activeNotes_.erase(it);
+}
+
+void NoteIntervalIndex::perNoteMessage(uint32_t index, uint8_t group, uint8_t channel, uint8_t note) {
+    auto it = activeNotes_.find(getKey(group, channel, note));
+    if (it != activeNotes_.end())
+        intervals_[it->second.back()].perNoteMessages.push_back(index);
+}
+
+// Implicit interval tree over the start-sorted array (as in Heng Li's cgranges): node i at level k has
+// its children at i -/+ 2^(k-1), and maxEnd_[i] is the maximum end tick within its subtree.
+// Notes that are still on may end later than their current endTick, so they are taken as never
+// ending; once they are terminated, maxEnd_ merely overestimates until the next rebuild.
+void NoteIntervalIndex::buildTree() {
+    size_t n = intervals_.size();
+    maxEnd_.resize(n);
+    treeSize_ = n;
+    if (n == 0) {
+        treeLevels_ = -1;
+        return;
+    }
+    auto endOf = [this](size_t i) {
+        return intervals_[i].isTerminated() ? intervals_[i].endTick : std::numeric_limits<int64_t>::max();
+    };
+    size_t lastIndex = 0;
+    int64_t last = 0;
+    for (size_t i = 0; i < n; i += 2) {
+        lastIndex = i;
+        last = maxEnd_[i] = endOf(i);
+    }
+    int k = 1;
+    for (; (size_t{1} << k) <= n; k++) {
+        size_t x = size_t{1} << (k - 1);
+        size_t first = (x << 1) - 1;
+        size_t step = x << 2;
+        for (size_t i = first; i < n; i += step) {
+            int64_t leftMax = maxEnd_[i - x];
+            int64_t rightMax = i + x < n ? maxEnd_[i + x] : last;
+            maxEnd_[i] = std::max({endOf(i), leftMax, rightMax});
+        }
+        // move lastIndex up to its parent
+        lastIndex = (lastIndex >> k & 1) ? lastIndex - x : lastIndex + x;
+        if (lastIndex < n && maxEnd_[lastIndex] > last)
+            last = maxEnd_[lastIndex];
+    }
+    treeLevels_ = k - 1;
+}
+
+size_t NoteIntervalIndex::size() {
+    update();
+    return intervals_.size();
+}
+
+size_t NoteIntervalIndex::query(int64_t startTick, int64_t endTick, std::vector<uint32_t>& results,
+                                uint8_t lowestNote, uint8_t highestNote) {
+    update();
+    size_t untreed = intervals_.size() - treeSize_;
+    if (untreed > 0 && untreed >= std::max<size_t>(16, treeSize_ / 8))
+        buildTree();
+    size_t n = treeSize_;
+    size_t found = 0;
+    if (intervals_.empty() || startTick >= endTick)
+        return 0;
+
+    auto emit = [&](size_t i) {
+        const auto& interval = intervals_[i];
+        // zero-length notes are reported when they start within the range
+        bool overlaps = interval.endTick > startTick ||
+                        (interval.endTick == interval.startTick && interval.startTick >= startTick);
+        if (overlaps && interval.note >= lowestNote && interval.note <= highestNote) {
+            results.push_back(static_cast<uint32_t>(i));
+            found++;
+        }
+    };
+
+    struct Node {
+        size_t x;
+        int k;
+        bool leftDone;
+    };
+    Node stack[64];
+    int top = 0;
+    if (n > 0)
+        stack[top++] = {(size_t{1} << treeLevels_) - 1, treeLevels_, false};
+    while (top > 0) {
+        Node z = stack[--top];
+        if (z.k <= 3) {
+            // small subtree: scan it linearly
+            size_t i0 = z.x >> z.k << z.k;
+            size_t i1 = std::min(i0 + (size_t{1} << (z.k + 1)) - 1, n);
+            for (size_t i = i0; i < i1 && intervals_[i].startTick < endTick; i++)
+                emit(i);
+        } else if (!z.leftDone) {
+            size_t left = z.x - (size_t{1} << (z.k - 1));
+            stack[top++] = {z.x, z.k, true};
+            if (left >= n || maxEnd_[left] >= startTick)
+                stack[top++] = {left, z.k - 1, false};
+        } else if (z.x < n && intervals_[z.x].startTick < endTick) {
+            emit(z.x);
+            stack[top++] = {z.x + (size_t{1} << (z.k - 1)), z.k - 1, false};
+        }
+    }
+    // intervals appended since the tree was built start after all of the tree's
+    for (size_t i = n; i < intervals_.size() && intervals_[i].startTick < endTick; i++)
+        emit(i);
+    return found;
+}
+
+} // namespace umppi
@@ -207,6 +207,51 @@ std::vector<Ump> Ump::fromWords(const uint32_t* words, size_t count) {
     return result;
 }
 
+size_t Ump::fromWords(UmpWordSpan words, std::span<Ump> dst, size_t* consumed) {
+    size_t count = 0;
+    size_t offset = 0;
+    while (offset < words.size() && count < dst.size()) {
+        uint32_t i1 = words[offset];
+        size_t sizeInInts = static_cast<size_t>(umpSizeInInts(static_cast<uint8_t>((i1 >> 28) & 0xF)));
+        if (offset + sizeInInts > words.size())
+            break;
+        dst[count++] = Ump(i1,
+                           sizeInInts > 1 ? words[offset + 1] : 0,
+                           sizeInInts > 2 ? words[offset + 2] : 0,
+                           sizeInInts > 3 ? words[offset + 3] : 0);
+        offset += sizeInInts;
+    }
+    if (consumed)
+        *consumed = offset;
+    return count;
+}
+
+size_t Ump::fromBytes(std::span<const uint8_t> bytes, std::span<Ump> dst, size_t* consumed) {
+    auto readInt = [&bytes](size_t off) -> uint32_t {
+        return (static_cast<uint32_t>(bytes[off]) << 24) |
+               (static_cast<uint32_t>(bytes[off + 1]) << 16) |
+               (static_cast<uint32_t>(bytes[off + 2]) << 8) |
+               static_cast<uint32_t>(bytes[off + 3]);
+    };
+
+    size_t count = 0;
+    size_t offset = 0;
+    while (offset + 4 <= bytes.size() && count < dst.size()) {
+        uint32_t i1 = readInt(offset);
+        size_t sizeInBytes = static_cast<size_t>(umpSizeInInts(static_cast<uint8_t>((i1 >> 28) & 0xF))) * 4;
+        if (offset + sizeInBytes > bytes.size())
+            break;
+        dst[count++] = Ump(i1,
+                           sizeInBytes > 4 ? readInt(offset + 4) : 0,
+                           sizeInBytes > 8 ? readInt(offset + 8) : 0,
+                           sizeInBytes > 12 ? readInt(offset + 12) : 0);
+        offset += sizeInBytes;
+    }
+    if (consumed)
+        *consumed = offset;
+    return count;
+}
+
 std::string Ump::toString() const {
     std::ostringstream oss;
     int size = getSizeInInts();
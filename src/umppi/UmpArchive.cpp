@@ -0,0 +1,396 @@
+#include <umppi/details/UmpArchive.hpp>
+#include <umppi/details/UmpClassifier.hpp>
+#include <zlib.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+namespace umppi {
+
+namespace {
+
+constexpr char FILE_MAGIC[4] = {'U', 'M', 'P', 'A'};
+constexpr char BLOCK_MAGIC[4] = {'U', 'M', 'P', 'B'};
+constexpr char INDEX_MAGIC[4] = {'U', 'M', 'P', 'I'};
+constexpr uint16_t FORMAT_VERSION = 1;
+constexpr size_t FILE_HEADER_SIZE = 8;
+constexpr size_t BLOCK_HEADER_SIZE = 36;
+constexpr size_t INDEX_ENTRY_SIZE = 28;
+constexpr size_t TRAILER_SIZE = 16;
+
+struct BlockHeader {
+    uint32_t rawSize;
+    uint32_t compressedSize;
+    uint32_t packetCount;
+    uint64_t firstTimestamp;
+    uint64_t lastTimestamp;
+    uint32_t crc;
+};
+
+void putU16(std::vector<uint8_t>& dst, uint16_t v) {
+    dst.push_back(static_cast<uint8_t>(v));
+    dst.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void putU32(std::vector<uint8_t>& dst, uint32_t v) {
+    for (int i = 0; i < 4; i++)
+        dst.push_back(static_cast<uint8_t>(v >> (i * 8)));
+}
+
+void putU64(std::vector<uint8_t>& dst, uint64_t v) {
+    for (int i = 0; i < 8; i++)
+        dst.push_back(static_cast<uint8_t>(v >> (i * 8)));
+}
+
+void putVarint(std::vector<uint8_t>& dst, uint64_t v) {
+    while (v >= 0x80) {
+        dst.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    dst.push_back(static_cast<uint8_t>(v));
+}
+
+uint32_t getU32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t getU64(const uint8_t* p) {
+    return getU32(p) | (static_cast<uint64_t>(getU32(p + 4)) << 32);
+}
+
+BlockHeader parseBlockHeader(const uint8_t* p) {
+    if (std::memcmp(p, BLOCK_MAGIC, 4) != 0)
+        throw std::runtime_error("UmpArchive: invalid block header");
+    return {getU32(p + 4), getU32(p + 8), getU32(p + 12), getU64(p + 16), getU64(p + 24), getU32(p + 32)};
+}
+
+} // namespace
+
+// UmpArchiveWriter
+
+UmpArchiveWriter::UmpArchiveWriter(const std::string& path, Options options) : options_(options) {
+    std::error_code ec;
+    bool exists = std::filesystem::exists(path, ec) && std::filesystem::file_size(path, ec) > 0;
+    if (exists) {
+        UmpArchiveReader existing(path);
+        blocks_ = existing.getBlocks();
+        packetCount_ = existing.getPacketCount();
+        endOfBlocks_ = FILE_HEADER_SIZE;
+        if (!blocks_.empty()) {
+            const auto& last = blocks_.back();
+            std::ifstream in(path, std::ios::binary);
+            uint8_t header[BLOCK_HEADER_SIZE];
+            in.seekg(static_cast<std::streamoff>(last.offset));
+            in.read(reinterpret_cast<char*>(header), BLOCK_HEADER_SIZE);
+            endOfBlocks_ = last.offset + BLOCK_HEADER_SIZE + parseBlockHeader(header).compressedSize;
+            lastTimestamp_ = last.lastTimestamp;
+        }
+        // drop the old index (and anything a crashed recorder left behind); close() writes a new one
+        std::filesystem::resize_file(path, endOfBlocks_);
+    } else {
+        std::ofstream create(path, std::ios::binary | std::ios::trunc);
+        std::vector<uint8_t> header(FILE_MAGIC, FILE_MAGIC + 4);
+        putU16(header, FORMAT_VERSION);
+        putU16(header, 0);
+        create.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        if (!create)
+            throw std::runtime_error("UmpArchiveWriter: cannot create " + path);
+        endOfBlocks_ = FILE_HEADER_SIZE;
+    }
+    file_.open(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file_)
+        throw std::runtime_error("UmpArchiveWriter: cannot open " + path);
+    timestamps_.reserve(options_.packetsPerBlock);
+    words_.reserve(options_.packetsPerBlock * 2);
+}
+
+UmpArchiveWriter::~UmpArchiveWriter() {
+    try {
+        close();
+    } catch (...) {
+        // destructors must not throw; call close() explicitly to see errors
+    }
+}
+
+void UmpArchiveWriter::write(UmpWordSpan words, uint64_t timestampNs) {
+    if (closed_)
+        throw std::logic_error("UmpArchiveWriter: already closed");
+    if (timestampNs < lastTimestamp_)
+        throw std::invalid_argument("UmpArchiveWriter: timestamps must not decrease");
+    lastTimestamp_ = timestampNs;
+    for (size_t i = 0; i < words.size();) {
+        size_t size = umpPacketSizeInInts[words[i] >> 28];
+        if (i + size > words.size())
+            throw std::invalid_argument("UmpArchiveWriter: incomplete UMP packet");
+        timestamps_.push_back(timestampNs);
+        words_.insert(words_.end(), words.begin() + i, words.begin() + i + size);
+        i += size;
+        if (timestamps_.size() >= options_.packetsPerBlock)
+            writeBlock();
+    }
+}
+
+void UmpArchiveWriter::writeBlock() {
+    if (timestamps_.empty())
+        return;
+    raw_.clear();
+    uint64_t previous = timestamps_.front();
+    for (uint64_t t : timestamps_) {
+        putVarint(raw_, t - previous);
+        previous = t;
+    }
+    for (uint32_t w : words_)
+        putU32(raw_, w);
+
+    uLongf compressedSize = compressBound(static_cast<uLong>(raw_.size()));
+    compressed_.resize(BLOCK_HEADER_SIZE + compressedSize);
+    int result = compress2(compressed_.data() + BLOCK_HEADER_SIZE, &compressedSize, raw_.data(),
+                           static_cast<uLong>(raw_.size()), options_.compressionLevel);
+    if (result != Z_OK)
+        throw std::runtime_error("UmpArchiveWriter: zlib compression failed");
+    compressed_.resize(BLOCK_HEADER_SIZE + compressedSize);
+
+    UmpArchiveBlockInfo info{endOfBlocks_, timestamps_.front(), timestamps_.back(),
+                             static_cast<uint32_t>(timestamps_.size())};
+    std::vector<uint8_t> header(BLOCK_MAGIC, BLOCK_MAGIC + 4);
+    putU32(header, static_cast<uint32_t>(raw_.size()));
+    putU32(header, static_cast<uint32_t>(compressedSize));
+    putU32(header, info.packetCount);
+    putU64(header, info.firstTimestamp);
+    putU64(header, info.lastTimestamp);
+    putU32(header, static_cast<uint32_t>(crc32(0, compressed_.data() + BLOCK_HEADER_SIZE, compressedSize)));
+    std::copy(header.begin(), header.end(), compressed_.begin());
+
+    file_.seekp(static_cast<std::streamoff>(endOfBlocks_));
+    file_.write(reinterpret_cast<const char*>(compressed_.data()), static_cast<std::streamsize>(compressed_.size()));
+    if (!file_)
+        throw std::runtime_error("UmpArchiveWriter: write failed");
+    endOfBlocks_ += compressed_.size();
+    packetCount_ += info.packetCount;
+    blocks_.push_back(info);
+    timestamps_.clear();
+    words_.clear();
+}
+
+void UmpArchiveWriter::writeIndex() {
+    std::vector<uint8_t> index;
+    index.reserve(blocks_.size() * INDEX_ENTRY_SIZE + TRAILER_SIZE);
+    for (const auto& block : blocks_) {
+        putU64(index, block.offset);
+        putU64(index, block.firstTimestamp);
+        putU64(index, block.lastTimestamp);
+        putU32(index, block.packetCount);
+    }
+    putU64(index, endOfBlocks_);
+    putU32(index, static_cast<uint32_t>(blocks_.size()));
+    index.insert(index.end(), INDEX_MAGIC, INDEX_MAGIC + 4);
+    // Blocks are only ever added, so the new index always ends at or beyond the previous one.
+    file_.seekp(static_cast<std::streamoff>(endOfBlocks_));
+    file_.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+    file_.flush();
+    if (!file_)
+        throw std::runtime_error("UmpArchiveWriter: write failed");
+}
+
+void UmpArchiveWriter::flush() {
+    if (closed_)
+        return;
+    writeBlock();
+    writeIndex();
+}
+
+void UmpArchiveWriter::close() {
+    if (closed_)
+        return;
+    flush();
+    closed_ = true;
+    file_.close();
+}
+
+// UmpArchiveReader
+
+UmpArchiveReader::UmpArchiveReader(const std::string& path) : path_(path) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec)
+        throw std::runtime_error("UmpArchiveReader: cannot open " + path);
+    load(size);
+}
+
+UmpArchiveReader::UmpArchiveReader(std::span<const uint8_t> data) : data_(data) {
+    load(data.size());
+}
+
+void UmpArchiveReader::readBytes(uint64_t offset, uint8_t* dst, size_t size) const {
+    if (path_.empty()) {
+        if (offset + size > data_.size())
+            throw std::runtime_error("UmpArchiveReader: unexpected end of data");
+        std::memcpy(dst, data_.data() + offset, size);
+        return;
+    }
+    // a stream per call keeps concurrent block reads independent
+    std::ifstream in(path_, std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(offset));
+    in.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(size));
+    if (static_cast<size_t>(in.gcount()) != size)
+        throw std::runtime_error("UmpArchiveReader: unexpected end of file");
+}
+
+void UmpArchiveReader::load(uint64_t fileSize) {
+    uint8_t header[FILE_HEADER_SIZE];
+    if (fileSize < FILE_HEADER_SIZE)
+        throw std::runtime_error("UmpArchiveReader: not a UMP archive");
+    readBytes(0, header, FILE_HEADER_SIZE);
+    if (std::memcmp(header, FILE_MAGIC, 4) != 0)
+        throw std::runtime_error("UmpArchiveReader: not a UMP archive");
+    if ((header[4] | (header[5] << 8)) > FORMAT_VERSION)
+        throw std::runtime_error("UmpArchiveReader: unsupported archive version");
+
+    if (fileSize >= FILE_HEADER_SIZE + TRAILER_SIZE) {
+        uint8_t trailer[TRAILER_SIZE];
+        readBytes(fileSize - TRAILER_SIZE, trailer, TRAILER_SIZE);
+        uint64_t indexOffset = getU64(trailer);
+        uint32_t count = getU32(trailer + 8);
+        bool valid = std::memcmp(trailer + 12, INDEX_MAGIC, 4) == 0 &&
+                     indexOffset + static_cast<uint64_t>(count) * INDEX_ENTRY_SIZE + TRAILER_SIZE == fileSize;
+        if (valid) {
+            std::vector<uint8_t> index(count * INDEX_ENTRY_SIZE);
+            readBytes(indexOffset, index.data(), index.size());
+            for (uint32_t i = 0; i < count && valid; i++) {
+                const uint8_t* p = index.data() + i * INDEX_ENTRY_SIZE;
+                UmpArchiveBlockInfo info{getU64(p), getU64(p + 8), getU64(p + 16), getU32(p + 24)};
+                uint8_t magic[4];
+                valid = info.offset + BLOCK_HEADER_SIZE <= indexOffset;
+                if (valid) {
+                    readBytes(info.offset, magic, 4);
+                    valid = std::memcmp(magic, BLOCK_MAGIC, 4) == 0;
+                }
+                blocks_.push_back(info);
+            }
+            if (valid)
+                return;
+            blocks_.clear();
+        }
+    }
+    scanBlocks(fileSize);
+}
+
+// Recovers the block list of an archive whose index is missing or stale.
+void UmpArchiveReader::scanBlocks(uint64_t fileSize) {
+    uint64_t offset = FILE_HEADER_SIZE;
+    uint8_t header[BLOCK_HEADER_SIZE];
+    while (offset + BLOCK_HEADER_SIZE <= fileSize) {
+        readBytes(offset, header, BLOCK_HEADER_SIZE);
+        if (std::memcmp(header, BLOCK_MAGIC, 4) != 0)
+            break;
+        auto block = parseBlockHeader(header);
+        if (offset + BLOCK_HEADER_SIZE + block.compressedSize > fileSize)
+            break; // partially written
+        blocks_.push_back({offset, block.firstTimestamp, block.lastTimestamp, block.packetCount});
+        offset += BLOCK_HEADER_SIZE + block.compressedSize;
+    }
+}
+
+uint64_t UmpArchiveReader::getPacketCount() const {
+    uint64_t total = 0;
+    for (const auto& block : blocks_)
+        total += block.packetCount;
+    return total;
+}
+
+size_t UmpArchiveReader::findBlock(uint64_t timestampNs) const {
+    auto it = std::partition_point(blocks_.begin(), blocks_.end(),
+                                   [timestampNs](const UmpArchiveBlockInfo& b) { return b.lastTimestamp < timestampNs; });
+    return static_cast<size_t>(it - blocks_.begin());
+}
+
+std::vector<UmpQueueEntry> UmpArchiveReader::readBlock(size_t index) const {
+    const auto& info = blocks_.at(index);
+    uint8_t headerBytes[BLOCK_HEADER_SIZE];
+    readBytes(info.offset, headerBytes, BLOCK_HEADER_SIZE);
+    auto header = parseBlockHeader(headerBytes);
+
+    std::vector<uint8_t> compressed(header.compressedSize);
+    readBytes(info.offset + BLOCK_HEADER_SIZE, compressed.data(), compressed.size());
+    if (crc32(0, compressed.data(), static_cast<uInt>(compressed.size())) != header.crc)
+        throw std::runtime_error("UmpArchiveReader: block checksum mismatch");
+    std::vector<uint8_t> raw(header.rawSize);
+    uLongf rawSize = header.rawSize;
+    if (uncompress(raw.data(), &rawSize, compressed.data(), static_cast<uLong>(compressed.size())) != Z_OK ||
+        rawSize != header.rawSize)
+        throw std::runtime_error("UmpArchiveReader: zlib decompression failed");
+
+    std::vector<UmpQueueEntry> entries(header.packetCount);
+    size_t pos = 0;
+    uint64_t timestamp = header.firstTimestamp;
+    for (auto& entry : entries) {
+        uint64_t delta = 0;
+        for (int shift = 0; pos < raw.size(); shift += 7) {
+            uint8_t b = raw[pos++];
+            delta |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                break;
+        }
+        timestamp += delta;
+        entry.timestamp = timestamp;
+    }
+    for (auto& entry : entries) {
+        if (pos + 4 > raw.size())
+            throw std::runtime_error("UmpArchiveReader: corrupted block");
+        uint32_t first = getU32(raw.data() + pos);
+        entry.sizeInInts = umpPacketSizeInInts[first >> 28];
+        if (pos + entry.sizeInInts * 4 > raw.size())
+            throw std::runtime_error("UmpArchiveReader: corrupted block");
+        entry.words = {};
+        for (size_t i = 0; i < entry.sizeInInts; i++, pos += 4)
+            entry.words[i] = getU32(raw.data() + pos);
+    }
+    return entries;
+}
+
+std::vector<UmpQueueEntry> UmpArchiveReader::read(uint64_t startNs, uint64_t endNs, unsigned threads) const {
+    size_t first = findBlock(startNs);
+    size_t last = static_cast<size_t>(
+        std::partition_point(blocks_.begin() + first, blocks_.end(),
+                             [endNs](const UmpArchiveBlockInfo& b) { return b.firstTimestamp < endNs; }) -
+        blocks_.begin());
+    size_t count = last > first ? last - first : 0;
+
+    std::vector<std::vector<UmpQueueEntry>> parts(count);
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    auto worker = [&] {
+        for (size_t i; (i = next.fetch_add(1)) < count;) {
+            try {
+                parts[i] = readBlock(first + i);
+            } catch (...) {
+                if (!failed.exchange(true))
+                    error = std::current_exception();
+                return;
+            }
+        }
+    };
+    size_t workerCount = std::min<size_t>(std::max(threads, 1u), count);
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < workerCount; i++)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+
+    std::vector<UmpQueueEntry> result;
+    for (auto& part : parts)
+        for (auto& entry : part)
+            if (entry.timestamp >= startNs && entry.timestamp < endNs)
+                result.push_back(entry);
+    return result;
+}
+
+} // namespace umppi
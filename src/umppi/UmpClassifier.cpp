@@ -0,0 +1,75 @@
+#include <umppi/details/UmpClassifier.hpp>
+
+namespace umppi {
+
+bool UmpClassifier::scan(UmpWordSpan words) {
+    words_ = words;
+    offsets_.clear();
+    keys_.clear();
+    truncatedWords_ = 0;
+
+    size_t size = words.size();
+    size_t pos = 0;
+    while (pos < size) {
+        uint32_t word = words[pos];
+        size_t next = pos + umpPacketSizeInInts[word >> 28];
+        if (next > size) {
+            truncatedWords_ = size - pos;
+            break;
+        }
+        offsets_.push_back(static_cast<uint32_t>(pos));
+        keys_.push_back(static_cast<uint16_t>(word >> 16));
+        pos = next;
+    }
+    return truncatedWords_ == 0;
+}
+
+UmpWordSpan UmpClassifier::getPacket(size_t index) const {
+    uint32_t offset = offsets_[index];
+    return words_.subspan(offset, umpPacketSizeInInts[keys_[index] >> 12]);
+}
+
+Ump UmpClassifier::getUmp(size_t index) const {
+    auto packet = getPacket(index);
+    Ump ump;
+    uint32_t* ints[] = {&ump.int1, &ump.int2, &ump.int3, &ump.int4};
+    for (size_t i = 0; i < packet.size() && i < 4; i++)
+        *ints[i] = packet[i];
+    return ump;
+}
+
+std::array<uint32_t, 16> UmpClassifier::countByMessageType() const {
+    std::array<uint32_t, 16> counts{};
+    for (uint16_t key : keys_)
+        counts[key >> 12]++;
+    return counts;
+}
+
+size_t UmpClassifier::select(const UmpFilter& filter, std::vector<uint32_t>& indices) const {
+    size_t start = indices.size();
+    size_t count = keys_.size();
+    // Write every index unconditionally and advance only on match, so that the loop has no branch.
+    indices.resize(start + count);
+    uint32_t* out = indices.data() + start;
+    size_t matched = 0;
+    for (size_t i = 0; i < count; i++) {
+        out[matched] = static_cast<uint32_t>(i);
+        matched += evaluate(filter, keys_[i]);
+    }
+    indices.resize(start + matched);
+    return matched;
+}
+
+size_t UmpClassifier::selectMask(const UmpFilter& filter, std::vector<uint64_t>& mask) const {
+    size_t count = keys_.size();
+    mask.assign((count + 63) / 64, 0);
+    size_t matched = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t bit = evaluate(filter, keys_[i]);
+        mask[i / 64] |= bit << (i % 64);
+        matched += bit;
+    }
+    return matched;
+}
+
+} // namespace umppi
@@ -0,0 +1,124 @@
+#include <umppi/details/UmpCoalescer.hpp>
+#include <umppi/details/Common.hpp>
+#include <algorithm>
+
+namespace umppi {
+
+namespace {
+
+// Bank select, data entry and parameter selection CCs are only meaningful in sequence,
+// and channel mode messages act on notes, so they are never coalesced.
+bool isOrderSensitiveCC(uint8_t index) {
+    switch (index) {
+        case MidiCC::BANK_SELECT:
+        case MidiCC::BANK_SELECT_LSB:
+        case MidiCC::DTE_MSB:
+        case MidiCC::DTE_LSB:
+        case MidiCC::DTE_INCREMENT:
+        case MidiCC::DTE_DECREMENT:
+        case MidiCC::NRPN_LSB:
+        case MidiCC::NRPN_MSB:
+        case MidiCC::RPN_LSB:
+        case MidiCC::RPN_MSB:
+            return true;
+        default:
+            return index >= MidiCC::ALL_SOUND_OFF;
+    }
+}
+
+} // namespace
+
+UmpCoalescer::UmpCoalescer(Sender sender, std::chrono::microseconds flushInterval)
+    : sender_(std::move(sender)), flushInterval_(flushInterval) {
+}
+
+bool UmpCoalescer::getCoalescingKey(UmpWordSpan packet, uint32_t& key) {
+    if (packet.empty())
+        return false;
+    uint32_t word = packet[0];
+    auto type = static_cast<uint8_t>(word >> 28);
+    uint8_t status = (word >> 16) & 0xF0;
+    uint8_t index = (word >> 8) & 0x7F;
+
+    if (type == static_cast<uint8_t>(MessageType::MIDI1)) {
+        switch (status) {
+            case MidiChannelStatus::CC:
+                if (isOrderSensitiveCC(index))
+                    return false;
+                key = word & 0xFFFFFF00;
+                return true;
+            case MidiChannelStatus::PAF:
+                key = word & 0xFFFFFF00;
+                return true;
+            case MidiChannelStatus::CAF:
+            case MidiChannelStatus::PITCH_BEND:
+                key = word & 0xFFFF0000;
+                return true;
+        }
+        return false;
+    }
+
+    if (type == static_cast<uint8_t>(MessageType::MIDI2) && packet.size() >= 2) {
+        switch (status) {
+            case MidiChannelStatus::CC:
+                if (isOrderSensitiveCC(index))
+                    return false;
+                [[fallthrough]];
+            // For these the first word holds exactly (group, channel, note, index); the value is in the second.
+            case MidiChannelStatus::PER_NOTE_RCC:
+            case MidiChannelStatus::PER_NOTE_ACC:
+            case MidiChannelStatus::RPN:
+            case MidiChannelStatus::NRPN:
+            case MidiChannelStatus::PER_NOTE_PITCH_BEND:
+            case MidiChannelStatus::PAF:
+            case MidiChannelStatus::CAF:
+            case MidiChannelStatus::PITCH_BEND:
+                key = word;
+                return true;
+        }
+    }
+    return false;
+}
+
+void UmpCoalescer::send(UmpWordSpan packet, Clock::time_point now) {
+    uint32_t key;
+    if (!getCoalescingKey(packet, key)) {
+        flushPending(now);
+        sender_(packet);
+        return;
+    }
+
+    if (pending_.empty() && now - lastFlush_ >= flushInterval_) {
+        lastFlush_ = now;
+        sender_(packet);
+        return;
+    }
+
+    Pending entry{key, {}, static_cast<uint8_t>(std::min<size_t>(packet.size(), 4))};
+    std::copy_n(packet.begin(), entry.sizeInInts, entry.words.begin());
+    auto it = std::find_if(pending_.begin(), pending_.end(), [key](const Pending& p) { return p.key == key; });
+    if (it != pending_.end()) {
+        *it = entry;
+        coalesced_++;
+    } else {
+        pending_.push_back(entry);
+    }
+}
+
+bool UmpCoalescer::flushIfDue(Clock::time_point now) {
+    if (pending_.empty() || now - lastFlush_ < flushInterval_)
+        return false;
+    flushPending(now);
+    return true;
+}
+
+void UmpCoalescer::flushPending(Clock::time_point now) {
+    if (pending_.empty())
+        return;
+    lastFlush_ = now;
+    for (const auto& entry : pending_)
+        sender_({entry.words.data(), entry.sizeInInts});
+    pending_.clear();
+}
+
+} // namespace umppi
@@ -0,0 +1,136 @@
+#include <umppi/details/UmpDemux.hpp>
+#include <bit>
+#include <stdexcept>
+
+namespace umppi {
+
+UmpPacketQueue::UmpPacketQueue(size_t capacity)
+    : entries_(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)), mask_(entries_.size() - 1) {
+}
+
+bool UmpPacketQueue::push(UmpWordSpan packet, uint64_t timestamp) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == entries_.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    auto& entry = entries_[tail & mask_];
+    entry.timestamp = timestamp;
+    entry.sizeInInts = static_cast<uint8_t>(packet.size() < 4 ? packet.size() : 4);
+    for (size_t i = 0; i < entry.sizeInInts; i++)
+        entry.words[i] = packet[i];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool UmpPacketQueue::pop(UmpQueueEntry& entry) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+        return false;
+    entry = entries_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+size_t UmpPacketQueue::size() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+}
+
+UmpDemux::RouteId UmpDemux::allocateRoute(const UmpFilter& filter) {
+    for (size_t i = 0; i < MAX_ROUTES; i++) {
+        if (!routes_[i].active) {
+            routes_[i].active = true;
+            routes_[i].filter = filter;
+            return static_cast<RouteId>(i);
+        }
+    }
+    throw std::length_error("UmpDemux: too many routes");
+}
+
+UmpDemux::RouteId UmpDemux::addRoute(const UmpFilter& filter, RouteCallback callback) {
+    RouteId id = allocateRoute(filter);
+    routes_[id].callback = std::move(callback);
+    compile();
+    return id;
+}
+
+UmpDemux::RouteId UmpDemux::addQueueRoute(const UmpFilter& filter, size_t capacity) {
+    RouteId id = allocateRoute(filter);
+    routes_[id].queue = std::make_unique<UmpPacketQueue>(capacity);
+    compile();
+    return id;
+}
+
+void UmpDemux::removeRoute(RouteId id) {
+    if (id < 0 || static_cast<size_t>(id) >= MAX_ROUTES)
+        return;
+    routes_[id] = Route{};
+    compile();
+}
+
+void UmpDemux::clearRoutes() {
+    for (auto& route : routes_)
+        route = Route{};
+    compile();
+}
+
+UmpPacketQueue* UmpDemux::getQueue(RouteId id) const {
+    if (id < 0 || static_cast<size_t>(id) >= MAX_ROUTES)
+        return nullptr;
+    return routes_[id].queue.get();
+}
+
+void UmpDemux::compile() {
+    for (size_t index = 0; index < table_.size(); index++) {
+        // rebuild the packet key with status nibble 0; statuses are not routed on.
+        auto key = static_cast<uint16_t>(((index & 0xFF0) << 4) | (index & 0xF));
+        uint64_t mask = 0;
+        for (size_t r = 0; r < MAX_ROUTES; r++) {
+            if (!routes_[r].active)
+                continue;
+            UmpFilter filter = routes_[r].filter;
+            filter.statuses = 0xFFFF;
+            if (UmpClassifier::matches(filter, key))
+                mask |= uint64_t{1} << r;
+        }
+        table_[index] = mask;
+    }
+    for (size_t status = 0; status < statusTable_.size(); status++) {
+        uint64_t mask = 0;
+        for (size_t r = 0; r < MAX_ROUTES; r++) {
+            if (routes_[r].active && ((routes_[r].filter.statuses >> status) & 1))
+                mask |= uint64_t{1} << r;
+        }
+        statusTable_[status] = mask;
+    }
+}
+
+size_t UmpDemux::process(UmpWordSpan words, uint64_t timestamp) {
+    size_t unrouted = 0;
+    size_t size = words.size();
+    size_t pos = 0;
+    while (pos < size) {
+        uint32_t word = words[pos];
+        size_t packetSize = umpPacketSizeInInts[word >> 28];
+        if (pos + packetSize > size) {
+            truncatedPackets_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        auto packet = words.subspan(pos, packetSize);
+        uint64_t mask = table_[getTableIndex(word)] & statusTable_[(word >> 20) & 0xF];
+        if (mask == 0)
+            unrouted++;
+        while (mask != 0) {
+            auto& route = routes_[std::countr_zero(mask)];
+            if (route.callback)
+                route.callback(packet, timestamp);
+            else
+                route.queue->push(packet, timestamp);
+            mask &= mask - 1;
+        }
+        pos += packetSize;
+    }
+    return unrouted;
+}
+
+} // namespace umppi
@@ -0,0 +1,160 @@
+#include <umppi/details/UmpScheduler.hpp>
+#include <umppi/details/UmpClassifier.hpp>
+#include <umppi/details/UmpFactory.hpp>
+#include <algorithm>
+#include <bit>
+
+namespace umppi {
+
+namespace {
+// JR Timestamps count in units of 1/31250 seconds.
+constexpr uint64_t JR_TICK_NS = 1000000000ULL / 31250;
+}
+
+UmpScheduler::UmpScheduler(Sender sender, Options options)
+    : sender_(std::move(sender)), options_(options),
+      slots_(std::bit_ceil(options.inputCapacity < 2 ? size_t{2} : options.inputCapacity)),
+      mask_(slots_.size() - 1) {
+    for (size_t i = 0; i < slots_.size(); i++)
+        slots_[i].turn.store(i, std::memory_order_relaxed);
+    heap_.reserve(slots_.size());
+    thread_ = std::thread([this] { run(); });
+}
+
+UmpScheduler::~UmpScheduler() {
+    stop();
+}
+
+uint64_t UmpScheduler::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool UmpScheduler::schedule(UmpWordSpan words, uint64_t timestamp_ns) {
+    if (timestamp_ns == 0)
+        timestamp_ns = now();
+    bool accepted = true;
+    for (size_t i = 0; i < words.size();) {
+        size_t size = std::min<size_t>(umpPacketSizeInInts[words[i] >> 28], words.size() - i);
+        if (!push(words.subspan(i, size), timestamp_ns)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            accepted = false;
+        }
+        i += size;
+    }
+    if (sleeping_.load()) {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+    }
+    wake_.notify_one();
+    return accepted;
+}
+
+void UmpScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        running_.store(false);
+    }
+    wake_.notify_one();
+    drained_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void UmpScheduler::flush() {
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    drained_.wait(lock, [this] { return pending_.load() == 0 || !running_.load(); });
+}
+
+// Bounded multi-producer ring: each slot's turn tells whether it is free for the producer
+// at that position or filled for the consumer, so producers only contend on enqueuePos_.
+bool UmpScheduler::push(UmpWordSpan packet, uint64_t timestamp) {
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots_[pos & mask_];
+        size_t turn = slot->turn.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(turn - pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1))
+                break;
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+    auto& entry = slot->entry;
+    entry.timestamp = timestamp;
+    entry.sequence = sequence_.fetch_add(1, std::memory_order_relaxed);
+    entry.sizeInInts = static_cast<uint8_t>(std::min<size_t>(packet.size(), 4));
+    std::copy_n(packet.begin(), entry.sizeInInts, entry.words.begin());
+    pending_.fetch_add(1, std::memory_order_release);
+    slot->turn.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool UmpScheduler::pop(Entry& entry) {
+    size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    auto& slot = slots_[pos & mask_];
+    if (slot.turn.load(std::memory_order_acquire) != pos + 1)
+        return false;
+    entry = slot.entry;
+    dequeuePos_.store(pos + 1, std::memory_order_relaxed);
+    slot.turn.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+}
+
+void UmpScheduler::run() {
+    Entry entry;
+    while (running_.load()) {
+        while (pop(entry)) {
+            heap_.push_back(entry);
+            std::push_heap(heap_.begin(), heap_.end(), Later{});
+        }
+
+        uint64_t current = now();
+        while (!heap_.empty() && heap_.front().timestamp <= current) {
+            std::pop_heap(heap_.begin(), heap_.end(), Later{});
+            dispatch(heap_.back());
+            heap_.pop_back();
+        }
+
+        uint64_t spinThreshold = static_cast<uint64_t>(options_.spinThreshold.count());
+        if (!heap_.empty() && heap_.front().timestamp - current <= spinThreshold) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        sleeping_.store(true);
+        // Re-checked after announcing the sleep, so that a producer either sees sleeping_ or its packet is seen here.
+        if (running_.load() && enqueuePos_.load() == dequeuePos_.load(std::memory_order_relaxed)) {
+            if (heap_.empty()) {
+                wake_.wait(lock);
+            } else {
+                auto wakeAt = std::chrono::steady_clock::time_point(
+                    std::chrono::nanoseconds(heap_.front().timestamp - spinThreshold));
+                wake_.wait_until(lock, wakeAt);
+            }
+        }
+        sleeping_.store(false);
+    }
+}
+
+void UmpScheduler::dispatch(const Entry& entry) {
+    if (options_.insertJrTimestamps) {
+        std::array<uint32_t, 5> words{};
+        words[0] = UmpFactory::jrTimestamp(static_cast<uint16_t>((entry.timestamp / JR_TICK_NS) & 0xFFFF));
+        std::copy_n(entry.words.begin(), entry.sizeInInts, words.begin() + 1);
+        sender_({words.data(), entry.sizeInInts + size_t{1}}, entry.timestamp);
+    } else {
+        sender_({entry.words.data(), entry.sizeInInts}, entry.timestamp);
+    }
+    sent_.fetch_add(1, std::memory_order_relaxed);
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        drained_.notify_all();
+    }
+}
+
+} // namespace umppi
@@ -0,0 +1,243 @@
+#include <umppi/details/UmpToMidi1Stream.hpp>
+
+namespace umppi {
+
+UmpToMidi1Stream::UmpToMidi1Stream(bool useRunningStatus, bool elideParameterSelection)
+    : useRunningStatus(useRunningStatus), elideParameterSelection(elideParameterSelection) {
+}
+
+void UmpToMidi1Stream::reset() {
+    channels_.fill(ChannelState{});
+    runningStatus_ = 0;
+    sysex7_.clear();
+    sysexPending_ = false;
+}
+
+size_t UmpToMidi1Stream::process(std::vector<uint8_t>& dst, const std::vector<Ump>& src) {
+    size_t total = 0;
+    for (const auto& ump : src)
+        total += process(dst, ump);
+    return total;
+}
+
+size_t UmpToMidi1Stream::process(std::vector<uint8_t>& dst, const Ump& ump) {
+    size_t start = dst.size();
+    uint8_t statusCode = ump.getStatusCode();
+    uint8_t channel = ump.getChannelInGroup();
+
+    switch (ump.getMessageType()) {
+        case MessageType::SYSTEM:
+            emitSystemMessage(dst, ump.getStatusByte(), ump);
+            break;
+
+        case MessageType::MIDI1:
+            switch (statusCode) {
+                case MidiChannelStatus::PROGRAM:
+                case MidiChannelStatus::CAF:
+                    emitChannelMessage(dst, ump.getStatusByte(), ump.getMidi1Msb());
+                    break;
+                case MidiChannelStatus::CC:
+                    trackMidi1ControlChange(channel, ump.getMidi1Msb(), ump.getMidi1Lsb());
+                    emitChannelMessage(dst, ump.getStatusByte(), ump.getMidi1Msb(), ump.getMidi1Lsb());
+                    break;
+                case MidiChannelStatus::NOTE_OFF:
+                    if (noteOffAsNoteOnZeroVelocity)
+                        emitChannelMessage(dst, MidiChannelStatus::NOTE_ON | channel, ump.getMidi1Msb(), 0);
+                    else
+                        emitChannelMessage(dst, ump.getStatusByte(), ump.getMidi1Msb(), ump.getMidi1Lsb());
+                    break;
+                default:
+                    emitChannelMessage(dst, ump.getStatusByte(), ump.getMidi1Msb(), ump.getMidi1Lsb());
+                    break;
+            }
+            break;
+
+        case MessageType::MIDI2:
+            switch (statusCode) {
+                case MidiChannelStatus::RPN:
+                case MidiChannelStatus::NRPN: {
+                    bool isRpn = statusCode == MidiChannelStatus::RPN;
+                    uint32_t data = isRpn ? ump.getMidi2RpnData() : ump.getMidi2NrpnData();
+                    emitParameterSelection(dst, channel, isRpn ? DteTarget::RPN : DteTarget::NRPN,
+                                           ump.getMidi2RpnMsb(), ump.getMidi2RpnLsb());
+                    uint8_t ccStatus = MidiChannelStatus::CC | channel;
+                    emitChannelMessage(dst, ccStatus, MidiCC::DTE_MSB, static_cast<uint8_t>((data >> 25) & 0x7F));
+                    emitChannelMessage(dst, ccStatus, MidiCC::DTE_LSB, static_cast<uint8_t>((data >> 18) & 0x7F));
+                    break;
+                }
+
+                case MidiChannelStatus::NOTE_OFF:
+                    if (noteOffAsNoteOnZeroVelocity)
+                        emitChannelMessage(dst, MidiChannelStatus::NOTE_ON | channel, ump.getMidi2Note(), 0);
+                    else
+                        emitChannelMessage(dst, ump.getStatusByte(), ump.getMidi2Note(),
+                                           static_cast<uint8_t>(ump.getMidi2Velocity16() / 0x200));
+                    break;
+
+                case MidiChannelStatus::NOTE_ON:
+                    emitChannelMessage(dst, ump.getStatusByte(), ump.getMidi2Note(),
+                                       static_cast<uint8_t>(ump.getMidi2Velocity16() / 0x200));
+                    break;
+
+                case MidiChannelStatus::PAF:
+                    emitChannelMessage(dst, ump.getStatusByte(), ump.getMidi2Note(),
+                                       static_cast<uint8_t>(ump.getMidi2PafData() / 0x2000000U));
+                    break;
+
+                case MidiChannelStatus::CC: {
+                    uint8_t index = ump.getMidi2CcIndex();
+                    uint8_t value = static_cast<uint8_t>(ump.getMidi2CcData() / 0x2000000U);
+                    trackMidi1ControlChange(channel, index, value);
+                    emitChannelMessage(dst, ump.getStatusByte(), index, value);
+                    break;
+                }
+
+                case MidiChannelStatus::PROGRAM:
+                    if (ump.getMidi2ProgramOptions() & MidiProgramChangeOptions::BANK_VALID)
+                        emitBankSelection(dst, channel, ump.getMidi2ProgramBankMsb(), ump.getMidi2ProgramBankLsb());
+                    emitChannelMessage(dst, MidiChannelStatus::PROGRAM | channel, ump.getMidi2ProgramProgram());
+                    break;
+
+                case MidiChannelStatus::CAF:
+                    emitChannelMessage(dst, ump.getStatusByte(), static_cast<uint8_t>(ump.getMidi2CafData() / 0x2000000U));
+                    break;
+
+                case MidiChannelStatus::PITCH_BEND: {
+                    uint32_t pitchBendV1 = ump.getMidi2PitchBendData() / 0x40000U;
+                    // Note: MIDI1 pitch bend is little endian
+                    emitChannelMessage(dst, ump.getStatusByte(),
+                                       static_cast<uint8_t>(pitchBendV1 & 0x7F),
+                                       static_cast<uint8_t>((pitchBendV1 >> 7) & 0x7F));
+                    break;
+                }
+
+                default:
+                    // no Default Translation for per-note and relative messages
+                    break;
+            }
+            break;
+
+        case MessageType::SYSEX7: {
+            BinaryChunkStatus status = ump.getBinaryChunkStatus();
+            if (status == BinaryChunkStatus::START || status == BinaryChunkStatus::COMPLETE_PACKET)
+                sysex7_.clear();
+            uint8_t size = ump.getSysex7Size();
+            for (int i = 0; i < size && i < 6; ++i) {
+                if (i == 0) sysex7_.push_back((ump.int1 >> 8) & 0x7F);
+                else if (i == 1) sysex7_.push_back(ump.int1 & 0x7F);
+                else sysex7_.push_back((ump.int2 >> (24 - (i - 2) * 8)) & 0x7F);
+            }
+            sysexPending_ = true;
+            if (status == BinaryChunkStatus::END || status == BinaryChunkStatus::COMPLETE_PACKET) {
+                dst.push_back(Midi1Status::SYSEX);
+                dst.insert(dst.end(), sysex7_.begin(), sysex7_.end());
+                dst.push_back(Midi1Status::SYSEX_END);
+                sysex7_.clear();
+                sysexPending_ = false;
+                runningStatus_ = 0;
+            }
+            break;
+        }
+
+        default:
+            // Utility, SysEx8/MDS, Flex Data and UMP Stream messages cannot be sent over MIDI 1.0
+            break;
+    }
+
+    return dst.size() - start;
+}
+
+void UmpToMidi1Stream::emitChannelMessage(std::vector<uint8_t>& dst, uint8_t status, uint8_t data1) {
+    if (!useRunningStatus || status != runningStatus_)
+        dst.push_back(status);
+    runningStatus_ = status;
+    dst.push_back(data1);
+}
+
+void UmpToMidi1Stream::emitChannelMessage(std::vector<uint8_t>& dst, uint8_t status, uint8_t data1, uint8_t data2) {
+    emitChannelMessage(dst, status, data1);
+    dst.push_back(data2);
+}
+
+void UmpToMidi1Stream::emitSystemMessage(std::vector<uint8_t>& dst, uint8_t status, const Ump& ump) {
+    dst.push_back(status);
+    switch (status) {
+        case MidiSystemStatus::MIDI_TIME_CODE:
+        case MidiSystemStatus::SONG_SELECT:
+            dst.push_back(ump.getMidi1Msb());
+            break;
+        case MidiSystemStatus::SONG_POSITION:
+            dst.push_back(ump.getMidi1Msb());
+            dst.push_back(ump.getMidi1Lsb());
+            break;
+    }
+    // System Real Time messages do not affect running status, System Common messages cancel it.
+    if (status < MidiSystemStatus::TIMING_CLOCK)
+        runningStatus_ = 0;
+}
+
+void UmpToMidi1Stream::emitParameterSelection(std::vector<uint8_t>& dst, uint8_t channel, DteTarget target,
+                                              uint8_t msb, uint8_t lsb) {
+    auto& ch = channels_[channel];
+    bool isRpn = target == DteTarget::RPN;
+    uint16_t& state = isRpn ? ch.rpnState : ch.nrpnState;
+    // Switching between RPN and NRPN always resends both bytes; receivers differ in what they retain.
+    bool sameTarget = elideParameterSelection && ch.dteTargetKnown && ch.dteTarget == target;
+    uint8_t ccStatus = MidiChannelStatus::CC | channel;
+
+    if (!sameTarget || (state >> 8) != msb)
+        emitChannelMessage(dst, ccStatus, isRpn ? MidiCC::RPN_MSB : MidiCC::NRPN_MSB, msb);
+    if (!sameTarget || (state & 0xFF) != lsb)
+        emitChannelMessage(dst, ccStatus, isRpn ? MidiCC::RPN_LSB : MidiCC::NRPN_LSB, lsb);
+
+    state = static_cast<uint16_t>((msb << 8) | lsb);
+    ch.dteTarget = target;
+    ch.dteTargetKnown = true;
+}
+
+void UmpToMidi1Stream::emitBankSelection(std::vector<uint8_t>& dst, uint8_t channel, uint8_t msb, uint8_t lsb) {
+    auto& ch = channels_[channel];
+    uint8_t ccStatus = MidiChannelStatus::CC | channel;
+
+    if (!elideParameterSelection || (ch.bankState >> 8) != msb)
+        emitChannelMessage(dst, ccStatus, MidiCC::BANK_SELECT, msb);
+    if (!elideParameterSelection || (ch.bankState & 0xFF) != lsb)
+        emitChannelMessage(dst, ccStatus, MidiCC::BANK_SELECT_LSB, lsb);
+
+    ch.bankState = static_cast<uint16_t>((msb << 8) | lsb);
+}
+
+// Keeps the remembered selection in sync when the selection CCs are sent explicitly.
+void UmpToMidi1Stream::trackMidi1ControlChange(uint8_t channel, uint8_t index, uint8_t value) {
+    auto& ch = channels_[channel];
+    switch (index) {
+        case MidiCC::RPN_MSB:
+            ch.rpnState = static_cast<uint16_t>((ch.rpnState & 0xFF) | (value << 8));
+            ch.dteTarget = DteTarget::RPN;
+            ch.dteTargetKnown = true;
+            break;
+        case MidiCC::RPN_LSB:
+            ch.rpnState = static_cast<uint16_t>((ch.rpnState & 0xFF00) | value);
+            ch.dteTarget = DteTarget::RPN;
+            ch.dteTargetKnown = true;
+            break;
+        case MidiCC::NRPN_MSB:
+            ch.nrpnState = static_cast<uint16_t>((ch.nrpnState & 0xFF) | (value << 8));
+            ch.dteTarget = DteTarget::NRPN;
+            ch.dteTargetKnown = true;
+            break;
+        case MidiCC::NRPN_LSB:
+            ch.nrpnState = static_cast<uint16_t>((ch.nrpnState & 0xFF00) | value);
+            ch.dteTarget = DteTarget::NRPN;
+            ch.dteTargetKnown = true;
+            break;
+        case MidiCC::BANK_SELECT:
+            ch.bankState = static_cast<uint16_t>((ch.bankState & 0xFF) | (value << 8));
+            break;
+        case MidiCC::BANK_SELECT_LSB:
+            ch.bankState = static_cast<uint16_t>((ch.bankState & 0xFF00) | value);
+            break;
+    }
+}
+
+} // namespace umppi
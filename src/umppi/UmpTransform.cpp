@@ -0,0 +1,225 @@
+#include <umppi/details/UmpTransform.hpp>
+#include <umppi/details/Common.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace umppi {
+
+namespace {
+
+constexpr uint32_t MIDI1 = MidiMessageType::MIDI1;
+constexpr uint32_t MIDI2 = MidiMessageType::MIDI2;
+
+// Bit n is set if status n (upper nibble) carries a note number in the third byte of the first word.
+constexpr uint16_t MIDI1_NOTE_STATUSES = (1u << 0x8) | (1u << 0x9) | (1u << 0xA);
+constexpr uint16_t MIDI2_NOTE_STATUSES = (1u << 0x0) | (1u << 0x1) | (1u << 0x6) | (1u << 0x8) | (1u << 0x9) |
+                                         (1u << 0xA) | (1u << 0xF);
+// Message types that have no group: Utility and UMP Stream.
+constexpr uint16_t GROUPLESS_TYPES = (1u << MidiMessageType::UTILITY) | (1u << MidiMessageType::UMP_STREAM);
+
+uint32_t toUint32Range(double normalized) {
+    return static_cast<uint32_t>(std::lround(std::clamp(normalized, 0.0, 1.0) * 0xFFFFFFFFu));
+}
+
+uint32_t scale(uint32_t value, uint32_t full, uint32_t outMin, uint32_t outMax) {
+    int64_t range = static_cast<int64_t>(outMax) - static_cast<int64_t>(outMin);
+    // |range| * value fits in 64 bits since both are below 2^32
+    int64_t offset = range >= 0 ? static_cast<int64_t>((static_cast<uint64_t>(range) * value) / full)
+                                : -static_cast<int64_t>((static_cast<uint64_t>(-range) * value) / full);
+    return static_cast<uint32_t>(static_cast<int64_t>(outMin) + offset);
+}
+
+} // namespace
+
+VelocityCurve VelocityCurve::fromFunction(const std::function<double(double)>& curve) {
+    VelocityCurve result;
+    for (size_t i = 0; i < result.table_.size(); i++) {
+        double x = std::min(1.0, static_cast<double>(i << 8) / 0xFFFF);
+        result.table_[i] = static_cast<uint16_t>(std::lround(std::clamp(curve(x), 0.0, 1.0) * 0xFFFF));
+    }
+    result.table7_[0] = 0;
+    for (size_t i = 1; i < result.table7_.size(); i++) {
+        long v = std::lround(std::clamp(curve(static_cast<double>(i) / 127), 0.0, 1.0) * 127);
+        result.table7_[i] = static_cast<uint8_t>(std::clamp(v, 1L, 127L));
+    }
+    return result;
+}
+
+VelocityCurve VelocityCurve::linear() {
+    return fromFunction([](double x) { return x; });
+}
+
+VelocityCurve VelocityCurve::gamma(double exponent) {
+    return fromFunction([exponent](double x) { return std::pow(x, exponent); });
+}
+
+VelocityCurve VelocityCurve::fixed(double velocity) {
+    return fromFunction([velocity](double) { return velocity; });
+}
+
+UmpTransformPipeline& UmpTransformPipeline::transpose(int semitones, const UmpFilter& filter) {
+    Stage stage{StageKind::Transpose, filter};
+    stage.semitones = semitones;
+    stages_.push_back(std::move(stage));
+    return *this;
+}
+
+UmpTransformPipeline& UmpTransformPipeline::applyVelocityCurve(const VelocityCurve& curve, const UmpFilter& filter) {
+    Stage stage{StageKind::VelocityCurve, filter};
+    stage.curve = std::make_shared<const VelocityCurve>(curve);
+    stages_.push_back(std::move(stage));
+    return *this;
+}
+
+UmpTransformPipeline& UmpTransformPipeline::remapGroups(const std::array<uint8_t, 16>& map) {
+    Stage stage{StageKind::GroupRemap, UmpFilter::all()};
+    for (size_t i = 0; i < 16; i++)
+        stage.map[i] = map[i] & 0xF;
+    stages_.push_back(std::move(stage));
+    return *this;
+}
+
+UmpTransformPipeline& UmpTransformPipeline::remapGroup(uint8_t from, uint8_t to) {
+    std::array<uint8_t, 16> map;
+    for (uint8_t i = 0; i < 16; i++)
+        map[i] = i;
+    map[from & 0xF] = to;
+    return remapGroups(map);
+}
+
+UmpTransformPipeline& UmpTransformPipeline::remapChannels(const std::array<uint8_t, 16>& map, const UmpFilter& filter) {
+    Stage stage{StageKind::ChannelRemap, filter};
+    for (size_t i = 0; i < 16; i++)
+        stage.map[i] = map[i] & 0xF;
+    stages_.push_back(std::move(stage));
+    return *this;
+}
+
+UmpTransformPipeline& UmpTransformPipeline::remapChannel(uint8_t from, uint8_t to, const UmpFilter& filter) {
+    std::array<uint8_t, 16> map;
+    for (uint8_t i = 0; i < 16; i++)
+        map[i] = i;
+    map[from & 0xF] = to;
+    return remapChannels(map, filter);
+}
+
+UmpTransformPipeline& UmpTransformPipeline::scaleControlChange(uint8_t index, double outMin, double outMax,
+                                                               const UmpFilter& filter) {
+    Stage stage{StageKind::ScaleControlChange, filter};
+    stage.ccIndex = index & 0x7F;
+    stage.outMin = toUint32Range(outMin);
+    stage.outMax = toUint32Range(outMax);
+    stages_.push_back(std::move(stage));
+    return *this;
+}
+
+bool UmpTransformPipeline::applyStage(const Stage& stage, uint32_t* words) {
+    uint32_t w = words[0];
+    if (!UmpClassifier::matches(stage.filter, static_cast<uint16_t>(w >> 16)))
+        return true;
+    uint32_t type = w >> 28;
+    uint32_t status = (w >> 20) & 0xF;
+
+    switch (stage.kind) {
+        case StageKind::GroupRemap:
+            if (!((GROUPLESS_TYPES >> type) & 1))
+                words[0] = (w & 0xF0FFFFFFu) | (static_cast<uint32_t>(stage.map[(w >> 24) & 0xF]) << 24);
+            return true;
+
+        case StageKind::ChannelRemap:
+            if (type == MIDI1 || type == MIDI2)
+                words[0] = (w & 0xFFF0FFFFu) | (static_cast<uint32_t>(stage.map[(w >> 16) & 0xF]) << 16);
+            return true;
+
+        case StageKind::Transpose: {
+            uint16_t noteStatuses = type == MIDI1 ? MIDI1_NOTE_STATUSES : type == MIDI2 ? MIDI2_NOTE_STATUSES : 0;
+            if (!((noteStatuses >> status) & 1))
+                return true;
+            int note = static_cast<int>((w >> 8) & 0x7F) + stage.semitones;
+            if (note < 0 || note > 127)
+                return false;
+            words[0] = (w & 0xFFFF00FFu) | (static_cast<uint32_t>(note) << 8);
+            return true;
+        }
+
+        case StageKind::VelocityCurve:
+            if (status != 0x9)
+                return true;
+            if (type == MIDI1) {
+                uint8_t velocity = w & 0x7F;
+                // velocity 0 is a Note Off
+                if (velocity != 0)
+                    words[0] = (w & 0xFFFFFF00u) | stage.curve->apply7(velocity);
+            } else if (type == MIDI2) {
+                uint16_t velocity = static_cast<uint16_t>(words[1] >> 16);
+                words[1] = (words[1] & 0xFFFFu) | (static_cast<uint32_t>(stage.curve->apply16(velocity)) << 16);
+            }
+            return true;
+
+        case StageKind::ScaleControlChange:
+            if (status != 0xB || ((w >> 8) & 0x7F) != stage.ccIndex)
+                return true;
+            if (type == MIDI1) {
+                uint32_t value = scale(w & 0x7F, 0x7F, stage.outMin >> 25, stage.outMax >> 25);
+                words[0] = (w & 0xFFFFFF00u) | value;
+            } else if (type == MIDI2) {
+                words[1] = scale(words[1], 0xFFFFFFFFu, stage.outMin, stage.outMax);
+            }
+            return true;
+    }
+    return true;
+}
+
+bool UmpTransformPipeline::apply(std::span<uint32_t> packet) const {
+    if (packet.empty() || packet.size() < umpPacketSizeInInts[packet[0] >> 28])
+        return true;
+    for (const auto& stage : stages_)
+        if (!applyStage(stage, packet.data()))
+            return false;
+    return true;
+}
+
+bool UmpTransformPipeline::apply(Ump& ump) const {
+    std::array<uint32_t, 4> words = ump.toInts();
+    if (!apply(std::span<uint32_t>{words}))
+        return false;
+    ump = Ump(words[0], words[1], words[2], words[3]);
+    return true;
+}
+
+size_t UmpTransformPipeline::process(std::span<uint32_t> words) const {
+    size_t read = 0;
+    size_t write = 0;
+    while (read < words.size()) {
+        size_t size = umpPacketSizeInInts[words[read] >> 28];
+        if (read + size > words.size()) {
+            // incomplete packet: keep as is
+            std::copy(words.begin() + read, words.end(), words.begin() + write);
+            write += words.size() - read;
+            break;
+        }
+        bool keep = apply(words.subspan(read, size));
+        if (keep) {
+            if (write != read)
+                std::copy_n(words.begin() + read, size, words.begin() + write);
+            write += size;
+        }
+        read += size;
+    }
+    return write;
+}
+
+void UmpTransformPipeline::process(std::vector<uint32_t>& words) const {
+    words.resize(process(std::span<uint32_t>{words}));
+}
+
+void UmpTransformPipeline::process(std::vector<Ump>& messages) const {
+    size_t write = 0;
+    for (size_t read = 0; read < messages.size(); read++) {
+        if (apply(messages[read]))
+            messages[write++] = messages[read];
+    }
+    messages.resize(write);
+}
+
+} // namespace umppi
@@ -1,6 +1,7 @@
 #include <umppi/details/UmpTranslator.hpp>
 #include <umppi/details/UmpFactory.hpp>
 #include <algorithm>
+#include <array>
 
 namespace {
 
@@ -180,240 +181,292 @@ SmfMetaProcessResult translateMetaToFlexData(umppi::Midi1ToUmpTranslatorContext&
     }
 }
 
-} // namespace
+// Writes MIDI 1.0 bytes, or only counts them when out is nullptr, so that the very same code path
+// computes the exact output size before writing.
+struct Midi1ByteWriter {
+    uint8_t* out;
+    size_t size = 0;
 
-namespace umppi {
+    void put(uint8_t value) {
+        if (out)
+            out[size] = value;
+        ++size;
+    }
 
+    void putBytes(const uint8_t* values, size_t length) {
+        if (out && length > 0)
+            std::copy(values, values + length, out + size);
+        size += length;
+    }
 
-int UmpTranslator::translateUmpToMidi1Bytes(std::vector<uint8_t>& dst,
-                                            const std::vector<Ump>& src,
-                                            const UmpToMidi1BytesTranslatorContext& context) {
-    // For now, implement a simplified version without SMF delta time support
-    dst.clear();
-    std::vector<uint8_t> sysex7;
-    int deltaTime = 0;
-    
-    for (const auto& ump : src) {
-        if (ump.isDeltaClockstamp()) {
-            deltaTime += ump.getDeltaClockstamp();
-            continue;
-        }
-        if (ump.isJRTimestamp()) {
-            if (!context.skipDeltaTime) {
-                deltaTime += ump.getJRTimestamp();
-            }
-            continue;
-        }
-        
-        size_t oldSize = dst.size();
-        dst.resize(dst.size() + 16); // Reserve space for the message
-        
-        int messageSize = translateSingleUmpToMidi1Bytes(dst, ump, oldSize, 
-                                                         context.skipDeltaTime ? -1 : deltaTime, 
-                                                         &sysex7);
-        
-        dst.resize(oldSize + messageSize); // Trim to actual size
-        
-        // Handle SysEx7 completion
-        if (ump.getMessageType() == MessageType::SYSEX7) {
-            BinaryChunkStatus status = ump.getBinaryChunkStatus();
-            if (status == BinaryChunkStatus::END || status == BinaryChunkStatus::COMPLETE_PACKET) {
-                // Add complete SysEx message
-                size_t sysexStart = dst.size();
-                dst.resize(dst.size() + 2 + sysex7.size()); // F0 + data + F7
-                dst[sysexStart] = 0xF0;
-                std::copy(sysex7.begin(), sysex7.end(), dst.begin() + sysexStart + 1);
-                dst[sysexStart + 1 + sysex7.size()] = 0xF7;
-                sysex7.clear();
-            }
+    void putVariableLength(uint32_t value) {
+        uint8_t buffer[5];
+        int length = 0;
+        do {
+            buffer[length++] = static_cast<uint8_t>(value & 0x7F);
+            value >>= 7;
+        } while (value != 0);
+        while (length > 0) {
+            --length;
+            put(static_cast<uint8_t>(buffer[length] | (length > 0 ? 0x80 : 0)));
         }
-        
-        deltaTime = 0;
     }
-    
-    return sysex7.empty() ? UmpTranslationResult::OK : UmpTranslationResult::INCOMPLETE_SYSEX7;
+};
+
+size_t appendSysex7Bytes(Midi1ByteWriter& writer, const umppi::Ump& ump) {
+    uint8_t size = ump.getSysex7Size();
+    size_t start = writer.size;
+    for (int i = 0; i < size && i < 6; ++i) {
+        if (i == 0) writer.put((ump.int1 >> 8) & 0x7F);
+        else if (i == 1) writer.put(ump.int1 & 0x7F);
+        else writer.put((ump.int2 >> (24 - (i - 2) * 8)) & 0x7F);
+    }
+    return writer.size - start;
 }
 
-int UmpTranslator::translateSingleUmpToMidi1Bytes(std::vector<uint8_t>& dst,
-                                                  const Ump& ump,
-                                                  size_t dstOffset,
-                                                  int deltaTime,
-                                                  std::vector<uint8_t>* sysex) {
-    int midiEventSize = 0;
+// Writes one UMP (other than SysEx) as MIDI 1.0 events. When deltaTime >= 0, each event is prefixed
+// by its SMF delta time; messages that expand to multiple events (RPN, NRPN, banked program change)
+// get deltaTime for the first event and 0 for the rest.
+void writeMidi1Event(Midi1ByteWriter& writer, const umppi::Ump& ump, int deltaTime) {
+    using namespace umppi;
     uint8_t statusCode = ump.getStatusCode();
-    size_t offset = dstOffset;
-    
-    auto addDeltaTimeAndStatus = [&]() {
+    uint8_t channel = ump.getChannelInGroup();
+
+    auto addDeltaTimeAndStatus = [&](uint8_t status) {
         if (deltaTime >= 0) {
-            // Simplified delta time encoding (just one byte for now)
-            dst[offset++] = static_cast<uint8_t>(deltaTime & 0x7F);
+            writer.putVariableLength(static_cast<uint32_t>(deltaTime));
+            deltaTime = 0;
         }
-        dst[offset++] = ump.getStatusByte();
+        writer.put(status);
     };
-    
+    auto addControlChange = [&](uint8_t index, uint8_t value) {
+        addDeltaTimeAndStatus(channel + MidiChannelStatus::CC);
+        writer.put(index);
+        writer.put(value);
+    };
+
     switch (ump.getMessageType()) {
         case MessageType::SYSTEM:
-            addDeltaTimeAndStatus();
-            midiEventSize = 1;
-            switch (statusCode) {
-                case 0xF1:
-                case 0xF3:
-                case 0xF9:
-                    dst[offset++] = ump.getMidi1Msb();
-                    midiEventSize = 2;
+            addDeltaTimeAndStatus(ump.getStatusByte());
+            switch (ump.getStatusByte()) {
+                case MidiSystemStatus::MIDI_TIME_CODE:
+                case MidiSystemStatus::SONG_SELECT:
+                    writer.put(ump.getMidi1Msb());
+                    break;
+                case MidiSystemStatus::SONG_POSITION:
+                    writer.put(ump.getMidi1Msb());
+                    writer.put(ump.getMidi1Lsb());
                     break;
             }
             break;
-            
+
         case MessageType::MIDI1:
-            addDeltaTimeAndStatus();
-            midiEventSize = 3;
-            dst[offset++] = ump.getMidi1Msb();
+            addDeltaTimeAndStatus(ump.getStatusByte());
+            writer.put(ump.getMidi1Msb());
             switch (statusCode) {
                 case MidiChannelStatus::PROGRAM:
                 case MidiChannelStatus::CAF:
-                    midiEventSize = 2;
                     break;
                 default:
-                    dst[offset++] = ump.getMidi1Lsb();
+                    writer.put(ump.getMidi1Lsb());
                     break;
             }
             break;
-            
+
         case MessageType::MIDI2:
             switch (statusCode) {
-                case MidiChannelStatus::RPN: {
-                    midiEventSize = 12;
-                    uint8_t channel = ump.getChannelInGroup();
-                    uint8_t ccStatus = channel + MidiChannelStatus::CC;
-                    
-                    dst[offset + 0] = ccStatus;
-                    dst[offset + 1] = MidiCC::RPN_MSB;
-                    dst[offset + 2] = ump.getMidi2RpnMsb();
-                    dst[offset + 3] = ccStatus;
-                    dst[offset + 4] = MidiCC::RPN_LSB;
-                    dst[offset + 5] = ump.getMidi2RpnLsb();
-                    dst[offset + 6] = ccStatus;
-                    dst[offset + 7] = MidiCC::DTE_MSB;
-                    dst[offset + 8] = static_cast<uint8_t>((ump.getMidi2RpnData() >> 25) & 0x7F);
-                    dst[offset + 9] = ccStatus;
-                    dst[offset + 10] = MidiCC::DTE_LSB;
-                    dst[offset + 11] = static_cast<uint8_t>((ump.getMidi2RpnData() >> 18) & 0x7F);
+                case MidiChannelStatus::RPN:
+                    addControlChange(MidiCC::RPN_MSB, ump.getMidi2RpnMsb());
+                    addControlChange(MidiCC::RPN_LSB, ump.getMidi2RpnLsb());
+                    addControlChange(MidiCC::DTE_MSB, static_cast<uint8_t>((ump.getMidi2RpnData() >> 25) & 0x7F));
+                    addControlChange(MidiCC::DTE_LSB, static_cast<uint8_t>((ump.getMidi2RpnData() >> 18) & 0x7F));
                     break;
-                }
-                
-                case MidiChannelStatus::NRPN: {
-                    midiEventSize = 12;
-                    uint8_t channel = ump.getChannelInGroup();
-                    uint8_t ccStatus = channel + MidiChannelStatus::CC;
-                    
-                    dst[offset + 0] = ccStatus;
-                    dst[offset + 1] = MidiCC::NRPN_MSB;
-                    dst[offset + 2] = ump.getMidi2NrpnMsb();
-                    dst[offset + 3] = ccStatus;
-                    dst[offset + 4] = MidiCC::NRPN_LSB;
-                    dst[offset + 5] = ump.getMidi2NrpnLsb();
-                    dst[offset + 6] = ccStatus;
-                    dst[offset + 7] = MidiCC::DTE_MSB;
-                    dst[offset + 8] = static_cast<uint8_t>((ump.getMidi2NrpnData() >> 25) & 0x7F);
-                    dst[offset + 9] = ccStatus;
-                    dst[offset + 10] = MidiCC::DTE_LSB;
-                    dst[offset + 11] = static_cast<uint8_t>((ump.getMidi2NrpnData() >> 18) & 0x7F);
+
+                case MidiChannelStatus::NRPN:
+                    addControlChange(MidiCC::NRPN_MSB, ump.getMidi2NrpnMsb());
+                    addControlChange(MidiCC::NRPN_LSB, ump.getMidi2NrpnLsb());
+                    addControlChange(MidiCC::DTE_MSB, static_cast<uint8_t>((ump.getMidi2NrpnData() >> 25) & 0x7F));
+                    addControlChange(MidiCC::DTE_LSB, static_cast<uint8_t>((ump.getMidi2NrpnData() >> 18) & 0x7F));
                     break;
-                }
-                
+
                 case MidiChannelStatus::NOTE_OFF:
                 case MidiChannelStatus::NOTE_ON:
-                    addDeltaTimeAndStatus();
-                    midiEventSize = 3;
-                    dst[offset++] = ump.getMidi2Note();
-                    dst[offset++] = static_cast<uint8_t>(ump.getMidi2Velocity16() / 0x200);
+                    addDeltaTimeAndStatus(ump.getStatusByte());
+                    writer.put(ump.getMidi2Note());
+                    writer.put(static_cast<uint8_t>(ump.getMidi2Velocity16() / 0x200));
                     break;
-                    
+
                 case MidiChannelStatus::PAF:
-                    addDeltaTimeAndStatus();
-                    midiEventSize = 3;
-                    dst[offset++] = ump.getMidi2Note();
-                    dst[offset++] = static_cast<uint8_t>(ump.getMidi2PafData() / 0x2000000U);
+                    addDeltaTimeAndStatus(ump.getStatusByte());
+                    writer.put(ump.getMidi2Note());
+                    writer.put(static_cast<uint8_t>(ump.getMidi2PafData() / 0x2000000U));
                     break;
-                    
+
                 case MidiChannelStatus::CC:
-                    addDeltaTimeAndStatus();
-                    midiEventSize = 3;
-                    dst[offset++] = ump.getMidi2CcIndex();
-                    dst[offset++] = static_cast<uint8_t>(ump.getMidi2CcData() / 0x2000000U);
+                    addDeltaTimeAndStatus(ump.getStatusByte());
+                    writer.put(ump.getMidi2CcIndex());
+                    writer.put(static_cast<uint8_t>(ump.getMidi2CcData() / 0x2000000U));
                     break;
-                    
-                case MidiChannelStatus::PROGRAM: {
+
+                case MidiChannelStatus::PROGRAM:
                     if (ump.getMidi2ProgramOptions() & MidiProgramChangeOptions::BANK_VALID) {
-                        midiEventSize = 8;
-                        uint8_t channel = ump.getChannelInGroup();
-                        dst[offset + 0] = channel + MidiChannelStatus::CC;
-                        dst[offset + 1] = MidiCC::BANK_SELECT;
-                        dst[offset + 2] = ump.getMidi2ProgramBankMsb();
-                        dst[offset + 3] = channel + MidiChannelStatus::CC;
-                        dst[offset + 4] = MidiCC::BANK_SELECT_LSB;
-                        dst[offset + 5] = ump.getMidi2ProgramBankLsb();
-                        dst[offset + 6] = channel + MidiChannelStatus::PROGRAM;
-                        dst[offset + 7] = ump.getMidi2ProgramProgram();
-                    } else {
-                        midiEventSize = 2;
-                        dst[offset + 0] = ump.getChannelInGroup() + MidiChannelStatus::PROGRAM;
-                        dst[offset + 1] = ump.getMidi2ProgramProgram();
+                        addControlChange(MidiCC::BANK_SELECT, ump.getMidi2ProgramBankMsb());
+                        addControlChange(MidiCC::BANK_SELECT_LSB, ump.getMidi2ProgramBankLsb());
                     }
+                    addDeltaTimeAndStatus(channel + MidiChannelStatus::PROGRAM);
+                    writer.put(ump.getMidi2ProgramProgram());
                     break;
-                }
-                
+
                 case MidiChannelStatus::CAF:
-                    addDeltaTimeAndStatus();
-                    midiEventSize = 2;
-                    dst[offset++] = static_cast<uint8_t>(ump.getMidi2CafData() / 0x2000000U);
+                    addDeltaTimeAndStatus(ump.getStatusByte());
+                    writer.put(static_cast<uint8_t>(ump.getMidi2CafData() / 0x2000000U));
                     break;
-                    
+
                 case MidiChannelStatus::PITCH_BEND: {
-                    addDeltaTimeAndStatus();
-                    midiEventSize = 3;
+                    addDeltaTimeAndStatus(ump.getStatusByte());
                     uint32_t pitchBendV1 = ump.getMidi2PitchBendData() / 0x40000U;
                     // Note: MIDI1 pitch bend is little endian
-                    dst[offset++] = static_cast<uint8_t>(pitchBendV1 & 0x7F);
-                    dst[offset++] = static_cast<uint8_t>((pitchBendV1 >> 7) & 0x7F);
+                    writer.put(static_cast<uint8_t>(pitchBendV1 & 0x7F));
+                    writer.put(static_cast<uint8_t>((pitchBendV1 >> 7) & 0x7F));
                     break;
                 }
-                
+
                 default:
                     // Skip unsupported status bytes
-                    midiEventSize = 0;
                     break;
             }
             break;
-            
-        case MessageType::SYSEX7:
-            midiEventSize = 0;
-            if (sysex) {
-                // Extract SysEx data from UMP and add to accumulator
-                uint8_t size = ump.getSysex7Size();
-                for (int i = 0; i < size && i < 6; ++i) {
-                    uint8_t dataByte;
-                    if (i == 0) dataByte = (ump.int1 >> 8) & 0x7F;
-                    else if (i == 1) dataByte = ump.int1 & 0x7F;
-                    else dataByte = (ump.int2 >> (24 - (i - 2) * 8)) & 0x7F;
-                    sysex->push_back(dataByte);
-                }
-            }
-            break;
-            
+
         case MessageType::SYSEX8_MDS:
             // Cannot be translated in Default Translation
-            midiEventSize = 0;
             break;
-            
+
         default:
             // Ignore other message types
-            midiEventSize = 0;
             break;
     }
-    
-    return midiEventSize;
+}
+
+// The SMF text meta event for a Flex Data text status, or -1 if it has none.
+int textMetaType(uint8_t statusBank, uint8_t status) {
+    using namespace umppi;
+    switch (statusBank) {
+        case FlexDataStatusBank::METADATA_TEXT:
+            switch (status) {
+                case MetadataTextStatus::COPYRIGHT:
+                    return MidiMetaType::COPYRIGHT;
+                case MetadataTextStatus::MIDI_CLIP_NAME:
+                    return MidiMetaType::TRACK_NAME;
+                case MetadataTextStatus::PRIMARY_PERFORMER:
+                    return MidiMetaType::INSTRUMENT_NAME;
+                default:
+                    return MidiMetaType::TEXT;
+            }
+        case FlexDataStatusBank::PERFORMANCE_TEXT:
+            return status == PerformanceTextStatus::LYRICS ? MidiMetaType::LYRIC : -1;
+        default:
+            return -1;
+    }
+}
+
+// Writes Flex Data back as the SMF meta events translateMetaToFlexData() makes of them: set tempo,
+// time signature and text events. A text spanning multiple packets is collected into text until its
+// last packet. Returns true if an event was written.
+bool writeFlexDataMeta(Midi1ByteWriter& writer, const umppi::Ump& ump, int deltaTime, std::vector<uint8_t>& text) {
+    using namespace umppi;
+    uint8_t format = static_cast<uint8_t>((ump.int1 >> 22) & 0x3);
+    uint8_t statusBank = static_cast<uint8_t>((ump.int1 >> 8) & 0xFF);
+    uint8_t status = static_cast<uint8_t>(ump.int1 & 0xFF);
+    auto putMeta = [&](uint8_t metaType, const uint8_t* data, size_t length) {
+        writer.putVariableLength(static_cast<uint32_t>(deltaTime));
+        writer.put(Midi1Status::META);
+        writer.put(metaType);
+        writer.putVariableLength(static_cast<uint32_t>(length));
+        writer.putBytes(data, length);
+    };
+
+    if (statusBank == FlexDataStatusBank::SETUP_AND_PERFORMANCE) {
+        if (format != 0)
+            return false;
+        switch (status) {
+            case FlexDataStatus::TEMPO: {
+                uint32_t microseconds = std::min<uint32_t>(ump.getTempo() / 100, 0xFFFFFF);
+                uint8_t data[3] = {static_cast<uint8_t>(microseconds >> 16), static_cast<uint8_t>(microseconds >> 8),
+                                   static_cast<uint8_t>(microseconds)};
+                putMeta(MidiMetaType::TEMPO, data, sizeof(data));
+                return true;
+            }
+            case FlexDataStatus::TIME_SIGNATURE: {
+                // The denominator is the note value here, the power of two in SMF. MIDI clocks per
+                // metronome click are not kept in Flex Data; 24 is one click per quarter note.
+                uint8_t power = 0;
+                while (power < 7 && (1u << power) < ump.getTimeSignatureDenominator())
+                    power++;
+                uint8_t data[4] = {ump.getTimeSignatureNumerator(), power, 24,
+                                   static_cast<uint8_t>((ump.int2 >> 8) & 0xFF)};
+                putMeta(MidiMetaType::TIME_SIGNATURE, data, sizeof(data));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int metaType = textMetaType(statusBank, status);
+    if (metaType < 0)
+        return false;
+    // format: 0 = complete, 1 = start, 2 = continue, 3 = end
+    if (format == 0 || format == 1)
+        text.clear();
+    for (uint32_t word : {ump.int2, ump.int3, ump.int4}) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            auto byte = static_cast<uint8_t>(word >> shift);
+            if (byte != 0) // padding
+                text.push_back(byte);
+        }
+    }
+    if (format == 1 || format == 2)
+        return false;
+    putMeta(static_cast<uint8_t>(metaType), text.data(), text.size());
+    return true;
+}
+
+} // namespace
+
+namespace umppi {
+
+
+int UmpTranslator::translateUmpToMidi1Bytes(std::vector<uint8_t>& dst,
+                                            const std::vector<Ump>& src,
+                                            const UmpToMidi1BytesTranslatorContext& context) {
+    UmpToMidi1BytesTranslator translator(context);
+    return translator.translate(dst, src);
+}
+
+int UmpTranslator::translateSingleUmpToMidi1Bytes(std::vector<uint8_t>& dst,
+                                                  const Ump& ump,
+                                                  size_t dstOffset,
+                                                  int deltaTime,
+                                                  std::vector<uint8_t>* sysex) {
+    if (ump.getMessageType() == MessageType::SYSEX7) {
+        if (sysex) {
+            // Extract SysEx data from UMP and add to accumulator
+            Midi1ByteWriter counter{nullptr};
+            size_t size = appendSysex7Bytes(counter, ump);
+            size_t sysexOffset = sysex->size();
+            sysex->resize(sysexOffset + size);
+            Midi1ByteWriter writer{sysex->data() + sysexOffset};
+            appendSysex7Bytes(writer, ump);
+        }
+        return 0;
+    }
+
+    Midi1ByteWriter counter{nullptr};
+    writeMidi1Event(counter, ump, deltaTime);
+    if (dst.size() < dstOffset + counter.size)
+        dst.resize(dstOffset + counter.size);
+    Midi1ByteWriter writer{dst.data() + dstOffset};
+    writeMidi1Event(writer, ump, deltaTime);
+    return static_cast<int>(writer.size);
 }
 
 uint64_t UmpTranslator::convertMidi1DteToUmp(Midi1ToUmpTranslatorContext& context, int channel) {
@@ -668,181 +721,278 @@ int UmpTranslator::translateMidi1BytesToUmp(Midi1ToUmpTranslatorContext& context
 void UmpTranslator::translateMidi1UmpToMidi2Ump(std::vector<Ump>& dst, const std::vector<Ump>& src) {
     dst.clear();
     dst.reserve(src.size());
+    for (const auto& ump : src)
+        dst.push_back(translateMidi1UmpToMidi2Ump(ump));
+}
 
-    for (const auto& ump : src) {
-        if (ump.getMessageType() != MessageType::MIDI1) {
-            dst.push_back(ump);
-            continue;
-        }
-
-        uint8_t statusCode = ump.getStatusCode();
-        uint8_t group = ump.getGroup();
-        uint8_t channel = ump.getChannelInGroup();
-
-        const uint8_t NO_ATTRIBUTE_TYPE = 0;
-        const uint16_t NO_ATTRIBUTE_DATA = 0;
+Ump UmpTranslator::translateMidi1UmpToMidi2Ump(const Ump& ump) {
+    if (ump.getMessageType() != MessageType::MIDI1)
+        return ump;
 
-        switch (statusCode) {
-            case MidiChannelStatus::NOTE_OFF: {
-                uint8_t note = ump.getMidi1Msb();
-                uint16_t velocity = static_cast<uint16_t>(ump.getMidi1Lsb()) << 9;
-                dst.emplace_back(UmpFactory::midi2NoteOff(group, channel, note, NO_ATTRIBUTE_TYPE,
-                                                          velocity, NO_ATTRIBUTE_DATA));
-                break;
-            }
-
-            case MidiChannelStatus::NOTE_ON: {
-                uint8_t note = ump.getMidi1Msb();
-                uint16_t velocity = static_cast<uint16_t>(ump.getMidi1Lsb()) << 9;
-                dst.emplace_back(UmpFactory::midi2NoteOn(group, channel, note, NO_ATTRIBUTE_TYPE,
-                                                         velocity, NO_ATTRIBUTE_DATA));
-                break;
-            }
+    uint8_t statusCode = ump.getStatusCode();
+    uint8_t group = ump.getGroup();
+    uint8_t channel = ump.getChannelInGroup();
+
+    const uint8_t NO_ATTRIBUTE_TYPE = 0;
+    const uint16_t NO_ATTRIBUTE_DATA = 0;
+
+    switch (statusCode) {
+        case MidiChannelStatus::NOTE_OFF: {
+            uint8_t note = ump.getMidi1Msb();
+            uint16_t velocity = static_cast<uint16_t>(ump.getMidi1Lsb()) << 9;
+            return Ump(UmpFactory::midi2NoteOff(group, channel, note, NO_ATTRIBUTE_TYPE,
+                                                velocity, NO_ATTRIBUTE_DATA));
+        }
 
-            case MidiChannelStatus::PAF: {
-                uint8_t note = ump.getMidi1Msb();
-                uint32_t data = static_cast<uint32_t>(ump.getMidi1Lsb()) << 25;
-                dst.emplace_back(UmpFactory::midi2PAf(group, channel, note, data));
-                break;
-            }
+        case MidiChannelStatus::NOTE_ON: {
+            uint8_t note = ump.getMidi1Msb();
+            uint16_t velocity = static_cast<uint16_t>(ump.getMidi1Lsb()) << 9;
+            return Ump(UmpFactory::midi2NoteOn(group, channel, note, NO_ATTRIBUTE_TYPE,
+                                               velocity, NO_ATTRIBUTE_DATA));
+        }
 
-            case MidiChannelStatus::CC: {
-                uint8_t index = ump.getMidi1Msb();
-                uint32_t data = static_cast<uint32_t>(ump.getMidi1Lsb()) << 25;
-                dst.emplace_back(UmpFactory::midi2CC(group, channel, index, data));
-                break;
-            }
+        case MidiChannelStatus::PAF: {
+            uint8_t note = ump.getMidi1Msb();
+            uint32_t data = static_cast<uint32_t>(ump.getMidi1Lsb()) << 25;
+            return Ump(UmpFactory::midi2PAf(group, channel, note, data));
+        }
 
-            case MidiChannelStatus::PROGRAM: {
-                uint8_t program = ump.getMidi1Msb();
-                dst.emplace_back(UmpFactory::midi2Program(group, channel,
-                                                          MidiProgramChangeOptions::NONE,
-                                                          program, 0, 0));
-                break;
-            }
+        case MidiChannelStatus::CC: {
+            uint8_t index = ump.getMidi1Msb();
+            uint32_t data = static_cast<uint32_t>(ump.getMidi1Lsb()) << 25;
+            return Ump(UmpFactory::midi2CC(group, channel, index, data));
+        }
 
-            case MidiChannelStatus::CAF: {
-                uint32_t data = static_cast<uint32_t>(ump.getMidi1Msb()) << 25;
-                dst.emplace_back(UmpFactory::midi2CAf(group, channel, data));
-                break;
-            }
+        case MidiChannelStatus::PROGRAM: {
+            uint8_t program = ump.getMidi1Msb();
+            return Ump(UmpFactory::midi2Program(group, channel,
+                                                MidiProgramChangeOptions::NONE,
+                                                program, 0, 0));
+        }
 
-            case MidiChannelStatus::PITCH_BEND: {
-                uint8_t lsb = ump.getMidi1Msb();
-                uint8_t msb = ump.getMidi1Lsb();
-                uint32_t data = static_cast<uint32_t>((msb << 7) | lsb) << 18;
-                dst.emplace_back(UmpFactory::midi2PitchBendDirect(group, channel, data));
-                break;
-            }
+        case MidiChannelStatus::CAF: {
+            uint32_t data = static_cast<uint32_t>(ump.getMidi1Msb()) << 25;
+            return Ump(UmpFactory::midi2CAf(group, channel, data));
+        }
 
-            default:
-                dst.push_back(ump);
-                break;
+        case MidiChannelStatus::PITCH_BEND: {
+            uint8_t lsb = ump.getMidi1Msb();
+            uint8_t msb = ump.getMidi1Lsb();
+            uint32_t data = static_cast<uint32_t>((msb << 7) | lsb) << 18;
+            return Ump(UmpFactory::midi2PitchBendDirect(group, channel, data));
         }
+
+        default:
+            return ump;
     }
 }
 
 void UmpTranslator::translateMidi2UmpToMidi1Ump(std::vector<Ump>& dst, const std::vector<Ump>& src) {
     dst.clear();
     dst.reserve(src.size());
-
+    std::array<Ump, 4> translated;
     for (const auto& ump : src) {
-        if (ump.getMessageType() != MessageType::MIDI2) {
-            dst.push_back(ump);
-            continue;
+        size_t count = translateMidi2UmpToMidi1Ump(ump, translated);
+        dst.insert(dst.end(), translated.begin(), translated.begin() + static_cast<std::ptrdiff_t>(count));
+    }
+}
+
+size_t UmpTranslator::translateMidi2UmpToMidi1Ump(const Ump& ump, std::span<Ump, 4> dst) {
+    if (ump.getMessageType() != MessageType::MIDI2) {
+        dst[0] = ump;
+        return 1;
+    }
+
+    uint8_t statusCode = ump.getStatusCode();
+    uint8_t group = ump.getGroup();
+    uint8_t channel = ump.getChannelInGroup();
+    size_t count = 0;
+
+    switch (statusCode) {
+        case MidiChannelStatus::NOTE_OFF: {
+            uint8_t note = ump.getMidi2Note();
+            uint8_t velocity = static_cast<uint8_t>(ump.getMidi2Velocity16() / 0x200);
+            dst[count++] = Ump(UmpFactory::midi1NoteOff(group, channel, note, velocity));
+            break;
         }
 
-        uint8_t statusCode = ump.getStatusCode();
-        uint8_t group = ump.getGroup();
-        uint8_t channel = ump.getChannelInGroup();
+        case MidiChannelStatus::NOTE_ON: {
+            uint8_t note = ump.getMidi2Note();
+            uint8_t velocity = static_cast<uint8_t>(ump.getMidi2Velocity16() / 0x200);
+            dst[count++] = Ump(UmpFactory::midi1NoteOn(group, channel, note, velocity));
+            break;
+        }
 
-        switch (statusCode) {
-            case MidiChannelStatus::NOTE_OFF: {
-                uint8_t note = ump.getMidi2Note();
-                uint8_t velocity = static_cast<uint8_t>(ump.getMidi2Velocity16() / 0x200);
-                dst.emplace_back(UmpFactory::midi1NoteOff(group, channel, note, velocity));
-                break;
-            }
+        case MidiChannelStatus::PAF: {
+            uint8_t note = ump.getMidi2Note();
+            uint8_t data = static_cast<uint8_t>(ump.getMidi2PafData() / 0x2000000U);
+            dst[count++] = Ump(UmpFactory::midi1PAf(group, channel, note, data));
+            break;
+        }
 
-            case MidiChannelStatus::NOTE_ON: {
-                uint8_t note = ump.getMidi2Note();
-                uint8_t velocity = static_cast<uint8_t>(ump.getMidi2Velocity16() / 0x200);
-                dst.emplace_back(UmpFactory::midi1NoteOn(group, channel, note, velocity));
-                break;
-            }
+        case MidiChannelStatus::CC: {
+            uint8_t index = ump.getMidi2CcIndex();
+            uint8_t data = static_cast<uint8_t>(ump.getMidi2CcData() / 0x2000000U);
+            dst[count++] = Ump(UmpFactory::midi1CC(group, channel, index, data));
+            break;
+        }
 
-            case MidiChannelStatus::PAF: {
-                uint8_t note = ump.getMidi2Note();
-                uint8_t data = static_cast<uint8_t>(ump.getMidi2PafData() / 0x2000000U);
-                dst.emplace_back(UmpFactory::midi1PAf(group, channel, note, data));
-                break;
+        case MidiChannelStatus::PROGRAM: {
+            uint8_t program = ump.getMidi2ProgramProgram();
+            if (ump.getMidi2ProgramOptions() & MidiProgramChangeOptions::BANK_VALID) {
+                dst[count++] = Ump(UmpFactory::midi1CC(group, channel, MidiCC::BANK_SELECT,
+                                                       ump.getMidi2ProgramBankMsb()));
+                dst[count++] = Ump(UmpFactory::midi1CC(group, channel, MidiCC::BANK_SELECT_LSB,
+                                                       ump.getMidi2ProgramBankLsb()));
             }
+            dst[count++] = Ump(UmpFactory::midi1Program(group, channel, program));
+            break;
+        }
 
-            case MidiChannelStatus::CC: {
-                uint8_t index = ump.getMidi2CcIndex();
-                uint8_t data = static_cast<uint8_t>(ump.getMidi2CcData() / 0x2000000U);
-                dst.emplace_back(UmpFactory::midi1CC(group, channel, index, data));
-                break;
-            }
+        case MidiChannelStatus::CAF: {
+            uint8_t data = static_cast<uint8_t>(ump.getMidi2CafData() / 0x2000000U);
+            dst[count++] = Ump(UmpFactory::midi1CAf(group, channel, data));
+            break;
+        }
 
-            case MidiChannelStatus::PROGRAM: {
-                uint8_t program = ump.getMidi2ProgramProgram();
-                if (ump.getMidi2ProgramOptions() & MidiProgramChangeOptions::BANK_VALID) {
-                    dst.emplace_back(UmpFactory::midi1CC(group, channel, MidiCC::BANK_SELECT,
-                                                         ump.getMidi2ProgramBankMsb()));
-                    dst.emplace_back(UmpFactory::midi1CC(group, channel, MidiCC::BANK_SELECT_LSB,
-                                                         ump.getMidi2ProgramBankLsb()));
-                }
-                dst.emplace_back(UmpFactory::midi1Program(group, channel, program));
-                break;
-            }
+        case MidiChannelStatus::PITCH_BEND: {
+            uint32_t pitchBend14 = ump.getMidi2PitchBendData() / 0x40000U;
+            dst[count++] = Ump(UmpFactory::midi1PitchBendDirect(group, channel,
+                                                                static_cast<uint16_t>(pitchBend14)));
+            break;
+        }
 
-            case MidiChannelStatus::CAF: {
-                uint8_t data = static_cast<uint8_t>(ump.getMidi2CafData() / 0x2000000U);
-                dst.emplace_back(UmpFactory::midi1CAf(group, channel, data));
-                break;
-            }
+        case MidiChannelStatus::RPN: {
+            uint8_t msb = ump.getMidi2RpnMsb();
+            uint8_t lsb = ump.getMidi2RpnLsb();
+            uint32_t data = ump.getMidi2RpnData();
+            uint8_t dteMsb = static_cast<uint8_t>((data >> 25) & 0x7F);
+            uint8_t dteLsb = static_cast<uint8_t>((data >> 18) & 0x7F);
+
+            dst[count++] = Ump(UmpFactory::midi1CC(group, channel, MidiCC::RPN_MSB, msb));
+            dst[count++] = Ump(UmpFactory::midi1CC(group, channel, MidiCC::RPN_LSB, lsb));
+            dst[count++] = Ump(UmpFactory::midi1CC(group, channel, MidiCC::DTE_MSB, dteMsb));
+            dst[count++] = Ump(UmpFactory::midi1CC(group, channel, MidiCC::DTE_LSB, dteLsb));
+            break;
+        }
 
-            case MidiChannelStatus::PITCH_BEND: {
-                uint32_t pitchBend14 = ump.getMidi2PitchBendData() / 0x40000U;
-                dst.emplace_back(UmpFactory::midi1PitchBendDirect(group, channel,
-                                                                  static_cast<uint16_t>(pitchBend14)));
-                break;
-            }
+        case MidiChannelStatus::NRPN: {
+            uint8_t msb = ump.getMidi2NrpnMsb();
+            uint8_t lsb = ump.getMidi2NrpnLsb();
+            uint32_t data = ump.getMidi2NrpnData();
+            uint8_t dteMsb = static_cast<uint8_t>((data >> 25) & 0x7F);
+            uint8_t dteLsb = static_cast<uint8_t>((data >> 18) & 0x7F);
+
+            dst[count++] = Ump(UmpFactory::midi1CC(group, channel, MidiCC::NRPN_MSB, msb));
+            dst[count++] = Ump(UmpFactory::midi1CC(group, channel, MidiCC::NRPN_LSB, lsb));
+            dst[count++] = Ump(UmpFactory::midi1CC(group, channel, MidiCC::DTE_MSB, dteMsb));
+            dst[count++] = Ump(UmpFactory::midi1CC(group, channel, MidiCC::DTE_LSB, dteLsb));
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return count;
+}
 
-            case MidiChannelStatus::RPN: {
-                uint8_t msb = ump.getMidi2RpnMsb();
-                uint8_t lsb = ump.getMidi2RpnLsb();
-                uint32_t data = ump.getMidi2RpnData();
-                uint8_t dteMsb = static_cast<uint8_t>((data >> 25) & 0x7F);
-                uint8_t dteLsb = static_cast<uint8_t>((data >> 18) & 0x7F);
-
-                dst.emplace_back(UmpFactory::midi1CC(group, channel, MidiCC::RPN_MSB, msb));
-                dst.emplace_back(UmpFactory::midi1CC(group, channel, MidiCC::RPN_LSB, lsb));
-                dst.emplace_back(UmpFactory::midi1CC(group, channel, MidiCC::DTE_MSB, dteMsb));
-                dst.emplace_back(UmpFactory::midi1CC(group, channel, MidiCC::DTE_LSB, dteLsb));
-                break;
+
+UmpToMidi1BytesTranslator::UmpToMidi1BytesTranslator(const UmpToMidi1BytesTranslatorContext& context)
+    : context(context) {
+}
+
+size_t UmpToMidi1BytesTranslator::computeMidi1BytesSize(std::span<const Ump> src) {
+    int result;
+    return process(nullptr, src, result);
+}
+
+int UmpToMidi1BytesTranslator::translate(std::vector<uint8_t>& dst, std::span<const Ump> src) {
+    dst.resize(computeMidi1BytesSize(src));
+    int result;
+    process(dst.data(), src, result);
+    return result;
+}
+
+int UmpToMidi1BytesTranslator::translate(uint8_t* dst, size_t dstSize, std::span<const Ump> src, size_t& written) {
+    written = 0;
+    size_t size = computeMidi1BytesSize(src);
+    if (dstSize < size)
+        return UmpTranslationResult::INSUFFICIENT_BUFFER;
+    int result;
+    written = process(dst, src, result);
+    return result;
+}
+
+size_t UmpToMidi1BytesTranslator::process(uint8_t* dst, std::span<const Ump> src, int& result) {
+    Midi1ByteWriter writer{dst};
+    bool onlyCountLength = dst == nullptr;
+    int deltaTime = 0;
+    size_t sysexLength = 0;
+    bool inSysex = false;
+
+    for (const auto& ump : src) {
+        if (ump.isDeltaClockstamp()) {
+            deltaTime += ump.getDeltaClockstamp();
+            continue;
+        }
+        if (ump.isJRTimestamp()) {
+            if (!context.skipDeltaTime) {
+                deltaTime += ump.getJRTimestamp();
             }
+            continue;
+        }
 
-            case MidiChannelStatus::NRPN: {
-                uint8_t msb = ump.getMidi2NrpnMsb();
-                uint8_t lsb = ump.getMidi2NrpnLsb();
-                uint32_t data = ump.getMidi2NrpnData();
-                uint8_t dteMsb = static_cast<uint8_t>((data >> 25) & 0x7F);
-                uint8_t dteLsb = static_cast<uint8_t>((data >> 18) & 0x7F);
-
-                dst.emplace_back(UmpFactory::midi1CC(group, channel, MidiCC::NRPN_MSB, msb));
-                dst.emplace_back(UmpFactory::midi1CC(group, channel, MidiCC::NRPN_LSB, lsb));
-                dst.emplace_back(UmpFactory::midi1CC(group, channel, MidiCC::DTE_MSB, dteMsb));
-                dst.emplace_back(UmpFactory::midi1CC(group, channel, MidiCC::DTE_LSB, dteLsb));
-                break;
+        if (ump.getMessageType() == MessageType::SYSEX7) {
+            BinaryChunkStatus status = ump.getBinaryChunkStatus();
+            if (!inSysex || status == BinaryChunkStatus::START || status == BinaryChunkStatus::COMPLETE_PACKET) {
+                sysexLength = 0;
+                if (!onlyCountLength)
+                    sysex7_.clear();
+            }
+            inSysex = true;
+            if (onlyCountLength) {
+                Midi1ByteWriter counter{nullptr};
+                sysexLength += appendSysex7Bytes(counter, ump);
+            } else {
+                size_t offset = sysex7_.size();
+                sysex7_.resize(offset + 6);
+                Midi1ByteWriter sysexWriter{sysex7_.data() + offset};
+                sysexLength += appendSysex7Bytes(sysexWriter, ump);
+                sysex7_.resize(sysexLength);
+            }
+            if (status == BinaryChunkStatus::END || status == BinaryChunkStatus::COMPLETE_PACKET) {
+                // SMF SysEx event is F0 <length> <data> F7, where length includes F7.
+                if (!context.skipDeltaTime)
+                    writer.putVariableLength(static_cast<uint32_t>(deltaTime));
+                writer.put(Midi1Status::SYSEX);
+                if (!context.skipDeltaTime)
+                    writer.putVariableLength(static_cast<uint32_t>(sysexLength + 1));
+                writer.putBytes(sysex7_.data(), sysexLength);
+                writer.put(Midi1Status::SYSEX_END);
+                inSysex = false;
+                deltaTime = 0;
             }
+            continue;
+        }
 
-            default:
-                break;
+        if (ump.getMessageType() == MessageType::FLEX_DATA) {
+            // meta events exist only in SMF, i.e. with delta times
+            if (!context.skipDeltaTime && writeFlexDataMeta(writer, ump, deltaTime, flexDataText_))
+                deltaTime = 0;
+            continue;
         }
+
+        size_t before = writer.size;
+        writeMidi1Event(writer, ump, context.skipDeltaTime ? -1 : deltaTime);
+        // keep accumulating delta time across messages that have no MIDI 1.0 counterpart
+        if (writer.size != before)
+            deltaTime = 0;
     }
-}
 
+    pendingDeltaTime_ = static_cast<uint32_t>(deltaTime);
+    result = inSysex ? UmpTranslationResult::INCOMPLETE_SYSEX7 : UmpTranslationResult::OK;
+    return writer.size;
+}
 
 } // namespace midicci
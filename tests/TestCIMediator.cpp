@@ -1,23 +1,47 @@
 #include "TestCIMediator.hpp"
+#include <algorithm>
 #include <memory>
 
 using namespace midicci;
 
-TestCIMediator::TestCIMediator() {
+TestCIMediator::TestCIMediator(bool queued) {
     config_.device_info = {0, 0, 0, 0, "TestDevice", "TestInitiatorFamily", "TestInitiatorModel", "0.0", "ABCDEFGH"};
     device1_ = std::make_unique<MidiCIDevice>(19474 & 0x7F7F7F7F, config_);
     device2_ = std::make_unique<MidiCIDevice>(37564 & 0x7F7F7F7F, config_);
     
-    device1Sender_ = [this](uint8_t group, const std::vector<uint8_t>& data) -> bool {
-        device2_->processInput(group, data);
+    device1Sender_ = [this, queued](uint8_t group, const std::vector<uint8_t>& data) -> bool {
+        if (queued)
+            queue_.push_back({device2_.get(), group, data});
+        else
+            device2_->processInput(group, data);
         return true;
     };
     
-    device2Sender_ = [this](uint8_t group, const std::vector<uint8_t>& data) -> bool {
-        device1_->processInput(group, data);
+    device2Sender_ = [this, queued](uint8_t group, const std::vector<uint8_t>& data) -> bool {
+        if (queued)
+            queue_.push_back({device1_.get(), group, data});
+        else
+            device1_->processInput(group, data);
         return true;
     };
     
     device1_->setSysexSender(device1Sender_);
     device2_->setSysexSender(device2Sender_);
 }
+
+size_t TestCIMediator::deliver(size_t max_messages) {
+    size_t delivered = 0;
+    while (delivered < max_messages && !queue_.empty()) {
+        auto message = std::move(queue_.front());
+        queue_.pop_front();
+        message.target->processInput(message.group, message.data);
+        delivered++;
+    }
+    return delivered;
+}
+
+size_t TestCIMediator::drop(size_t max_messages) {
+    size_t dropped = std::min(max_messages, queue_.size());
+    queue_.erase(queue_.begin(), queue_.begin() + static_cast<std::ptrdiff_t>(dropped));
+    return dropped;
+}
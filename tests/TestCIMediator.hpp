@@ -3,6 +3,7 @@
 #include <midicci/midicci.hpp>
 #include <memory>
 #include <vector>
+#include <deque>
 #include <cstdint>
 
 using namespace midicci;
@@ -11,13 +12,28 @@ class TestPropertyRules;
 
 class TestCIMediator {
 public:
-    TestCIMediator();
+    // queued: messages wait until deliver(), like on a real transport, instead of being
+    // processed before the sender returns.
+    explicit TestCIMediator(bool queued = false);
     ~TestCIMediator() = default;
     
     MidiCIDevice& getDevice1() { return *device1_; }
     MidiCIDevice& getDevice2() { return *device2_; }
+
+    // Processes queued messages, including those sent in response, until none is left or
+    // max_messages were processed. Returns how many were processed.
+    size_t deliver(size_t max_messages = SIZE_MAX);
+    // Discards up to max_messages queued messages, as if they were lost. Returns how many were dropped.
+    size_t drop(size_t max_messages = SIZE_MAX);
     
 private:
+    struct QueuedMessage {
+        MidiCIDevice* target;
+        uint8_t group;
+        std::vector<uint8_t> data;
+    };
+    std::deque<QueuedMessage> queue_;
+
     MidiCIDeviceConfiguration config_{};
     std::unique_ptr<MidiCIDevice> device1_;
     std::unique_ptr<MidiCIDevice> device2_;
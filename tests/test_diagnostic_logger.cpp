@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <midicci/midicci.hpp>
+#include <thread>
+#include <set>
+
+using namespace midicci;
+
+TEST(DiagnosticLoggerTest, DisabledByDefault) {
+    DiagnosticLogger logger;
+    for (int c = 0; c < static_cast<int>(LogCategory::Count); c++) {
+        EXPECT_FALSE(logger.isEnabled(LogLevel::Error, static_cast<LogCategory>(c)));
+    }
+
+    logger.setLevel(LogCategory::Property, LogLevel::Info);
+    EXPECT_FALSE(logger.isEnabled(LogLevel::Debug, LogCategory::Property));
+    EXPECT_TRUE(logger.isEnabled(LogLevel::Info, LogCategory::Property));
+    EXPECT_TRUE(logger.isEnabled(LogLevel::Error, LogCategory::Property));
+    EXPECT_FALSE(logger.isEnabled(LogLevel::Error, LogCategory::Transport));
+
+    logger.setLevel(LogLevel::Trace);
+    EXPECT_TRUE(logger.isEnabled(LogLevel::Trace, LogCategory::Transport));
+    EXPECT_FALSE(logger.isEnabled(LogLevel::Off, LogCategory::Transport));
+}
+
+TEST(DiagnosticLoggerTest, RecordsAreRenderedByConsumer) {
+    DiagnosticLogger logger;
+    std::vector<uint8_t> sysex{0x7E, 0x7F, 0x0D, 0x70};
+    EXPECT_TRUE(logger.write(LogLevel::Debug, LogCategory::Transport, LogEvent::SysExReceived, 0x1234, {2, 4}, sysex));
+    EXPECT_TRUE(logger.write(LogLevel::Debug, LogCategory::Property, LogEvent::PropertyChunkReceived, 0x5678, {0x35, 3, 1, 2}));
+    EXPECT_TRUE(logger.writeText(LogLevel::Warning, LogCategory::Application, "hello"));
+
+    std::vector<std::string> lines;
+    EXPECT_EQ(3u, logger.drain([&](const LogRecord& record) { lines.push_back(formatLogRecord(record)); }));
+    ASSERT_EQ(3u, lines.size());
+    EXPECT_EQ("DEBUG [transport] [received CI SysEx (grp:2)] 7e 7f 0d 70 ", lines[0]);
+    EXPECT_EQ("DEBUG [property] property message 0x35 (request 3) from MUID 0x00005678 part: 1 / 2", lines[1]);
+    EXPECT_EQ("WARN [app] hello", lines[2]);
+    EXPECT_EQ(0u, logger.drain([](const LogRecord&) {}));
+}
+
+TEST(DiagnosticLoggerTest, LongPayloadsSpanRecords) {
+    DiagnosticLogger logger(16);
+    std::vector<uint8_t> sysex(200);
+    for (size_t i = 0; i < sysex.size(); i++) {
+        sysex[i] = static_cast<uint8_t>(i);
+    }
+    auto size = static_cast<uint32_t>(sysex.size());
+
+    // cut to one record by default
+    EXPECT_TRUE(logger.write(LogLevel::Debug, LogCategory::Transport, LogEvent::SysExReceived, 1, {0, size}, sysex));
+    logger.setMaxPayloadSize(1000);
+    EXPECT_TRUE(logger.write(LogLevel::Debug, LogCategory::Transport, LogEvent::SysExReceived, 2, {0, size}, sysex));
+    EXPECT_TRUE(logger.writeText(LogLevel::Info, LogCategory::Application, "after"));
+
+    std::vector<std::vector<uint8_t>> payloads;
+    std::vector<std::string> lines;
+    EXPECT_EQ(3u, logger.drain([&](const LogRecord& record, std::span<const uint8_t> payload) {
+        payloads.emplace_back(payload.begin(), payload.end());
+        lines.push_back(formatLogRecord(record, payload));
+    }));
+    ASSERT_EQ(3u, payloads.size());
+    EXPECT_EQ(LogRecord::MAX_PAYLOAD_SIZE, payloads[0].size());
+    EXPECT_NE(std::string::npos, lines[0].find("... (200 bytes)"));
+    EXPECT_EQ(sysex, payloads[1]);
+    EXPECT_EQ(std::string::npos, lines[1].find("..."));
+    EXPECT_EQ("INFO [app] after", lines[2]);
+
+    // a payload that does not fit in the free part of the ring is dropped as a whole
+    logger.setMaxPayloadSize(16 * LogRecord::MAX_PAYLOAD_SIZE);
+    EXPECT_TRUE(logger.writeText(LogLevel::Info, LogCategory::Application, "first"));
+    std::vector<uint8_t> huge(16 * LogRecord::MAX_PAYLOAD_SIZE);
+    EXPECT_FALSE(logger.write(LogLevel::Debug, LogCategory::Transport, LogEvent::SysExReceived, 3, {0, 0}, huge));
+    EXPECT_EQ(1u, logger.drain([](const LogRecord&) {}));
+}
+
+TEST(DiagnosticLoggerTest, RingDropsWhenFull) {
+    LogRecordRing ring(3);
+    EXPECT_EQ(4u, ring.getCapacity());
+    LogRecord record;
+    for (uint32_t i = 0; i < 4; i++) {
+        record.muid = i;
+        EXPECT_TRUE(ring.tryPush(record));
+    }
+    EXPECT_FALSE(ring.tryPush(record));
+    EXPECT_EQ(1u, ring.getDroppedCount());
+
+    for (uint32_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(ring.tryPop(record));
+        EXPECT_EQ(i, record.muid);
+    }
+    EXPECT_FALSE(ring.tryPop(record));
+    EXPECT_TRUE(ring.tryPush(record));
+}
+
+TEST(DiagnosticLoggerTest, ConcurrentProducers) {
+    DiagnosticLogger logger(4096);
+    constexpr uint32_t PRODUCERS = 4;
+    constexpr uint32_t RECORDS = 1000;
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([&logger, p] {
+            for (uint32_t i = 0; i < RECORDS; i++) {
+                logger.write(LogLevel::Info, LogCategory::Transport, LogEvent::MessageReceived, p, {i});
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    std::set<std::pair<uint32_t, uint32_t>> seen;
+    logger.drain([&](const LogRecord& record) { seen.emplace(record.muid, record.args[0]); });
+    EXPECT_EQ(PRODUCERS * RECORDS, seen.size());
+    EXPECT_EQ(0u, logger.getRing().getDroppedCount());
+}
+
+TEST(DiagnosticLoggerTest, DeviceReportsPropertyChunks) {
+    MidiCIDeviceConfiguration config;
+    MidiCIDevice device(0x1234, config);
+    auto& diagnostics = device.getDiagnosticLogger();
+
+    MidiCIDeviceConfiguration sender_config;
+    sender_config.max_property_chunk_size = 32;
+    std::vector<uint8_t> body(100, 'x');
+    GetPropertyDataReply reply(Common(0x5678, 0x1234, MIDI_CI_ADDRESS_FUNCTION_BLOCK, 0), 9,
+                               std::vector<uint8_t>{'{', '}'}, body);
+    auto chunks = reply.serialize(sender_config);
+    ASSERT_GT(chunks.size(), 1u);
+
+    for (const auto& chunk : chunks) {
+        device.processInput(0, chunk);
+    }
+    EXPECT_EQ(0u, diagnostics.drain([](const LogRecord&) {}));
+
+    diagnostics.setLevel(LogCategory::Property, LogLevel::Debug);
+    for (const auto& chunk : chunks) {
+        device.processInput(0, chunk);
+    }
+    std::vector<LogRecord> records;
+    diagnostics.drain([&](const LogRecord& record) { records.push_back(record); });
+    ASSERT_EQ(chunks.size(), records.size());
+    EXPECT_EQ(LogEvent::PropertyChunkReceived, records[0].event);
+    EXPECT_EQ(0x5678u, records[0].muid);
+    EXPECT_EQ(9u, records[0].args[1]);
+    EXPECT_EQ(chunks.size(), records.back().args[2]);
+    EXPECT_EQ(chunks.size(), records.back().args[3]);
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <umppi/umppi.hpp>
+
+using namespace umppi;
+
+namespace {
+constexpr uint64_t TICK = JrClockSync::NANOSECONDS_PER_TICK;
+}
+
+TEST(JrClockSyncTest, testRemovesTransportJitter) {
+    JrClockSync sync;
+    uint64_t base = 5'000'000'000;
+    // JR Clocks every 100ms (3125 ticks), starting near the 16-bit wrap point, with 0-3ms of random-ish delay
+    const uint64_t delays[] = {0, 3'000'000, 1'000'000, 2'500'000, 0, 500'000, 2'000'000, 0};
+    int64_t senderStart = 60000;
+    for (int i = 0; i < 8; i++) {
+        int64_t sender = senderStart + i * 3125;
+        sync.onJrClock(static_cast<uint16_t>(sender & 0xFFFF), base + sender * TICK + delays[i]);
+    }
+    ASSERT_TRUE(sync.isSynchronized());
+    EXPECT_NEAR(0.0, sync.getDriftPpm(), 5000.0);
+
+    // a timestamp 10 ticks after the last clock (which wrapped around) maps onto the undelayed timeline
+    int64_t stamped = senderStart + 7 * 3125 + 10;
+    auto local = sync.convertJrTimestamp(static_cast<uint16_t>(stamped & 0xFFFF));
+    ASSERT_TRUE(local.has_value());
+    EXPECT_NEAR(static_cast<double>(base + stamped * TICK), static_cast<double>(*local), 100'000.0);
+}
+
+TEST(JrClockSyncTest, testEstimatesDrift) {
+    JrClockSync sync;
+    // the sender clock runs 100ppm fast: each sender tick is a little shorter in local time
+    double localPerTick = TICK / 1.0001;
+    for (int i = 0; i < 20; i++) {
+        int64_t sender = i * 3125;
+        sync.onJrClock(static_cast<uint16_t>(sender & 0xFFFF), 1'000'000'000 + static_cast<uint64_t>(sender * localPerTick));
+    }
+    EXPECT_NEAR(100.0, sync.getDriftPpm(), 1.0);
+}
+
+TEST(JrClockSyncTest, testProcessAppliesTimestampsAndLatency) {
+    JrClockSync sync(2'000'000);
+    uint64_t arrival = 1'000'000'000;
+    std::vector<uint32_t> clocks{JrClockSync::createJrClock(arrival)};
+    sync.process(clocks, arrival, [](UmpWordSpan, uint64_t) { FAIL() << "JR Clock must not be delivered"; });
+    clocks[0] = JrClockSync::createJrClock(arrival + 100'000'000);
+    sync.process(clocks, arrival + 100'000'000, [](UmpWordSpan, uint64_t) {});
+
+    std::vector<uint32_t> words{JrClockSync::createJrTimestamp(arrival + 100'000'000 + 50 * TICK),
+                                UmpFactory::midi1NoteOn(0, 0, 60, 100),
+                                UmpFactory::midi1NoteOff(0, 0, 60, 0)};
+    std::vector<std::pair<uint32_t, uint64_t>> received;
+    // arrives 5ms late; the timestamped note is still placed at its original time
+    uint64_t lateArrival = arrival + 100'000'000 + 50 * TICK + 5'000'000;
+    sync.process(words, lateArrival, [&](UmpWordSpan packet, uint64_t t) { received.emplace_back(packet[0], t); });
+    ASSERT_EQ(2, received.size());
+    EXPECT_EQ(words[1], received[0].first);
+    EXPECT_NEAR(static_cast<double>(arrival + 100'000'000 + 50 * TICK + 2'000'000),
+                static_cast<double>(received[0].second), 32'000.0);
+    // the timestamp only applies to the message right after it
+    EXPECT_EQ(lateArrival + 2'000'000, received[1].second);
+}
+
+TEST(JrClockSyncTest, testJrClockDue) {
+    JrClockSync sync;
+    EXPECT_TRUE(sync.isJrClockDue(0));
+    uint32_t clock = sync.nextJrClock(1'000'000'000);
+    EXPECT_EQ(UmpFactory::jrClock(JrClockSync::toJrTicks(1'000'000'000)), clock);
+    EXPECT_FALSE(sync.isJrClockDue(1'100'000'000));
+    EXPECT_TRUE(sync.isJrClockDue(1'250'000'000));
+}
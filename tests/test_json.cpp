@@ -131,3 +131,41 @@ TEST(JsonTest, parseArray4) {
         EXPECT_EQ(1, arr3Items[i].asObject().size());
     }
 }
+
+TEST(JsonTest, arrayIndexSlice) {
+    std::string json = " [\"1\", 2 ,[3,[4]],{\"x,y\": 5, \"a\\\"]\": 7}, {\"\": {}}, \"{}[],\\\\\"] \n";
+    std::vector<uint8_t> bytes(json.begin(), json.end());
+    auto index = JsonArrayIndex::build(bytes);
+    ASSERT_TRUE(index.has_value());
+    EXPECT_EQ(6, index->size());
+
+    auto slice = [&](size_t offset, size_t limit) {
+        auto page = index->slice(bytes, offset, limit);
+        return std::string(page.begin(), page.end());
+    };
+    EXPECT_EQ("[2,[3,[4]]]", slice(1, 2));
+    EXPECT_EQ("[{\"x,y\": 5, \"a\\\"]\": 7},{\"\": {}},\"{}[],\\\\\"]", slice(3, SIZE_MAX));
+    EXPECT_EQ("[]", slice(6, 10));
+    EXPECT_EQ(JsonValue::parse(json).serialize(), JsonValue::parse(slice(0, SIZE_MAX)).serialize());
+}
+
+TEST(JsonTest, arrayIndexRejectsNonArray) {
+    for (std::string json : {"", "[]", "{\"a\":[1]}", "[1,2", "[1,,2]", "[1,]", "[\"]", "[1] 2", "\"[1]\"",
+                             "[1}", "[{]}", "[[1}]", "[1 2]", "[\"a\" \"b\"]", "[{} 1]", "[1\"a\"]", "[true false]"}) {
+        std::vector<uint8_t> bytes(json.begin(), json.end());
+        if (json == "[]") {
+            auto index = JsonArrayIndex::build(bytes);
+            ASSERT_TRUE(index.has_value());
+            EXPECT_EQ(0, index->size());
+        } else {
+            EXPECT_FALSE(JsonArrayIndex::build(bytes).has_value()) << json;
+        }
+    }
+
+    std::string json = "[ -1.5e3 , true,null ]";
+    std::vector<uint8_t> bytes(json.begin(), json.end());
+    auto index = JsonArrayIndex::build(bytes);
+    ASSERT_TRUE(index.has_value());
+    auto page = index->slice(bytes, 0, SIZE_MAX);
+    EXPECT_EQ("[-1.5e3,true,null]", std::string(page.begin(), page.end()));
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include "midicci/midicci.hpp"
@@ -100,16 +101,174 @@ TEST(MessageSerializationTest, MessageReconstruction) {
     EXPECT_EQ(dest_muid, 0x12345678u);
     
     // Extract header and body using CIRetrieval methods
-    std::vector<uint8_t> extracted_header = CIRetrieval::getPropertyHeader(data);
-    std::vector<uint8_t> extracted_body = CIRetrieval::getPropertyBodyInThisChunk(data);
+    auto extracted_header = CIRetrieval::getPropertyHeader(data);
+    auto extracted_body = CIRetrieval::getPropertyBodyInThisChunk(data);
     
     // Header and body sizes should be reasonable
     EXPECT_GT(extracted_header.size(), 0u);
     EXPECT_GE(extracted_body.size(), 0u);
     
     Common reconstructed_common(source_muid, dest_muid, ADDRESS_FUNCTION_BLOCK, 0);
-    GetPropertyDataReply reconstructed(reconstructed_common, extracted_request_id, extracted_header, extracted_body);
+    GetPropertyDataReply reconstructed(reconstructed_common, extracted_request_id,
+                                       std::vector<uint8_t>(extracted_header.begin(), extracted_header.end()),
+                                       std::vector<uint8_t>(extracted_body.begin(), extracted_body.end()));
     
     // Reconstructed reply requestId should match original
     EXPECT_EQ(reconstructed.getRequestId(), test_request_id);
-}
\ No newline at end of file
+}
+TEST(MessageSerializationTest, ChunkViewsAndReassembly) {
+    MidiCIDeviceConfiguration config;
+    config.max_property_chunk_size = 64;
+
+    std::string header_json = R"({"status":200})";
+    std::vector<uint8_t> header(header_json.begin(), header_json.end());
+    std::vector<uint8_t> body;
+    for (int i = 0; i < 300; i++)
+        body.push_back(static_cast<uint8_t>('a' + i % 26));
+
+    GetPropertyDataReply reply(Common(0x87654321, 0x12345678, ADDRESS_FUNCTION_BLOCK, 0), 7, header, body);
+    auto chunks = reply.serialize(config);
+    ASSERT_GT(chunks.size(), 1u);
+
+    PropertyChunkManager manager;
+    std::pair<std::vector<uint8_t>, std::vector<uint8_t>> result;
+    for (const auto& chunk : chunks) {
+        auto chunk_header = CIRetrieval::getPropertyHeader(chunk);
+        auto chunk_body = CIRetrieval::getPropertyBodyInThisChunk(chunk);
+        // views refer to the input sysex rather than to copies
+        if (!chunk_body.empty()) {
+            EXPECT_GE(chunk_body.data(), chunk.data());
+            EXPECT_LE(chunk_body.data() + chunk_body.size(), chunk.data() + chunk.size());
+        }
+        uint16_t index = CIRetrieval::getPropertyChunkIndex(chunk);
+        uint16_t total = CIRetrieval::getPropertyTotalChunks(chunk);
+        if (index < total)
+            manager.addPendingChunk(0, 0x87654321, 7, chunk_header, chunk_body);
+        else
+            result = manager.finishPendingChunk(0x87654321, 7, chunk_body);
+    }
+
+    EXPECT_EQ(header, result.first);
+    EXPECT_EQ(body, result.second);
+    EXPECT_FALSE(manager.hasPendingChunk(0x87654321, 7));
+}
+
+TEST(MessageSerializationTest, StreamingSerialization) {
+    MidiCIDeviceConfiguration config;
+    config.max_property_chunk_size = 256;
+
+    std::string header_json = R"({"resource":"State","resId":"x"})";
+    std::vector<uint8_t> header(header_json.begin(), header_json.end());
+    std::vector<uint8_t> body(1024 * 1024);
+    for (size_t i = 0; i < body.size(); i++)
+        body[i] = static_cast<uint8_t>(i % 0x80);
+    SetPropertyData request(Common(0x1234567, 0x7654321, ADDRESS_FUNCTION_BLOCK, 0), 9, header, body);
+
+    auto expected = request.serializeMulti(config);
+    std::vector<uint8_t> buffer;
+    size_t index = 0;
+    size_t max_capacity = 0;
+    request.serializeInto(config, buffer, [&](const std::vector<uint8_t>& packet) {
+        EXPECT_EQ(&buffer, &packet);
+        EXPECT_EQ(expected[index], packet);
+        max_capacity = std::max(max_capacity, packet.capacity());
+        index++;
+        return true;
+    });
+    EXPECT_EQ(expected.size(), index);
+    EXPECT_LE(max_capacity, static_cast<size_t>(config.max_property_chunk_size));
+
+    // the sink can stop the serialization
+    size_t count = 0;
+    request.serializeInto(config, buffer, [&](const std::vector<uint8_t>&) { return ++count < 3; });
+    EXPECT_EQ(3u, count);
+
+    // single packet messages
+    PropertyGetCapabilities capabilities(Common(0x1234567, 0x7654321, ADDRESS_FUNCTION_BLOCK, 0), 4);
+    count = 0;
+    capabilities.serializeInto(config, buffer, [&](const std::vector<uint8_t>& packet) {
+        EXPECT_EQ(capabilities.serialize(config), packet);
+        count++;
+        return true;
+    });
+    EXPECT_EQ(1u, count);
+}
+
+TEST(MessageSerializationTest, ChunkManagerExpiresStaleTransfers) {
+    PropertyChunkManager manager;
+    manager.setTimeout(5);
+    std::vector<uint8_t> header{'{', '}'};
+    std::vector<uint8_t> chunk(100, 'x');
+
+    manager.addPendingChunk(1000, 0x1000, 1, header, chunk, 5);
+    manager.addPendingChunk(1000, 0x2000, 1, header, chunk, 5);
+    manager.addPendingChunk(1000, 0x1000, 2, header, chunk, 5);
+    EXPECT_EQ(3u, manager.getPendingChunkCount());
+
+    // keeps 0x1000/1 alive; the others have not seen a chunk for 5 seconds yet
+    manager.addPendingChunk(1004, 0x1000, 1, {}, chunk, 5);
+    manager.addPendingChunk(1005, 0x1000, 1, {}, chunk, 5);
+    EXPECT_EQ(3u, manager.getPendingChunkCount());
+
+    // 6 seconds later only the transfer that kept receiving chunks is left
+    manager.addPendingChunk(1006, 0x1000, 1, {}, chunk, 5);
+    EXPECT_EQ(1u, manager.getPendingChunkCount());
+    EXPECT_FALSE(manager.hasPendingChunk(0x2000, 1));
+
+    auto result = manager.finishPendingChunk(0x1000, 1, chunk);
+    EXPECT_EQ(header, result.first);
+    EXPECT_EQ(500u, result.second.size());
+    EXPECT_EQ(0u, manager.getPendingChunkCount());
+
+    // a long gap expires everything at once
+    manager.addPendingChunk(2000, 0x3000, 1, header, chunk, 2);
+    manager.addPendingChunk(2000, 0x3000, 2, header, chunk, 2);
+    manager.addPendingChunk(3000, 0x4000, 1, header, chunk, 2);
+    EXPECT_EQ(1u, manager.getPendingChunkCount());
+    EXPECT_TRUE(manager.hasPendingChunk(0x4000, 1));
+
+    // once chunks stop coming in, the periodic tick expires what is left
+    manager.expireChunks(3005);
+    EXPECT_EQ(1u, manager.getPendingChunkCount());
+    manager.expireChunks(3006);
+    EXPECT_EQ(0u, manager.getPendingChunkCount());
+}
+
+TEST(MessageSerializationTest, LogRecordRendersOnDemand) {
+    Common common(0x1234567, 0x7654321, ADDRESS_FUNCTION_BLOCK, 0);
+    std::string header_json = R"({"resource":"X-Test","resId":"a b"})";
+    std::string body_json = R"({"list":[1,{"name":"x,y"}],"empty":{}})";
+    GetPropertyDataReply reply(common, 7, std::vector<uint8_t>(header_json.begin(), header_json.end()),
+                               std::vector<uint8_t>(body_json.begin(), body_json.end()));
+
+    auto record = reply.createLogRecord();
+    auto copy = record;
+    EXPECT_TRUE(copy.isPropertyMessage());
+    EXPECT_EQ(MessageType::GetPropertyDataReply, copy.getType());
+    EXPECT_EQ(0x1234567u, copy.getSourceMuid());
+    EXPECT_EQ(7, copy.getRequestId());
+    EXPECT_EQ(record.getBody().data(), copy.getBody().data());
+    EXPECT_EQ(reply.getLabel(), copy.getLabel());
+    EXPECT_EQ(reply.getLogMessage(), copy.getText());
+    EXPECT_EQ("{\n"
+              "  \"header\": {\n"
+              "    \"resource\": \"X-Test\",\n"
+              "    \"resId\": \"a b\"\n"
+              "  },\n"
+              "  \"body\": {\n"
+              "    \"list\": [\n"
+              "      1,\n"
+              "      {\n"
+              "        \"name\": \"x,y\"\n"
+              "      }\n"
+              "    ],\n"
+              "    \"empty\": {}\n"
+              "  }\n"
+              "}", copy.getPrettyJson());
+
+    PropertyGetCapabilities capabilities(common, 4);
+    auto capabilities_record = capabilities.createLogRecord();
+    EXPECT_FALSE(capabilities_record.isPropertyMessage());
+    EXPECT_EQ(capabilities.getLogMessage(), capabilities_record.getText());
+    EXPECT_EQ("", capabilities_record.getPrettyJson());
+}
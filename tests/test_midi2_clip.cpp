@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <umppi/umppi.hpp>
+#include <sstream>
+#include <tuple>
+
+using namespace umppi;
+
+TEST(Midi2ClipTest, testWriteAndRead) {
+    std::vector<Ump> messages{
+        Ump(UmpFactory::midi2NoteOn(0, 0, 60, 0, 0xF800, 0)),
+        Ump(UmpFactory::deltaClockstamp(480)),
+        Ump(UmpFactory::midi2NoteOff(0, 0, 60, 0, 0, 0)),
+    };
+    auto sysex = UmpFactory::sysex7(0, {0x7E, 0x7F, 0x06, 0x01, 0x10, 0x20, 0x30, 0x40});
+    messages.insert(messages.end(), sysex.begin(), sysex.end());
+
+    std::stringstream stream;
+    Midi2ClipWriter writer(stream);
+    EXPECT_THROW(writer.write(messages[0]), std::logic_error);
+    writer.writeHeader(480);
+    writer.write(messages);
+    writer.finish();
+    EXPECT_EQ(messages.size(), writer.getPacketCount());
+
+    auto bytes = stream.str();
+    ASSERT_GE(bytes.size(), 8u);
+    EXPECT_EQ("SMF2CLIP", bytes.substr(0, 8));
+    // DCS, DCTPQ, DCS are one word each; UMP words are big endian
+    EXPECT_EQ(0x00, static_cast<uint8_t>(bytes[12]));
+    EXPECT_EQ(0x30, static_cast<uint8_t>(bytes[13]));
+
+    Midi2ClipReader reader(stream);
+    EXPECT_EQ(480, reader.readHeader());
+    std::vector<Ump> actual;
+    Ump ump;
+    while (reader.read(ump))
+        actual.push_back(ump);
+    EXPECT_FALSE(reader.isTruncated());
+    // the trailing delta clockstamp before End of Clip is part of the sequence
+    ASSERT_EQ(messages.size() + 1, actual.size());
+    for (size_t i = 0; i < messages.size(); i++)
+        EXPECT_EQ(messages[i], actual[i]) << i;
+    EXPECT_TRUE(actual.back().isDeltaClockstamp());
+}
+
+TEST(Midi2ClipTest, testTruncatedAndInvalidClip) {
+    std::stringstream stream;
+    Midi2ClipWriter writer(stream);
+    writer.writeHeader(96);
+    writer.write(Ump(UmpFactory::midi2NoteOn(0, 0, 60, 0, 0xF800, 0)));
+    // no finish()
+
+    auto bytes = stream.str();
+    std::istringstream truncated(bytes.substr(0, bytes.size() - 2));
+    Midi2ClipReader reader(truncated);
+    EXPECT_EQ(96, reader.readHeader());
+    Ump ump;
+    EXPECT_FALSE(reader.read(ump));
+    EXPECT_TRUE(reader.isTruncated());
+
+    std::istringstream invalid("SMF1CLIP");
+    Midi2ClipReader invalidReader(invalid);
+    EXPECT_THROW(invalidReader.readHeader(), std::runtime_error);
+}
+
+TEST(Midi2ClipTest, testMidi1ReaderTrackByTrack) {
+    Midi1Music music;
+    music.format = 1;
+    music.deltaTimeSpec = 480;
+    for (int i = 0; i < 3; i++) {
+        Midi1Track track;
+        track.events.emplace_back(i * 10, std::make_shared<Midi1SimpleMessage>(0x90 + i, 60, 100));
+        music.addTrack(track);
+    }
+    std::stringstream stream;
+    Midi1Writer(stream).write(music);
+
+    Midi1Reader reader(stream);
+    Midi1Music header;
+    EXPECT_EQ(3, reader.readHeader(header));
+    EXPECT_EQ(480, header.deltaTimeSpec);
+    EXPECT_EQ(1, header.format);
+    EXPECT_TRUE(header.tracks.empty());
+    for (int i = 0; i < 3; i++) {
+        auto track = reader.readTrack();
+        ASSERT_FALSE(track.events.empty());
+        EXPECT_EQ(i * 10, track.events[0].deltaTime);
+        EXPECT_EQ(0x90 + i, track.events[0].message->getStatusByte());
+    }
+}
+
+TEST(Midi2ClipTest, testConverterRoundTrip) {
+    Midi1Music music;
+    music.format = 1;
+    music.deltaTimeSpec = 480;
+    Midi1Track notes;
+    std::vector<uint8_t> tempo{0x07, 0xA1, 0x20}; // 500000 microseconds
+    std::vector<uint8_t> name{'L', 'e', 'a', 'd', ' ', 'S', 'y', 'n', 't', 'h', ' ', 'P', 'a', 'r', 't'};
+    notes.events.emplace_back(0, std::make_shared<Midi1CompoundMessage>(0xFF, MidiMetaType::TEMPO, 0, tempo));
+    notes.events.emplace_back(0, std::make_shared<Midi1CompoundMessage>(0xFF, MidiMetaType::TRACK_NAME, 0, name));
+    notes.events.emplace_back(0, std::make_shared<Midi1SimpleMessage>(0x90, 60, 100));
+    notes.events.emplace_back(480, std::make_shared<Midi1SimpleMessage>(0x80, 60, 0));
+    music.addTrack(notes);
+    Midi1Track controllers;
+    controllers.events.emplace_back(240, std::make_shared<Midi1SimpleMessage>(0xB1, 7, 90));
+    controllers.events.emplace_back(0, std::make_shared<Midi1SimpleMessage>(0xC1, 5, 0));
+    // a key signature is not written back to SMF, but the ticks up to it still count for End of Track
+    std::vector<uint8_t> key{0x02, 0x00};
+    controllers.events.emplace_back(360, std::make_shared<Midi1CompoundMessage>(0xFF, MidiMetaType::KEY_SIGNATURE, 0, key));
+    music.addTrack(controllers);
+    std::stringstream smf;
+    Midi1Writer(smf).write(music);
+
+    Midi2ClipConverter converter;
+    std::stringstream clip;
+    EXPECT_GT(converter.smfToClip(smf, clip), 0);
+    std::stringstream result;
+    converter.clipToSmf(clip, result);
+
+    // the tracks are merged by time into one, and End of Track keeps the length
+    Midi1Reader reader(result);
+    Midi1Music header;
+    ASSERT_EQ(1, reader.readHeader(header));
+    EXPECT_EQ(480, header.deltaTimeSpec);
+    auto track = reader.readTrack();
+    std::vector<std::tuple<int, int, int, int>> events;
+    std::vector<std::vector<uint8_t>> metaData;
+    int tick = 0;
+    for (const auto& event : track.events) {
+        tick += event.deltaTime;
+        events.emplace_back(tick, event.message->getStatusByte(), event.message->getMsb(), event.message->getLsb());
+        if (auto* meta = dynamic_cast<const Midi1CompoundMessage*>(event.message.get())) {
+            auto begin = meta->getExtraData().begin() + static_cast<std::ptrdiff_t>(meta->getExtraDataOffset());
+            metaData.emplace_back(begin, begin + static_cast<std::ptrdiff_t>(meta->getExtraDataLength()));
+        }
+    }
+    std::vector<std::tuple<int, int, int, int>> expected{
+        {0, 0xFF, MidiMetaType::TEMPO, 0}, {0, 0xFF, MidiMetaType::TRACK_NAME, 0}, {0, 0x90, 60, 100},
+        {240, 0xB1, 7, 90}, {240, 0xC1, 5, 0}, {480, 0x80, 60, 0}, {600, 0xFF, 0x2F, 0}};
+    EXPECT_EQ(expected, events);
+    ASSERT_GE(metaData.size(), 2u);
+    EXPECT_EQ(tempo, metaData[0]);
+    EXPECT_EQ(name, metaData[1]);
+}
@@ -25,3 +25,39 @@ TEST(MidiCIDeviceTest, basicRun) {
 
     ASSERT_NE(nullptr, conn->getDeviceInfo()) << "conn->getDeviceInfo()";
 }
+
+TEST(MidiCIDeviceTest, dispatchWithoutObservers) {
+    using namespace midicci;
+    MidiCIDeviceConfiguration config;
+    MidiCIDevice device(0x1234, config);
+    std::vector<std::vector<uint8_t>> sent;
+    device.setSysexSender([&](uint8_t, const std::vector<uint8_t>& data) {
+        sent.push_back(data);
+        return true;
+    });
+
+    // discovery inquiries are answered without any logger or callback
+    DiscoveryInquiry inquiry(Common(0x5678, MIDI_CI_BROADCAST_MUID_32, MIDI_CI_ADDRESS_FUNCTION_BLOCK, 0),
+                             DeviceDetails(1, 2, 3, 4), 0x1C, 4096, 0);
+    device.processInput(0, inquiry.serialize(config));
+    ASSERT_EQ(1, sent.size());
+    EXPECT_EQ(static_cast<uint8_t>(CISubId2::DISCOVERY_REPLY), sent[0][3]);
+
+    std::vector<MessageType> received;
+    SetProfileOn set_on(Common(0x5678, 0x1234, 0, 0), MidiCIProfileId(std::vector<uint8_t>{0x7E, 0, 0, 0, 1}), 1);
+    device.processInput(0, set_on.serialize(config));
+    device.setMessageReceivedCallback([&](const Message& msg) { received.push_back(msg.getType()); });
+    device.processInput(0, set_on.serialize(config));
+    ASSERT_EQ(1, received.size());
+    EXPECT_EQ(MessageType::SetProfileOn, received[0]);
+
+    // truncated and unknown messages are dropped
+    auto truncated = set_on.serialize(config);
+    truncated.resize(16);
+    device.processInput(0, truncated);
+    auto unknown = set_on.serialize(config);
+    unknown[3] = 0x10;
+    device.processInput(0, unknown);
+    EXPECT_EQ(1, received.size());
+    EXPECT_EQ(1, sent.size());
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <umppi/umppi.hpp>
+
+using namespace umppi;
+
+namespace {
+
+void addDelta(Midi2Track& track, uint32_t ticks) {
+    track.messages.emplace_back(UmpFactory::deltaClockstamp(ticks));
+}
+
+void addMidi2(Midi2Track& track, uint64_t packet) {
+    track.messages.emplace_back(packet);
+}
+
+} // namespace
+
+TEST(NoteIntervalIndexTest, testMidi2PairingAndQuery) {
+    Midi2Track track;
+    addMidi2(track, UmpFactory::midi2NoteOn(0, 0, 60, 3, 0x8000, 0x1234));
+    addDelta(track, 10);
+    addMidi2(track, UmpFactory::midi2NoteOn(0, 0, 64, 0, 0x4000, 0));
+    addMidi2(track, UmpFactory::midi2PerNoteACC(0, 0, 60, 1, 100));
+    addDelta(track, 10);
+    addMidi2(track, UmpFactory::midi2NoteOff(0, 0, 60, 0, 0x2000, 0));
+    addDelta(track, 30);
+    addMidi2(track, UmpFactory::midi2NoteOff(0, 0, 64, 0, 0, 0));
+
+    NoteIntervalIndex index(track);
+    ASSERT_EQ(2, index.size());
+    const auto& first = index.getInterval(0);
+    EXPECT_EQ(0, first.startTick);
+    EXPECT_EQ(20, first.endTick);
+    EXPECT_EQ(0x8000, first.velocity);
+    EXPECT_EQ(0x2000, first.releaseVelocity);
+    EXPECT_EQ(3, first.attributeType);
+    EXPECT_EQ(0x1234, first.attributeData);
+    ASSERT_EQ(1, first.perNoteMessages.size());
+    EXPECT_EQ(3, first.perNoteMessages[0]);
+    EXPECT_EQ(10, index.getInterval(1).startTick);
+    EXPECT_EQ(50, index.getInterval(1).endTick);
+
+    std::vector<uint32_t> results;
+    EXPECT_EQ(1, index.query(25, 40, results));
+    EXPECT_EQ(1, results[0]);
+    results.clear();
+    EXPECT_EQ(2, index.query(0, 100, results));
+    results.clear();
+    EXPECT_EQ(0, index.query(20, 100, results, 60, 60));
+    EXPECT_EQ(0, index.query(50, 100, results));
+}
+
+TEST(NoteIntervalIndexTest, testIncrementalUpdate) {
+    Midi2Track track;
+    addMidi2(track, UmpFactory::midi2NoteOn(0, 1, 60, 0, 0x8000, 0));
+    addDelta(track, 100);
+
+    NoteIntervalIndex index(track);
+    std::vector<uint32_t> results;
+    EXPECT_EQ(1, index.query(50, 60, results));
+    EXPECT_FALSE(index.getInterval(0).isTerminated());
+    EXPECT_EQ(100, index.getInterval(0).endTick);
+
+    // recording goes on
+    addDelta(track, 100);
+    addMidi2(track, UmpFactory::midi2NoteOff(0, 1, 60, 0, 0, 0));
+    track.messages.emplace_back(UmpFactory::midi1NoteOn(0, 1, 62, 100));
+    results.clear();
+    EXPECT_EQ(1, index.query(150, 160, results));
+    EXPECT_TRUE(index.getInterval(0).isTerminated());
+    EXPECT_EQ(200, index.getInterval(0).endTick);
+    EXPECT_EQ(2, index.size());
+    EXPECT_EQ(100, index.getInterval(1).velocity);
+}
+
+TEST(NoteIntervalIndexTest, testQueryMatchesLinearScan) {
+    Midi2Track track;
+    // overlapping notes of varying lengths
+    for (int i = 0; i < 500; i++) {
+        addMidi2(track, UmpFactory::midi2NoteOn(0, 0, static_cast<uint8_t>(i % 128), 0, 0x8000, 0));
+        addDelta(track, 1 + (i * 7) % 5);
+        if (i >= 10)
+            addMidi2(track, UmpFactory::midi2NoteOff(0, 0, static_cast<uint8_t>((i - 10) % 128), 0, 0, 0));
+    }
+    NoteIntervalIndex index(track);
+    const auto& intervals = index.getIntervals();
+    std::vector<uint32_t> results;
+    for (int64_t start = 0; start < 1600; start += 37) {
+        int64_t end = start + 1 + start % 50;
+        results.clear();
+        index.query(start, end, results, 30, 90);
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < intervals.size(); i++) {
+            const auto& n = intervals[i];
+            if (n.startTick < end && n.endTick > start && n.note >= 30 && n.note <= 90)
+                expected.push_back(i);
+        }
+        EXPECT_EQ(expected, results) << "range " << start << "-" << end;
+    }
+}
+
+TEST(NoteIntervalIndexTest, testQueriesWhileRecording) {
+    Midi2Track track;
+    NoteIntervalIndex index(track);
+    std::vector<uint32_t> results;
+    for (int i = 0; i < 300; i++) {
+        addMidi2(track, UmpFactory::midi2NoteOn(0, 0, static_cast<uint8_t>(i % 100), 0, 0x8000, 0));
+        addDelta(track, 3);
+        // long notes stay on across several tree rebuilds
+        if (i >= 20 && i % 4 != 0)
+            addMidi2(track, UmpFactory::midi2NoteOff(0, 0, static_cast<uint8_t>((i - 20) % 100), 0, 0, 0));
+
+        int64_t start = i * 3 - 70;
+        results.clear();
+        index.query(start, start + 50, results);
+        std::vector<uint32_t> expected;
+        const auto& intervals = index.getIntervals();
+        for (uint32_t j = 0; j < intervals.size(); j++) {
+            if (intervals[j].startTick < start + 50 && intervals[j].endTick > start)
+                expected.push_back(j);
+        }
+        ASSERT_EQ(expected, results) << "after note " << i;
+    }
+}
+
+TEST(NoteIntervalIndexTest, testMidi1Track) {
+    Midi1Track track;
+    track.events.emplace_back(0, std::make_shared<Midi1SimpleMessage>(0x90, 60, 100));
+    track.events.emplace_back(48, std::make_shared<Midi1SimpleMessage>(0xA0, 60, 20));
+    track.events.emplace_back(48, std::make_shared<Midi1SimpleMessage>(0x90, 60, 0));
+
+    NoteIntervalIndex index(track);
+    ASSERT_EQ(1, index.size());
+    EXPECT_EQ(96, index.getInterval(0).endTick);
+    EXPECT_EQ(100, index.getInterval(0).velocity);
+    EXPECT_EQ(1, index.getInterval(0).perNoteMessages.size());
+}
@@ -83,3 +83,451 @@ TEST(PropertyFacadesTest, propertyExchange2) {
     auto& client = conn->getPropertyClientFacade();
     client.sendGetPropertyData(PropertyResourceNames::CHANNEL_LIST, "", "");
 }
+
+TEST(PropertyFacadesTest, receivedBodyIsShared) {
+    TestCIMediator mediator;
+    auto& device1 = mediator.getDevice1();
+    auto& device2 = mediator.getDevice2();
+
+    std::string id = "X-02";
+    auto& host = device2.getPropertyHostFacade();
+    host.addMetadata(std::make_unique<CommonRulesPropertyMetadata>(id));
+
+    device1.sendDiscovery();
+    auto connections = device1.getConnections();
+    ASSERT_GT(connections.size(), 0) << "No connections established after discovery";
+    auto& client = connections.begin()->second->getPropertyClientFacade();
+
+    std::string json = R"({"large":")" + std::string(1000, 'x') + R"("})";
+    client.sendSetPropertyData(id, "", std::vector<uint8_t>(json.begin(), json.end()));
+
+    // the reassembled body is stored both in the device configuration and in the property list
+    auto& stored = device2.getConfig().property_values;
+    auto stored_it = std::find_if(stored.begin(), stored.end(), [&id](const PropertyValue& pv) { return pv.id == id; });
+    ASSERT_NE(stored_it, stored.end());
+    auto values = host.getProperties().getValues();
+    auto value_it = std::find_if(values.begin(), values.end(), [&id](const PropertyValue& pv) { return pv.id == id; });
+    ASSERT_NE(value_it, values.end());
+    EXPECT_EQ(json, std::string(value_it->body.begin(), value_it->body.end()));
+    EXPECT_EQ(stored_it->body.data(), value_it->body.data()) << "Body was copied";
+}
+
+namespace {
+
+// Runs eagerly and frees itself when done.
+struct DetachedCoroutine {
+    struct promise_type {
+        DetachedCoroutine get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+DetachedCoroutine fetchAll(PropertyClientFacade& client, std::vector<std::string> ids, std::vector<std::string>& bodies) {
+    std::vector<PropertyClientFacade::GetPropertyDataTask> tasks;
+    for (const auto& id : ids)
+        tasks.push_back(client.getPropertyDataAsync(id));
+    for (const auto& reply : co_await whenAll(std::move(tasks)))
+        bodies.emplace_back(reply->getBody().begin(), reply->getBody().end());
+}
+
+DetachedCoroutine fetchOne(PropertyClientFacade& client, std::string id, std::vector<std::string>& bodies) {
+    auto reply = co_await client.getPropertyDataAsync(id);
+    bodies.emplace_back(reply->getBody().begin(), reply->getBody().end());
+}
+
+} // namespace
+
+TEST(PropertyFacadesTest, asyncPropertyExchange) {
+    TestCIMediator mediator;
+    auto& device1 = mediator.getDevice1();
+    auto& device2 = mediator.getDevice2();
+
+    auto& host = device2.getPropertyHostFacade();
+    for (std::string id : {"X-A", "X-B"}) {
+        auto metadata = std::make_unique<CommonRulesPropertyMetadata>(id);
+        metadata->canSet = "full";
+        host.addMetadata(std::move(metadata));
+        std::string json = JsonValue(id).serialize();
+        host.setPropertyValue(id, "", std::vector<uint8_t>(json.begin(), json.end()), false);
+    }
+
+    device1.sendDiscovery();
+    auto connections = device1.getConnections();
+    ASSERT_GT(connections.size(), 0) << "No connections established after discovery";
+    auto& client = connections.begin()->second->getPropertyClientFacade();
+
+    std::vector<std::string> bodies;
+    fetchAll(client, {"X-A", "X-B"}, bodies);
+    EXPECT_EQ((std::vector<std::string>{"\"X-A\"", "\"X-B\""}), bodies);
+
+    std::string json = JsonValue("NEW").serialize();
+    auto set = client.setPropertyDataAsync("X-B", "", std::vector<uint8_t>(json.begin(), json.end()));
+    ASSERT_TRUE(set.isReady());
+    EXPECT_EQ(PropertyExchangeStatus::OK,
+              client.getPropertyRules()->getHeaderFieldInteger(set.getFuture().get()->getHeader(), "status"));
+    auto body = client.getPropertyDataAsync("X-B").getFuture().get()->getBody();
+    EXPECT_EQ(json, std::string(body.begin(), body.end()));
+}
+
+TEST(PropertyFacadesTest, asyncReplyAfterSuspension) {
+    TestCIMediator mediator(true);
+    auto& device1 = mediator.getDevice1();
+    auto& device2 = mediator.getDevice2();
+
+    auto& host = device2.getPropertyHostFacade();
+    for (std::string id : {"X-A", "X-B", "X-C"}) {
+        host.addMetadata(std::make_unique<CommonRulesPropertyMetadata>(id));
+        std::string json = JsonValue(id).serialize();
+        host.setPropertyValue(id, "", std::vector<uint8_t>(json.begin(), json.end()), false);
+    }
+
+    device1.sendDiscovery();
+    mediator.deliver();
+    auto connections = device1.getConnections();
+    ASSERT_GT(connections.size(), 0) << "No connections established after discovery";
+    auto& client = connections.begin()->second->getPropertyClientFacade();
+
+    std::vector<std::string> all_bodies;
+    std::vector<std::string> one_body;
+    fetchAll(client, {"X-A", "X-B"}, all_bodies);
+    fetchOne(client, "X-C", one_body);
+    // both coroutines are suspended until the replies are delivered
+    EXPECT_TRUE(all_bodies.empty());
+    EXPECT_TRUE(one_body.empty());
+
+    EXPECT_GT(mediator.deliver(), 0u);
+    EXPECT_EQ((std::vector<std::string>{"\"X-A\"", "\"X-B\""}), all_bodies);
+    EXPECT_EQ(std::vector<std::string>{"\"X-C\""}, one_body);
+}
+
+TEST(PropertyFacadesTest, asyncRequestCancellation) {
+    MidiCIDeviceConfiguration config;
+    MidiCIDevice device(0x12345678, config);
+    std::vector<std::vector<uint8_t>> sent;
+    device.setSysexSender([&sent](uint8_t, const std::vector<uint8_t>& data) {
+        sent.push_back(data);
+        return true;
+    });
+    // nothing answers this connection
+    ClientConnection connection(device, 0x07654321, DeviceDetails{0x123, 0x456, 0x789, 0xABC}, 4096);
+    PropertyClientFacade client(device, connection);
+    client.getRequestScheduler().setMaxInFlight(1);
+
+    auto in_flight = client.getPropertyDataAsync("DeviceInfo");
+    auto queued = client.getPropertyDataAsync("ChannelList");
+    auto shared = client.getPropertyDataAsync("ChannelList");
+    EXPECT_EQ(queued.getRequestId(), shared.getRequestId());
+    EXPECT_EQ(1u, sent.size());
+
+    // the queued request stays while someone still waits for it
+    queued.cancel();
+    EXPECT_THROW(queued.getFuture().get(), PropertyRequestCancelledException);
+    EXPECT_TRUE(client.getRequestScheduler().isPending(*shared.getRequestId()));
+    shared.cancel();
+    EXPECT_FALSE(client.getRequestScheduler().isPending(*shared.getRequestId()));
+
+    // an unanswered request completes with an error status once its retries run out
+    auto& scheduler = client.getRequestScheduler();
+    scheduler.setMaxRetries(0);
+    scheduler.processTimeouts(PropertyRequestScheduler::Clock::now() + scheduler.getTimeout());
+    ASSERT_TRUE(in_flight.isReady());
+    EXPECT_EQ(PropertyExchangeStatus::INTERNAL_ERROR,
+              client.getPropertyRules()->getHeaderFieldInteger(in_flight.getFuture().get()->getHeader(), "status"));
+    EXPECT_EQ(1u, sent.size());
+
+    // a task outliving its facade fails, and cancelling it is harmless
+    std::optional<PropertyClientFacade::GetPropertyDataTask> orphan;
+    {
+        PropertyClientFacade other(device, connection);
+        orphan = other.getPropertyDataAsync("DeviceInfo");
+    }
+    EXPECT_THROW(orphan->getFuture().get(), std::future_error);
+    orphan->cancel();
+}
+
+TEST(PropertyFacadesTest, retryAfterPartialReply) {
+    TestCIMediator mediator(true);
+    auto& device1 = mediator.getDevice1();
+    auto& device2 = mediator.getDevice2();
+    device2.getConfig().max_property_chunk_size = 256;
+
+    std::string id = "X-LARGE";
+    auto& host = device2.getPropertyHostFacade();
+    host.addMetadata(std::make_unique<CommonRulesPropertyMetadata>(id));
+    std::string json = R"({"large":")" + std::string(1000, 'x') + R"("})";
+    host.setPropertyValue(id, "", std::vector<uint8_t>(json.begin(), json.end()), false);
+
+    device1.sendDiscovery();
+    mediator.deliver();
+    auto connections = device1.getConnections();
+    ASSERT_GT(connections.size(), 0) << "No connections established after discovery";
+    auto& client = connections.begin()->second->getPropertyClientFacade();
+
+    // only the first chunk of the reply arrives
+    auto task = client.getPropertyDataAsync(id);
+    ASSERT_EQ(1u, mediator.deliver(1));
+    ASSERT_EQ(1u, mediator.deliver(1));
+    EXPECT_GT(mediator.drop(), 0u);
+    EXPECT_EQ(1u, client.getPendingChunkManager().getPendingChunkCount());
+
+    // the retry (with the same request ID) starts over instead of appending to the partial reply
+    auto& scheduler = client.getRequestScheduler();
+    scheduler.processTimeouts(PropertyRequestScheduler::Clock::now() + scheduler.getTimeout() * 2);
+    EXPECT_EQ(0u, client.getPendingChunkManager().getPendingChunkCount());
+    mediator.deliver();
+    ASSERT_TRUE(task.isReady());
+    auto reply = task.getFuture().get();
+    EXPECT_EQ(PropertyExchangeStatus::OK, client.getPropertyRules()->getHeaderFieldInteger(reply->getHeader(), "status"));
+    EXPECT_EQ(json, std::string(reply->getBody().begin(), reply->getBody().end()));
+}
+
+TEST(PropertyFacadesTest, explicitRequestIdsAreRemapped) {
+    MidiCIDeviceConfiguration config;
+    MidiCIDevice device(0x12345678, config);
+    std::vector<uint8_t> sent_ids;
+    device.setSysexSender([&sent_ids](uint8_t, const std::vector<uint8_t>& data) {
+        // request ID follows sub-ID #1/#2, version, source and destination MUIDs
+        sent_ids.push_back(data[13]);
+        return true;
+    });
+    ClientConnection connection(device, 0x07654321, DeviceDetails{0x123, 0x456, 0x789, 0xABC}, 4096);
+    PropertyClientFacade client(device, connection);
+
+    auto first = client.sendGetPropertyData("DeviceInfo", "");
+    std::string header = "{\"resource\":\"ChannelList\"}";
+    GetPropertyData msg(Common(device.getMuid(), connection.getTargetMuid(), 0x7F, 0), first,
+                        std::vector<uint8_t>(header.begin(), header.end()));
+    auto second = client.sendGetPropertyData(msg);
+    EXPECT_NE(first, second);
+    EXPECT_TRUE(client.getRequestScheduler().isPending(first));
+    EXPECT_TRUE(client.getRequestScheduler().isPending(second));
+    EXPECT_EQ((std::vector<uint8_t>{first, second}), sent_ids);
+}
+
+TEST(PropertyFacadesTest, paginatedPropertyFetch) {
+    TestCIMediator mediator;
+    auto& device1 = mediator.getDevice1();
+    auto& device2 = mediator.getDevice2();
+
+    std::string id = "X-LIST";
+    auto& host = device2.getPropertyHostFacade();
+    auto metadata = std::make_unique<CommonRulesPropertyMetadata>(id);
+    metadata->canPaginate = true;
+    host.addMetadata(std::move(metadata));
+    JsonArray list;
+    for (int i = 0; i < 70; i++)
+        list.push_back(JsonValue(i));
+    std::string json = JsonValue(list).serialize();
+    host.setPropertyValue(id, "", std::vector<uint8_t>(json.begin(), json.end()), false);
+
+    device1.sendDiscovery();
+    auto connections = device1.getConnections();
+    ASSERT_GT(connections.size(), 0) << "No connections established after discovery";
+    auto& client = connections.begin()->second->getPropertyClientFacade();
+
+    std::vector<size_t> page_offsets;
+    std::vector<int> received(70, -1);
+    int completed_status = 0;
+    size_t completed_total = 0;
+    client.getPaginatedPropertyData(id, "", 16,
+        [&](size_t offset, const JsonArray& entries) {
+            page_offsets.push_back(offset);
+            for (size_t i = 0; i < entries.size(); i++)
+                received[offset + i] = entries[i].asInt();
+        },
+        [&](int status, size_t total_count) {
+            completed_status = status;
+            completed_total = total_count;
+        });
+
+    EXPECT_EQ((std::vector<size_t>{0, 16, 32, 48, 64}), page_offsets);
+    for (int i = 0; i < 70; i++)
+        EXPECT_EQ(i, received[i]);
+    EXPECT_EQ(PropertyExchangeStatus::OK, completed_status);
+    EXPECT_EQ(70u, completed_total);
+
+    // the assembled list, not the last page, is the property value
+    auto values = client.getProperties()->getValues();
+    auto it = std::find_if(values.begin(), values.end(), [&id](const PropertyValue& pv) { return pv.id == id; });
+    ASSERT_NE(it, values.end());
+    EXPECT_EQ(json, std::string(it->body.begin(), it->body.end()));
+}
+
+TEST(PropertyFacadesTest, paginatedFetchOfManyPages) {
+    TestCIMediator mediator(true);
+    auto& device1 = mediator.getDevice1();
+    auto& device2 = mediator.getDevice2();
+
+    std::string id = "X-LONG-LIST";
+    auto& host = device2.getPropertyHostFacade();
+    auto metadata = std::make_unique<CommonRulesPropertyMetadata>(id);
+    metadata->canPaginate = true;
+    host.addMetadata(std::move(metadata));
+    // far more pages than there are request IDs
+    const int count = 5000;
+    JsonArray list;
+    for (int i = 0; i < count; i++)
+        list.push_back(JsonValue(i));
+    std::string json = JsonValue(list).serialize();
+    host.setPropertyValue(id, "", std::vector<uint8_t>(json.begin(), json.end()), false);
+
+    device1.sendDiscovery();
+    mediator.deliver();
+    auto connections = device1.getConnections();
+    ASSERT_GT(connections.size(), 0) << "No connections established after discovery";
+    auto& client = connections.begin()->second->getPropertyClientFacade();
+    auto& scheduler = client.getRequestScheduler();
+
+    std::vector<int> received(count, -1);
+    size_t max_pending = 0;
+    int completed_status = 0;
+    client.getPaginatedPropertyData(id, "", 16,
+        [&](size_t offset, const JsonArray& entries) {
+            max_pending = std::max(max_pending, scheduler.getInFlightCount() + scheduler.getQueuedCount());
+            for (size_t i = 0; i < entries.size(); i++)
+                received[offset + i] = entries[i].asInt();
+        },
+        [&](int status, size_t) { completed_status = status; });
+
+    mediator.deliver();
+    EXPECT_EQ(PropertyExchangeStatus::OK, completed_status);
+    EXPECT_LE(max_pending, scheduler.getMaxInFlight());
+    for (int i = 0; i < count; i++)
+        ASSERT_EQ(i, received[i]);
+    auto values = client.getProperties()->getValues();
+    auto it = std::find_if(values.begin(), values.end(), [&id](const PropertyValue& pv) { return pv.id == id; });
+    ASSERT_NE(it, values.end());
+    EXPECT_EQ(json, std::string(it->body.begin(), it->body.end()));
+}
+
+TEST(PropertyFacadesTest, singlePageGetIsStored) {
+    TestCIMediator mediator;
+    auto& device1 = mediator.getDevice1();
+    auto& device2 = mediator.getDevice2();
+
+    std::string id = "X-LIST";
+    auto& host = device2.getPropertyHostFacade();
+    auto metadata = std::make_unique<CommonRulesPropertyMetadata>(id);
+    metadata->canPaginate = true;
+    host.addMetadata(std::move(metadata));
+    std::string json = JsonValue(JsonArray{JsonValue(1), JsonValue(2), JsonValue(3)}).serialize();
+    host.setPropertyValue(id, "", std::vector<uint8_t>(json.begin(), json.end()), false);
+
+    device1.sendDiscovery();
+    auto connections = device1.getConnections();
+    ASSERT_GT(connections.size(), 0) << "No connections established after discovery";
+    auto& client = connections.begin()->second->getPropertyClientFacade();
+
+    // a GET with offset and limit from outside a paginated fetch (e.g. an inspector) stores what it gets
+    client.sendGetPropertyData(id, "", "", 0, 2);
+    auto values = client.getProperties()->getValues();
+    auto it = std::find_if(values.begin(), values.end(), [&id](const PropertyValue& pv) { return pv.id == id; });
+    ASSERT_NE(it, values.end());
+    EXPECT_EQ(JsonValue(JsonArray{JsonValue(1), JsonValue(2)}).serialize(), std::string(it->body.begin(), it->body.end()));
+}
+
+TEST(PropertyFacadesTest, paginatedFetchFromCappingResponder) {
+    MidiCIDeviceConfiguration config;
+    MidiCIDevice device(0x12345678, config);
+    std::vector<std::vector<uint8_t>> sent;
+    device.setSysexSender([&sent](uint8_t, const std::vector<uint8_t>& data) {
+        sent.push_back(data);
+        return true;
+    });
+    ClientConnection connection(device, 0x07654321, DeviceDetails{0x123, 0x456, 0x789, 0xABC}, 4096);
+    PropertyClientFacade client(device, connection);
+
+    std::vector<size_t> page_offsets;
+    int completed_status = 0;
+    size_t completed_total = 0;
+    client.getPaginatedPropertyData("X-LIST", "", 4,
+        [&](size_t offset, const JsonArray&) { page_offsets.push_back(offset); },
+        [&](int status, size_t total_count) {
+            completed_status = status;
+            completed_total = total_count;
+        });
+
+    // The responder has 10 entries but claims 1000, and sends no more than 3 entries per reply.
+    auto& rules = *client.getPropertyRules();
+    for (size_t i = 0; i < sent.size(); i++) {
+        auto span = CIRetrieval::getPropertyHeader(sent[i]);
+        std::vector<uint8_t> request_header(span.begin(), span.end());
+        auto offset = rules.getHeaderFieldInteger(request_header, "offset");
+        auto limit = rules.getHeaderFieldInteger(request_header, "limit");
+        JsonArray page;
+        for (int entry = offset; entry < std::min({offset + limit, offset + 3, 10}); entry++)
+            page.push_back(JsonValue(entry));
+        std::string header = R"({"status":200,"totalCount":1000})";
+        std::string body = JsonValue(page).serialize();
+        client.processGetDataReply(GetPropertyDataReply(Common(connection.getTargetMuid(), device.getMuid(), 0x7F, 0),
+                                                        sent[i][13], std::vector<uint8_t>(header.begin(), header.end()),
+                                                        std::vector<uint8_t>(body.begin(), body.end())));
+    }
+
+    EXPECT_EQ(PropertyExchangeStatus::OK, completed_status);
+    EXPECT_EQ(10u, completed_total);
+    // the short first page is continued where it stopped
+    ASSERT_GE(page_offsets.size(), 2u);
+    EXPECT_EQ(0u, page_offsets[0]);
+    EXPECT_EQ(3u, page_offsets[1]);
+    JsonArray expected;
+    for (int i = 0; i < 10; i++)
+        expected.push_back(JsonValue(i));
+    auto values = client.getProperties()->getValues();
+    auto it = std::find_if(values.begin(), values.end(), [](const PropertyValue& pv) { return pv.id == "X-LIST"; });
+    ASSERT_NE(it, values.end());
+    EXPECT_EQ(JsonValue(expected).serialize(), std::string(it->body.begin(), it->body.end()));
+}
+
+TEST(PropertyFacadesTest, hostReusesEncodedReplies) {
+    TestCIMediator mediator;
+    auto& device2 = mediator.getDevice2();
+    auto& host = device2.getPropertyHostFacade();
+
+    std::string id = "X-CACHED";
+    host.addMetadata(std::make_unique<CommonRulesPropertyMetadata>(id));
+    std::string json = JsonValue("FOO").serialize();
+    host.setPropertyValue(id, "", std::vector<uint8_t>(json.begin(), json.end()), false);
+
+    auto get = [&](const std::string& resource, const std::string& encoding = "") {
+        std::string header = R"({"resource":")" + resource + R"(")" +
+            (encoding.empty() ? "" : R"(,"mutualEncoding":")" + encoding + R"(")") + "}";
+        GetPropertyData msg(Common(0x1234, device2.getMuid(), 0x7F, 0), 1, std::vector<uint8_t>(header.begin(), header.end()));
+        return host.processGetPropertyData(msg).getSharedBody();
+    };
+
+    auto first = get(id);
+    EXPECT_EQ(first.getShared(), get(id).getShared()) << "Repeated GET was not served from the cache";
+    EXPECT_NE(first.getShared(), get(id, PropertyDataEncoding::MCODED7).getShared());
+
+    std::string updated = JsonValue("BAR").serialize();
+    host.setPropertyValue(id, "", std::vector<uint8_t>(updated.begin(), updated.end()), false);
+    auto after_set = get(id);
+    EXPECT_EQ(updated, std::string(after_set.begin(), after_set.end()));
+
+    auto resource_list = get(PropertyResourceNames::RESOURCE_LIST);
+    EXPECT_EQ(resource_list.getShared(), get(PropertyResourceNames::RESOURCE_LIST).getShared());
+    host.addMetadata(std::make_unique<CommonRulesPropertyMetadata>("X-OTHER"));
+    auto new_list = get(PropertyResourceNames::RESOURCE_LIST);
+    EXPECT_NE(std::string::npos, std::string(new_list.begin(), new_list.end()).find("X-OTHER"));
+
+    auto device_info = get(PropertyResourceNames::DEVICE_INFO);
+    DeviceInfo info = device2.getDeviceInfo();
+    info.model = "Cached Model";
+    host.updateCommonRulesDeviceInfo(info);
+    auto new_device_info = get(PropertyResourceNames::DEVICE_INFO);
+    EXPECT_NE(std::string::npos, std::string(new_device_info.begin(), new_device_info.end()).find("Cached Model"));
+
+    // values from a custom getter may change at any time, so they are not cached
+    int calls = 0;
+    host.setPropertyBinaryGetter([&](const std::string&, const std::string&) -> SharedBytes {
+        calls++;
+        return std::vector<uint8_t>(json.begin(), json.end());
+    });
+    get(id);
+    get(id);
+    EXPECT_EQ(2, calls);
+}
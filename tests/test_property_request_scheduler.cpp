@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <midicci/midicci.hpp>
+#include <future>
+#include <set>
+
+using namespace midicci;
+
+namespace {
+
+std::shared_ptr<GetPropertyData> makeGet(uint8_t request_id, const std::string& resource, uint32_t destination = 0x200) {
+    std::string header = "{\"resource\":\"" + resource + "\"}";
+    return std::make_shared<GetPropertyData>(Common(0x100, destination, 0x7F, 0), request_id,
+                                             std::vector<uint8_t>(header.begin(), header.end()));
+}
+
+} // namespace
+
+TEST(PropertyRequestSchedulerTest, KeepsRequestsWithinWindow) {
+    std::vector<uint8_t> sent;
+    PropertyRequestScheduler scheduler([&](const PropertyMessage& msg) { sent.push_back(msg.getRequestId()); }, 2);
+
+    for (int i = 0; i < 5; i++) {
+        auto id = scheduler.allocateRequestId();
+        scheduler.enqueue(makeGet(id, "Resource" + std::to_string(i)));
+    }
+    ASSERT_EQ(2u, sent.size());
+    EXPECT_EQ(2u, scheduler.getInFlightCount());
+    EXPECT_EQ(3u, scheduler.getQueuedCount());
+
+    // nothing goes out until a reply frees a slot, and then in FIFO order
+    scheduler.dispatch();
+    EXPECT_EQ(2u, sent.size());
+    ASSERT_TRUE(scheduler.complete(sent[0]));
+    EXPECT_FALSE(scheduler.complete(sent[0]));
+    scheduler.dispatch();
+    ASSERT_EQ(3u, sent.size());
+    EXPECT_EQ(sent[1] + 1, sent[2]);
+
+    scheduler.setMaxInFlight(5);
+    scheduler.dispatch();
+    EXPECT_EQ(5u, sent.size());
+    EXPECT_EQ(0u, scheduler.getQueuedCount());
+}
+
+TEST(PropertyRequestSchedulerTest, NeverReusesLiveRequestId) {
+    PropertyRequestScheduler scheduler([](const PropertyMessage&) {}, 127);
+
+    std::set<uint8_t> ids;
+    for (int i = 0; i < PropertyRequestScheduler::MAX_REQUEST_ID + 1; i++) {
+        auto id = scheduler.allocateRequestId();
+        EXPECT_TRUE(ids.insert(id).second);
+        scheduler.enqueue(makeGet(id, "Resource" + std::to_string(i)));
+    }
+    EXPECT_THROW(scheduler.allocateRequestId(), std::runtime_error);
+    EXPECT_THROW(scheduler.enqueue(makeGet(*ids.begin(), "Other")), std::invalid_argument);
+
+    // a completed ID becomes available again
+    uint8_t in_flight = 0;
+    while (!scheduler.complete(in_flight))
+        in_flight++;
+    EXPECT_EQ(in_flight, scheduler.allocateRequestId());
+}
+
+TEST(PropertyRequestSchedulerTest, FindsIdenticalPendingRequest) {
+    PropertyRequestScheduler scheduler([](const PropertyMessage&) {}, 1);
+    scheduler.enqueue(makeGet(1, "DeviceInfo"));
+    scheduler.enqueue(makeGet(2, "ChannelList"));
+
+    EXPECT_EQ(std::optional<uint8_t>{1}, scheduler.findPending(*makeGet(3, "DeviceInfo")));
+    EXPECT_EQ(std::optional<uint8_t>{2}, scheduler.findPending(*makeGet(3, "ChannelList")));
+    EXPECT_FALSE(scheduler.findPending(*makeGet(3, "DeviceInfo", 0x300)));
+    EXPECT_FALSE(scheduler.findPending(*makeGet(3, "ProgramList")));
+}
+
+TEST(PropertyRequestSchedulerTest, RetriesThenFailsTimedOutRequest) {
+    std::vector<uint8_t> sent;
+    std::vector<uint8_t> failed;
+    PropertyRequestScheduler scheduler([&](const PropertyMessage& msg) { sent.push_back(msg.getRequestId()); }, 1);
+    scheduler.setFailureHandler([&](const PropertyMessage& msg) { failed.push_back(msg.getRequestId()); });
+    scheduler.setMaxRetries(1);
+
+    auto t = PropertyRequestScheduler::Clock::now();
+    auto timeout = scheduler.getTimeout();
+    scheduler.enqueue(makeGet(1, "DeviceInfo"), t);
+    scheduler.enqueue(makeGet(2, "ChannelList"), t);
+    ASSERT_EQ(std::vector<uint8_t>{1}, sent);
+
+    // chunks still arriving push the deadline back
+    scheduler.extend(1, t + timeout / 2);
+    scheduler.dispatch(t + timeout);
+    EXPECT_EQ(std::vector<uint8_t>{1}, sent);
+
+    t += timeout / 2 + timeout;
+    scheduler.dispatch(t);
+    EXPECT_EQ((std::vector<uint8_t>{1, 1}), sent);
+    EXPECT_TRUE(failed.empty());
+
+    // the retry goes unanswered too, so the request fails and the next one goes out
+    t += timeout;
+    scheduler.dispatch(t);
+    EXPECT_EQ(std::vector<uint8_t>{1}, failed);
+    EXPECT_FALSE(scheduler.isPending(1));
+    EXPECT_EQ((std::vector<uint8_t>{1, 1, 2}), sent);
+}
+
+TEST(PropertyRequestSchedulerTest, RequeueSendsAgainFirst) {
+    std::vector<uint8_t> sent;
+    PropertyRequestScheduler scheduler([&](const PropertyMessage& msg) { sent.push_back(msg.getRequestId()); }, 1);
+    scheduler.setMaxRetries(1);
+    auto now = PropertyRequestScheduler::Clock::now();
+    scheduler.enqueue(makeGet(1, "DeviceInfo"), now);
+    scheduler.enqueue(makeGet(2, "ChannelList"), now);
+
+    // it waits for the retry delay, and the request behind it waits too
+    EXPECT_TRUE(scheduler.requeue(1, now));
+    scheduler.dispatch(now + scheduler.getRetryDelay() / 2);
+    EXPECT_EQ((std::vector<uint8_t>{1}), sent);
+    scheduler.dispatch(now + scheduler.getRetryDelay());
+    EXPECT_EQ((std::vector<uint8_t>{1, 1}), sent);
+
+    // out of retries: it stays in flight until it is completed or times out
+    EXPECT_FALSE(scheduler.requeue(1));
+    EXPECT_TRUE(scheduler.complete(1));
+    scheduler.dispatch(now + scheduler.getRetryDelay());
+    EXPECT_EQ((std::vector<uint8_t>{1, 1, 2}), sent);
+}
+
+TEST(PropertyRequestSchedulerTest, CallsSenderAndFailureHandlerUnlocked) {
+    PropertyRequestScheduler* self = nullptr;
+    // another thread can use the scheduler while the callbacks run
+    auto unlocked = [&self] {
+        auto other = std::async(std::launch::async, [&self] { return self->getInFlightCount(); });
+        return other.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+    };
+    std::vector<bool> sent_unlocked;
+    std::vector<bool> failed_unlocked;
+    PropertyRequestScheduler scheduler([&](const PropertyMessage&) { sent_unlocked.push_back(unlocked()); }, 1);
+    self = &scheduler;
+    scheduler.setFailureHandler([&](const PropertyMessage&) { failed_unlocked.push_back(unlocked()); });
+    scheduler.setMaxRetries(0);
+
+    auto t = PropertyRequestScheduler::Clock::now();
+    scheduler.enqueue(makeGet(1, "DeviceInfo"), t);
+    scheduler.dispatch(t + scheduler.getTimeout());
+    EXPECT_EQ(std::vector<bool>{true}, sent_unlocked);
+    EXPECT_EQ(std::vector<bool>{true}, failed_unlocked);
+}
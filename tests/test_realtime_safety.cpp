@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <umppi/umppi.hpp>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+using namespace umppi;
+
+// Allocation tracking for the realtime-safe API subset. The global allocation functions are replaced
+// for the whole test executable, but allocations are only counted on a thread inside an AllocationGuard.
+namespace {
+
+thread_local bool trackingAllocations = false;
+thread_local size_t trackedAllocations = 0;
+
+void* trackedAllocate(std::size_t size) {
+    if (trackingAllocations)
+        trackedAllocations++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+class AllocationGuard {
+public:
+    AllocationGuard() {
+        trackedAllocations = 0;
+        trackingAllocations = true;
+    }
+    ~AllocationGuard() { trackingAllocations = false; }
+
+    size_t getAllocationCount() const { return trackedAllocations; }
+};
+
+std::vector<uint32_t> createChannelVoiceWords() {
+    std::vector<uint32_t> words;
+    for (uint8_t i = 0; i < 16; i++) {
+        words.push_back(UmpFactory::midi1NoteOn(0, i, 60 + i, 100));
+        Ump(UmpFactory::midi2NoteOn(0, i, 60 + i, 0, 0x8000, 0)).toWords(words, words.size());
+        Ump(UmpFactory::midi2CC(0, i, 7, 0x12345678)).toWords(words, words.size());
+    }
+    return words;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (void* p = trackedAllocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* p = trackedAllocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+TEST(RealtimeSafetyTest, testGuardDetectsAllocation) {
+    AllocationGuard guard;
+    std::vector<int> values;
+    values.push_back(1);
+    EXPECT_GT(guard.getAllocationCount(), 0u);
+}
+
+TEST(RealtimeSafetyTest, testParseIntoSpan) {
+    auto words = createChannelVoiceWords();
+    auto expected = Ump::fromWords(words);
+    std::vector<uint8_t> bytes;
+    for (const auto& ump : expected)
+        ump.toBytes(bytes, bytes.size());
+
+    std::array<Ump, 64> fromWords;
+    std::array<Ump, 20> fromBytes;
+    size_t wordCount, wordsConsumed, byteCount, bytesConsumed, visited = 0, visitedWords;
+    {
+        AllocationGuard guard;
+        wordCount = Ump::fromWords(words, fromWords, &wordsConsumed);
+        // fills the destination, leaving the rest to the next call
+        byteCount = Ump::fromBytes(bytes, fromBytes, &bytesConsumed);
+        visitedWords = forEachUmp(words, [&](const Ump&) { visited++; });
+        EXPECT_EQ(0u, guard.getAllocationCount());
+    }
+
+    ASSERT_EQ(expected.size(), wordCount);
+    EXPECT_EQ(words.size(), wordsConsumed);
+    EXPECT_EQ(words.size(), visitedWords);
+    EXPECT_EQ(expected.size(), visited);
+    for (size_t i = 0; i < wordCount; i++)
+        EXPECT_EQ(expected[i], fromWords[i]);
+    ASSERT_EQ(fromBytes.size(), byteCount);
+    for (size_t i = 0; i < byteCount; i++)
+        EXPECT_EQ(expected[i], fromBytes[i]);
+    size_t rest = Ump::fromBytes(std::span<const uint8_t>(bytes).subspan(bytesConsumed), fromWords);
+    EXPECT_EQ(expected.size() - byteCount, rest);
+
+    // a truncated packet is left unconsumed
+    std::vector<uint32_t> truncated{UmpFactory::midi1NoteOn(0, 0, 60, 100), 0x40903C00};
+    EXPECT_EQ(1u, Ump::fromWords(truncated, fromWords, &wordsConsumed));
+    EXPECT_EQ(1u, wordsConsumed);
+}
+
+TEST(RealtimeSafetyTest, testChannelVoiceBuildersAndTranslation) {
+    std::array<Ump, 4> midi1;
+    std::array<uint8_t, 64> bytes;
+    size_t written = 0;
+    UmpToMidi1BytesTranslator translator(UmpToMidi1BytesTranslatorContext(480, false, true));
+    size_t rpnCount, bytesResult;
+    Ump midi2;
+    {
+        AllocationGuard guard;
+        Ump noteOn(UmpFactory::midi1NoteOn(0, 1, 60, 100));
+        Ump pitchBend(UmpFactory::midi2PitchBendDirect(0, 1, 0x80000000));
+        Ump rpn(UmpFactory::midi2RPN(0, 1, 0, 0, 0x10000000));
+        midi2 = UmpTranslator::translateMidi1UmpToMidi2Ump(noteOn);
+        rpnCount = UmpTranslator::translateMidi2UmpToMidi1Ump(rpn, midi1);
+        std::array<Ump, 2> packets{midi2, pitchBend};
+        bytesResult = static_cast<size_t>(translator.translate(bytes.data(), bytes.size(), packets, written));
+        EXPECT_EQ(0u, guard.getAllocationCount());
+    }
+
+    EXPECT_EQ(Ump(UmpFactory::midi2NoteOn(0, 1, 60, 0, 100 << 9, 0)), midi2);
+    EXPECT_EQ(4u, rpnCount);
+    EXPECT_EQ(Ump(UmpFactory::midi1CC(0, 1, MidiCC::RPN_MSB, 0)), midi1[0]);
+    EXPECT_EQ(static_cast<size_t>(UmpTranslationResult::OK), bytesResult);
+    EXPECT_EQ(6u, written);
+}
+
+TEST(RealtimeSafetyTest, testMachines) {
+    auto midi1Machine = std::make_unique<Midi1Machine>();
+    auto midi2Machine = std::make_unique<Midi2Machine>();
+    int midi1Messages = 0;
+    int midi2Messages = 0;
+    midi1Machine->messageListeners.emplace_back([&](const Midi1Message&) { midi1Messages++; });
+    midi2Machine->messageListeners.emplace_back([&](const Ump&) { midi2Messages++; });
+    auto words = createChannelVoiceWords();
+
+    {
+        AllocationGuard guard;
+        forEachUmp(words, [&](const Ump& ump) {
+            midi1Machine->processMessage(ump);
+            midi2Machine->processMessage(ump);
+        });
+        EXPECT_EQ(0u, guard.getAllocationCount());
+    }
+
+    EXPECT_EQ(16, midi1Messages);
+    EXPECT_EQ(32, midi2Messages);
+    EXPECT_TRUE(midi1Machine->channels[3].noteOnStatus[63]);
+    EXPECT_EQ(100, midi1Machine->channels[3].noteVelocity[63]);
+    EXPECT_TRUE(midi2Machine->channels[5].noteOnStatus[65]);
+    EXPECT_EQ(0x8000, midi2Machine->channels[5].noteVelocity[65]);
+    EXPECT_EQ(0x12345678u, midi2Machine->channels[5].controls[7]);
+}
+
+TEST(RealtimeSafetyTest, testTransformPipeline) {
+    UmpTransformPipeline pipeline;
+    pipeline.transpose(12).applyVelocityCurve(VelocityCurve::gamma(0.5)).remapChannel(0, 9);
+    auto words = createChannelVoiceWords();
+    size_t count;
+    {
+        AllocationGuard guard;
+        count = pipeline.process(std::span<uint32_t>(words));
+        EXPECT_EQ(0u, guard.getAllocationCount());
+    }
+    EXPECT_EQ(words.size(), count);
+    EXPECT_EQ(MidiChannelStatus::NOTE_ON | 9, Ump(words[0]).getStatusByte());
+    EXPECT_EQ(72, Ump(words[0]).getMidi1Note());
+}
+
+TEST(RealtimeSafetyTest, testMidi2MachineState) {
+    auto machine = std::make_unique<Midi2Machine>(2);
+    machine->processMessage(Ump(UmpFactory::midi2NoteOn(0, 0, 60, 0, 0x8000, 0)));
+    EXPECT_FALSE(machine->channels[0].noteOnStatus[60]);
+
+    machine->processMessage(Ump(UmpFactory::midi2NoteOn(2, 0, 60, 3, 0x8000, 0x1234)));
+    EXPECT_TRUE(machine->channels[0].noteOnStatus[60]);
+    EXPECT_EQ(3, machine->channels[0].noteAttributeType[60]);
+    EXPECT_EQ(0x1234, machine->channels[0].noteAttributeData[60]);
+    machine->processMessage(Ump(UmpFactory::midi2NoteOff(2, 0, 60, 0, 0x100, 0)));
+    EXPECT_FALSE(machine->channels[0].noteOnStatus[60]);
+
+    machine->processMessage(Ump(UmpFactory::midi2RPN(2, 1, 0, 2, 100)));
+    machine->processMessage(Ump(UmpFactory::midi2RelativeRPN(2, 1, 0, 2, static_cast<uint32_t>(-30))));
+    EXPECT_EQ(70u, machine->channels[1].rpns[2]);
+    machine->processMessage(Ump(UmpFactory::midi2Program(2, 1, MidiProgramChangeOptions::BANK_VALID, 5, 1, 2)));
+    EXPECT_EQ(5, machine->channels[1].program);
+    EXPECT_EQ(1, machine->channels[1].bankMsb);
+    EXPECT_EQ(2, machine->channels[1].bankLsb);
+}
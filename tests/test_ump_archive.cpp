@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <umppi/umppi.hpp>
+#include <filesystem>
+
+using namespace umppi;
+
+namespace {
+
+std::string tempArchivePath(const char* name) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+} // namespace
+
+TEST(UmpArchiveTest, testWriteAndReadRange) {
+    auto path = tempArchivePath("umppi_test_archive.umpa");
+    UmpArchiveWriter::Options options;
+    options.packetsPerBlock = 100;
+    {
+        UmpArchiveWriter writer(path, options);
+        for (uint32_t i = 0; i < 1000; i++) {
+            std::vector<uint32_t> words;
+            Ump(static_cast<uint64_t>(UmpFactory::midi2CC(0, 0, 7, i))).toWords(words, 0);
+            writer.write(words, 1'000'000ULL * i);
+        }
+        EXPECT_THROW(writer.write(std::vector<uint32_t>{UmpFactory::midi1NoteOn(0, 0, 60, 1)}, 0), std::invalid_argument);
+        writer.close();
+        EXPECT_EQ(10, writer.getBlockCount());
+    }
+
+    UmpArchiveReader reader(path);
+    EXPECT_EQ(10, reader.getBlocks().size());
+    EXPECT_EQ(1000, reader.getPacketCount());
+    EXPECT_EQ(3, reader.findBlock(350'000'000));
+
+    auto entries = reader.read(250'000'000, 750'000'000, 4);
+    ASSERT_EQ(500, entries.size());
+    EXPECT_EQ(250'000'000, entries.front().timestamp);
+    EXPECT_EQ(2, entries.front().sizeInInts);
+    EXPECT_EQ(250, entries.front().words[1]);
+    EXPECT_EQ(749, entries.back().words[1]);
+
+    // in-memory (e.g. memory-mapped) archive
+    auto bytes = readFile(path);
+    UmpArchiveReader memoryReader(bytes);
+    EXPECT_EQ(1000, memoryReader.read(0, UINT64_MAX, 2).size());
+    std::filesystem::remove(path);
+}
+
+TEST(UmpArchiveTest, testAppendAndRecovery) {
+    auto path = tempArchivePath("umppi_test_archive_append.umpa");
+    uint32_t noteOn = UmpFactory::midi1NoteOn(0, 0, 60, 100);
+    {
+        UmpArchiveWriter writer(path);
+        writer.write({&noteOn, 1}, 10);
+    }
+    {
+        UmpArchiveWriter writer(path);
+        EXPECT_EQ(1, writer.getPacketCount());
+        auto sysex = UmpFactory::sysex7(1, {1, 2, 3, 4, 5, 6, 7, 8});
+        std::vector<uint32_t> words;
+        for (auto& ump : sysex)
+            ump.toWords(words, words.size());
+        writer.write(words, 20);
+        writer.flush();
+    }
+    UmpArchiveReader reader(path);
+    auto entries = reader.read(0, UINT64_MAX);
+    ASSERT_EQ(3, entries.size());
+    EXPECT_EQ(noteOn, entries[0].words[0]);
+    EXPECT_EQ(20, entries[2].timestamp);
+
+    // drop the index, as if the recorder crashed: the blocks are still found
+    auto bytes = readFile(path);
+    bytes.resize(reader.getBlocks().size() == 2 ? bytes.size() - 2 * 28 - 16 : 0);
+    UmpArchiveReader recovered(bytes);
+    EXPECT_EQ(3, recovered.getPacketCount());
+    std::filesystem::remove(path);
+}
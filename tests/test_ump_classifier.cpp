@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <umppi/umppi.hpp>
+
+using namespace umppi;
+
+namespace {
+
+std::vector<uint32_t> toWords(const std::vector<Ump>& umps) {
+    std::vector<uint32_t> words;
+    for (const auto& ump : umps)
+        ump.toWords(words, words.size());
+    return words;
+}
+
+std::vector<uint32_t> createWords() {
+    std::vector<Ump> umps;
+    umps.emplace_back(UmpFactory::midi1NoteOn(0, 1, 60, 100));                              // 0
+    umps.emplace_back(static_cast<uint64_t>(UmpFactory::midi2NoteOn(0, 2, 60, 0, 0x8000, 0))); // 1
+    auto sysex = UmpFactory::sysex7(0, {1, 2, 3, 4, 5, 6, 7, 8});                           // 2, 3
+    umps.insert(umps.end(), sysex.begin(), sysex.end());
+    umps.emplace_back(static_cast<uint64_t>(UmpFactory::midi2CC(1, 2, 7, 0x10000000)));     // 4
+    umps.emplace_back(UmpFactory::noop());                                                   // 5
+    umps.emplace_back(static_cast<uint64_t>(UmpFactory::midi2NoteOff(1, 2, 60, 0, 0, 0)));   // 6
+    auto sysex2 = UmpFactory::sysex7(1, {1, 2});                                             // 7
+    umps.insert(umps.end(), sysex2.begin(), sysex2.end());
+    return toWords(umps);
+}
+
+}
+
+TEST(UmpClassifierTest, testScan) {
+    auto words = createWords();
+    UmpClassifier classifier;
+    EXPECT_TRUE(classifier.scan(words));
+    ASSERT_EQ(8, classifier.getPacketCount());
+    std::vector<uint32_t> expectedOffsets = {0, 1, 3, 5, 7, 9, 10, 12};
+    EXPECT_EQ(expectedOffsets, std::vector<uint32_t>(classifier.getPacketOffsets().begin(), classifier.getPacketOffsets().end()));
+    EXPECT_EQ(Ump(static_cast<uint64_t>(UmpFactory::midi2CC(1, 2, 7, 0x10000000))), classifier.getUmp(4));
+    EXPECT_EQ(2, classifier.getPacket(4).size());
+
+    auto counts = classifier.countByMessageType();
+    EXPECT_EQ(1, counts[static_cast<int>(MessageType::UTILITY)]);
+    EXPECT_EQ(1, counts[static_cast<int>(MessageType::MIDI1)]);
+    EXPECT_EQ(3, counts[static_cast<int>(MessageType::MIDI2)]);
+    EXPECT_EQ(3, counts[static_cast<int>(MessageType::SYSEX7)]);
+
+    // truncated packet at the end is reported and excluded
+    words.pop_back();
+    EXPECT_FALSE(classifier.scan(words));
+    EXPECT_EQ(7, classifier.getPacketCount());
+    EXPECT_EQ(1, classifier.getTruncatedWordCount());
+}
+
+TEST(UmpClassifierTest, testSelect) {
+    auto words = createWords();
+    UmpClassifier classifier;
+    classifier.scan(words);
+
+    std::vector<uint32_t> indices;
+    EXPECT_EQ(2, classifier.select(UmpFilter::ofMessageType(MessageType::SYSEX7).withGroup(0), indices));
+    EXPECT_EQ((std::vector<uint32_t>{2, 3}), indices);
+
+    indices.clear();
+    auto notes = UmpFilter::ofMessageType(MessageType::MIDI2)
+        .withStatuses({MidiChannelStatus::NOTE_ON, MidiChannelStatus::NOTE_OFF});
+    EXPECT_EQ(2, classifier.select(notes, indices));
+    EXPECT_EQ((std::vector<uint32_t>{1, 6}), indices);
+
+    indices.clear();
+    EXPECT_EQ(3, classifier.select(UmpFilter::all().withGroup(1), indices));
+    EXPECT_EQ((std::vector<uint32_t>{4, 6, 7}), indices);
+
+    // channel applies only to channel voice messages
+    indices.clear();
+    EXPECT_EQ(4, classifier.select(UmpFilter::all().withGroup(0).withChannel(1), indices));
+    EXPECT_EQ((std::vector<uint32_t>{0, 2, 3, 5}), indices);
+
+    std::vector<uint64_t> mask;
+    EXPECT_EQ(3, classifier.selectMask(UmpFilter::ofMessageType(MessageType::MIDI2), mask));
+    ASSERT_EQ(1, mask.size());
+    EXPECT_EQ(0b1010010u, mask[0]);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <umppi/umppi.hpp>
+
+using namespace umppi;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<uint32_t> toWords(uint64_t packet) {
+    return {static_cast<uint32_t>(packet >> 32), static_cast<uint32_t>(packet)};
+}
+
+} // namespace
+
+TEST(UmpCoalescerTest, testLastValueWins) {
+    std::vector<Ump> sent;
+    UmpCoalescer coalescer([&sent](UmpWordSpan packet) { sent.push_back(Ump::fromWords(packet)[0]); }, 10ms);
+    auto t0 = UmpCoalescer::Clock::time_point{} + 1s;
+
+    // the first change after an idle period goes out immediately
+    coalescer.send(toWords(UmpFactory::midi2CC(0, 0, 7, 100)), t0);
+    ASSERT_EQ(1, sent.size());
+
+    for (uint32_t v = 1; v <= 5; v++)
+        coalescer.send(toWords(UmpFactory::midi2CC(0, 0, 7, v * 1000)), t0 + 1ms);
+    coalescer.send(toWords(UmpFactory::midi2CC(0, 1, 7, 42)), t0 + 2ms);
+    coalescer.send(toWords(UmpFactory::midi2PerNoteACC(0, 0, 60, 3, 1)), t0 + 2ms);
+    coalescer.send(toWords(UmpFactory::midi2PerNoteACC(0, 0, 60, 3, 2)), t0 + 2ms);
+    coalescer.send(toWords(UmpFactory::midi2PerNoteACC(0, 0, 61, 3, 3)), t0 + 2ms);
+    EXPECT_EQ(1, sent.size());
+    EXPECT_EQ(4, coalescer.getPendingCount());
+    EXPECT_EQ(5, coalescer.getCoalescedCount());
+
+    EXPECT_FALSE(coalescer.flushIfDue(t0 + 5ms));
+    EXPECT_TRUE(coalescer.flushIfDue(t0 + 10ms));
+    ASSERT_EQ(5, sent.size());
+    EXPECT_EQ(5000, sent[1].getMidi2CcData());
+    EXPECT_EQ(1, sent[2].getChannelInGroup());
+    EXPECT_EQ(60, sent[3].getMidi2Note());
+    EXPECT_EQ(2, sent[3].int2);
+    EXPECT_EQ(61, sent[4].getMidi2Note());
+    EXPECT_EQ(0, coalescer.getPendingCount());
+}
+
+TEST(UmpCoalescerTest, testNotesAreBarriers) {
+    std::vector<Ump> sent;
+    UmpCoalescer coalescer([&sent](UmpWordSpan packet) { sent.push_back(Ump::fromWords(packet)[0]); }, 10ms);
+    auto t0 = UmpCoalescer::Clock::time_point{} + 1s;
+
+    coalescer.send(toWords(UmpFactory::midi2PitchBendDirect(0, 0, 1)), t0);
+    coalescer.send(toWords(UmpFactory::midi2PitchBendDirect(0, 0, 2)), t0 + 1ms);
+    coalescer.send(toWords(UmpFactory::midi2NoteOn(0, 0, 60, 0, 0x8000, 0)), t0 + 1ms);
+    coalescer.send(toWords(UmpFactory::midi2PitchBendDirect(0, 0, 3)), t0 + 2ms);
+
+    // the held pitch bend goes out before the note, the one after it is still pending
+    ASSERT_EQ(3, sent.size());
+    EXPECT_EQ(2, sent[1].getMidi2PitchBendData());
+    EXPECT_EQ(MidiChannelStatus::NOTE_ON, sent[2].getStatusCode());
+    EXPECT_EQ(1, coalescer.getPendingCount());
+
+    coalescer.flush();
+    ASSERT_EQ(4, sent.size());
+    EXPECT_EQ(3, sent[3].getMidi2PitchBendData());
+}
+
+TEST(UmpCoalescerTest, testOrderSensitiveMessagesAreNotCoalesced) {
+    uint32_t key;
+    auto bank = toWords(UmpFactory::midi2CC(0, 0, MidiCC::BANK_SELECT, 1));
+    EXPECT_FALSE(UmpCoalescer::getCoalescingKey(bank, key));
+    uint32_t dte = UmpFactory::midi1CC(0, 0, MidiCC::DTE_MSB, 1);
+    EXPECT_FALSE(UmpCoalescer::getCoalescingKey({&dte, 1}, key));
+    uint32_t allNotesOff = UmpFactory::midi1CC(0, 0, MidiCC::ALL_NOTES_OFF, 0);
+    EXPECT_FALSE(UmpCoalescer::getCoalescingKey({&allNotesOff, 1}, key));
+    auto program = toWords(UmpFactory::midi2Program(0, 0, 0, 1, 0, 0));
+    EXPECT_FALSE(UmpCoalescer::getCoalescingKey(program, key));
+
+    uint32_t a = UmpFactory::midi1CC(0, 0, 74, 1);
+    uint32_t b = UmpFactory::midi1CC(0, 0, 74, 127);
+    uint32_t ka, kb;
+    ASSERT_TRUE(UmpCoalescer::getCoalescingKey({&a, 1}, ka));
+    ASSERT_TRUE(UmpCoalescer::getCoalescingKey({&b, 1}, kb));
+    EXPECT_EQ(ka, kb);
+
+    // zero interval passes everything through
+    int count = 0;
+    UmpCoalescer passThrough([&count](UmpWordSpan) { count++; }, 0us);
+    passThrough.send({&a, 1});
+    passThrough.send({&b, 1});
+    EXPECT_EQ(2, count);
+    EXPECT_EQ(0, passThrough.getPendingCount());
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <umppi/umppi.hpp>
+#include <thread>
+
+using namespace umppi;
+
+TEST(UmpDemuxTest, testRouteByGroupAndChannel) {
+    UmpDemux demux;
+    std::vector<Ump> part1, part2, sysex;
+    auto collect = [](std::vector<Ump>& dst) {
+        return [&dst](UmpWordSpan packet, uint64_t) { dst.push_back(Ump::fromWords(packet)[0]); };
+    };
+    demux.addRoute(UmpFilter::all().withGroup(0).withChannel(1), collect(part1));
+    auto id2 = demux.addRoute(UmpFilter::ofMessageType(MessageType::MIDI2).withGroup(1).withChannel(2), collect(part2));
+    demux.addRoute(UmpFilter::ofMessageType(MessageType::SYSEX7), collect(sysex));
+
+    std::vector<uint32_t> words;
+    Ump(UmpFactory::midi1NoteOn(0, 1, 60, 100)).toWords(words, words.size());
+    Ump(static_cast<uint64_t>(UmpFactory::midi2NoteOn(1, 2, 60, 0, 0x8000, 0))).toWords(words, words.size());
+    Ump(static_cast<uint64_t>(UmpFactory::midi2NoteOn(1, 3, 60, 0, 0x8000, 0))).toWords(words, words.size());
+    for (auto& ump : UmpFactory::sysex7(1, {1, 2, 3, 4, 5, 6, 7, 8}))
+        ump.toWords(words, words.size());
+
+    // channel 3 note is not routed anywhere
+    EXPECT_EQ(1, demux.process(words, 100));
+    ASSERT_EQ(1, part1.size());
+    EXPECT_EQ(MessageType::MIDI1, part1[0].getMessageType());
+    ASSERT_EQ(1, part2.size());
+    EXPECT_EQ(2, part2[0].getChannelInGroup());
+    EXPECT_EQ(2, sysex.size());
+
+    demux.removeRoute(id2);
+    part1.clear();
+    part2.clear();
+    sysex.clear();
+    EXPECT_EQ(2, demux.process(words, 100));
+    EXPECT_TRUE(part2.empty());
+
+    // truncated packet is dropped
+    words.pop_back();
+    demux.process(words, 100);
+    EXPECT_EQ(1, demux.getTruncatedPacketCount());
+}
+
+TEST(UmpDemuxTest, testRouteByStatus) {
+    UmpDemux demux;
+    std::vector<Ump> notes, all;
+    demux.addRoute(UmpFilter::ofMessageType(MessageType::MIDI2).withStatuses({MidiChannelStatus::NOTE_ON, MidiChannelStatus::NOTE_OFF}),
+                   [&notes](UmpWordSpan packet, uint64_t) { notes.push_back(Ump::fromWords(packet)[0]); });
+    demux.addRoute(UmpFilter::all(), [&all](UmpWordSpan packet, uint64_t) { all.push_back(Ump::fromWords(packet)[0]); });
+
+    std::vector<uint32_t> words;
+    Ump(static_cast<uint64_t>(UmpFactory::midi2NoteOn(0, 0, 60, 0, 0x8000, 0))).toWords(words, words.size());
+    Ump(static_cast<uint64_t>(UmpFactory::midi2CC(0, 0, 1, 5))).toWords(words, words.size());
+    Ump(static_cast<uint64_t>(UmpFactory::midi2NoteOff(0, 0, 60, 0, 0, 0))).toWords(words, words.size());
+
+    EXPECT_EQ(0, demux.process(words));
+    ASSERT_EQ(2, notes.size());
+    EXPECT_EQ(MidiChannelStatus::NOTE_ON, notes[0].getStatusCode());
+    EXPECT_EQ(MidiChannelStatus::NOTE_OFF, notes[1].getStatusCode());
+    EXPECT_EQ(3, all.size());
+}
+
+TEST(UmpDemuxTest, testQueueRoute) {
+    UmpDemux demux;
+    auto id = demux.addQueueRoute(UmpFilter::ofMessageType(MessageType::MIDI2), 4);
+    auto queue = demux.getQueue(id);
+    ASSERT_NE(nullptr, queue);
+    EXPECT_EQ(4, queue->capacity());
+
+    std::vector<uint32_t> words;
+    for (int i = 0; i < 1000; i++)
+        Ump(static_cast<uint64_t>(UmpFactory::midi2CC(0, 0, 1, static_cast<uint32_t>(i)))).toWords(words, words.size());
+
+    std::vector<uint32_t> received;
+    std::thread consumer([&] {
+        UmpQueueEntry entry;
+        while (received.size() < 1000) {
+            if (queue->pop(entry)) {
+                EXPECT_EQ(2, entry.getWords().size());
+                EXPECT_EQ(42, entry.timestamp);
+                received.push_back(entry.words[1]);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (size_t i = 0; i < words.size(); i += 2) {
+        while (queue->size() == queue->capacity())
+            std::this_thread::yield();
+        demux.process(UmpWordSpan{words.data() + i, 2}, 42);
+    }
+    consumer.join();
+
+    EXPECT_EQ(0, queue->getDroppedCount());
+    for (uint32_t i = 0; i < received.size(); i++)
+        EXPECT_EQ(i, received[i]);
+}
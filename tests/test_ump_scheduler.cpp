@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <umppi/umppi.hpp>
+#include <mutex>
+#include <thread>
+
+using namespace umppi;
+
+namespace {
+
+struct SentPacket {
+    std::vector<uint32_t> words;
+    uint64_t timestamp;
+    uint64_t sentAt;
+};
+
+} // namespace
+
+TEST(UmpSchedulerTest, testReleaseInTimestampOrder) {
+    std::mutex mutex;
+    std::vector<SentPacket> sent;
+    UmpScheduler scheduler([&](UmpWordSpan words, uint64_t timestamp) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sent.push_back({{words.begin(), words.end()}, timestamp, UmpScheduler::now()});
+    });
+
+    uint64_t base = UmpScheduler::now() + 20'000'000;
+    uint32_t late = UmpFactory::midi1NoteOff(0, 0, 60, 0);
+    uint32_t early = UmpFactory::midi1NoteOn(0, 0, 60, 100);
+    auto sameTime = UmpFactory::sysex7(0, {1, 2, 3, 4, 5, 6, 7, 8});
+    std::vector<uint32_t> sameTimeWords;
+    for (auto& ump : sameTime)
+        ump.toWords(sameTimeWords, sameTimeWords.size());
+
+    EXPECT_TRUE(scheduler.schedule({&late, 1}, base + 10'000'000));
+    EXPECT_TRUE(scheduler.schedule({&early, 1}, base));
+    EXPECT_TRUE(scheduler.schedule(sameTimeWords, base + 5'000'000));
+    EXPECT_EQ(4, scheduler.getPendingCount());
+
+    scheduler.flush();
+    ASSERT_EQ(4, sent.size());
+    EXPECT_EQ(early, sent[0].words[0]);
+    // packets of one call keep their order
+    EXPECT_EQ(2, sent[1].words.size());
+    EXPECT_EQ(sameTimeWords[0], sent[1].words[0]);
+    EXPECT_EQ(sameTimeWords[2], sent[2].words[0]);
+    EXPECT_EQ(late, sent[3].words[0]);
+    for (auto& p : sent)
+        EXPECT_GE(p.sentAt, p.timestamp);
+    EXPECT_EQ(0, scheduler.getPendingCount());
+    EXPECT_EQ(4, scheduler.getSentCount());
+}
+
+TEST(UmpSchedulerTest, testJrTimestampInsertion) {
+    std::vector<std::vector<uint32_t>> sent;
+    UmpScheduler::Options options;
+    options.insertJrTimestamps = true;
+    UmpScheduler scheduler([&](UmpWordSpan words, uint64_t) { sent.emplace_back(words.begin(), words.end()); }, options);
+
+    uint32_t noteOn = UmpFactory::midi1NoteOn(0, 0, 60, 100);
+    // 64000ns = 2 ticks of 1/31250s
+    scheduler.schedule({&noteOn, 1}, 64000);
+    scheduler.flush();
+    ASSERT_EQ(1, sent.size());
+    ASSERT_EQ(2, sent[0].size());
+    EXPECT_EQ(UmpFactory::jrTimestamp(static_cast<uint16_t>(2)), sent[0][0]);
+    EXPECT_EQ(noteOn, sent[0][1]);
+}
+
+TEST(UmpSchedulerTest, testConcurrentProducers) {
+    std::atomic<int> count{0};
+    UmpScheduler scheduler([&](UmpWordSpan, uint64_t) { count++; });
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; t++) {
+        producers.emplace_back([&scheduler] {
+            for (int i = 0; i < 500; i++) {
+                uint32_t word = UmpFactory::midi1CC(0, 0, 7, static_cast<uint8_t>(i & 0x7F));
+                while (!scheduler.schedule({&word, 1}, 0))
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& p : producers)
+        p.join();
+    scheduler.flush();
+    EXPECT_EQ(2000, count.load());
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <umppi/umppi.hpp>
+
+using namespace umppi;
+
+TEST(UmpTransformTest, testTransposeAndRemap) {
+    UmpTransformPipeline pipeline;
+    pipeline.transpose(12).remapGroup(0, 3).remapChannel(9, 2);
+
+    std::vector<uint32_t> words;
+    words.push_back(UmpFactory::midi1NoteOn(0, 9, 60, 100));
+    Ump(static_cast<uint64_t>(UmpFactory::midi2NoteOn(0, 1, 120, 0, 0x8000, 0))).toWords(words, words.size());
+    Ump(static_cast<uint64_t>(UmpFactory::midi2CC(1, 9, 7, 0x12345678))).toWords(words, words.size());
+    words.push_back(UmpFactory::jrTimestamp(static_cast<uint16_t>(5)));
+
+    pipeline.process(words);
+    // the MIDI2 note (120 + 12) is out of range and dropped
+    ASSERT_EQ(4, words.size());
+    auto umps = Ump::fromWords(words);
+    ASSERT_EQ(3, umps.size());
+    EXPECT_EQ(UmpFactory::midi1NoteOn(3, 2, 72, 100), umps[0].int1);
+    EXPECT_EQ(1, umps[1].getGroup());
+    EXPECT_EQ(2, umps[1].getChannelInGroup());
+    EXPECT_EQ(0x12345678u, umps[1].getMidi2CcData());
+    // groupless utility message is untouched
+    EXPECT_EQ(UmpFactory::jrTimestamp(static_cast<uint16_t>(5)), umps[2].int1);
+}
+
+TEST(UmpTransformTest, testVelocityCurveAndFilter) {
+    UmpTransformPipeline pipeline;
+    pipeline.applyVelocityCurve(VelocityCurve::fixed(1.0), UmpFilter::all().withChannel(0));
+
+    Ump midi2(static_cast<uint64_t>(UmpFactory::midi2NoteOn(0, 0, 60, 0, 0x1000, 0x55)));
+    Ump otherChannel(static_cast<uint64_t>(UmpFactory::midi2NoteOn(0, 1, 60, 0, 0x1000, 0)));
+    Ump midi1(UmpFactory::midi1NoteOn(0, 0, 60, 10));
+    Ump midi1Off(UmpFactory::midi1NoteOn(0, 0, 60, 0));
+    std::vector<Ump> messages{midi2, otherChannel, midi1, midi1Off};
+    pipeline.process(messages);
+    ASSERT_EQ(4, messages.size());
+    EXPECT_EQ(0xFFFF, messages[0].getMidi2Velocity16());
+    EXPECT_EQ(0x55, messages[0].int2 & 0xFFFF);
+    EXPECT_EQ(0x1000, messages[1].getMidi2Velocity16());
+    EXPECT_EQ(127, messages[2].getMidi1Lsb());
+    // Note On with velocity 0 is a Note Off and is kept as is
+    EXPECT_EQ(0, messages[3].getMidi1Lsb());
+
+    auto soft = VelocityCurve::gamma(2.0);
+    EXPECT_EQ(0x4000, soft.apply16(0x8000) & 0xFF00);
+    EXPECT_EQ(1, soft.apply7(1));
+    EXPECT_EQ(127, soft.apply7(127));
+}
+
+TEST(UmpTransformTest, testScaleControlChange) {
+    UmpTransformPipeline pipeline;
+    pipeline.scaleControlChange(7, 1.0, 0.0);
+
+    std::vector<uint32_t> words{UmpFactory::midi1CC(0, 0, 7, 127), UmpFactory::midi1CC(0, 0, 8, 127)};
+    Ump(static_cast<uint64_t>(UmpFactory::midi2CC(0, 0, 7, 0))).toWords(words, words.size());
+    pipeline.process(words);
+    ASSERT_EQ(4, words.size());
+    EXPECT_EQ(0, words[0] & 0x7F);
+    EXPECT_EQ(127, words[1] & 0x7F);
+    EXPECT_EQ(0xFFFFFFFFu, words[3]);
+}
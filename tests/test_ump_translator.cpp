@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <midicci/midicci.hpp>
+#include <umppi/umppi.hpp>
 
 using namespace midicci;
 using namespace umppi;
@@ -517,3 +518,156 @@ TEST_F(UmpTranslatorTest, testRoundtripPreservesNonMidi1Messages) {
     EXPECT_EQ(umppi::MessageType::MIDI1, roundtripMidi1Umps[1].getMessageType());
     EXPECT_EQ(midi1Umps[2].int1, roundtripMidi1Umps[2].int1);
 }
+
+TEST_F(UmpTranslatorTest, testMidi1StreamElidesRpnSelection) {
+    UmpToMidi1Stream stream;
+    std::vector<uint8_t> dst;
+
+    stream.process(dst, Ump(static_cast<uint64_t>(UmpFactory::midi2RPN(0, 1, 2, 3, 517 * 0x40000))));
+    std::vector<uint8_t> expected = {0xB1, 101, 2, 100, 3, 6, 4, 38, 5};
+    EXPECT_EQ(expected, dst);
+
+    // same parameter again: only data entry, status byte omitted
+    dst.clear();
+    stream.process(dst, Ump(static_cast<uint64_t>(UmpFactory::midi2RPN(0, 1, 2, 3, 518 * 0x40000))));
+    expected = {6, 4, 38, 6};
+    EXPECT_EQ(expected, dst);
+
+    // only LSB changed
+    dst.clear();
+    stream.process(dst, Ump(static_cast<uint64_t>(UmpFactory::midi2RPN(0, 1, 2, 4, 0))));
+    expected = {100, 4, 6, 0, 38, 0};
+    EXPECT_EQ(expected, dst);
+
+    // switching to NRPN sends the full selection
+    dst.clear();
+    stream.process(dst, Ump(static_cast<uint64_t>(UmpFactory::midi2NRPN(0, 1, 2, 4, 0))));
+    expected = {99, 2, 98, 4, 6, 0, 38, 0};
+    EXPECT_EQ(expected, dst);
+
+    // the selection is tracked per channel
+    dst.clear();
+    stream.process(dst, Ump(static_cast<uint64_t>(UmpFactory::midi2NRPN(0, 2, 2, 4, 0))));
+    expected = {0xB2, 99, 2, 98, 4, 6, 0, 38, 0};
+    EXPECT_EQ(expected, dst);
+
+    dst.clear();
+    stream.reset();
+    stream.process(dst, Ump(static_cast<uint64_t>(UmpFactory::midi2NRPN(0, 2, 2, 4, 0))));
+    EXPECT_EQ(expected, dst);
+}
+
+TEST_F(UmpTranslatorTest, testMidi1StreamElidesBankSelection) {
+    UmpToMidi1Stream stream;
+    std::vector<uint8_t> dst;
+
+    stream.process(dst, Ump(static_cast<uint64_t>(UmpFactory::midi2Program(0, 1, MidiProgramChangeOptions::BANK_VALID, 10, 1, 2))));
+    std::vector<uint8_t> expected = {0xB1, 0, 1, 32, 2, 0xC1, 10};
+    EXPECT_EQ(expected, dst);
+
+    dst.clear();
+    stream.process(dst, Ump(static_cast<uint64_t>(UmpFactory::midi2Program(0, 1, MidiProgramChangeOptions::BANK_VALID, 11, 1, 2))));
+    expected = {11};
+    EXPECT_EQ(expected, dst);
+
+    // explicitly sent bank select updates the tracked state
+    dst.clear();
+    stream.process(dst, Ump(UmpFactory::midi1CC(0, 1, MidiCC::BANK_SELECT, 5)));
+    stream.process(dst, Ump(static_cast<uint64_t>(UmpFactory::midi2Program(0, 1, MidiProgramChangeOptions::BANK_VALID, 12, 5, 2))));
+    expected = {0xB1, 0, 5, 0xC1, 12};
+    EXPECT_EQ(expected, dst);
+}
+
+TEST_F(UmpTranslatorTest, testMidi1StreamRunningStatus) {
+    UmpToMidi1Stream stream;
+    std::vector<uint8_t> dst;
+
+    std::vector<Ump> src = {
+        Ump(UmpFactory::midi1NoteOn(0, 0, 60, 100)),
+        Ump(UmpFactory::midi1NoteOn(0, 0, 64, 100)),
+        Ump(UmpFactory::systemMessage(0, MidiSystemStatus::TIMING_CLOCK, 0, 0)),
+        Ump(UmpFactory::midi1NoteOn(0, 0, 67, 100)),
+        Ump(UmpFactory::systemMessage(0, MidiSystemStatus::SONG_SELECT, 3, 0)),
+        Ump(UmpFactory::midi1NoteOn(0, 0, 60, 0)),
+        Ump(UmpFactory::midi1NoteOff(0, 0, 64, 0x40)),
+    };
+    EXPECT_EQ(16, stream.process(dst, src));
+    std::vector<uint8_t> expected = {0x90, 60, 100, 64, 100, 0xF8, 67, 100, 0xF3, 3, 0x90, 60, 0, 0x80, 64, 0x40};
+    EXPECT_EQ(expected, dst);
+
+    dst.clear();
+    stream.reset();
+    stream.noteOffAsNoteOnZeroVelocity = true;
+    stream.process(dst, Ump(UmpFactory::midi1NoteOn(0, 0, 60, 100)));
+    stream.process(dst, Ump(static_cast<uint64_t>(UmpFactory::midi2NoteOff(0, 0, 60, 0, 0xE800, 0))));
+    expected = {0x90, 60, 100, 60, 0};
+    EXPECT_EQ(expected, dst);
+
+    // SysEx cancels running status
+    dst.clear();
+    stream.process(dst, UmpFactory::sysex7(0, {0x7E, 0x7F}));
+    stream.process(dst, Ump(UmpFactory::midi1NoteOn(0, 0, 62, 100)));
+    expected = {0xF0, 0x7E, 0x7F, 0xF7, 0x90, 62, 100};
+    EXPECT_EQ(expected, dst);
+
+    dst.clear();
+    UmpToMidi1Stream plain(false, false);
+    plain.process(dst, Ump(UmpFactory::midi1NoteOn(0, 0, 60, 100)));
+    plain.process(dst, Ump(UmpFactory::midi1NoteOn(0, 0, 64, 100)));
+    expected = {0x90, 60, 100, 0x90, 64, 100};
+    EXPECT_EQ(expected, dst);
+}
+
+TEST_F(UmpTranslatorTest, testConvertUmpToMidi1BytesWithDeltaTime) {
+    std::vector<Ump> src = {
+        Ump(UmpFactory::midi1NoteOn(0, 1, 60, 100)),
+        Ump(UmpFactory::deltaClockstamp(200)),
+        Ump(UmpFactory::midi1NoteOff(0, 1, 60, 0)),
+        Ump(static_cast<uint64_t>(UmpFactory::midi2Program(0, 1, MidiProgramChangeOptions::BANK_VALID, 8, 16, 24))),
+    };
+    std::vector<Ump> sysex = UmpFactory::sysex7(0, {1, 2, 3, 4, 5, 6, 7, 8});
+    src.push_back(Ump(UmpFactory::deltaClockstamp(10)));
+    src.insert(src.end(), sysex.begin(), sysex.end());
+
+    std::vector<uint8_t> dst;
+    EXPECT_EQ(UmpTranslationResult::OK, UmpTranslator::translateUmpToMidi1Bytes(dst, src));
+    std::vector<uint8_t> expected = {
+        0, 0x91, 60, 100,
+        0x81, 0x48, 0x81, 60, 0, // delta time 200 as VLQ
+        0, 0xB1, 0, 16, 0, 0xB1, 32, 24, 0, 0xC1, 8,
+        10, 0xF0, 9, 1, 2, 3, 4, 5, 6, 7, 8, 0xF7
+    };
+    EXPECT_EQ(expected, dst);
+
+    UmpToMidi1BytesTranslator translator;
+    EXPECT_EQ(expected.size(), translator.computeMidi1BytesSize(src));
+
+    std::vector<uint8_t> buffer(expected.size() - 1);
+    size_t written;
+    EXPECT_EQ(UmpTranslationResult::INSUFFICIENT_BUFFER, translator.translate(buffer.data(), buffer.size(), src, written));
+    EXPECT_EQ(0, written);
+    buffer.resize(expected.size());
+    EXPECT_EQ(UmpTranslationResult::OK, translator.translate(buffer.data(), buffer.size(), src, written));
+    EXPECT_EQ(expected.size(), written);
+    EXPECT_EQ(expected, buffer);
+}
+
+TEST_F(UmpTranslatorTest, testConvertUmpToMidi1BytesWithoutDeltaTime) {
+    std::vector<Ump> src = UmpFactory::sysex7(0, {1, 2, 3, 4, 5, 6, 7, 8});
+    src.insert(src.begin(), Ump(UmpFactory::midi1NoteOn(0, 1, 60, 100)));
+
+    UmpToMidi1BytesTranslator translator(UmpToMidi1BytesTranslatorContext(192, false, true));
+    std::vector<uint8_t> dst;
+    EXPECT_EQ(UmpTranslationResult::OK, translator.translate(dst, src));
+    std::vector<uint8_t> expected = {0x91, 60, 100, 0xF0, 1, 2, 3, 4, 5, 6, 7, 8, 0xF7};
+    EXPECT_EQ(expected, dst);
+
+    // the translator is reusable
+    EXPECT_EQ(UmpTranslationResult::OK, translator.translate(dst, src));
+    EXPECT_EQ(expected, dst);
+
+    src.pop_back();
+    EXPECT_EQ(UmpTranslationResult::INCOMPLETE_SYSEX7, translator.translate(dst, src));
+    expected = {0x91, 60, 100};
+    EXPECT_EQ(expected, dst);
+}
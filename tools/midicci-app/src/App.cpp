@@ -205,6 +205,9 @@ bool MidicciApplication::render_frame() {
         return false;
     }
 
+    if (auto ci = repository_->get_ci_device_manager()) {
+        ci->drain_diagnostics();
+    }
     render_window();
     ui_scale_dirty_ = false;
     return true;
@@ -333,6 +336,13 @@ void MidicciApplication::render_local_device_tab() {
     }
 }
 
+const std::string& MidicciApplication::LogLine::get_text() const {
+    if (record && text->empty()) {
+        *text = record->getText();
+    }
+    return *text;
+}
+
 std::vector<MidicciApplication::LogLine> MidicciApplication::copy_logs_for_render() {
     std::lock_guard<std::mutex> lock(log_mutex_);
     return std::vector<LogLine>(log_lines_.begin(), log_lines_.end());
@@ -360,7 +370,8 @@ void MidicciApplication::render_logs_tab() {
 
     for (size_t idx = 0; idx < entries.size(); ++idx) {
         const auto& entry = entries[idx];
-        if (!log_filter_.PassFilter(entry.message.c_str())) {
+        const auto& text = entry.get_text();
+        if (!log_filter_.PassFilter(text.c_str())) {
             continue;
         }
 
@@ -378,13 +389,16 @@ void MidicciApplication::render_logs_tab() {
         ImGui::PopStyleColor();
 
         ImGui::PushID(static_cast<int>(idx));
-        ImGui::TextWrapped("%s", entry.message.c_str());
+        ImGui::TextWrapped("%s", text.c_str());
         if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
-            ImGui::SetClipboardText(entry.message.c_str());
+            ImGui::SetClipboardText(text.c_str());
         }
         if (ImGui::BeginPopupContextItem("log_context")) {
             if (ImGui::MenuItem("Copy")) {
-                ImGui::SetClipboardText(entry.message.c_str());
+                ImGui::SetClipboardText(text.c_str());
+            }
+            if (entry.record && entry.record->isPropertyMessage() && ImGui::MenuItem("Copy as JSON")) {
+                ImGui::SetClipboardText(entry.record->getPrettyJson().c_str());
             }
             ImGui::EndPopup();
         }
@@ -405,7 +419,8 @@ void MidicciApplication::append_log_entry(const tooling::LogEntry& entry) {
         entry.direction,
         entry.source_muid,
         entry.destination_muid,
-        entry.message
+        entry.record,
+        std::make_shared<std::string>(entry.message)
     });
     if (log_lines_.size() > kMaxLogLines) {
         log_lines_.pop_front();
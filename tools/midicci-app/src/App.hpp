@@ -35,7 +35,11 @@ private:
         tooling::MessageDirection direction;
         uint32_t source_muid;
         uint32_t destination_muid;
-        std::string message;
+        std::shared_ptr<const MessageLogRecord> record;
+        // Rendered from record the first time the line is shown; shared by the per-frame copies.
+        std::shared_ptr<std::string> text;
+
+        const std::string& get_text() const;
     };
 
     std::vector<LogLine> copy_logs_for_render();
@@ -120,7 +120,11 @@ KeyboardPanel::KeyboardPanel(tooling::CIToolRepository* repository)
             auto direction = entry.direction == midicci::keyboard::MessageDirection::In
                                  ? tooling::MessageDirection::In
                                  : tooling::MessageDirection::Out;
-            repository_->log(entry.message, direction, entry.source_muid, entry.destination_muid);
+            if (entry.record) {
+                repository_->log(*entry.record, direction);
+            } else {
+                repository_->log(entry.message, direction, entry.source_muid, entry.destination_muid);
+            }
         };
         message_logger_.add_log_callback(log_bridge_);
     }
@@ -218,6 +222,8 @@ KeyboardPanel::~KeyboardPanel() {
 
 void KeyboardPanel::render() {
     apply_pending_updates();
+    if (controller_)
+        controller_->drainDiagnostics();
 
     render_transport_section();
     ImGui::Spacing();
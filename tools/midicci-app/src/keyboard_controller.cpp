@@ -160,10 +160,23 @@ std::vector<std::string> build_disambiguated_labels(const Ports& ports) {
 
 KeyboardController::KeyboardController(midicci::keyboard::MessageLogger* logger) 
     : logger_(logger) {
+    // called with output_mutex_ held; the packets are sent by drain_outgoing_packets()
+    output_coalescer_ = std::make_unique<umppi::UmpCoalescer>([this](umppi::UmpWordSpan words) {
+        output_outbox_.emplace_back(words[0], words.size() > 1 ? words[1] : 0,
+                                    words.size() > 2 ? words[2] : 0, words.size() > 3 ? words[3] : 0);
+    });
+    output_flusher_ = std::thread([this] { run_output_flusher(); });
     resetMidiConnections();
 }
 
 KeyboardController::~KeyboardController() {
+    {
+        std::lock_guard<std::mutex> lock(output_mutex_);
+        output_flusher_stop_ = true;
+    }
+    output_flusher_cv_.notify_one();
+    output_flusher_.join();
+
     if (initialized) {
         allNotesOff();
         if (midiIn && midiIn->is_port_open()) {
@@ -402,7 +415,7 @@ void KeyboardController::noteOn(int note, int velocity) {
     try {
         // Send MIDI 2.0 UMP note on message
         libremidi::ump noteOnPacket = createUmpNoteOn(0, note, velocity);
-        dispatch_outgoing_packet(noteOnPacket);
+        send_outgoing_packet(noteOnPacket);
     } catch (const std::exception& e) {
         std::cerr << "Error sending note on: " << e.what() << std::endl;
     }
@@ -414,7 +427,7 @@ void KeyboardController::noteOff(int note) {
     try {
         // Send MIDI 2.0 UMP note off message
         libremidi::ump noteOffPacket = createUmpNoteOff(0, note);
-        dispatch_outgoing_packet(noteOffPacket);
+        send_outgoing_packet(noteOffPacket);
     } catch (const std::exception& e) {
         std::cerr << "Error sending note off: " << e.what() << std::endl;
     }
@@ -874,7 +887,7 @@ bool KeyboardController::sendSysExViaMidi(uint8_t group, const std::vector<uint8
         try {
             umppi::UmpFactory::sysex7Process(group, data, [this](const umppi::Ump& ump) {
                 libremidi::ump packet(ump.int1, ump.int2, 0, 0);
-                dispatch_outgoing_packet(packet);
+                send_outgoing_packet(packet);
             });
             std::cout << "[SYSEX SEND] UMP SYSEX7 packets sent successfully" << std::endl;
         } catch (const std::exception& e) {
@@ -900,7 +913,7 @@ void KeyboardController::sendControlChange(int channel, int controller, uint32_t
     try {
         auto cc = umppi::UmpFactory::midi2CC(clamp_group(group), channel, controller, value);
         libremidi::ump packet(cc >> 32, cc & 0xFFFFFFFF, 0, 0);
-        dispatch_outgoing_packet(packet);
+        send_outgoing_packet(packet);
 
         std::cout << "[MIDI OUT] CC Ch:" << channel << " CC:" << controller << " Val:" << value << std::endl;
     } catch (const std::exception& e) {
@@ -914,7 +927,7 @@ void KeyboardController::sendRPN(int channel, int msb, int lsb, uint32_t value,
     try {
         auto rpn = umppi::UmpFactory::midi2RPN(clamp_group(group), channel, msb, lsb, value);
         libremidi::ump packet(rpn >> 32, rpn & 0xFFFFFFFF, 0, 0);
-        dispatch_outgoing_packet(packet);
+        send_outgoing_packet(packet);
 
         std::cout << "[MIDI OUT] RPN Ch:" << channel << " MSB:" << msb << " LSB:" << lsb << " Val:" << value << std::endl;
     } catch (const std::exception& e) {
@@ -928,7 +941,7 @@ void KeyboardController::sendNRPN(int channel, int msb, int lsb, uint32_t value,
     try {
         auto nrpn = umppi::UmpFactory::midi2NRPN(clamp_group(group), channel, msb, lsb, value);
         libremidi::ump packet(nrpn >> 32, nrpn & 0xFFFFFFFF, 0, 0);
-        dispatch_outgoing_packet(packet);
+        send_outgoing_packet(packet);
 
         std::cout << "[MIDI OUT] NRPN Ch:" << channel << " MSB:" << msb << " LSB:" << lsb << " Val:" << value << std::endl;
     } catch (const std::exception& e) {
@@ -942,7 +955,7 @@ void KeyboardController::sendPerNoteControlChange(int channel, int note, int con
     try {
         auto pnac = umppi::UmpFactory::midi2PerNoteACC(clamp_group(group), channel, note, controller, value);
         libremidi::ump packet(pnac >> 32, pnac & 0xFFFFFFFF, 0, 0);
-        dispatch_outgoing_packet(packet);
+        send_outgoing_packet(packet);
 
         std::cout << "[MIDI OUT] Per-Note CC Ch:" << channel << " Note:" << note << " CC:" << controller << " Val:" << value << std::endl;
     } catch (const std::exception& e) {
@@ -956,7 +969,7 @@ void KeyboardController::sendPerNoteAftertouch(int channel, int note, uint32_t v
     try {
         auto paf = umppi::UmpFactory::midi2PAf(clamp_group(group), channel, note, value);
         libremidi::ump packet(paf >> 32, paf & 0xFFFFFFFF, 0, 0);
-        dispatch_outgoing_packet(packet);
+        send_outgoing_packet(packet);
 
         std::cout << "[MIDI OUT] Per-Note AC Ch:" << channel << " Note:" << note << " Val:" << value << std::endl;
     } catch (const std::exception& e) {
@@ -970,7 +983,7 @@ void KeyboardController::sendProgramChange(int channel, uint8_t program, uint8_t
     try {
         auto pc = umppi::UmpFactory::midi2Program(clamp_group(group), channel, umppi::MidiProgramChangeOptions::BANK_VALID, program, bankMSB, bankLSB);
         libremidi::ump packet(pc >> 32, pc & 0xFFFFFFFF, 0, 0);
-        dispatch_outgoing_packet(packet);
+        send_outgoing_packet(packet);
 
         std::cout << "[MIDI OUT] Program Change Ch:" << channel << " Program:" << (int)program
                   << " Bank MSB:" << (int)bankMSB << " Bank LSB:" << (int)bankLSB << std::endl;
@@ -1059,6 +1072,66 @@ void KeyboardController::checkAndAutoConnect() {
     }
 }
 
+void KeyboardController::drainDiagnostics() {
+    if (midiCIManager && midiCIManager->isInitialized()) {
+        midiCIManager->drainDiagnostics();
+    }
+}
+
+void KeyboardController::send_outgoing_packet(const libremidi::ump& packet) {
+    umppi::UmpWordSpan words{packet.data, static_cast<size_t>(umppi::umpSizeInInts(packet.data[0] >> 28))};
+    uint32_t key;
+    std::unique_lock<std::mutex> lock(output_mutex_);
+    if (umppi::UmpCoalescer::getCoalescingKey(words, key)) {
+        output_coalescer_->send(words);
+        if (output_coalescer_->getPendingCount() > 0)
+            output_flusher_cv_.notify_one();
+    } else {
+        // notes, SysEx and the like pass by the coalescer once the values it holds back are out
+        output_coalescer_->flush();
+        output_outbox_.push_back(packet);
+    }
+    drain_outgoing_packets(lock);
+}
+
+// Sends the outbox with output_mutex_ released. Packets queued meanwhile (also from other threads, or
+// from the output callbacks) are sent by the thread that is already draining, so they stay in order.
+void KeyboardController::drain_outgoing_packets(std::unique_lock<std::mutex>& lock) {
+    if (output_draining_)
+        return;
+    output_draining_ = true;
+    std::vector<libremidi::ump> packets;
+    while (!output_outbox_.empty()) {
+        packets.swap(output_outbox_);
+        lock.unlock();
+        try {
+            for (const auto& packet : packets)
+                dispatch_outgoing_packet(packet);
+        } catch (...) {
+            lock.lock();
+            output_draining_ = false;
+            throw;
+        }
+        packets.clear();
+        lock.lock();
+    }
+    output_draining_ = false;
+}
+
+void KeyboardController::run_output_flusher() {
+    std::unique_lock<std::mutex> lock(output_mutex_);
+    while (!output_flusher_stop_) {
+        if (output_coalescer_->getPendingCount() == 0)
+            output_flusher_cv_.wait(lock);
+        else
+            output_flusher_cv_.wait_for(lock, output_coalescer_->getFlushInterval());
+        if (output_flusher_stop_)
+            break;
+        output_coalescer_->flushIfDue();
+        drain_outgoing_packets(lock);
+    }
+}
+
 void KeyboardController::dispatch_outgoing_packet(const libremidi::ump& packet) {
     try {
         if (midiOut) {
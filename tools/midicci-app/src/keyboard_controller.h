@@ -7,6 +7,10 @@
 #include <string>
 #include <set>
 #include <optional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <umppi/details/UmpCoalescer.hpp>
 #include "midi_ci_manager.h"
 #include "message_logger.h"
 
@@ -78,6 +82,7 @@ public:
     void sendPerNoteControlChange(int channel, int note, int controller, uint32_t value, int group = 0);
     void sendPerNoteAftertouch(int channel, int note, uint32_t value, int group = 0);
     void sendProgramChange(int channel, uint8_t program, uint8_t bankMSB, uint8_t bankLSB, int group = 0);
+    void drainDiagnostics();
     
     // MIDI connection state
     bool hasValidMidiPair() const;
@@ -106,6 +111,9 @@ private:
     std::set<std::vector<uint8_t>> recentOutgoingSysEx;
     
     void onMidiInput(libremidi::ump&& packet);
+    void send_outgoing_packet(const libremidi::ump& packet);
+    void drain_outgoing_packets(std::unique_lock<std::mutex>& lock);
+    void run_output_flusher();
     void dispatch_outgoing_packet(const libremidi::ump& packet);
     bool extract_note_event(const libremidi::ump& packet, int& note, int& velocity, bool& is_pressed) const;
     bool extract_control_value(const libremidi::ump& packet, IncomingControlValue& value) const;
@@ -129,6 +137,18 @@ private:
     std::vector<uint8_t> sysex_buffer_;
     bool sysex_in_progress_ = false;
     
+    // Controller values go through the coalescer, which holds back superseded values; anything else
+    // first flushes what is held back, so that controllers stay ordered relative to notes. Packets
+    // leave through output_outbox_, which one thread at a time sends without holding output_mutex_.
+    // output_flusher_ sends the values still held back once the flush interval has elapsed.
+    std::unique_ptr<umppi::UmpCoalescer> output_coalescer_;
+    std::vector<libremidi::ump> output_outbox_;
+    bool output_draining_ = false;
+    bool output_flusher_stop_ = false;
+    std::mutex output_mutex_;
+    std::condition_variable output_flusher_cv_;
+    std::thread output_flusher_;
+
     midicci::keyboard::MessageLogger* logger_;
     std::function<void(const libremidi::ump&)> external_output_callback_;
     std::function<void(int, int, bool)> incoming_note_callback_;
@@ -7,6 +7,10 @@ namespace midicci::keyboard {
 LogEntry::LogEntry(MessageDirection dir, const std::string& msg, uint32_t src_muid, uint32_t dest_muid)
     : timestamp(std::chrono::system_clock::now()), direction(dir), message(msg), source_muid(src_muid), destination_muid(dest_muid) {}
 
+LogEntry::LogEntry(MessageDirection dir, std::shared_ptr<const MessageLogRecord> msg)
+    : timestamp(std::chrono::system_clock::now()), direction(dir), record(std::move(msg)),
+      source_muid(record->getSourceMuid()), destination_muid(record->getDestinationMuid()) {}
+
 class MessageLogger::Impl {
 public:
     std::vector<LogEntry> logs_;
@@ -30,11 +34,14 @@ void MessageLogger::log(const std::string& message, MessageDirection direction,
 }
 
 void MessageLogger::log_midi_ci_message(const midicci::Message& message, MessageDirection direction) {
-    std::string log_message = message.getLogMessage();
-    uint32_t source_muid = message.getSourceMuid();
-    uint32_t destination_muid = message.getDestinationMuid();
+    auto record = std::make_shared<const MessageLogRecord>(message.createLogRecord());
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+    LogEntry entry(direction, std::move(record));
+    pimpl_->logs_.push_back(entry);
     
-    log(log_message, direction, source_muid, destination_muid);
+    for (const auto& callback : pimpl_->log_callbacks_) {
+        callback(entry);
+    }
 }
 
 void MessageLogger::add_log_callback(LogCallback callback) {
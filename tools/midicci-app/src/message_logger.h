@@ -10,6 +10,7 @@
 // Forward declaration for MIDI-CI message
 namespace midicci {
     class Message;
+    class MessageLogRecord;
 }
 
 namespace midicci::keyboard {
@@ -23,10 +24,13 @@ struct LogEntry {
     std::chrono::system_clock::time_point timestamp;
     MessageDirection direction;
     std::string message;
+    // Set for MIDI-CI messages, whose text is only rendered when it is displayed (message is empty).
+    std::shared_ptr<const MessageLogRecord> record;
     uint32_t source_muid;
     uint32_t destination_muid;
     
     LogEntry(MessageDirection dir, const std::string& msg, uint32_t src_muid = 0, uint32_t dest_muid = 0);
+    LogEntry(MessageDirection dir, std::shared_ptr<const MessageLogRecord> msg);
 };
 
 class MessageLogger {
@@ -1,6 +1,7 @@
 #include "midi_ci_manager.h"
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <fstream>
 #include <random>
 #include <chrono>
@@ -68,6 +69,12 @@ bool MidiCIManager::initialize(uint32_t muid) {
             }
         );
         
+        // The SysEx and CI message traces that used to go to the console are diagnostics now;
+        // drainDiagnostics() prints them.
+        auto& diagnostics = device_->getDiagnosticLogger();
+        diagnostics.setLevel(midicci::LogCategory::Transport, midicci::LogLevel::Debug);
+        diagnostics.setMaxPayloadSize(std::numeric_limits<size_t>::max());
+
         // Setup callbacks
         setupCallbacks();
         
@@ -111,18 +118,15 @@ void MidiCIManager::shutdown() {
 void MidiCIManager::processMidi1SysEx(const std::vector<uint8_t>& sysex_data) {
     if (!initialized_ || !device_) return;
     
-    std::cout << "[MIDICCI] Processing MIDI 1.0 SysEx, size: " << sysex_data.size() << std::endl;
-    std::cout << "[MIDICCI] SysEx data: ";
-    for (size_t i = 0; i < std::min(sysex_data.size(), size_t(16)); i++) {
-        std::cout << std::hex << "0x" << (int)sysex_data[i] << " ";
+    auto& diagnostics = device_->getDiagnosticLogger();
+    if (diagnostics.isEnabled(midicci::LogLevel::Debug, midicci::LogCategory::Transport)) {
+        diagnostics.write(midicci::LogLevel::Debug, midicci::LogCategory::Transport, midicci::LogEvent::SysExReceived,
+                          muid_, {0, static_cast<uint32_t>(sysex_data.size())}, sysex_data);
     }
-    if (sysex_data.size() > 16) std::cout << "... (truncated)";
-    std::cout << std::dec << std::endl;
     
     try {
         // Process MIDI 1.0 SysEx data through MIDI-CI device
         device_->processInput(0, sysex_data); // Use group 0 for MIDI 1.0
-        std::cout << "[MIDICCI] SysEx processed successfully" << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "[MIDI-CI ERROR] Error processing MIDI 1.0 SysEx: " << e.what() << std::endl;
     }
@@ -304,20 +308,20 @@ void MidiCIManager::setupCallbacks() {
     
     // Set up message callback for outgoing messages
     device_->setMessageCallback([this](const midicci::Message& message) {
-        std::string msgTypeName;
-        switch(message.getType()) {
-            case midicci::MessageType::DiscoveryInquiry: msgTypeName = "DiscoveryInquiry"; break;
-            case midicci::MessageType::DiscoveryReply: msgTypeName = "DiscoveryReply"; break;
-            case midicci::MessageType::GetPropertyData: msgTypeName = "GetPropertyData"; break;
-            case midicci::MessageType::GetPropertyDataReply: msgTypeName = "GetPropertyDataReply"; break;
-            default: msgTypeName = "Unknown(" + std::to_string(static_cast<int>(message.getType())) + ")"; break;
+        auto& diagnostics = device_->getDiagnosticLogger();
+        if (diagnostics.isEnabled(midicci::LogLevel::Debug, midicci::LogCategory::Transport)) {
+            diagnostics.write(midicci::LogLevel::Debug, midicci::LogCategory::Transport, midicci::LogEvent::MessageSent,
+                              muid_, {static_cast<uint8_t>(message.getType()), message.getDestinationMuid()}, {}, true);
         }
-        std::cout << "[MIDI-CI SENT] " << msgTypeName << " to MUID: 0x" << std::hex << message.getDestinationMuid() << std::dec << std::endl;
     });
     
     // Set up message received callback
     device_->setMessageReceivedCallback([this](const midicci::Message& message) {
-        std::cout << "[UMP-KEYBOARD RECV] Message type: " << static_cast<int>(message.getType()) << std::endl;
+        auto& diagnostics = device_->getDiagnosticLogger();
+        if (diagnostics.isEnabled(midicci::LogLevel::Debug, midicci::LogCategory::Transport)) {
+            diagnostics.write(midicci::LogLevel::Debug, midicci::LogCategory::Transport, midicci::LogEvent::MessageReceived,
+                              muid_, {static_cast<uint8_t>(message.getType()), message.getSourceMuid()});
+        }
         
         // Handle Endpoint Reply messages to populate device combobox
         if (message.getType() == midicci::MessageType::EndpointReply) {
@@ -476,6 +480,13 @@ void MidiCIManager::setupCallbacks() {
     });
 }
 
+void MidiCIManager::drainDiagnostics() {
+    if (!initialized_ || !device_) return;
+    device_->getDiagnosticLogger().drain([this](const midicci::LogRecord& record, std::span<const uint8_t> payload) {
+        log(midicci::formatLogRecord(record, payload), record.is_outgoing);
+    });
+}
+
 void MidiCIManager::log(const std::string& message, bool is_outgoing) {
     std::string prefix = is_outgoing ? "[MIDI-CI OUT] " : "[MIDI-CI IN] ";
     std::string full_message = prefix + message;
@@ -908,6 +919,12 @@ void MidiCIManager::removePendingPropertyRequest(uint32_t muid, const std::strin
 void MidiCIManager::cleanupExpiredPropertyRequests() {
     std::lock_guard<std::recursive_mutex> lock(midi_ci_mutex_);
     const auto now = std::chrono::steady_clock::now();
+
+    // Retries and timeouts of the requests themselves are up to each connection's request scheduler.
+    if (device_) {
+        for (const auto& [muid, conn] : device_->getConnections())
+            conn->getPropertyClientFacade().processTimeouts();
+    }
     
     auto it = std::remove_if(pending_property_requests_.begin(), pending_property_requests_.end(),
                             [now](const PendingPropertyRequest& req) {
@@ -56,6 +56,8 @@ public:
     // MIDI message processing
     void processMidi1SysEx(const std::vector<uint8_t>& sysex_data);
     void processUmpSysEx(uint8_t group, const std::vector<uint8_t>& sysex_data);
+    // Renders queued diagnostic records (see MidiCIDevice::getDiagnosticLogger()) into the log.
+    void drainDiagnostics();
     
     // Device management
     void sendDiscovery();
@@ -34,6 +34,10 @@ public:
     void shutdown();
     
     std::shared_ptr<CIDeviceModel> get_device_model() const;
+
+    // Renders queued diagnostic records of the CI device into the repository log. Call it from the
+    // UI thread (e.g. once per frame).
+    void drain_diagnostics();
     
 private:
     CIToolRepository& repository_;
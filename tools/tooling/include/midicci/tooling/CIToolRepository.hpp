@@ -20,10 +20,15 @@ struct LogEntry {
     std::chrono::system_clock::time_point timestamp;
     MessageDirection direction;
     std::string message;
+    // Set for MIDI-CI messages, whose text is only rendered when it is displayed (message is empty).
+    std::shared_ptr<const MessageLogRecord> record;
     uint32_t source_muid;
     uint32_t destination_muid;
     
     LogEntry(MessageDirection dir, const std::string& msg, uint32_t src_muid = 0, uint32_t dest_muid = 0);
+    LogEntry(MessageDirection dir, std::shared_ptr<const MessageLogRecord> msg);
+
+    std::string get_text() const;
 };
 
 class CIToolRepository {
@@ -37,6 +42,7 @@ public:
     CIToolRepository& operator=(const CIToolRepository&) = delete;
     
     void log(const std::string& message, MessageDirection direction, uint32_t source_muid = 0, uint32_t destination_muid = 0);
+    void log(MessageLogRecord record, MessageDirection direction);
     void add_log_callback(LogCallback callback);
     void remove_log_callback(LogCallback callback);
     
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <map>
 #include <memory>
 #include <vector>
 #include <functional>
@@ -7,6 +8,9 @@
 #include <cstdint>
 #include <mutex>
 #include <umppi/details/Ump.hpp>
+#include <umppi/details/UmpDemux.hpp>
+#include <umppi/details/UmpScheduler.hpp>
+#include <umppi/details/JrClockSync.hpp>
 
 namespace libremidi {
 class midi_in;
@@ -37,11 +41,28 @@ public:
     
     void set_sysex_callback(SysExCallback callback);
     bool send_sysex(uint8_t group, umppi::UmpWordSpan words);
+    // timestamp_ns is a steady_clock time (see umppi::UmpScheduler::now()). It is only honored when
+    // scheduled output is enabled; otherwise the words are sent immediately. With scheduled output,
+    // timestamp 0 means "due now": the words still go through the scheduler, behind any packets that
+    // are already due, so that they never overtake earlier output.
     void send_ump(umppi::UmpWordSpan words, uint64_t timestamp_ns);
+    // Must not be called from the scheduler's dispatch thread (i.e. from a send), as replacing the
+    // scheduler waits for that thread to finish.
+    void enable_scheduled_output(bool enabled, bool insert_jr_timestamps = false);
+    bool scheduled_output_enabled() const;
+    // Timestamps incoming packets from the sender's JR Clock/JR Timestamps (removing transport jitter,
+    // plus latency_ns so that they can be replayed in the future), and sends JR Clocks with the output.
+    void enable_jr_sync(bool enabled, uint64_t latency_ns = 0);
+    bool jr_sync_enabled() const;
     
     void process_incoming_sysex(uint8_t group, umppi::UmpWordSpan words);
     void add_ump_listener(UmpListener listener);
     void clear_ump_listeners();
+    // Unlike add_ump_listener(), the listener only receives the packets that match the filter.
+    // Routes are dispatched by one table lookup per packet, regardless of the number of routes.
+    // Like the listeners, route listeners run outside the manager's lock and may add or remove routes.
+    int add_ump_route(const umppi::UmpFilter& filter, UmpListener listener);
+    void remove_ump_route(int route_id);
     
     std::vector<std::string> get_available_input_devices() const;
     std::vector<std::string> get_available_output_devices() const;
@@ -72,6 +93,16 @@ private:
     bool initialized_;
     SysExCallback sysex_callback_;
     std::vector<UmpListener> ump_listeners_;
+    // Route changes build a new demux from ump_routes_ and swap it in, so that a packet being
+    // dispatched (outside mutex_) keeps the routes it started with.
+    std::map<int, std::pair<umppi::UmpFilter, UmpListener>> ump_routes_;
+    int next_ump_route_id_{0};
+    std::shared_ptr<umppi::UmpDemux> ump_demux_;
+    // Guarded by its own mutex rather than mutex_, which the dispatch thread takes to send;
+    // send_ump() uses a snapshot of it outside the lock.
+    std::shared_ptr<umppi::UmpScheduler> output_scheduler_;
+    mutable std::mutex output_scheduler_mutex_;
+    std::unique_ptr<umppi::JrClockSync> jr_sync_;
     std::string current_input_device_;
     std::string current_output_device_;
     
@@ -97,6 +128,9 @@ private:
     void open_virtual_ports_locked();
     void close_virtual_ports_locked();
     void reopen_virtual_ports_locked();
+    void rebuild_ump_demux_locked();
+    void send_ump_now(umppi::UmpWordSpan words, uint64_t timestamp_ns);
+    void replace_output_scheduler(std::shared_ptr<umppi::UmpScheduler> scheduler);
     void notify_ump_listeners(umppi::UmpWordSpan words, uint64_t timestamp_ns);
     static std::string format_ump_packet(const libremidi::ump& packet);
     void log_virtual_event(const std::string& message, VirtualPortDirection direction);
@@ -3,6 +3,7 @@
 #include "midicci/tooling/MidiDeviceManager.hpp"
 #include "midicci/tooling/CIDeviceModel.hpp"
 #include <midicci/midicci.hpp>
+#include <limits>
 #include <mutex>
 #include <iostream>
 #include <format>
@@ -22,10 +23,8 @@ void CIDeviceManager::initialize() {
     auto logger_wrapper = [this](const LogData& log_data) {
         MessageDirection direction = log_data.is_outgoing ? MessageDirection::Out : MessageDirection::In;
         if (log_data.hasMessage()) {
-            // For structured messages, extract MUIDs and use the message's log string
-            const auto& message = log_data.getMessage();
-            repository_.log(message.getLogMessage(), direction, 
-                          message.getSourceMuid(), message.getDestinationMuid());
+            // For structured messages, keep a record that is only rendered when displayed
+            repository_.log(log_data.getMessage().createLogRecord(), direction);
         } else {
             // For plain string messages, no MUID information
             repository_.log(log_data.getString(), direction);
@@ -48,6 +47,12 @@ void CIDeviceManager::initialize() {
         logger_wrapper);
 
     ci_session_ = std::shared_ptr<musicdevice::MidiCISession>(std::move(session));
+    // The tool shows raw CI traffic and chunk progress in its log; drain_diagnostics() renders them.
+    auto& diagnostics = ci_session_->getDevice().getDiagnosticLogger();
+    diagnostics.setLevel(LogCategory::Transport, LogLevel::Debug);
+    diagnostics.setLevel(LogCategory::Property, LogLevel::Debug);
+    // SysEx dumps were always logged in full
+    diagnostics.setMaxPayloadSize(std::numeric_limits<size_t>::max());
 
     device_model_ = std::make_shared<CIDeviceModel>(
         *this,
@@ -87,6 +92,20 @@ std::shared_ptr<CIDeviceModel> CIDeviceManager::get_device_model() const {
     return device_model_;
 }
 
+void CIDeviceManager::drain_diagnostics() {
+    std::shared_ptr<musicdevice::MidiCISession> session;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        session = ci_session_;
+    }
+    if (!session) {
+        return;
+    }
+    session->getDevice().getDiagnosticLogger().drain([this](const LogRecord& record, std::span<const uint8_t> payload) {
+        repository_.log(formatLogRecord(record, payload), record.is_outgoing ? MessageDirection::Out : MessageDirection::In);
+    });
+}
+
 void CIDeviceManager::process_single_ump_packet(const umppi::Ump& ump) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     
@@ -11,6 +11,14 @@ namespace midicci::tooling {
 LogEntry::LogEntry(MessageDirection dir, const std::string& msg, uint32_t src_muid, uint32_t dest_muid)
     : timestamp(std::chrono::system_clock::now()), direction(dir), message(msg), source_muid(src_muid), destination_muid(dest_muid) {}
 
+LogEntry::LogEntry(MessageDirection dir, std::shared_ptr<const MessageLogRecord> msg)
+    : timestamp(std::chrono::system_clock::now()), direction(dir), record(std::move(msg)),
+      source_muid(record->getSourceMuid()), destination_muid(record->getDestinationMuid()) {}
+
+std::string LogEntry::get_text() const {
+    return record ? record->getText() : message;
+}
+
 class CIToolRepository::Impl {
 public:
     Impl() : muid_(generate_muid()) {
@@ -57,6 +65,16 @@ void CIToolRepository::log(const std::string& message, MessageDirection directio
     }
 }
 
+void CIToolRepository::log(MessageLogRecord record, MessageDirection direction) {
+    std::lock_guard<std::mutex> lock(pimpl_->mutex_);
+    LogEntry entry(direction, std::make_shared<const MessageLogRecord>(std::move(record)));
+    pimpl_->logs_.push_back(entry);
+    
+    for (const auto& callback : pimpl_->log_callbacks_) {
+        callback(entry);
+    }
+}
+
 void CIToolRepository::add_log_callback(LogCallback callback) {
     std::lock_guard<std::mutex> lock(pimpl_->mutex_);
     pimpl_->log_callbacks_.push_back(std::move(callback));
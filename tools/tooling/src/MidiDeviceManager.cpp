@@ -3,6 +3,7 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 
 namespace {
 constexpr const char* kDefaultVirtualInputName = "MIDICCI App (In)";
@@ -31,6 +32,7 @@ void MidiDeviceManager::initialize() {
 }
 
 void MidiDeviceManager::shutdown() {
+    replace_output_scheduler(nullptr);
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (initialized_) {
         if (midi_input_) {
@@ -77,6 +79,38 @@ void MidiDeviceManager::add_ump_listener(UmpListener listener) {
 void MidiDeviceManager::clear_ump_listeners() {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     ump_listeners_.clear();
+    ump_routes_.clear();
+    ump_demux_.reset();
+}
+
+int MidiDeviceManager::add_ump_route(const umppi::UmpFilter& filter, UmpListener listener) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (ump_routes_.size() >= umppi::UmpDemux::MAX_ROUTES) {
+        throw std::length_error("MidiDeviceManager: too many UMP routes");
+    }
+    int route_id = next_ump_route_id_++;
+    ump_routes_.emplace(route_id, std::make_pair(filter, std::move(listener)));
+    rebuild_ump_demux_locked();
+    return route_id;
+}
+
+void MidiDeviceManager::remove_ump_route(int route_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (ump_routes_.erase(route_id) > 0) {
+        rebuild_ump_demux_locked();
+    }
+}
+
+void MidiDeviceManager::rebuild_ump_demux_locked() {
+    if (ump_routes_.empty()) {
+        ump_demux_.reset();
+        return;
+    }
+    auto demux = std::make_shared<umppi::UmpDemux>();
+    for (const auto& [route_id, route] : ump_routes_) {
+        demux->addRoute(route.first, route.second);
+    }
+    ump_demux_ = std::move(demux);
 }
 
 void MidiDeviceManager::send_ump(umppi::UmpWordSpan words, uint64_t timestamp_ns) {
@@ -84,6 +118,71 @@ void MidiDeviceManager::send_ump(umppi::UmpWordSpan words, uint64_t timestamp_ns
         return;
     }
 
+    std::shared_ptr<umppi::UmpScheduler> scheduler;
+    {
+        std::lock_guard<std::mutex> lock(output_scheduler_mutex_);
+        scheduler = output_scheduler_;
+    }
+    // a full queue drops the packets; the scheduler counts them
+    if (scheduler) {
+        scheduler->schedule(words, timestamp_ns);
+        return;
+    }
+    send_ump_now(words, timestamp_ns);
+}
+
+void MidiDeviceManager::enable_scheduled_output(bool enabled, bool insert_jr_timestamps) {
+    std::shared_ptr<umppi::UmpScheduler> scheduler;
+    if (enabled) {
+        umppi::UmpScheduler::Options options;
+        options.insertJrTimestamps = insert_jr_timestamps;
+        scheduler = std::make_shared<umppi::UmpScheduler>(
+            [this](umppi::UmpWordSpan words, uint64_t timestamp_ns) { send_ump_now(words, timestamp_ns); },
+            options);
+    }
+    replace_output_scheduler(std::move(scheduler));
+}
+
+bool MidiDeviceManager::scheduled_output_enabled() const {
+    std::lock_guard<std::mutex> lock(output_scheduler_mutex_);
+    return output_scheduler_ != nullptr;
+}
+
+void MidiDeviceManager::replace_output_scheduler(std::shared_ptr<umppi::UmpScheduler> scheduler) {
+    {
+        std::lock_guard<std::mutex> lock(output_scheduler_mutex_);
+        output_scheduler_.swap(scheduler);
+    }
+    // Stopping joins the dispatch thread, which may be waiting for mutex_ in send_ump_now(), so it
+    // happens with no lock held. What the old scheduler did not send yet is discarded; a send_ump()
+    // still holding it only queues into a stopped scheduler.
+    if (scheduler)
+        scheduler->stop();
+}
+
+void MidiDeviceManager::enable_jr_sync(bool enabled, uint64_t latency_ns) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    jr_sync_ = enabled ? std::make_unique<umppi::JrClockSync>(latency_ns) : nullptr;
+}
+
+bool MidiDeviceManager::jr_sync_enabled() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return jr_sync_ != nullptr;
+}
+
+void MidiDeviceManager::send_ump_now(umppi::UmpWordSpan words, uint64_t timestamp_ns) {
+    std::vector<uint32_t> with_jr_clock;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        uint64_t now = umppi::UmpScheduler::now();
+        if (jr_sync_ && jr_sync_->isJrClockDue(now)) {
+            with_jr_clock.push_back(jr_sync_->nextJrClock(now));
+            with_jr_clock.insert(with_jr_clock.end(), words.begin(), words.end());
+            words = with_jr_clock;
+        }
+    }
+
+
     bool sent = false;
 
     if (midi_output_) {
@@ -364,7 +463,14 @@ void MidiDeviceManager::handle_input_message(libremidi::ump&& packet, bool from_
         if (from_virtual) {
             log_virtual_event("[virtual in] " + format_ump_packet(packet), VirtualPortDirection::In);
         }
-        notify_ump_listeners(span, 0);
+        uint64_t timestamp_ns = 0;
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex_);
+            if (jr_sync_) {
+                timestamp_ns = jr_sync_->receive(span, umppi::UmpScheduler::now());
+            }
+        }
+        notify_ump_listeners(span, timestamp_ns);
         process_incoming_sysex(group, span);
 
         if (extract_note_event(packet, note, velocity, is_pressed)) {
@@ -464,12 +570,18 @@ void MidiDeviceManager::reopen_virtual_ports_locked() {
 }
 
 void MidiDeviceManager::notify_ump_listeners(umppi::UmpWordSpan words, uint64_t timestamp_ns) {
+    std::shared_ptr<umppi::UmpDemux> demux;
     std::vector<UmpListener> listeners;
     {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
+        demux = ump_demux_;
         listeners = ump_listeners_;
     }
 
+    if (demux) {
+        demux->process(words, timestamp_ns);
+    }
+
     if (listeners.empty()) {
         return;
     }
@@ -0,0 +1,249 @@
+// umppi-convert: converts directories of Standard MIDI Files to MIDI 2.0 clip files and back.
+//
+//   umppi-convert [--to-clip | --to-smf] [-j threads] [--group n] [--quiet] <input> <output>
+//
+// <input> is a file or a directory (searched recursively); the directory structure is mirrored under
+// <output>. Files are converted in parallel by umppi::Midi2ClipConverter. SMF tracks are read and
+// translated one at a time, but all translated tracks of a file are kept until they are merged into the
+// clip; clips are translated in chunks as they are read.
+
+#include <umppi/umppi.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace umppi;
+
+namespace {
+
+enum class Direction {
+    ToClip,
+    ToSmf
+};
+
+struct Options {
+    Direction direction = Direction::ToClip;
+    fs::path input;
+    fs::path output;
+    unsigned threads = 0;
+    int group = 0;
+    bool quiet = false;
+};
+
+struct Job {
+    fs::path input;
+    fs::path output;
+};
+
+struct Statistics {
+    std::atomic<uint64_t> files{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> inputBytes{0};
+    std::atomic<uint64_t> outputBytes{0};
+    std::atomic<uint64_t> packets{0};
+};
+
+void printUsage() {
+    std::cerr << "Usage: umppi-convert [--to-clip | --to-smf] [-j threads] [--group n] [--quiet] <input> <output>\n"
+              << "  --to-clip   convert SMF (.mid, .midi, .smf) to MIDI 2.0 clip files (.midi2) (default)\n"
+              << "  --to-smf    convert MIDI 2.0 clip files (.midi2) to SMF (.mid)\n"
+              << "  -j threads  number of worker threads (default: hardware concurrency)\n"
+              << "  --group n   UMP group (0-15) of the generated clip messages\n"
+              << "  --quiet     only print the summary and errors\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--to-clip") {
+            options.direction = Direction::ToClip;
+        } else if (arg == "--to-smf") {
+            options.direction = Direction::ToSmf;
+        } else if (arg == "-j" && i + 1 < argc) {
+            options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--group" && i + 1 < argc) {
+            options.group = std::stoi(argv[++i]);
+            if (options.group < 0 || options.group > 15)
+                return false;
+        } else if (arg == "--quiet") {
+            options.quiet = true;
+        } else if (arg == "-h" || arg == "--help") {
+            return false;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() != 2)
+        return false;
+    options.input = positional[0];
+    options.output = positional[1];
+    if (options.threads == 0)
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+    return true;
+}
+
+bool isInputFile(const fs::path& path, Direction direction) {
+    auto ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (direction == Direction::ToClip)
+        return ext == ".mid" || ext == ".midi" || ext == ".smf";
+    return ext == ".midi2";
+}
+
+std::vector<Job> collectJobs(const Options& options) {
+    std::vector<Job> jobs;
+    const char* outputExtension = options.direction == Direction::ToClip ? ".midi2" : ".mid";
+    if (fs::is_regular_file(options.input)) {
+        fs::path output = options.output;
+        if (fs::is_directory(output))
+            output /= options.input.filename();
+        if (fs::is_directory(options.output) || output.extension().empty())
+            output.replace_extension(outputExtension);
+        jobs.push_back({options.input, output});
+        return jobs;
+    }
+    for (const auto& entry : fs::recursive_directory_iterator(options.input)) {
+        if (!entry.is_regular_file() || !isInputFile(entry.path(), options.direction))
+            continue;
+        fs::path output = options.output / fs::relative(entry.path(), options.input);
+        output.replace_extension(outputExtension);
+        jobs.push_back({entry.path(), output});
+    }
+    // larger files first, so that one big file does not end up running alone at the end
+    std::vector<std::pair<uintmax_t, size_t>> sizes;
+    for (size_t i = 0; i < jobs.size(); i++)
+        sizes.emplace_back(fs::file_size(jobs[i].input), i);
+    std::sort(sizes.begin(), sizes.end(), std::greater<>());
+    std::vector<Job> sorted;
+    sorted.reserve(jobs.size());
+    for (const auto& [size, index] : sizes)
+        sorted.push_back(std::move(jobs[index]));
+    return sorted;
+}
+
+uint64_t convertSmfToClip(const Job& job, int group, Midi2ClipConverter& converter) {
+    std::ifstream input(job.input, std::ios::binary);
+    if (!input)
+        throw std::runtime_error("Failed to open file: " + job.input.string());
+    std::ofstream output(job.output, std::ios::binary | std::ios::trunc);
+    if (!output)
+        throw std::runtime_error("Failed to create file: " + job.output.string());
+    return converter.smfToClip(input, output, group);
+}
+
+uint64_t convertClipToSmf(const Job& job, Midi2ClipConverter& converter) {
+    std::ifstream input(job.input, std::ios::binary);
+    if (!input)
+        throw std::runtime_error("Failed to open file: " + job.input.string());
+    std::ofstream output(job.output, std::ios::binary | std::ios::trunc);
+    if (!output)
+        throw std::runtime_error("Failed to create file: " + job.output.string());
+    return converter.clipToSmf(input, output);
+}
+
+std::string formatRate(double value, const char* unit) {
+    const char* prefixes[] = {"", "k", "M", "G"};
+    int prefix = 0;
+    while (value >= 1000.0 && prefix < 3) {
+        value /= 1000.0;
+        prefix++;
+    }
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%.2f %s%s/s", value, prefixes[prefix], unit);
+    return buffer;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage();
+            return 2;
+        }
+    } catch (const std::exception&) {
+        printUsage();
+        return 2;
+    }
+
+    std::vector<Job> jobs;
+    try {
+        jobs = collectJobs(options);
+        for (const auto& job : jobs)
+            fs::create_directories(job.output.parent_path().empty() ? fs::path(".") : job.output.parent_path());
+    } catch (const std::exception& e) {
+        std::cerr << "umppi-convert: " << e.what() << "\n";
+        return 1;
+    }
+    if (jobs.empty()) {
+        std::cerr << "umppi-convert: no input files found in " << options.input << "\n";
+        return 1;
+    }
+
+    Statistics statistics;
+    std::atomic<size_t> nextJob{0};
+    std::mutex outputMutex;
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        // reused across the files converted by this worker
+        Midi2ClipConverter converter;
+        for (size_t index = nextJob++; index < jobs.size(); index = nextJob++) {
+            const auto& job = jobs[index];
+            try {
+                uint64_t packets = options.direction == Direction::ToClip
+                    ? convertSmfToClip(job, options.group, converter)
+                    : convertClipToSmf(job, converter);
+                statistics.files++;
+                statistics.packets += packets;
+                statistics.inputBytes += fs::file_size(job.input);
+                statistics.outputBytes += fs::file_size(job.output);
+                if (!options.quiet) {
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    std::cout << job.input.string() << " -> " << job.output.string() << "\n";
+                }
+            } catch (const std::exception& e) {
+                statistics.failures++;
+                std::error_code ignored;
+                fs::remove(job.output, ignored);
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::cerr << job.input.string() << ": " << e.what() << "\n";
+            }
+        }
+    };
+
+    unsigned threadCount = static_cast<unsigned>(std::min<size_t>(options.threads, jobs.size()));
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; i++)
+        threads.emplace_back(worker);
+    for (auto& thread : threads)
+        thread.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (seconds <= 0)
+        seconds = 1e-9;
+    std::cout << "Converted " << statistics.files.load() << " file(s), " << statistics.failures.load() << " failed, in "
+              << seconds << " s using " << threadCount << " thread(s)\n"
+              << "  " << formatRate(statistics.files.load() / seconds, "files") << ", "
+              << formatRate(statistics.inputBytes.load() / seconds, "B") << " read, "
+              << formatRate(statistics.outputBytes.load() / seconds, "B") << " written, "
+              << formatRate(statistics.packets.load() / seconds, "packets") << "\n";
+    return statistics.failures == 0 ? 0 : 1;
+}